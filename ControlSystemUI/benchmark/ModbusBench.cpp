@@ -0,0 +1,434 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+#include <QHash>
+#include <QFile>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include "ModbusManager.h"
+#include "MoverStatusDecoder.h"
+
+/**
+ * @brief ModbusManager无界面基准测试
+ *
+ * 连接本地模拟PLC（PlcSimulator），对异步接口做闭环压测：保持固定数量的调用在途，
+ * 每个调用产生的全部请求结束后记一次往返时间；随后启动周期扫描，统计快照到达间隔的抖动。
+ * 结果以JSON输出到标准输出或文件，便于回归比对。
+ */
+
+namespace {
+
+// --- 统计 ---
+
+/**
+ * @brief 往返时间样本，输出请求速率和百分位延迟
+ */
+class LatencySamples
+{
+public:
+    void add(qint64 ns) { m_samples.append(ns); }
+    void addFailure() { ++m_failures; }
+
+    QJsonObject toJson(qint64 elapsedNs) const
+    {
+        QVector<qint64> sorted = m_samples;
+        std::sort(sorted.begin(), sorted.end());
+
+        QJsonObject latency;
+        latency["min"] = toUs(sorted.isEmpty() ? 0 : sorted.first());
+        latency["mean"] = toUs(mean(sorted));
+        latency["p50"] = toUs(percentile(sorted, 0.50));
+        latency["p99"] = toUs(percentile(sorted, 0.99));
+        latency["p999"] = toUs(percentile(sorted, 0.999));
+        latency["max"] = toUs(sorted.isEmpty() ? 0 : sorted.last());
+
+        QJsonObject result;
+        result["calls"] = sorted.size() + m_failures;
+        result["failures"] = m_failures;
+        result["durationMs"] = elapsedNs / 1e6;
+        result["callsPerSec"] = elapsedNs > 0 ? sorted.size() * 1e9 / elapsedNs : 0.0;
+        result["latencyUs"] = latency;
+        return result;
+    }
+
+    static double percentile(const QVector<qint64> &sorted, double p)
+    {
+        if (sorted.isEmpty()) {
+            return 0.0;
+        }
+        // 最近秩法：样本不足时p999退化为最大值
+        const int rank = qBound(1, static_cast<int>(std::ceil(p * sorted.size())), sorted.size());
+        return sorted.at(rank - 1);
+    }
+
+    static double mean(const QVector<qint64> &samples)
+    {
+        if (samples.isEmpty()) {
+            return 0.0;
+        }
+        double sum = 0.0;
+        for (qint64 sample : samples) {
+            sum += sample;
+        }
+        return sum / samples.size();
+    }
+
+    static double toUs(double ns) { return std::round(ns / 100.0) / 10.0; }
+
+private:
+    QVector<qint64> m_samples;
+    int m_failures = 0;
+};
+
+struct BenchConfig {
+    QString host = "127.0.0.1";
+    int port = 5020;
+    int unitId = 1;
+    int iterations = 2000;
+    int warmup = 100;
+    int depth = 1;
+    int moverCount = 10;
+    int statusBase = ModbusRegisters::MoverStatus::BASE_ADDRESS;    // 动子状态块基址，与模拟PLC的--status-base一致
+    int writeAddress = 0x24;        // 配方区：模拟PLC中写入不会触发运动
+    int scanPeriodMs = 20;
+    int scanDurationMs = 10000;
+    int scanSpeed = 100;            // 扫描测量期间动子的运行速度 (mm/s)
+    int timeoutMs = 2000;
+};
+
+// --- 测量 ---
+
+/**
+ * @brief 闭环测量一个异步接口
+ *
+ * 调用前后的lastRequestId之差就是该调用投递的请求，全部请求结束（requestCompleted）后
+ * 记一次往返时间并补发下一个调用，始终保持depth个调用在途。
+ * 超过timeoutMs没有任何请求结束时放弃剩余调用并计为失败。
+ * @param issue 发起第index次调用，返回false表示未能投递
+ */
+QJsonObject measureAsync(ModbusManager &manager, const BenchConfig &config, int iterations, int depth,
+                         const std::function<bool(int index)> &issue)
+{
+    struct Call {
+        qint64 startNs = 0;
+        int remaining = 0;
+        bool failed = false;
+    };
+
+    LatencySamples samples;
+    QHash<quint64, int> requestToCall;
+    QVector<Call> calls(iterations);
+    QElapsedTimer clock;
+    QEventLoop loop;
+    QTimer watchdog;
+    int issued = 0;
+    int finished = 0;
+    int inFlight = 0;
+
+    auto issueNext = [&]() {
+        while (inFlight < depth && issued < iterations) {
+            const int index = issued++;
+            const quint64 before = manager.lastRequestId();
+            calls[index].startNs = clock.nsecsElapsed();
+            const bool queued = issue(index);
+            const quint64 after = manager.lastRequestId();
+            if (!queued || after == before) {
+                samples.addFailure();
+                ++finished;
+                continue;
+            }
+            calls[index].remaining = static_cast<int>(after - before);
+            for (quint64 id = before + 1; id <= after; ++id) {
+                requestToCall.insert(id, index);
+            }
+            ++inFlight;
+        }
+        if (finished >= iterations) {
+            loop.quit();
+        }
+    };
+
+    const QMetaObject::Connection connection = QObject::connect(&manager, &ModbusManager::requestCompleted,
+        [&](quint64 id, bool success) {
+            const auto it = requestToCall.find(id);
+            if (it == requestToCall.end()) {
+                return;
+            }
+            Call &call = calls[it.value()];
+            requestToCall.erase(it);
+            call.failed = call.failed || !success;
+            if (--call.remaining > 0) {
+                return;
+            }
+            if (call.failed) {
+                samples.addFailure();
+            } else {
+                samples.add(clock.nsecsElapsed() - call.startNs);
+            }
+            ++finished;
+            --inFlight;
+            watchdog.start();
+            issueNext();
+        });
+
+    watchdog.setSingleShot(true);
+    watchdog.setInterval(config.timeoutMs);
+    QObject::connect(&watchdog, &QTimer::timeout, &loop, &QEventLoop::quit);
+
+    clock.start();
+    watchdog.start();
+    issueNext();
+    if (finished < iterations) {
+        loop.exec();
+    }
+    const qint64 elapsedNs = clock.nsecsElapsed();
+    QObject::disconnect(connection);
+
+    for (int i = finished; i < iterations; ++i) {
+        samples.addFailure();
+    }
+
+    QJsonObject result = samples.toJson(elapsedNs);
+    result["depth"] = depth;
+    return result;
+}
+
+/**
+ * @brief 统计周期扫描的快照到达间隔
+ *
+ * 间隔在GUI线程收到moverSnapshotReady时计时，包含跨线程通知的延迟，即界面实际感受到的扫描抖动。
+ * 帧序号不连续时说明中间的帧被合并，跳过该间隔并计入missedFrames。
+ * 扫描结果不变时I/O线程不发布快照，因此测量期间让所有动子以scanSpeed匀速运行。
+ */
+QJsonObject measureScan(ModbusManager &manager, const BenchConfig &config)
+{
+    QVector<qint64> intervals;
+    QElapsedTimer clock;
+    qint64 lastArrivalNs = -1;
+    quint64 lastSequence = 0;
+    quint64 missedFrames = 0;
+    int frames = 0;
+
+    const QMetaObject::Connection connection = QObject::connect(&manager, &ModbusManager::moverSnapshotReady,
+        [&]() {
+            const qint64 now = clock.nsecsElapsed();
+            const MoverSnapshotFrame &frame = manager.acquireMoverSnapshot();
+            if (frame.sequence == lastSequence) {
+                return;
+            }
+            if (lastArrivalNs >= 0) {
+                if (frame.sequence == lastSequence + 1) {
+                    intervals.append(now - lastArrivalNs);
+                } else {
+                    missedFrames += frame.sequence - lastSequence - 1;
+                }
+            }
+            lastSequence = frame.sequence;
+            lastArrivalNs = now;
+            ++frames;
+        });
+
+    const int speedAddress = ModbusRegisters::MultiAxis::SPEED_BASE_ADDRESS;
+    manager.writeRegistersAsync(speedAddress, QVector<quint16>(config.moverCount, static_cast<quint16>(config.scanSpeed)));
+
+    manager.setScanMoverCount(config.moverCount);
+    clock.start();
+    manager.startCyclicRead(config.scanPeriodMs);
+
+    QEventLoop loop;
+    QTimer::singleShot(config.scanDurationMs, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    manager.stopCyclicRead();
+    QObject::disconnect(connection);
+    manager.writeRegistersAsync(speedAddress, QVector<quint16>(config.moverCount, 0));
+
+    std::sort(intervals.begin(), intervals.end());
+    const double periodNs = qMax(10, config.scanPeriodMs) * 1e6;
+    const double meanNs = LatencySamples::mean(intervals);
+    double variance = 0.0;
+    QVector<qint64> deviations;
+    deviations.reserve(intervals.size());
+    for (qint64 interval : intervals) {
+        variance += (interval - meanNs) * (interval - meanNs);
+        deviations.append(std::llabs(interval - static_cast<qint64>(periodNs)));
+    }
+    variance = intervals.isEmpty() ? 0.0 : variance / intervals.size();
+    std::sort(deviations.begin(), deviations.end());
+
+    QJsonObject interval;
+    interval["mean"] = LatencySamples::toUs(meanNs);
+    interval["p50"] = LatencySamples::toUs(LatencySamples::percentile(intervals, 0.50));
+    interval["p99"] = LatencySamples::toUs(LatencySamples::percentile(intervals, 0.99));
+    interval["p999"] = LatencySamples::toUs(LatencySamples::percentile(intervals, 0.999));
+    interval["max"] = LatencySamples::toUs(intervals.isEmpty() ? 0 : intervals.last());
+
+    QJsonObject jitter;
+    jitter["stddev"] = LatencySamples::toUs(std::sqrt(variance));
+    jitter["p99AbsDeviation"] = LatencySamples::toUs(LatencySamples::percentile(deviations, 0.99));
+    jitter["maxAbsDeviation"] = LatencySamples::toUs(deviations.isEmpty() ? 0 : deviations.last());
+
+    QJsonObject result;
+    result["periodMs"] = qMax(10, config.scanPeriodMs);
+    result["moverCount"] = config.moverCount;
+    result["moverSpeed"] = config.scanSpeed;
+    result["frames"] = frames;
+    result["missedFrames"] = static_cast<qint64>(missedFrames);
+    result["intervalUs"] = interval;
+    result["jitterUs"] = jitter;
+    return result;
+}
+
+bool waitForConnection(ModbusManager &manager, const BenchConfig &config, QString *errorText)
+{
+    QEventLoop loop;
+    bool connected = false;
+    QObject::connect(&manager, &ModbusManager::connected, &loop, [&]() {
+        connected = true;
+        loop.quit();
+    });
+    QObject::connect(&manager, &ModbusManager::connectionError, &loop, [&](const QString &error) {
+        *errorText = error;
+        loop.quit();
+    });
+    QTimer::singleShot(config.timeoutMs * 2, &loop, &QEventLoop::quit);
+
+    if (!manager.connectToDevice(config.host, config.port, config.unitId)) {
+        *errorText = QStringLiteral("无法发起连接");
+        return false;
+    }
+    loop.exec();
+    if (!connected && errorText->isEmpty()) {
+        *errorText = QStringLiteral("连接超时");
+    }
+    return connected;
+}
+
+// 默认屏蔽每次成功写入的qDebug日志，避免终端输出拖慢测量
+bool g_verbose = false;
+
+void messageHandler(QtMsgType type, const QMessageLogContext &, const QString &message)
+{
+    if (!g_verbose && (type == QtDebugMsg || type == QtInfoMsg)) {
+        return;
+    }
+    std::fprintf(stderr, "%s\n", qPrintable(message));
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ModbusBench");
+
+    BenchConfig config;
+    QCommandLineParser parser;
+    parser.setApplicationDescription("ControlSystemUI ModbusManager基准测试，结果以JSON输出");
+    parser.addHelpOption();
+    const QCommandLineOption hostOption("host", "PLC地址", "host", config.host);
+    const QCommandLineOption portOption("port", "Modbus TCP端口", "port", QString::number(config.port));
+    const QCommandLineOption unitOption("unit", "从站地址", "id", QString::number(config.unitId));
+    const QCommandLineOption iterationsOption("iterations", "每个接口的测量调用次数", "n", QString::number(config.iterations));
+    const QCommandLineOption warmupOption("warmup", "每个接口测量前丢弃的预热调用次数", "n", QString::number(config.warmup));
+    const QCommandLineOption depthOption("depth", "写接口同时在途的调用数", "n", QString::number(config.depth));
+    const QCommandLineOption moversOption("movers", "动子数量（批量读取和周期扫描）", "count", QString::number(config.moverCount));
+    const QCommandLineOption statusBaseOption("status-base", "动子状态块基址", "address", QString::number(config.statusBase));
+    const QCommandLineOption addressOption("address", "写测试使用的寄存器地址", "address", QString::number(config.writeAddress));
+    const QCommandLineOption scanPeriodOption("scan-period", "周期扫描间隔 (ms)", "ms", QString::number(config.scanPeriodMs));
+    const QCommandLineOption scanDurationOption("scan-duration", "周期扫描测量时长 (ms)", "ms", QString::number(config.scanDurationMs));
+    const QCommandLineOption scanSpeedOption("scan-speed", "周期扫描测量期间动子速度 (mm/s)", "speed", QString::number(config.scanSpeed));
+    const QCommandLineOption timeoutOption("timeout", "请求超时 (ms)", "ms", QString::number(config.timeoutMs));
+    const QCommandLineOption outputOption({"o", "output"}, "结果文件，缺省输出到标准输出", "file");
+    const QCommandLineOption verboseOption("verbose", "输出ModbusManager的调试日志");
+    parser.addOptions({hostOption, portOption, unitOption, iterationsOption, warmupOption, depthOption, moversOption,
+                       statusBaseOption, addressOption, scanPeriodOption, scanDurationOption, scanSpeedOption, timeoutOption, outputOption, verboseOption});
+    parser.process(app);
+
+    config.host = parser.value(hostOption);
+    config.port = parser.value(portOption).toInt();
+    config.unitId = parser.value(unitOption).toInt();
+    config.iterations = qMax(1, parser.value(iterationsOption).toInt());
+    config.warmup = qMax(0, parser.value(warmupOption).toInt());
+    config.depth = qMax(1, parser.value(depthOption).toInt());
+    config.statusBase = parser.value(statusBaseOption).toInt(nullptr, 0);
+    config.moverCount = qBound(1, parser.value(moversOption).toInt(), MoverSnapshotFrame::MAX_MOVERS);
+    config.writeAddress = parser.value(addressOption).toInt(nullptr, 0);
+    config.scanPeriodMs = parser.value(scanPeriodOption).toInt();
+    config.scanDurationMs = qMax(100, parser.value(scanDurationOption).toInt());
+    config.scanSpeed = parser.value(scanSpeedOption).toInt();
+    config.timeoutMs = qMax(100, parser.value(timeoutOption).toInt());
+    g_verbose = parser.isSet(verboseOption);
+    qInstallMessageHandler(messageHandler);
+
+    ModbusManager manager;
+    QString errorText;
+    if (!waitForConnection(manager, config, &errorText)) {
+        std::fprintf(stderr, "连接 %s:%d 失败: %s\n", qPrintable(config.host), config.port, qPrintable(errorText));
+        return 1;
+    }
+    if (!manager.setMoverStatusBase(config.statusBase) || config.moverCount > manager.moverCapacity()) {
+        std::fprintf(stderr, "动子状态块基址 %d 最多容纳 %d 个动子\n",
+                     config.statusBase, MoverStatusDecoder::capacityAt(config.statusBase));
+        return 1;
+    }
+
+    // readAllMoverData在上一次读取返回前不会重复排队，只能逐个调用
+    const std::function<bool(int)> writeDint = [&](int index) {
+        return manager.writeHoldingRegisterDINT(config.writeAddress, index);
+    };
+    const std::function<bool(int)> readMovers = [&](int) {
+        return manager.readAllMoverData(config.moverCount);
+    };
+
+    QJsonObject results;
+    measureAsync(manager, config, config.warmup, config.depth, writeDint);
+    results["writeHoldingRegisterDINT"] = measureAsync(manager, config, config.iterations, config.depth, writeDint);
+    measureAsync(manager, config, config.warmup, 1, readMovers);
+    results["readAllMoverData"] = measureAsync(manager, config, config.iterations, 1, readMovers);
+
+    QJsonObject configJson;
+    configJson["iterations"] = config.iterations;
+    configJson["warmup"] = config.warmup;
+    configJson["depth"] = config.depth;
+    configJson["moverCount"] = config.moverCount;
+    configJson["statusBase"] = config.statusBase;
+    configJson["writeAddress"] = config.writeAddress;
+    configJson["scanPeriodMs"] = config.scanPeriodMs;
+    configJson["scanDurationMs"] = config.scanDurationMs;
+    configJson["scanSpeed"] = config.scanSpeed;
+    configJson["timeoutMs"] = config.timeoutMs;
+
+    QJsonObject report;
+    report["benchmark"] = "ControlSystemUI/ModbusManager";
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["qtVersion"] = QString::fromLatin1(qVersion());
+    report["host"] = config.host;
+    report["port"] = config.port;
+    report["unitId"] = config.unitId;
+    report["config"] = configJson;
+    report["results"] = results;
+    report["scan"] = measureScan(manager, config);
+
+    manager.disconnectFromDevice();
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+            std::fprintf(stderr, "写入结果文件失败: %s\n", qPrintable(file.errorString()));
+            return 1;
+        }
+    } else {
+        std::fwrite(json.constData(), 1, json.size(), stdout);
+    }
+    return 0;
+}
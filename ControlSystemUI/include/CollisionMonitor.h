@@ -0,0 +1,101 @@
+#ifndef COLLISIONMONITOR_H
+#define COLLISIONMONITOR_H
+
+#include <QString>
+#include <QVector>
+#include <limits>
+#include "MoverData.h"
+#include "MoverRingIndex.h"
+#include "MotionProfile.h"
+
+/**
+ * @brief 相邻动子间距告警等级，按预计突破安全距离的剩余时间分级
+ */
+enum class CollisionLevel : quint8 {
+    None = 0,
+    Advisory,   // 提示：数秒内将突破安全距离
+    Warning,    // 警告
+    Critical    // 严重：即将或已经突破安全距离
+};
+
+/**
+ * @brief 一对相邻动子的间距告警（后方动子追向前方动子，方向为轨道正方向）
+ */
+struct CollisionAlert {
+    int behindId = -1;
+    int aheadId = -1;
+    double gap = 0.0;               // 当前中心距 (mm)
+    double closingSpeed = 0.0;      // 接近速度 (mm/s)，正值表示间距在缩小
+    double timeToViolation = std::numeric_limits<double>::infinity(); // 预计突破安全距离的剩余时间 (s)
+    CollisionLevel level = CollisionLevel::None;
+};
+
+/**
+ * @brief 预测式碰撞与间距监视器
+ *
+ * 每个状态刷新周期由主窗口调用一次 update()：
+ * 1. 只对本周期变化的动子增量更新环线顺序索引与加速度估计；
+ * 2. 对环线上每一对相邻动子按匀加速模型求解间距降到安全距离的时间，
+ *    与分级阈值比较得到告警等级。
+ * 64个动子每周期只有64对相邻关系、不分配内存，耗时在微秒级。
+ */
+class CollisionMonitor
+{
+public:
+    struct Thresholds {
+        double advisorySec = 3.0;
+        double warningSec = 1.5;
+        double criticalSec = 0.5;
+    };
+
+    CollisionMonitor(double trackLength, double safetyDistance);
+
+    void setSafetyDistance(double distance) { m_safetyDistance = distance; }
+    double safetyDistance() const { return m_safetyDistance; }
+    void setThresholds(const Thresholds &thresholds) { m_thresholds = thresholds; }
+    const Thresholds &thresholds() const { return m_thresholds; }
+
+    // --- 周期更新 ---
+    void reset(const MoverTelemetryTable &telemetry);
+    void updateIndex(const MoverTelemetryTable &telemetry, const QVector<int> &changedIds);
+    bool update(const MoverTelemetryTable &telemetry, const QVector<int> &changedIds);
+
+    // --- 结果 ---
+    const QVector<CollisionAlert> &alerts() const { return m_alerts; }
+    const QVector<CollisionAlert> &escalations() const { return m_escalations; }
+    CollisionLevel highestLevel() const;
+    const MoverRingIndex &ringIndex() const { return m_index; }
+
+    // 预览：按运动曲线推演动子移动过程，与前后邻居按当前速度外推的位置比较
+    CollisionAlert checkProfile(int moverId, const MotionProfile &profile,
+                                const MoverTelemetryTable &telemetry) const;
+    // 协同定位预览：同一触发同时启动的一组曲线（以动子编号为下标，无效曲线表示不参与）
+    CollisionAlert checkGroup(const QVector<MotionProfile> &profiles,
+                              const MoverTelemetryTable &telemetry) const;
+
+    static QString levelText(CollisionLevel level);
+
+private:
+    CollisionAlert evaluatePair(const MoverTelemetryTable &telemetry, int behindId, int aheadId) const;
+    CollisionLevel levelFor(double timeToViolation) const;
+
+    double extrapolate(const MoverTelemetryTable &telemetry, int id, double t) const;
+
+    static constexpr double ACCEL_SMOOTHING = 0.5;  // 加速度估计的指数平滑系数
+    static constexpr int PROFILE_SAMPLES = 64;      // 曲线预览检查的时间采样数
+
+    MoverRingIndex m_index;
+    double m_safetyDistance;
+    Thresholds m_thresholds;
+
+    QVector<double> m_acceleration;     // 下标为动子编号，速度差分后平滑 (mm/s²)
+    QVector<double> m_lastSpeed;
+    QVector<qint64> m_lastSampleMs;
+    QVector<CollisionLevel> m_pairLevel; // 以后方动子编号为下标的上一周期等级
+    QVector<int> m_pairAhead;           // 与m_pairLevel对应的前方动子，-1表示尚未评估
+
+    QVector<CollisionAlert> m_alerts;
+    QVector<CollisionAlert> m_escalations;
+};
+
+#endif // COLLISIONMONITOR_H
@@ -0,0 +1,61 @@
+#ifndef GROUPMOVEDIALOG_H
+#define GROUPMOVEDIALOG_H
+
+#include <QDialog>
+#include <QList>
+#include <QVector>
+#include <functional>
+#include "MoverData.h"
+#include "ModbusManager.h"
+
+class QTableWidget;
+class QLabel;
+class QPushButton;
+class QDoubleSpinBox;
+class QSpinBox;
+
+/**
+ * @brief 多动子协同定位对话框
+ *
+ * 勾选参与的动子并为每个动子填写目标位置与速度，
+ * 每次修改都调用校验函数（碰撞检查），校验通过才允许提交。
+ */
+class GroupMoveDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // 返回空字符串表示命令组可以执行，否则为拒绝原因
+    using Validator = std::function<QString(const QVector<ModbusManager::GroupMoveCommand> &)>;
+
+    GroupMoveDialog(const QList<MoverData> &movers, const QVector<int> &preselected,
+                    double trackLength, QWidget *parent = nullptr);
+
+    void setValidator(Validator validator);
+    QVector<ModbusManager::GroupMoveCommand> commands() const;
+
+public slots:
+    void accept() override;
+
+private slots:
+    void revalidate();
+    void onApplyOffset();
+
+private:
+    void setupUI(const QList<MoverData> &movers, const QVector<int> &preselected);
+    bool isRowChecked(int row) const;
+
+    QTableWidget *m_table;
+    QDoubleSpinBox *m_offsetSpin;
+    QSpinBox *m_commonSpeedSpin;
+    QLabel *m_statusLabel;
+    QPushButton *m_commitBtn;
+
+    double m_trackLength;
+    QVector<double> m_positions;                // 打开对话框时各行动子的位置
+    QVector<QDoubleSpinBox *> m_targetSpins;
+    QVector<QSpinBox *> m_speedSpins;
+    Validator m_validator;
+};
+
+#endif // GROUPMOVEDIALOG_H
@@ -9,6 +9,9 @@
 #include "MoverData.h"
 #include "LogWidget.h"
 #include "MainWindow.h"
+#include "MoverRingIndex.h"
+#include "MotionProfile.h"
+#include "ProgramEngine.h"
 
 class TrackWidget;
 class QScrollArea;
@@ -42,9 +45,15 @@ public:
 public slots:
     // 从主窗口接收动子数据的更新
     void updateMovers(const QList<MoverData> &movers);
+    // 主窗口发布的增量变化
+    void onMoversChanged(const QVector<int> &changedIds, quint64 generation);
+    // 主窗口发布的相邻动子间距告警
+    void onCollisionAlertsChanged(const QVector<CollisionAlert> &alerts);
     // 响应主窗口的急停信号
     void onEmergencyStopTriggered();
     void onEmergencyStopReset();
+    // 轨迹回放期间停止自动运行并禁用控制命令
+    void onReplayModeChanged(bool active);
     // 更新动子选择下拉框
     void updateMoverSelector();
 
@@ -55,22 +64,21 @@ private slots:
     void onStopMover();
     void onEnableStateChanged(bool enabled);
 
-    // --- 实时数据更新 ---
-    void onRealTimeDataUpdate();
-
     // --- JOG控制 (长按与短按) ---
     void onJogForwardPressed();
     void onJogForwardReleased();
     void onJogBackwardPressed();
     void onJogBackwardReleased();
-    void performContinuousJog();
+    void onJogSessionAborted(const QString &reason);
 
     // --- 自动运行控制 ---
     void onAutoRunModeToggled(bool enabled);
     void onAutoRunStart();
     void onAutoRunStop();
     void onAutoRunPause();
-    void performAutoRunStep();
+    void onProgramFinished(int moverId);
+    void onProgramAborted(int moverId, const QString &reason);
+    void onModbusDisconnected();
 
 private:
     // --- 内部辅助函数 ---
@@ -78,9 +86,14 @@ private:
     void updateMoverInfo();
     void setControlsEnabled(bool enabled);
     void addLogEntry(const QString &message, const QString &type = "info");
-    bool checkCollision(int moverId, double targetPosition);
+    bool checkCollision(int moverId, const QVector<MotionProfile> &legs);
     double normalizePosition(double position);
     double calculateShortestDistance(double pos1, double pos2);
+    void rebuildRingIndex();
+    void updateMotionPreview();
+    MotionProfile planGoToProfile(int moverId, double targetPosition) const;
+    MotionProfile planMoveProfile(int moverId, double start, double targetPosition) const;
+    QVector<double> plannedTargets() const;
 
     // JOG控制逻辑
     void startLongPressDetection(bool isForward);
@@ -96,6 +109,7 @@ private:
     void setupAutoRunUI();
     void sendAutoRunCommandToPLC();
     void connectAutoRunSignals();
+    MotionProgram buildShuttleProgram(int moverId, double targetPosition, quint16 speed) const;
 
     // --- UI组件 ---
     QComboBox *m_moverSelector;
@@ -110,6 +124,8 @@ private:
     QPushButton *m_disableBtn;
     QDoubleSpinBox *m_targetPosSpinBox;
     QSpinBox *m_speedSpinBox;
+    QComboBox *m_profileShapeCombo;
+    QLabel *m_profilePreviewLabel;
     QPushButton *m_goToBtn;
     QPushButton *m_stopBtn;
     QSpinBox *m_jogStepSpinBox;
@@ -132,30 +148,30 @@ private:
     QString m_currentUser;      // 当前操作员用户名
     ModbusManager *m_modbusManager; // Modbus通信管理器实例
     MainWindow *m_mainWindow;       // 主窗口指针
+    MoverRingIndex m_ringIndex;     // 动子沿环线的位置顺序索引，用于碰撞检测
 
     // --- 状态与定时器 ---
-    QTimer *m_realTimeUpdateTimer;
     bool m_isRealTimeEnabled;
     bool m_emergencyActive;
 
     // JOG长按相关
     QTimer *m_longPressTimer;
-    QTimer *m_continuousJogTimer;
     bool m_isLongPressing;
     bool m_isContinuousJogging;
     bool m_jogDirection; // true=前进, false=后退
 
     // 自动运行相关
-    QTimer *m_autoRunTimer;
+    ProgramEngine *m_programEngine;     // 按状态反馈推进的自动运行程序，可同时驱动多个动子
     bool m_isAutoRunActive;
     bool m_isAutoRunPaused;
+    bool m_replayActive;                // 主窗口处于轨迹回放，动子数据不是实时状态
 
     // --- 静态常量 ---
     static const int LONG_PRESS_THRESHOLD = 500;  // 长按阈值 (ms)
-    static const int CONTINUOUS_JOG_INTERVAL = 100; // 连续JOG间隔 (ms)
-    static const int AUTO_RUN_INTERVAL = 1000;      // 自动运行更新间隔(ms)
+    static const int AUTO_RUN_DWELL_MS = 500;       // 自动运行往返两端的停留时间(ms)
     static const double TRACK_LENGTH;
     static const double SAFETY_DISTANCE;
+    static const double PREVIEW_JERK;   // S形曲线预览使用的加加速度 (mm/s³)
 };
 
 #endif // JOGCONTROLPAGE_H
@@ -0,0 +1,84 @@
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QStyledItemDelegate>
+#include <QVector>
+#include <QColor>
+
+/**
+ * @brief 固定容量的环形日志模型
+ *
+ * 日志条目存放在预分配的环形数组中：追加和淘汰最旧条目都是O(1)，
+ * 不移动其他条目，视图只收到单行的插入/删除通知。
+ */
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        TimestampRole = Qt::UserRole + 1,
+        UserNameRole,
+        LevelTextRole,
+        LevelColorRole,
+        MessageRole
+    };
+
+    // 单条日志，未显示的字段留空
+    struct LogRecord {
+        QString timestamp;
+        QString user;
+        QString levelText;
+        QColor levelColor;
+        QString message;
+    };
+
+    explicit LogModel(int capacity = 1000, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief 追加一条日志，容量已满时先淘汰最旧的一条
+     * @return 是否发生了淘汰
+     */
+    bool append(const LogRecord &record);
+
+    /**
+     * @brief 修改容量，超出部分从最旧的条目开始丢弃
+     * @return 丢弃的条目数
+     */
+    int setCapacity(int capacity);
+    int capacity() const { return static_cast<int>(m_records.size()); }
+
+    void clear();
+
+    // 第row行的纯文本形式，用于导出
+    QString plainText(int row) const;
+
+private:
+    int physicalIndex(int row) const { return (m_head + row) % capacity(); }
+
+    QVector<LogRecord> m_records;   // 环形存储，大小即容量
+    int m_head = 0;                 // 最旧条目所在位置
+    int m_count = 0;                // 有效条目数
+};
+
+/**
+ * @brief 日志行绘制代理
+ *
+ * 按时间、用户、级别、内容分段着色，单行绘制，配合QListView的统一行高实现虚拟化显示。
+ */
+class LogItemDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
+
+#endif // LOGMODEL_H
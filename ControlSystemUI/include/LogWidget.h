@@ -2,7 +2,7 @@
 #define LOGWIDGET_H
 
 #include <QWidget>
-#include <QTextEdit>
+#include <QListView>
 #include <QPushButton>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -12,6 +12,7 @@
 #include <QTextStream>
 #include <QMessageBox>
 #include <QTimer>
+#include "LogModel.h"
 
 class LogWidget : public QWidget
 {
@@ -60,15 +61,14 @@ public slots:
 private:
     void setupUI();
     void setupStyles();
-    QString formatLogEntry(const QString &message, LogLevel level, const QString &user);
-    QString getLevelColor(LogLevel level);
-    QString getLevelString(LogLevel level);
+    LogModel::LogRecord makeRecord(const QString &message, LogLevel level, const QString &user) const;
+    QString getLevelColor(LogLevel level) const;
+    QString getLevelString(LogLevel level) const;
     LogLevel stringToLevel(const QString &type);
-    void trimLogIfNeeded();
 
     // UI组件
     QGroupBox *m_groupBox;
-    QTextEdit *m_logDisplay;
+    QListView *m_logView;
     QPushButton *m_clearBtn;
     QPushButton *m_exportBtn;
     QVBoxLayout *m_mainLayout;
@@ -79,11 +79,10 @@ private:
     bool m_autoScroll;
     bool m_showTimestamp;
     bool m_showUser;
-    int m_currentLineCount;
     QString m_title;
 
-    // 缓存
-    QStringList m_logEntries;
+    // 日志数据：固定容量环形模型
+    LogModel *m_model;
 };
 
 #endif // LOGWIDGET_H
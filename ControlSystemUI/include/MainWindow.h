@@ -4,12 +4,15 @@
 #include <QMainWindow>
 #include <QList>
 #include <QMutex>
+#include <QBitArray>
 #include "MoverData.h"
+#include "CollisionMonitor.h"
 #include "LogWidget.h"
 #include "ModbusConfigDialog.h"
 
 struct ModbusConfig;
 class ModbusManager;
+struct MoverSnapshot;
 class QTabWidget;
 class QPushButton;
 class QLabel;
@@ -18,6 +21,10 @@ class QStatusBar;
 class OverviewPage;
 class JogControlPage;
 class RecipeManagerPage;
+class ReplayController;
+class ReplayControlBar;
+class QToolBar;
+struct MoverSnapshotFrame;
 
 class MainWindow : public QMainWindow
 {
@@ -30,6 +37,8 @@ public:
     // 公共方法供其他页面访问
     ModbusManager* getModbusManager() const { return m_modbusManager; }
     bool isSimulationMode() const;
+    // 回放模式下界面显示历史轨迹，实时快照被丢弃
+    bool isReplayMode() const;
     void onMoverCountChanged(int count);
 
     // 提供全局日志接口
@@ -39,13 +48,29 @@ public:
     void addLogEntry(const QString &message, const QString &type = "info");
     void onModbusError(const QString &error);
 
+    // 动子数据变更标记：页面修改共享动子数据后调用，下一个刷新周期只通知变化的动子
+    void markMoverDirty(int id);
+    void markAllMoversDirty();
+    quint64 moversGeneration() const { return m_moversGeneration; }
+    // PLC遥测的结构数组视图，供碰撞检查等批量计算使用
+    const MoverTelemetryTable& moverTelemetry() const { return m_telemetry; }
+    const QVector<CollisionAlert>& collisionAlerts() const { return m_collisionMonitor.alerts(); }
+    const CollisionMonitor& collisionMonitor() const { return m_collisionMonitor; }
+
 signals:
+    // 动子列表结构变化（数量、重新初始化）时发出，订阅者需要整体重建
     void moversUpdated(const QList<MoverData>& movers);
+    // 刷新周期内有动子数据变化时发出，只携带变化的动子编号
+    void moversChanged(const QVector<int>& changedIds, quint64 generation);
+    // 相邻动子间距告警的动子对或等级变化时发出，携带当前全部告警
+    void collisionAlertsChanged(const QVector<CollisionAlert>& alerts);
     void userChanged(const QString& username);
     void currentRecipeChanged(int id, const QString &name);
     void emergencyStopTriggered();
     void emergencyStopReset();
     void moverCountChanged(int count);   // 动子数量变化信号
+    // 进入/退出轨迹回放；回放期间动子数据来自历史记录，控制页面须停止自动运行并禁用命令
+    void replayModeChanged(bool active);
 
 private slots:
     void updateSystemStatus();
@@ -58,6 +83,9 @@ private slots:
     void onUserLoginSuccess(const QString& username);
     void onRecipeApplied(int id, const QString &name);
     void openSystemLog();
+    void openReplay();
+    void exitReplay();
+    void onReplayFrame(const MoverSnapshotFrame &frame);
 
     // Modbus相关槽函数
     void onModbusConnected();
@@ -66,6 +94,7 @@ private slots:
     void onModbusConnectButtonClicked();
 
     void onModbusDataReceived(int startAddress, const QVector<quint16> &data);
+    void onMoverSnapshotReady();
     void onModbusCoilsReceived(int startAddress, const QVector<bool> &data);
     void onSystemStatusChanged(bool initialized, bool enabled);
 
@@ -80,6 +109,10 @@ private:
     void onEmergencyStopFromPLC();
 
     void processMoversStatusData(int startAddress, const QVector<quint16> &data);
+    void applySnapshotFrame(const MoverSnapshotFrame &frame);
+    bool applyMoverSnapshot(int id, const MoverSnapshot &snapshot);
+    void publishMoverChanges();
+    void updateCollisionMonitor(const QVector<int> &changedIds);
     void updateMoverStatus(MoverData &mover, quint16 statusWord);
     void updateMoverError(MoverData &mover, quint16 errorCode);
     void processSystemStatusData(int startAddress, const QVector<quint16> &data);
@@ -112,6 +145,8 @@ private:
     //动子数量
     int getMoverCount() const;
     void setMoverCount(int count);
+    int getMoverStatusBase() const;
+    int getMoverCapacity() const;
 
     //急停相关
     bool m_isEmergencyStopPressed;
@@ -126,8 +161,12 @@ private:
     RecipeManagerPage *m_recipePage;
 
     // 数据
-    QList<MoverData> m_movers;
+    QList<MoverData> m_movers;       // 界面使用的完整动子数据（含字符串等冷数据）
+    MoverTelemetryTable m_telemetry; // PLC遥测热数据，下标即动子编号
+    CollisionMonitor m_collisionMonitor{m_moverConfig.trackLength, m_moverConfig.safetyDistance};
     QTimer *m_updateTimer;
+    QBitArray m_dirtyMovers;         // 自上次发布以来变化的动子
+    quint64 m_moversGeneration = 0;  // 每发布一次变化递增
 
     // 用户相关
     bool m_isLoggedIn;
@@ -142,6 +181,11 @@ private:
     QPushButton *m_loginLogoutButton;
     QPushButton *m_emergencyButton;
 
+    // 轨迹回放
+    ReplayController *m_replayController = nullptr;
+    ReplayControlBar *m_replayBar = nullptr;
+    QToolBar *m_replayToolBar = nullptr;
+
     // Modbus相关成员
     ModbusManager *m_modbusManager;
     bool m_modbusConnected;
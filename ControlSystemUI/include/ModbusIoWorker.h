@@ -0,0 +1,169 @@
+#ifndef MODBUSIOWORKER_H
+#define MODBUSIOWORKER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QQueue>
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QModbusClient>
+#include <QModbusDevice>
+#include <QModbusDataUnit>
+#include <QModbusReply>
+#include <QModbusPdu>
+#include <atomic>
+#include <functional>
+#include "SpscQueue.h"
+#include "MoverSnapshotBuffer.h"
+#include "TelemetryRecorder.h"
+
+// GUI线程投递给I/O线程的命令
+struct ModbusCommand
+{
+    enum Type {
+        ConnectTcp,
+        ConnectSerial,
+        Disconnect,
+        Read,
+        Write,
+        MaskWrite,              // 0x16掩码写，不支持时在I/O线程内退回读-改-写
+        SetMaxInFlight,
+        ConfigureScanGroup,
+        StartScan,
+        StopScan,
+        StartRecording,
+        StopRecording
+    };
+
+    Type type = Read;
+    quint64 id = 0;             // 请求编号，完成时原样返回
+    QModbusDataUnit unit;       // Read/Write使用
+    bool urgent = false;        // Read/Write使用：插入发送队列队首（如点动停止）
+    quint16 andMask = 0xFFFF;   // MaskWrite使用
+    quint16 orMask = 0;
+
+    // 连接参数
+    QString address;            // TCP主机地址或串口名
+    int port = 502;             // TCP端口或串口波特率
+    int deviceId = 1;
+
+    // 扫描组参数（也用于SetMaxInFlight的count）
+    int groupId = -1;
+    int startAddress = 0;
+    int count = 0;
+    int periodMs = 0;
+    bool enabled = true;
+
+    // 轨迹记录参数（StartRecording使用）
+    TelemetryRecorder::Options recorderOptions;
+};
+
+/**
+ * @brief Modbus I/O工作对象
+ *
+ * 运行在独立线程中，持有Modbus客户端、请求队列和周期扫描组。
+ * 命令通过SPSC无锁队列进入，请求结果通过队列连接的信号返回，
+ * 动子状态块解码后写入MoverSnapshotBuffer供GUI线程读取。
+ */
+class ModbusIoWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ModbusIoWorker(MoverSnapshotBuffer *snapshots, QObject *parent = nullptr);
+    ~ModbusIoWorker();
+
+    // 由GUI线程（唯一生产者）调用，队列满时返回false
+    bool submit(ModbusCommand &&command);
+
+signals:
+    void stateChanged(int state);
+    void deviceError(int error, const QString &errorText);
+    void requestFinished(quint64 id, bool success, int startAddress,
+                         const QVector<quint16> &values, const QString &errorText);
+    void scanDataChanged(int startAddress, const QVector<quint16> &values);
+    void moverSnapshotReady();
+    void recordingStateChanged(bool recording, const QString &filePath, const QString &errorText);
+
+private slots:
+    void processCommands();
+    void onReplyFinished();
+    void onScanTimer();
+    void onClientStateChanged(QModbusDevice::State state);
+    void onClientError(QModbusDevice::Error error);
+
+private:
+    using ReplyHandler = std::function<void(bool success, const QModbusDataUnit &result, const QString &errorText)>;
+
+    // I/O线程内部排队的请求
+    struct PendingRequest {
+        enum Type { Read, Write, Raw };
+        Type type = Read;
+        QModbusDataUnit unit;
+        QModbusRequest rawRequest;
+        bool exclusive = false;     // 独占请求：等待在途请求清空后单独发出
+        ReplyHandler handler;
+    };
+
+    // 周期扫描组：每组一次多寄存器读取，数据变化时才通知
+    struct ScanGroup {
+        int startAddress = 0;
+        int count = 0;
+        int periodMs = 200;
+        bool enabled = true;
+        bool inFlight = false;          // 上一次读取尚未返回时跳过本周期
+        qint64 nextDueMs = 0;           // 下次到期时间（单调时钟）
+        QVector<quint16> lastValues;    // 上次读取结果，用于变化检测
+    };
+
+    void executeCommand(const ModbusCommand &command);
+    void openClient(const ModbusCommand &command);
+    void closeClient();
+
+    // 请求队列调度
+    void enqueueRequest(const PendingRequest &request, bool urgent = false);
+    void dispatchPendingRequests();
+    void failPendingRequests(const QString &reason);
+    void finishCommand(quint64 id, bool success, const QModbusDataUnit &result, const QString &errorText);
+    void startMaskWrite(quint64 id, int address, quint16 andMask, quint16 orMask);
+    void startReadModifyWrite(quint64 id, int address, quint16 andMask, quint16 orMask);
+
+    // 周期扫描
+    void configureScanGroup(const ModbusCommand &command);
+    void startScan();
+    void stopScan();
+    void scheduleNextScan();
+    void pollScanGroup(int groupId);
+    void publishMoverSnapshot(const QVector<quint16> &values);
+
+    // 轨迹记录
+    void startRecording(const TelemetryRecorder::Options &options);
+    void stopRecording();
+
+    SpscQueue<ModbusCommand> m_commandQueue;
+    std::atomic<bool> m_wakePending;
+    MoverSnapshotBuffer *m_snapshots;
+
+    QModbusClient *m_modbusClient;
+    int m_deviceId;
+    bool m_isConnected;
+
+    QQueue<PendingRequest> m_requestQueue;                  // 等待发送的请求
+    QHash<QModbusReply *, PendingRequest> m_inFlightRequests; // 已发送、等待应答的请求
+    int m_maxInFlight;
+    bool m_exclusiveInFlight;
+    bool m_isDispatching;
+    bool m_maskWriteUnsupported;                            // PLC对0x16返回非法功能码后退回读-改-写
+    QModbusPdu::ExceptionCode m_lastExceptionCode;          // 正在回调的应答携带的异常码，仅在handler内有效
+
+    QVector<ScanGroup> m_scanGroups;
+    QTimer *m_scanTimer;
+    QElapsedTimer m_scanClock;
+    bool m_scanActive;
+    quint64 m_snapshotSequence;
+
+    TelemetryRecorder m_recorder;                           // 每帧快照写入轨迹文件
+};
+
+#endif // MODBUSIOWORKER_H
@@ -7,14 +7,22 @@
 #include <QModbusDevice>
 #include <QModbusDataUnit>
 #include <QModbusReply>
+#include <QModbusPdu>
 #include <QModbusTcpClient>
 #include <QModbusTcpServer>
 #include <QTcpSocket>
 #include <QSerialPort>
-#include <QMutex>
+#include <QHash>
+#include <QQueue>
+#include <functional>
 #include "MoverData.h"
+#include "MoverSnapshotBuffer.h"
+#include "TelemetryRecorder.h"
 
 class MainWindow;
+class ModbusIoWorker;
+class QThread;
+struct ModbusCommand;
 namespace ModbusRegisters {
 
     // --- 单动子控制寄存器 (基于 mainwindow.cpp 分析) ---
@@ -35,15 +43,35 @@ namespace ModbusRegisters {
         const int AUTO_RUN_BIT = 5;              // bit5: 自动运行 (1=运行, 0=停止)
     }
 
+    // --- 点动会话保活 ---
+    // 会话期间上位机周期写入变化的保活计数，PLC超过TIMEOUT_MS未见变化即停止点动；
+    // 写入0表示会话结束，PLC立即停止点动，不依赖控制字的读-改-写。
+    // PLC侧要求：两个寄存器可读写并实现上述超时停止。连接时回读探测，
+    // 读取或会话开始写入失败时本次连接退回普通点动（只置位/清除控制字点动位，没有超时保护）
+    namespace JogSession {
+        const int KEEPALIVE = 0x0006;            // 保活计数，非零递增
+        const int TIMEOUT_MS = 0x0007;           // 保活超时 (ms)，0表示不检查
+    }
+
     // 动子状态（用于配方和主窗口）
+    // 默认基址100只容纳10个动子（之后是系统状态块）；更多动子需要PLC把状态块放到空闲区，
+    // 并通过ModbusManager::setMoverStatusBase配置基址，容量由MoverStatusDecoder::capacityAt计算
     namespace MoverStatus {
-        const int BASE_ADDRESS = 100;
+        const int BASE_ADDRESS = 100;            // 默认基址
         const int REGISTERS_PER_MOVER = 10;
         const int POSITION_LOW = 0;              // Position low word offset
         const int VELOCITY_LOW = 2;              // Velocity low word offset
+        const int STATUS_WORD = 4;               // 状态字
+        const int ERROR_CODE = 5;                // 错误码
         const int TARGET_LOW = 8;
         }
 
+    // 协议帧长度限制
+    namespace Limits {
+        const int MAX_READ_REGISTERS = 125;      // FC03单帧最多读取的寄存器数
+        const int MAX_WRITE_REGISTERS = 123;     // FC16单帧最多写入的寄存器数
+        }
+
     // 系统状态
     namespace SystemStatus {
         const int SYSTEM_READY = 200;
@@ -57,6 +85,22 @@ namespace ModbusRegisters {
         const int ENABLE_BASE_ADDRESS = 0x0100;  // 动子使能状态基地址 (保持寄存器)
         const int SPEED_BASE_ADDRESS = 0x0200;   // 动子速度设置基地址 (保持寄存器)
     }
+
+    // --- 多动子协同定位命令块 ---
+    // 上位机先写条目再写序号，PLC在序号变化的扫描周期内同时启动全部条目，
+    // 执行后把该序号写入ACK_SEQUENCE；上位机确认后才提交下一组
+    namespace GroupMove {
+        const int BASE_ADDRESS = 0x0400;
+        const int SEQUENCE = 0;                  // 触发序号，非零且与上次不同时执行
+        const int COUNT = 1;                     // 条目数
+        const int ENTRIES = 2;                   // 第一个条目的偏移
+        const int REGISTERS_PER_ENTRY = 4;
+        const int ENTRY_MOVER_ID = 0;
+        const int ENTRY_TARGET_LOW = 1;          // 目标位置 (um, DINT)，与状态块的位置编码一致
+        const int ENTRY_SPEED = 3;               // 速度 (mm/s)
+        const int MAX_ENTRIES = 128;
+        const int ACK_SEQUENCE = ENTRIES + MAX_ENTRIES * REGISTERS_PER_ENTRY;  // PLC已执行的序号（上位机只读）
+    }
 }
 
 class ModbusManager : public QObject
@@ -64,6 +108,9 @@ class ModbusManager : public QObject
     Q_OBJECT
 
 public:
+    // 异步请求完成回调：success为请求是否成功，result为读请求返回的数据单元
+    using ReplyHandler = std::function<void(bool success, const QModbusDataUnit &result)>;
+
     explicit ModbusManager(QObject *parent = nullptr);
     ~ModbusManager();
 
@@ -83,23 +130,69 @@ public:
     bool setSingleAxisJogPosition(qint16 position);
     bool setSingleAxisJogSpeed(qint32 speed);
 
+    // 点动会话：一次命令启动，保活维持，松开、保活失败或断线时停止
+    bool startJogSession(int direction); // 1: 左, 2: 右
+    void stopJogSession();
+    bool isJogSessionActive() const { return m_jogSessionActive; }
+    bool isJogKeepAliveSupported() const { return m_jogKeepAliveSupported; }
+
     // --- 多动子控制高级接口 ---
     bool setMultiAxisEnable(int moverId, bool enable);
     bool setMultiAxisSpeed(int moverId, quint16 speed);
 
+    // 多动子协同定位：所有条目由一个触发序号同时启动
+    struct GroupMoveCommand {
+        int moverId = -1;
+        double targetPosition = 0.0;    // 目标位置 (mm)
+        quint16 speed = 0;              // 速度 (mm/s)
+    };
+    bool commitGroupMove(const QVector<GroupMoveCommand> &commands);
+    void cancelGroupMoveEntries(int moverId);
+    quint16 lastGroupMoveSequence() const { return m_groupMoveSequence; }   // 最近一次提交的触发序号，与groupMoveFinished配合使用
+    bool isGroupMoveReady() const { return m_groupMoveSequenceValid; }      // 已从PLC同步触发序号，且PLC未表现出不支持协同定位
+
     // 获取连接模式
     QString getConnectionInfo() const;
     int getSuccessfulOperations() const { return m_successfulOperations; }
     int getFailedOperations() const { return m_failedOperations; }
 
-    // 批量数据读取（更高效）
-    bool readAllMoverData(QList<MoverData> &movers);
+    // 批量数据读取（更高效），结果通过dataReceived信号返回
+    bool readAllMoverData(int moverCount);
     bool writeHoldingRegisterDINT(int address, qint32 value);
 
+    // --- 异步请求接口 ---
+    bool readRegistersAsync(int startAddress, int count, ReplyHandler handler);
+    bool writeRegistersAsync(int startAddress, const QVector<quint16> &values, ReplyHandler handler = nullptr);
+    int pendingRequestCount() const { return m_pendingRequests.size(); }
+    quint64 lastRequestId() const { return m_nextRequestId; }    // 最近一次投递的请求编号，与requestCompleted配合使用
+    void setMaxInFlight(int count);
+
     // 循环读取
     void startCyclicRead(int intervalMs = 200);
     void stopCyclicRead();
 
+    // --- 扫描组配置 ---
+    enum ScanGroupId {
+        MoverScanGroup = 0,       // 动子状态块（解码后写入快照缓冲区）
+        SystemScanGroup,          // 系统状态块
+        ControlWordScanGroup      // 控制字（刷新影子缓存）
+    };
+    int addScanGroup(const QString &name, int startAddress, int count, int periodMs);
+    void setScanGroupPeriod(int groupId, int periodMs);
+    void setScanGroupEnabled(int groupId, bool enabled);
+    void setScanMoverCount(int moverCount);
+    bool setMoverStatusBase(int baseAddress);
+    int moverStatusBase() const { return m_moverStatusBase; }
+    int moverCapacity() const;                              // 当前状态块基址下不与其他寄存器区重叠的最大动子数
+
+    // 最新的动子状态快照（仅限GUI线程调用，返回的引用在下次调用前有效）
+    const MoverSnapshotFrame &acquireMoverSnapshot() { return m_moverSnapshots.acquireLatest(); }
+
+    // --- 动子轨迹记录（在I/O线程中逐帧写入，结果通过telemetryRecordingChanged返回） ---
+    bool startTelemetryRecording(const TelemetryRecorder::Options &options);
+    void stopTelemetryRecording();
+    bool isTelemetryRecording() const { return m_telemetryRecording; }
+
     // 日志记录接口
     void setMainWindow(MainWindow *mainWindow) { m_mainWindow = mainWindow; }
 
@@ -109,40 +202,147 @@ signals:
     void connectionError(const QString &error);
     void dataReceived(int startAddress, const QVector<quint16> &data);
     void systemStatusChanged(bool initialized, bool enabled);
+    void moverSnapshotReady();
+    // 每个投递到I/O线程的请求结束时发出（含断开连接时取消的请求），供基准测试和诊断统计往返时间
+    void requestCompleted(quint64 id, bool success);
+    void telemetryRecordingChanged(bool recording, const QString &filePath, const QString &errorText);
+    // PLC确认执行该序号后发出success=true；写入失败、未在超时内确认或连接断开时为false
+    void groupMoveFinished(quint16 sequence, bool success);
+    // 点动会话因保活写入失败或连接断开而中止（正常松开停止不发出）
+    void jogSessionAborted(const QString &reason);
 
 private slots:
-    // Modbus内部响应处理
-    void onModbusError(QModbusDevice::Error error);
+    // I/O线程回送的事件
+    void onWorkerStateChanged(int state);
+    void onWorkerDeviceError(int error, const QString &errorText);
+    void onWorkerRequestFinished(quint64 id, bool success, int startAddress,
+                                 const QVector<quint16> &values, const QString &errorText);
+    void onScanDataChanged(int startAddress, const QVector<quint16> &values);
+    void onWorkerRecordingStateChanged(bool recording, const QString &filePath, const QString &errorText);
+    void flushControlWord();
+    void sendJogKeepAlive();
+
 private:
-    void setupModbusClient();
+    // 已投递到I/O线程、等待结果的请求
+    struct PendingRequest {
+        bool isRead = false;
+        QString operation;          // 日志中的操作名称
+        QString details;            // 成功时附加的日志信息
+        bool logSuccess = true;     // 成功时是否记录日志（周期读取等高频请求关闭）
+        ReplyHandler handler;
+    };
+
+    // 扫描组配置（实际扫描在I/O线程中进行）
+    struct ScanGroup {
+        QString name;
+        int startAddress = 0;
+        int count = 0;
+        int periodMs = 200;
+        bool enabled = true;
+    };
+
     void cleanup();
     QString errorString(QModbusDevice::Error error) const;
     void logOperation(const QString &operation, bool success, const QString &details = QString());
 
+    // 与I/O线程交互
+    bool isClientReady() const;
+    bool submitCommand(ModbusCommand &command);
+    bool submitRequest(ModbusCommand &command, const PendingRequest &request);
+    void failPendingRequests(const QString &reason);
+    void initializeScanGroups();
+    void submitScanGroup(int groupId);
+
     // 基础读写方法
     bool writeHoldingRegister(int address, quint16 value);
-    bool readHoldingRegisters(int startAddress, int count);
-    QVector<quint16> readRegistersSync(int address, int count);
+    bool readHoldingRegisters(int startAddress, int count, ReplyHandler handler = nullptr);
 
     // 核心位操作函数
     bool setControlWordBit(int bit, bool value);
-    quint16 readControlWordSync();
+    bool setControlWordBits(quint16 setMask, quint16 clearMask);
+
+    // 控制字影子缓存
+    void refreshControlWordShadow();
+    void updateControlWordShadow(int startAddress, const QVector<quint16> &values);
+    void invalidateControlWordShadow();
+
+    // 点动会话
+    void abortJogSession(const QString &reason);
+    void probeJogKeepAlive();
 
-    QModbusClient *m_modbusClient;
-    QTimer *m_cyclicTimer;
-    QMutex m_mutex;
+    // 协同定位：同一时刻只有一组在PLC处理，确认后再写下一组，避免覆盖未执行的条目
+    struct GroupMoveJob {
+        quint16 sequence = 0;
+        QVector<quint16> block;             // [序号, 条目数, 条目...]
+        bool headSent = false;              // 触发帧已提交，之后条目不能再修改
+        bool rewrite = false;               // 分块写入期间有条目被取消，写完后按新内容重写而不触发
+    };
+    void syncGroupMoveSequence();
+    void startNextGroupMove();
+    void writeGroupMoveBlock();
+    bool sendGroupMoveHead(int headLength);
+    void waitGroupMoveAck(quint16 sequence, qint64 deadlineMs);
+    void finishGroupMove(quint16 sequence, bool success, const QString &reason = QString());
+
+    // I/O线程
+    QThread *m_ioThread;
+    ModbusIoWorker *m_worker;
+    MoverSnapshotBuffer m_moverSnapshots;   // I/O线程写入、GUI线程读取的动子快照
     MainWindow *m_mainWindow;
 
     // 连接参数
     QString m_host;
     int m_port;
     int m_deviceId;
+    bool m_isSerial;
     bool m_isConnected;
+    bool m_connectRequested;
 
     // 统计信息
     int m_successfulOperations;
     int m_failedOperations;
 
+    // 异步请求
+    QHash<quint64, PendingRequest> m_pendingRequests;       // 等待I/O线程回送结果的请求
+    quint64 m_nextRequestId;
+    bool m_moverReadPending;                                // 动子批量读取是否在途
+
+    // 控制字影子缓存：同一事件循环周期内的位修改合并为一次写入
+    quint16 m_controlWordShadow;                            // 本地镜像的控制字
+    bool m_controlWordValid;                                // 镜像是否与PLC同步
+    quint16 m_pendingSetMask;                               // 待置1的位
+    quint16 m_pendingClearMask;                             // 待清0的位
+    bool m_controlWordFlushScheduled;                       // 是否已安排合并写入
+    int m_controlWordWritesInFlight;                        // 在途的控制字写请求数
+
+    // 周期扫描
+    QVector<ScanGroup> m_scanGroups;
+    int m_scanMoverCount;
+    int m_moverStatusBase;                                  // 动子状态块基址
+    bool m_cyclicReadActive;
+
+    bool m_telemetryRecording;                              // I/O线程最近报告的记录状态
+    quint16 m_groupMoveSequence;                            // 上一次协同定位使用的触发序号
+    bool m_groupMoveSequenceValid;                          // 触发序号已与PLC同步；PLC未确认执行时本次连接不再使用
+    bool m_groupMoveInFlight;                               // 有一组正在写入或等待PLC确认
+    QQueue<GroupMoveJob> m_groupMoveQueue;                  // 等待前一组确认的协同定位
+    GroupMoveJob m_groupMoveCurrent;                        // 正在写入或等待确认的一组
+
+    // 点动会话
+    QTimer *m_jogKeepAliveTimer;
+    bool m_jogSessionActive;
+    int m_jogDirection;
+    quint16 m_jogKeepAliveCounter;                          // 上一次写入的保活计数
+    bool m_jogKeepAliveInFlight;                            // 上一次保活未应答时跳过本周期，请求不会堆积
+    bool m_jogStartPending;                                 // 会话开始的保活/超时写入尚未应答
+    bool m_jogKeepAliveSupported;                           // PLC提供保活寄存器；否则点动不带保活
+
+    static const int TCP_MAX_IN_FLIGHT = 4;                 // TCP按事务ID流水线发送
+    static const int SERIAL_MAX_IN_FLIGHT = 1;              // RTU总线同一时刻只能有一个事务
+    static const int JOG_KEEPALIVE_INTERVAL = 100;          // 保活周期 (ms)
+    static const int JOG_SESSION_TIMEOUT = 350;             // PLC侧保活超时 (ms)，容忍约两次保活丢失
+    static const int GROUP_MOVE_ACK_POLL = 10;              // 等待协同定位确认的回读间隔 (ms)
+    static const int GROUP_MOVE_ACK_TIMEOUT = 1000;         // 协同定位确认超时 (ms)
 };
 
 #endif // MODBUSMANAGER_H
@@ -0,0 +1,85 @@
+#ifndef MOTIONPROFILE_H
+#define MOTIONPROFILE_H
+
+#include <QVector>
+#include "MoverData.h"
+
+/**
+ * @brief 绝对定位运动曲线（静止到静止）
+ *
+ * 梯形曲线：加速度阶跃，匀加速-匀速-匀减速；
+ * S形曲线：给定加加速度（jerk）时加速度线性变化，最多七段。
+ * 行程过短达不到目标速度时自动降低峰值速度（以及S形曲线的峰值加速度）。
+ * 曲线由若干段恒定加加速度的分段表示，规划为解析计算，
+ * 查询任一时刻的位置/速度只需遍历至多七段，适合随输入逐次重算。
+ *
+ * 位置沿运动方向单调变化，方向按 MoverData::MovementDirection 规定：
+ * 逆时针为前进（位置增大），AUTO 取最短路径。
+ */
+class MotionProfile
+{
+public:
+    enum Shape {
+        Trapezoidal,
+        SCurve
+    };
+
+    struct Limits {
+        double maxSpeed = 100.0;        // 目标速度 (mm/s)
+        double acceleration = 500.0;    // 加/减速度 (mm/s²)
+        double jerk = 0.0;              // 加加速度 (mm/s³)，仅S形曲线使用
+    };
+
+    MotionProfile() = default;
+
+    static MotionProfile plan(double start, double target, double trackLength,
+                              MoverData::MovementDirection direction,
+                              Shape shape, const Limits &limits);
+
+    bool isValid() const { return m_valid; }
+    Shape shape() const { return m_shape; }
+    double startPosition() const { return m_start; }
+    double endPosition() const { return m_end; }
+    double direction() const { return m_direction; }    // +1 前进（逆时针），-1 后退
+    double distance() const { return m_distance; }      // 行程长度 (mm)，非负
+    double duration() const { return m_duration; }      // 预计用时 (s)
+    double peakSpeed() const { return m_peakSpeed; }
+    double peakAcceleration() const { return m_peakAcceleration; }
+
+    // 自起点沿运动方向走过的距离与速度，t 超出范围时钳位
+    double travelledAt(double t) const;
+    double speedAt(double t) const;
+    // 轨道上的绝对位置（已按轨道长度回绕）
+    double positionAt(double t) const;
+
+    // 占用的轨道区间：从 startPosition 沿运动方向延伸 distance
+    bool envelopeContains(double position, double margin = 0.0) const;
+
+private:
+    struct Segment {
+        double t0 = 0.0;    // 段起始时刻
+        double duration = 0.0;
+        double s0 = 0.0;    // 段起点的行程、速度、加速度
+        double v0 = 0.0;
+        double a0 = 0.0;
+        double jerk = 0.0;
+    };
+
+    void appendSegment(double duration, double a0, double jerk);
+    const Segment *segmentAt(double t) const;
+    double wrap(double position) const;
+
+    bool m_valid = false;
+    Shape m_shape = Trapezoidal;
+    double m_trackLength = 0.0;
+    double m_start = 0.0;
+    double m_end = 0.0;
+    double m_direction = 1.0;
+    double m_distance = 0.0;
+    double m_duration = 0.0;
+    double m_peakSpeed = 0.0;
+    double m_peakAcceleration = 0.0;
+    QVector<Segment> m_segments;
+};
+
+#endif // MOTIONPROFILE_H
@@ -2,7 +2,73 @@
 #define MOVERDATA_H
 
 #include <QString>
-#include <QDateTime>
+#include <QVector>
+#include <QElapsedTimer>
+
+// 动子状态码，状态文字只在显示时由状态码生成
+enum class MoverStatusCode : quint8 {
+    Unknown,
+    Stopped,
+    Ready,
+    Running,
+    Disabled,
+    Error,
+    EmergencyStop
+};
+
+inline QString moverStatusText(MoverStatusCode code)
+{
+    switch (code) {
+    case MoverStatusCode::Stopped:       return QStringLiteral("停止");
+    case MoverStatusCode::Ready:         return QStringLiteral("就绪");
+    case MoverStatusCode::Running:       return QStringLiteral("运行中");
+    case MoverStatusCode::Disabled:      return QStringLiteral("禁用");
+    case MoverStatusCode::Error:         return QStringLiteral("错误");
+    case MoverStatusCode::EmergencyStop: return QStringLiteral("紧急停止");
+    case MoverStatusCode::Unknown:       break;
+    }
+    return QStringLiteral("未知");
+}
+
+// 单调时钟毫秒数，不受系统时间调整影响，也不分配内存
+inline qint64 moverClockMs()
+{
+    return QElapsedTimer::msecsSinceReference();
+}
+
+/**
+ * 动子高频遥测表
+ * 按字段分列存放（结构数组），解码、碰撞检查和绘制只遍历连续的数值，
+ * 不触碰字符串等冷数据。下标即动子编号。
+ */
+struct MoverTelemetryTable {
+    static constexpr qint64 STALE_TIMEOUT_MS = 2000;
+
+    QVector<double> position;          // 当前实际位置 (mm)
+    QVector<double> speed;             // 当前实际速度 (mm/s)
+    QVector<double> target;            // 目标位置 (mm)
+    QVector<quint16> statusWord;       // PLC原始状态字
+    QVector<quint16> errorCode;        // PLC原始错误码
+    QVector<MoverStatusCode> status;   // 解析后的状态码
+    QVector<qint64> lastUpdateMs;      // 最后更新时间（单调时钟）
+
+    int size() const { return static_cast<int>(position.size()); }
+
+    void resize(int count) {
+        position.fill(0.0, count);
+        speed.fill(0.0, count);
+        target.fill(0.0, count);
+        statusWord.fill(0, count);
+        errorCode.fill(0, count);
+        status.fill(MoverStatusCode::Unknown, count);
+        lastUpdateMs.fill(0, count);
+    }
+
+    // 检查数据是否过时 (超过2秒没有更新)
+    bool isStale(int id, qint64 nowMs) const {
+        return nowMs - lastUpdateMs[id] > STALE_TIMEOUT_MS;
+    }
+};
 
 struct MoverData {
     int id;
@@ -29,7 +95,8 @@ struct MoverData {
     double targetAcceleration; // 目标加速度
 
     // 状态信息
-    QString status;        // 当前状态 (从PLC读取)
+    MoverStatusCode statusCode; // 当前状态码 (从PLC读取)
+    QString status;        // 当前状态的显示文字
     QString lastCommand;   // 最后发送的命令
     double temperature;    // 温度 (从PLC读取)
     bool isSelected;
@@ -41,9 +108,9 @@ struct MoverData {
     QString errorMessage;  // 错误信息
     bool isEnabled;        // 动子使能
 
-    // 时间戳
-    QDateTime lastUpdateTime;  // 最后更新时间
-    QDateTime lastCommandTime; // 最后命令时间
+    // 时间戳（单调时钟毫秒，见moverClockMs）
+    qint64 lastUpdateMs;   // 最后更新时间
+    qint64 lastCommandMs;  // 最后命令时间
 
     // 构造函数
     MoverData()
@@ -54,8 +121,10 @@ struct MoverData {
         , speed(0.0)
         , targetSpeed(100.0)
         , commandedSpeed(100.0)
+        , movementDirection(AUTO)
         , acceleration(500.0)
         , targetAcceleration(500.0)
+        , statusCode(MoverStatusCode::Unknown)
         , status("未知")
         , lastCommand("无")
         , temperature(25.0)
@@ -64,9 +133,9 @@ struct MoverData {
         , inPosition(false)
         , hasError(false)
         , errorMessage("")
-        , lastUpdateTime(QDateTime::currentDateTime())
-        , lastCommandTime(QDateTime::currentDateTime())
-        , movementDirection(AUTO)
+        , isEnabled(false)
+        , lastUpdateMs(moverClockMs())
+        , lastCommandMs(lastUpdateMs)
     {
     }
 
@@ -78,8 +147,10 @@ struct MoverData {
         , speed(0.0)
         , targetSpeed(100.0)
         , commandedSpeed(100.0)
+        , movementDirection(AUTO)
         , acceleration(500.0)
         , targetAcceleration(500.0)
+        , statusCode(MoverStatusCode::Stopped)
         , status("停止")
         , lastCommand("无")
         , temperature(25.0)
@@ -89,14 +160,20 @@ struct MoverData {
         , hasError(false)
         , errorMessage("")
         , isEnabled(false)
-        , lastUpdateTime(QDateTime::currentDateTime())
-        , lastCommandTime(QDateTime::currentDateTime())
+        , lastUpdateMs(moverClockMs())
+        , lastCommandMs(lastUpdateMs)
     {
     }
 
+    // 设置状态码并同步显示文字
+    void setStatus(MoverStatusCode code) {
+        statusCode = code;
+        status = moverStatusText(code);
+    }
+
     // 检查数据是否过时 (超过2秒没有更新)
     bool isDataStale() const {
-        return lastUpdateTime.msecsTo(QDateTime::currentDateTime()) > 2000;
+        return moverClockMs() - lastUpdateMs > MoverTelemetryTable::STALE_TIMEOUT_MS;
     }
 
     // 检查命令是否执行完成
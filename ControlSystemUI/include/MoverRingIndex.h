@@ -0,0 +1,64 @@
+#ifndef MOVERRINGINDEX_H
+#define MOVERRINGINDEX_H
+
+#include <QVector>
+
+/**
+ * @brief 环线上动子的位置顺序索引
+ *
+ * 按位置维护动子编号的有序序列和每个动子在序列中的名次。
+ * 单个位置更新用二分查找定位新名次，再只搬动跨过的那一段，
+ * 两次刷新之间动子很少越过邻居，代价接近O(log n)；相邻动子查询为O(1)。
+ *
+ * 动子在环线上不能互相超越，一次移动只可能与运动方向上的相邻动子以及
+ * 从后方追来的相邻动子冲突，扫掠检查因此只需看两个邻居。
+ */
+class MoverRingIndex
+{
+public:
+    /**
+     * @brief 扫掠检查发现的冲突
+     */
+    struct Conflict {
+        int moverId = -1;           // 被检查的动子
+        int otherId = -1;           // 与之冲突的相邻动子
+        double clearance = 0.0;     // 两段扫掠区间之间的最小净距 (mm)，为负表示越过了对方
+        bool isValid() const { return moverId >= 0; }
+    };
+
+    explicit MoverRingIndex(double trackLength);
+
+    // --- 索引维护 ---
+    void reset(const QVector<double> &positions);
+    void updatePosition(int id, double position);
+    int size() const { return m_positions.size(); }
+    double trackLength() const { return m_trackLength; }
+    double position(int id) const { return m_positions.at(id); }
+
+    // --- 邻居查询 ---
+    int aheadOf(int id) const;                      // 正方向上的下一个动子
+    int behindOf(int id) const;                     // 反方向上的下一个动子
+    double gapAhead(int id) const;
+    double gapBehind(int id) const;
+    int firstAtOrAfter(double position) const;      // 从position起沿正方向遇到的第一个动子
+    double minimumGap(int *behindId = nullptr) const;
+
+    // --- 扫掠检查 ---
+    Conflict checkMove(int id, double target, const QVector<double> &plannedTargets, double minGap) const;
+    Conflict checkSpan(int id, double backReach, double forwardReach,
+                       const QVector<double> &plannedTargets, double minGap) const;
+    Conflict checkBatch(const QVector<int> &ids, const QVector<double> &plannedTargets, double minGap) const;
+
+    double wrap(double position) const;
+    double signedDistance(double from, double to) const;
+
+private:
+    double plannedTarget(int id, const QVector<double> &plannedTargets) const;
+
+    double m_trackLength;
+    QVector<double> m_positions;    // 下标为动子编号
+    QVector<int> m_order;           // 按位置升序排列的动子编号
+    QVector<int> m_rank;            // 动子编号 -> 在m_order中的名次
+};
+
+#endif // MOVERRINGINDEX_H
@@ -0,0 +1,153 @@
+#ifndef MOVERSTATUSDECODER_H
+#define MOVERSTATUSDECODER_H
+
+#include <QVector>
+#include "ModbusManager.h"
+#include "MoverSnapshotBuffer.h"
+
+/**
+ * @brief 动子状态块的读取规划与解码
+ *
+ * 每个动子在PLC中占REGISTERS_PER_MOVER个连续寄存器。读取时按单帧上限
+ * 拆成按动子对齐的最大分块；解码时按字段表逐项转换，新增字段只需在表中加一行。
+ */
+class MoverStatusDecoder
+{
+public:
+    // 一次读请求覆盖的寄存器范围
+    struct ReadChunk {
+        int startAddress;
+        int count;
+    };
+
+    /**
+     * @brief 把一段动子状态块拆分为不超过单帧上限的读请求
+     * @param startAddress 起始地址
+     * @param count 寄存器总数
+     * @return 按地址递增排列的分块，每块都包含整数个动子
+     */
+    static QVector<ReadChunk> planChunks(int startAddress, int count)
+    {
+        using namespace ModbusRegisters;
+        const int perChunk = (Limits::MAX_READ_REGISTERS / MoverStatus::REGISTERS_PER_MOVER)
+                             * MoverStatus::REGISTERS_PER_MOVER;
+
+        QVector<ReadChunk> chunks;
+        for (int offset = 0; offset < count; offset += perChunk) {
+            chunks.append({startAddress + offset, qMin(perChunk, count - offset)});
+        }
+        return chunks;
+    }
+
+    /**
+     * @brief 状态块从baseAddress开始时可容纳的最大动子数
+     *
+     * 状态块不能与控制字/点动会话、系统状态、多动子使能与速度、协同定位邮箱重叠；
+     * 多动子使能与速度块的长度随动子数变化，因此逐个动子数检查。
+     * @param baseAddress 状态块基址
+     * @return 最大动子数，基址本身不可用时为0
+     */
+    static int capacityAt(int baseAddress)
+    {
+        using namespace ModbusRegisters;
+        if (baseAddress < 0) {
+            return 0;
+        }
+
+        for (int movers = MoverSnapshotFrame::MAX_MOVERS; movers > 0; --movers) {
+            const int end = baseAddress + movers * MoverStatus::REGISTERS_PER_MOVER;
+            if (end > 65536) {
+                continue;
+            }
+            const int reserved[][2] = {
+                {SingleAxis::CONTROL_WORD, JogSession::TIMEOUT_MS + 1},
+                {SystemStatus::SYSTEM_READY, SystemStatus::MOVER_COUNT + 1},
+                {MultiAxis::ENABLE_BASE_ADDRESS, MultiAxis::ENABLE_BASE_ADDRESS + movers},
+                {MultiAxis::SPEED_BASE_ADDRESS, MultiAxis::SPEED_BASE_ADDRESS + movers},
+                {GroupMove::BASE_ADDRESS, GroupMove::BASE_ADDRESS + GroupMove::ACK_SEQUENCE + 1},
+            };
+            bool overlaps = false;
+            for (const auto &range : reserved) {
+                if (baseAddress < range[1] && range[0] < end) {
+                    overlaps = true;
+                    break;
+                }
+            }
+            if (!overlaps) {
+                return movers;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief 解码一个动子的寄存器块
+     * @param block 指向该动子第一个寄存器
+     * @param snapshot 输出的快照（只覆盖字段表中的字段）
+     */
+    static void decodeMover(const quint16 *block, MoverSnapshot &snapshot)
+    {
+        for (const FieldSpec &field : FIELDS) {
+            const quint16 *raw = block + field.offset;
+            switch (field.type) {
+            case Dint: {
+                const qint32 value = static_cast<qint32>((static_cast<quint32>(raw[1]) << 16) | raw[0]);
+                snapshot.*field.realField = value * field.scale;
+                break;
+            }
+            case Word:
+                snapshot.*field.wordField = raw[0];
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief 解码一段连续的动子状态块
+     * @param firstMover 数据块中第一个动子的编号
+     * @param values 寄存器数据
+     * @param movers 输出数组
+     * @param maxMovers 输出数组容量
+     * @param timestampMs 采样时间
+     * @return 解码的动子数量
+     */
+    static int decodeBlock(int firstMover, const QVector<quint16> &values,
+                           MoverSnapshot *movers, int maxMovers, qint64 timestampMs)
+    {
+        using namespace ModbusRegisters::MoverStatus;
+        const int count = qMin(static_cast<int>(values.size()) / REGISTERS_PER_MOVER, maxMovers);
+
+        for (int i = 0; i < count; ++i) {
+            MoverSnapshot &snapshot = movers[i];
+            snapshot.id = firstMover + i;
+            snapshot.timestampMs = timestampMs;
+            decodeMover(values.constData() + i * REGISTERS_PER_MOVER, snapshot);
+        }
+        return count;
+    }
+
+private:
+    enum FieldType {
+        Dint,   // 两个寄存器组成的有符号32位数，低字在前
+        Word    // 单个寄存器原值
+    };
+
+    struct FieldSpec {
+        int offset;                         // 动子块内偏移
+        FieldType type;
+        double scale;                       // Dint原始值到工程单位的系数
+        double MoverSnapshot::*realField;
+        quint16 MoverSnapshot::*wordField;
+    };
+
+    // PLC以微米、微米/秒为单位
+    static constexpr FieldSpec FIELDS[] = {
+        {ModbusRegisters::MoverStatus::POSITION_LOW, Dint, 0.001, &MoverSnapshot::position, nullptr},
+        {ModbusRegisters::MoverStatus::VELOCITY_LOW, Dint, 0.001, &MoverSnapshot::speed, nullptr},
+        {ModbusRegisters::MoverStatus::TARGET_LOW, Dint, 0.001, &MoverSnapshot::target, nullptr},
+        {ModbusRegisters::MoverStatus::STATUS_WORD, Word, 1.0, nullptr, &MoverSnapshot::statusWord},
+        {ModbusRegisters::MoverStatus::ERROR_CODE, Word, 1.0, nullptr, &MoverSnapshot::errorCode},
+    };
+};
+
+#endif // MOVERSTATUSDECODER_H
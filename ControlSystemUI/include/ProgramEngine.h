@@ -0,0 +1,117 @@
+#ifndef PROGRAMENGINE_H
+#define PROGRAMENGINE_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QString>
+#include "MoverData.h"
+#include "ModbusManager.h"
+
+class QTimer;
+
+/**
+ * @brief 自动运行程序的一步
+ */
+struct ProgramStep {
+    enum Type {
+        MoveTo,             // 发出绝对定位命令后立即进入下一步
+        Dwell,              // 停留指定时间
+        WaitInPosition,     // 等待PLC反馈到位（且位于最近一次定位目标处）
+        Loop                // 跳回 jumpTo；repeat为循环体执行次数，0表示无限循环
+    };
+
+    Type type = Dwell;
+    double position = 0.0;  // MoveTo: 目标位置 (mm)
+    quint16 speed = 0;      // MoveTo: 速度 (mm/s)
+    int dwellMs = 0;        // Dwell: 停留时间 (ms)
+    int jumpTo = 0;         // Loop: 跳转到的步骤序号
+    int repeat = 0;         // Loop: 循环体执行次数
+
+    static ProgramStep moveTo(double position, quint16 speed);
+    static ProgramStep dwell(int ms);
+    static ProgramStep waitInPosition();
+    static ProgramStep loop(int jumpTo, int repeat = 0);
+};
+
+using MotionProgram = QVector<ProgramStep>;
+
+/**
+ * @brief 多动子自动运行程序引擎
+ *
+ * 每个动子各自运行一段程序，程序在启动时校验后按状态机执行：
+ * 步骤推进只由两类事件驱动——主窗口发布的动子状态变化，以及最早到期的停留时间，
+ * 因此步骤之间的延迟取决于PLC反馈，而不是固定的轮询周期。
+ * 同一事件中到期的全部定位命令合并为一次协同定位写入（ModbusManager::commitGroupMove），
+ * 多个动子的程序同步推进时它们在同一个PLC周期内启动。
+ * PLC没有协同定位邮箱时（isGroupMoveReady()为false）改用单轴控制字定位，
+ * 此时同一时刻只能运行一个程序。
+ */
+class ProgramEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    ProgramEngine(ModbusManager *modbusManager, const MoverTelemetryTable *telemetry,
+                  double trackLength, QObject *parent = nullptr);
+
+    // 校验程序，返回空字符串表示可以执行，否则为错误原因
+    QString validate(const MotionProgram &program) const;
+
+    bool start(int moverId, const MotionProgram &program);
+    bool isSingleAxisMode() const;
+    void stop(int moverId);
+    void stopAll();
+    void setPaused(bool paused);
+
+    bool isRunning(int moverId) const { return m_runs.contains(moverId); }
+    bool isPaused() const { return m_paused; }
+    int runningCount() const { return m_runs.size(); }
+    int currentStep(int moverId) const;
+
+    // 主窗口发布动子状态变化后调用，只重新评估发生变化的动子
+    void update(const QVector<int> &changedIds);
+
+signals:
+    void stepStarted(int moverId, int stepIndex);
+    void programFinished(int moverId);
+    void programAborted(int moverId, const QString &reason);
+
+private slots:
+    void onDwellTimeout();
+    void onGroupMoveFinished(quint16 sequence, bool success);
+
+private:
+    struct Run {
+        MotionProgram program;
+        int pc = 0;                     // 当前步骤
+        QVector<int> loopCounts;        // 每个Loop步骤已完成的循环次数
+        double moveTarget = 0.0;        // 最近一次定位目标
+        bool hasMoveTarget = false;
+        qint64 dwellUntilMs = 0;        // 停留到期时间（单调时钟），0表示未在停留
+        quint16 moveSpeed = 0;          // 最近一次定位速度
+        quint16 moveSequence = 0;       // 最近一次定位所在的协同定位序号
+        bool singleAxis = false;        // 最近一次定位经单轴控制字发出
+    };
+
+    void advance(int moverId, QVector<ModbusManager::GroupMoveCommand> &moves);
+    void flushMoves(const QVector<ModbusManager::GroupMoveCommand> &moves);
+    void sendSingleAxisMove(int moverId, double position, quint16 speed);
+    void halt(int moverId, const Run &run, QVector<ModbusManager::GroupMoveCommand> &holds);
+    void flushHolds(const QVector<ModbusManager::GroupMoveCommand> &holds);
+    bool isInPosition(int moverId, const Run &run) const;
+    QString faultReason(int moverId) const;
+    void abort(int moverId, const QString &reason);
+    void scheduleDwellTimer();
+
+    ModbusManager *m_modbusManager;
+    const MoverTelemetryTable *m_telemetry;
+    double m_trackLength;
+    QHash<int, Run> m_runs;
+    QTimer *m_dwellTimer;
+    bool m_paused;
+
+    static const double IN_POSITION_TOLERANCE;  // 到位判定容差 (mm)
+};
+
+#endif // PROGRAMENGINE_H
@@ -0,0 +1,109 @@
+#ifndef REPLAYCONTROLLER_H
+#define REPLAYCONTROLLER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QWidget>
+#include "TelemetryReader.h"
+
+class QPushButton;
+class QComboBox;
+class QSlider;
+class QLabel;
+
+/**
+ * @brief 轨迹回放控制器
+ *
+ * 按回放倍速推进回放时钟，把到期的记录帧合并成当前状态后通过frameReady发出，
+ * 下游沿用实时快照的处理路径。发出的帧时间戳替换为当前单调时钟，
+ * 避免界面把历史数据判定为过期；历史时间通过positionChanged提供。
+ */
+class ReplayController : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ReplayController(QObject *parent = nullptr);
+
+    bool open(const QString &directory);
+    void close();
+    bool isOpen() const { return m_reader.isOpen(); }
+    bool isPlaying() const { return m_timer->isActive(); }
+
+    double speed() const { return m_speed; }
+    qint64 startTimeMs() const { return m_reader.startTimeMs(); }
+    qint64 endTimeMs() const { return m_reader.endTimeMs(); }
+    qint64 currentTimeMs() const { return m_replayTimeMs; }
+    QString errorString() const { return m_reader.errorString(); }
+    int moverCount() const { return m_reader.state().count; }
+
+public slots:
+    void play();
+    void pause();
+    void setSpeed(double speed);
+    void seek(qint64 timeMs);
+
+signals:
+    // 只能直连：帧引用在下一次发出前有效
+    void frameReady(const MoverSnapshotFrame &frame);
+    void positionChanged(qint64 timeMs);
+    void playingChanged(bool playing);
+    void finished();
+
+private slots:
+    void onTick();
+
+private:
+    void emitFrame();
+
+    static constexpr int TICK_INTERVAL_MS = 16;
+
+    TelemetryReader m_reader;
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_lastTickMs;
+    qint64 m_replayTimeMs;          // 回放时钟（墙上时间）
+    double m_speed;
+    MoverSnapshotFrame m_output;
+};
+
+/**
+ * @brief 回放工具栏：打开记录、播放/暂停、倍速和时间轴拖动
+ */
+class ReplayControlBar : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ReplayControlBar(ReplayController *controller, QWidget *parent = nullptr);
+
+    // 弹出目录选择框并打开记录
+    bool openRecording(const QString &defaultDirectory);
+
+signals:
+    void recordingOpened(const QString &directory);
+    void exitRequested();
+
+private slots:
+    void onPlayPauseClicked();
+    void onSpeedChanged(int index);
+    void onSliderMoved(int value);
+    void onPositionChanged(qint64 timeMs);
+    void onPlayingChanged(bool playing);
+
+private:
+    void updateRange();
+    static QString formatTime(qint64 timeMs);
+
+    ReplayController *m_controller;
+    QPushButton *m_openButton;
+    QPushButton *m_playButton;
+    QComboBox *m_speedCombo;
+    QSlider *m_timeSlider;
+    QLabel *m_timeLabel;
+    QPushButton *m_exitButton;
+    QString m_lastDirectory;
+};
+
+#endif // REPLAYCONTROLLER_H
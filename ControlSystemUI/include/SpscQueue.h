@@ -0,0 +1,78 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 单生产者单消费者无锁环形队列
+ *
+ * 只允许一个线程调用tryPush、另一个线程调用tryPop，两端均不加锁。
+ * 容量向上取整为2的幂，队列满时tryPush返回false，由调用方决定如何处理。
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(std::size_t capacity = 1024)
+        : m_mask(roundUpPowerOfTwo(capacity) - 1)
+        , m_buffer(m_mask + 1)
+        , m_head(0)
+        , m_tail(0)
+    {
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // 生产者线程调用
+    bool tryPush(T &&item)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) > m_mask) {
+            return false; // 队列已满
+        }
+        m_buffer[tail & m_mask] = std::move(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者线程调用
+    bool tryPop(T &item)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false; // 队列为空
+        }
+        item = std::move(m_buffer[head & m_mask]);
+        m_buffer[head & m_mask] = T(); // 及时释放元素持有的资源
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const { return m_mask + 1; }
+
+private:
+    static std::size_t roundUpPowerOfTwo(std::size_t value)
+    {
+        std::size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const std::size_t m_mask;
+    std::vector<T> m_buffer;
+    alignas(64) std::atomic<std::size_t> m_head;   // 消费者读取位置
+    alignas(64) std::atomic<std::size_t> m_tail;   // 生产者写入位置
+};
+
+#endif // SPSCQUEUE_H
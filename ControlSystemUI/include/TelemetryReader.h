@@ -0,0 +1,82 @@
+#ifndef TELEMETRYREADER_H
+#define TELEMETRYREADER_H
+
+#include <QString>
+#include <QVector>
+#include <QSharedPointer>
+#include <QFile>
+#include "TelemetryRecorder.h"
+
+/**
+ * @brief 动子轨迹文件读取器
+ *
+ * 把目录内同一前缀的所有分段只读映射，合并各分段的块索引为一条按时间排序的时间线。
+ * 时间统一换算为墙上时间（UTC毫秒），跨程序重启录制的分段也能连续回放。
+ * 定位时二分查找块索引，再从块的关键帧向后解码，最多解码一个块的帧。
+ */
+class TelemetryReader
+{
+public:
+    TelemetryReader();
+    ~TelemetryReader();
+
+    TelemetryReader(const TelemetryReader &) = delete;
+    TelemetryReader &operator=(const TelemetryReader &) = delete;
+
+    bool open(const QString &directory, const QString &baseName = "mover");
+    void close();
+    bool isOpen() const { return !m_chunks.isEmpty(); }
+
+    // 时间线范围（墙上时间，毫秒）
+    qint64 startTimeMs() const;
+    qint64 endTimeMs() const;
+    int segmentCount() const { return m_segments.size(); }
+    int chunkCount() const { return m_chunks.size(); }
+
+    // 定位到不晚于timeMs的最后一帧，state()随之更新为该时刻的完整动子状态
+    bool seek(qint64 timeMs);
+    // 解码下一帧并合并到state()，到达末尾时返回false
+    bool readNext();
+    // 下一帧的时间，已到末尾时返回-1
+    qint64 nextTimeMs() const;
+    qint64 currentTimeMs() const { return m_currentTimeMs; }
+
+    // 当前时刻的动子状态：count为出现过的最大动子编号+1，timestampMs为墙上时间
+    const MoverSnapshotFrame &state() const { return m_state; }
+
+    QString errorString() const { return m_errorString; }
+
+private:
+    struct Segment {
+        QSharedPointer<QFile> file;
+        const uchar *map = nullptr;
+        quint64 dataEnd = 0;
+        qint64 clockOffsetMs = 0;   // 墙上时间 - 单调时钟
+    };
+
+    struct ChunkRef {
+        qint64 firstTimeMs;
+        qint64 lastTimeMs;
+        int segment;
+        quint64 offset;
+        quint64 end;
+    };
+
+    bool openSegment(const QString &path);
+    bool positionAt(int chunk);
+    const TelemetryFormat::FrameHeader *peekFrame() const;
+    void applyFrame(const TelemetryFormat::FrameHeader *frame);
+
+    QVector<Segment> m_segments;
+    QVector<ChunkRef> m_chunks;
+
+    // 读取游标
+    int m_chunk;
+    quint64 m_offset;
+    qint64 m_currentTimeMs;
+    MoverSnapshotFrame m_state;
+
+    QString m_errorString;
+};
+
+#endif // TELEMETRYREADER_H
@@ -0,0 +1,164 @@
+#ifndef TELEMETRYRECORDER_H
+#define TELEMETRYRECORDER_H
+
+#include <QString>
+#include <QFile>
+#include <QtGlobal>
+#include "MoverSnapshotBuffer.h"
+
+/**
+ * @brief 动子轨迹文件格式（.mtr）
+ *
+ * 每个分段文件预分配固定大小并整体映射到内存，只追加不改写：
+ *   SegmentHeader | ChunkIndexEntry[indexCapacity] | 数据区
+ * 数据区由若干数据块（chunk）组成，每块是连续的帧，块内第一帧为关键帧（包含帧内所有动子），
+ * 其余帧只记录与上一次记录相比有变化的动子；没有任何变化的扫描也写一个空帧（recordCount为0），
+ * 回放时据此区分“扫描到但没有变化”和“漏扫”。
+ * 帧 = FrameHeader + changedMask中置位动子的MoverRecord（按编号递增）。
+ * 文件头中的dataEnd/chunkCount在每帧写完后才更新，读端只信任已提交的范围。
+ * 所有字段均为小端序。
+ */
+namespace TelemetryFormat {
+
+constexpr quint32 MAGIC = 0x4352544D;      // "MTRC"
+constexpr quint16 VERSION = 1;
+constexpr quint16 FLAG_KEYFRAME = 0x0001;
+constexpr quint32 SEGMENT_OPEN = 0;
+constexpr quint32 SEGMENT_CLOSED = 1;
+constexpr int MASK_WORDS = MoverSnapshotFrame::MAX_MOVERS / 64;
+
+struct SegmentHeader {
+    quint32 magic;
+    quint16 version;
+    quint16 headerSize;             // sizeof(SegmentHeader)
+    quint32 indexCapacity;          // 块索引表容量
+    quint32 chunkCount;             // 已提交的块数量（含正在写入的块）
+    quint64 dataOffset;             // 数据区起始偏移
+    quint64 dataEnd;                // 已提交数据的结束偏移
+    qint64 monotonicStartMs;        // 打开分段时的单调时钟
+    qint64 wallClockStartMs;        // 打开分段时的UTC时间，用于把帧时间换算为墙上时间
+    quint32 state;                  // SEGMENT_OPEN / SEGMENT_CLOSED
+    quint32 reserved[5];
+};
+
+struct ChunkIndexEntry {
+    qint64 firstTimestampMs;
+    qint64 lastTimestampMs;
+    quint64 offset;                 // 块在文件中的起始偏移（指向关键帧）
+    quint32 bytes;
+    quint32 frameCount;
+};
+
+struct FrameHeader {
+    qint64 timestampMs;             // 采样时间（单调时钟）
+    quint16 recordCount;            // 随后MoverRecord的数量
+    quint16 flags;
+    quint32 sequence;               // 快照帧序号低32位
+    quint64 changedMask[MASK_WORDS]; // 第i位表示动子i有记录
+};
+
+// 原始PLC单位，与寄存器中的DINT一致，换算无损
+struct MoverRecord {
+    qint32 positionUm;
+    qint32 speedUmPerSec;
+    qint32 targetUm;
+    quint16 statusWord;
+    quint16 errorCode;
+};
+
+static_assert(sizeof(SegmentHeader) == 72, "SegmentHeader layout changed");
+static_assert(sizeof(ChunkIndexEntry) == 32, "ChunkIndexEntry layout changed");
+static_assert(sizeof(FrameHeader) == 16 + 8 * MASK_WORDS, "FrameHeader layout changed");
+static_assert(sizeof(MoverRecord) == 16, "MoverRecord layout changed");
+
+inline MoverRecord encodeRecord(const MoverSnapshot &snapshot)
+{
+    MoverRecord record;
+    record.positionUm = qRound(snapshot.position * 1000.0);
+    record.speedUmPerSec = qRound(snapshot.speed * 1000.0);
+    record.targetUm = qRound(snapshot.target * 1000.0);
+    record.statusWord = snapshot.statusWord;
+    record.errorCode = snapshot.errorCode;
+    return record;
+}
+
+inline void decodeRecord(const MoverRecord &record, int id, qint64 timestampMs, MoverSnapshot &snapshot)
+{
+    snapshot.id = id;
+    snapshot.position = record.positionUm * 0.001;
+    snapshot.speed = record.speedUmPerSec * 0.001;
+    snapshot.target = record.targetUm * 0.001;
+    snapshot.statusWord = record.statusWord;
+    snapshot.errorCode = record.errorCode;
+    snapshot.timestampMs = timestampMs;
+}
+
+} // namespace TelemetryFormat
+
+/**
+ * @brief 动子轨迹记录器
+ *
+ * 把每一帧动子快照追加到内存映射的分段文件中，单帧只做比较和memcpy，
+ * 可以在生产环境常开。分段写满或块索引用完后切换到新分段，
+ * 目录内同名前缀的分段总大小超过上限时删除最旧的分段，磁盘占用有界。
+ * 非线程安全：只能在一个线程（I/O线程）中使用。
+ */
+class TelemetryRecorder
+{
+public:
+    struct Options {
+        QString directory;
+        QString baseName = "mover";
+        qint64 segmentBytes = 64LL * 1024 * 1024;       // 单个分段预分配大小
+        qint64 maxTotalBytes = 4LL * 1024 * 1024 * 1024; // 目录内分段总大小上限
+        int indexCapacity = 4096;                       // 每个分段的块数上限
+        int chunkBytes = 256 * 1024;                    // 块大小达到后开始新块
+        int chunkSpanMs = 1000;                         // 块时间跨度达到后开始新块（决定定位粒度）
+    };
+
+    static constexpr const char *FILE_SUFFIX = ".mtr";
+
+    TelemetryRecorder();
+    ~TelemetryRecorder();
+
+    TelemetryRecorder(const TelemetryRecorder &) = delete;
+    TelemetryRecorder &operator=(const TelemetryRecorder &) = delete;
+
+    bool start(const Options &options);
+    void stop();
+    bool isRecording() const { return m_recording; }
+
+    // 追加一帧快照，分段切换失败时停止记录并返回false
+    bool record(const MoverSnapshotFrame &frame);
+    // 追加一帧无变化的扫描（只写帧头），需要开始新块时按最近的记录写出关键帧
+    bool recordIdle(qint64 timestampMs);
+
+    QString currentFilePath() const { return m_file.fileName(); }
+    QString errorString() const { return m_errorString; }
+    quint64 framesWritten() const { return m_framesWritten; }
+
+private:
+    bool openSegment(qint64 timestampMs);
+    void closeSegment();
+    void enforceRetention();
+    void beginChunk(qint64 timestampMs);
+    TelemetryFormat::SegmentHeader *header() const;
+    TelemetryFormat::ChunkIndexEntry *indexEntry(int chunk) const;
+
+    Options m_options;
+    QFile m_file;
+    uchar *m_map;                   // 当前分段的映射区，未打开分段时为空
+    bool m_recording;
+    quint64 m_writeOffset;
+    int m_currentChunk;             // 当前块在索引表中的下标，-1表示需要开始新块
+
+    // 每个动子上一次写入的记录，用于变化检测；块开始时清空以写入关键帧
+    TelemetryFormat::MoverRecord m_lastRecords[MoverSnapshotFrame::MAX_MOVERS];
+    quint64 m_knownMask[TelemetryFormat::MASK_WORDS];
+
+    quint64 m_lastSequence;         // 最近一次记录的快照帧序号，空帧沿用
+    quint64 m_framesWritten;
+    QString m_errorString;
+};
+
+#endif // TELEMETRYRECORDER_H
@@ -3,9 +3,16 @@
 
 #include <QWidget>
 #include <QList>
+#include <QVector>
 #include <QWheelEvent>
 #include <QShowEvent>
+#include <QPixmap>
+#include <QPolygonF>
 #include "MoverData.h"
+#include "CollisionMonitor.h"
+#include "MotionProfile.h"
+
+class QPainter;
 
 class TrackWidget : public QWidget
 {
@@ -14,6 +21,13 @@ class TrackWidget : public QWidget
 public:
     explicit TrackWidget(QWidget *parent = nullptr);
     void updateMovers(const QList<MoverData> &movers);
+    // 只同步变化的动子，数量不一致时退化为整体复制
+    void updateMovers(const QList<MoverData> &movers, const QVector<int> &changedIds);
+    // 标出间距告警的相邻动子对，只重绘新旧告警覆盖的区域
+    void setCollisionAlerts(const QVector<CollisionAlert> &alerts);
+    // 定位预览：沿轨道绘制运动曲线的虚影轨迹，时间刻度点间距反映加减速
+    void setMotionPreview(const MotionProfile &profile, bool conflict);
+    void clearMotionPreview();
 
 public slots: // 公共槽函数，用于从外部控制缩放
     void zoomIn();
@@ -26,11 +40,60 @@ signals:
 protected:
     void paintEvent(QPaintEvent *event) override;
     void wheelEvent(QWheelEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
     //void showEvent(QShowEvent *event) override;
 
 private:
-    QPointF getTrackPosition(double position);
+    QPointF getTrackPosition(double position) const;
+    QPointF trackCenter() const;
+    double trackScale() const;
+
+    // 静态层：网格、轨道、刻度、信息面板，缓存为位图，尺寸/缩放/主题变化时失效
+    void invalidateStaticLayer();
+    void renderStaticLayer();
+
+    // 轨道位置→屏幕坐标查找表：等距采样，线性插值
+    static constexpr int LUT_SEGMENTS = 2048;
+    void ensureTrackLut();
+    void mapTrackPositions(const double *positions, double *xs, double *ys, int count) const;
+    QPointF trackPointAt(double position) const;
+
+    // 动态层：逐帧只绘制动子及其目标指示
+    void drawMover(QPainter &painter, const MoverData &mover,
+                   const QPointF &currentPos, const QPointF &targetPos);
+    QRect moverBounds(const MoverData &mover) const;
+    QRect moverBounds(const MoverData &mover, const QPointF &currentPos, const QPointF &targetPos) const;
+    static bool moverChanged(const MoverData &a, const MoverData &b);
+    void drawCollisionAlert(QPainter &painter, const CollisionAlert &alert,
+                            const QPointF &behindPos, const QPointF &aheadPos);
+    QRect alertBounds(const QPointF &behindPos, const QPointF &aheadPos) const;
+    QRegion collisionAlertsRegion() const;
+    void buildPreviewGeometry(QPolygonF &path, QVector<QPointF> &ticks) const;
+    QRect previewBounds() const;
+    void drawMotionPreview(QPainter &painter);
+
+    static constexpr int PREVIEW_PATH_SAMPLES = 48;    // 虚影轨迹的折线采样数
+    static constexpr int PREVIEW_MAX_TICKS = 40;       // 时间刻度点上限
+    static constexpr double PREVIEW_TICK_SEC = 0.5;    // 时间刻度间隔 (s)
+
+    static constexpr double MAX_SPEED_RATIO = 2.0;     // 速度箭头长度上限（相对目标速度）
+    static constexpr double LABEL_HALF_WIDTH = 40.0;   // 动子标签的估计半宽 (px)
+    static constexpr double LABEL_HALF_HEIGHT = 14.0;  // 动子标签的估计半高 (px)
+
+    QPixmap m_staticLayer;
+    bool m_staticLayerValid = false;
+    QVector<double> m_lutX;            // 查找表样本（屏幕坐标）
+    QVector<double> m_lutY;
+    double m_lutScale = 0.0;           // 建表时的缩放比例
+    QPointF m_lutCenter;               // 建表时的轨道中心
+    QVector<double> m_paintPositions;  // 绘制时批量映射的暂存，避免逐帧分配
+    QVector<double> m_paintX;
+    QVector<double> m_paintY;
     QList<MoverData> m_movers;
+    QVector<CollisionAlert> m_collisionAlerts;
+    MotionProfile m_previewProfile;
+    bool m_previewConflict = false;
     //QSize m_originalSize;
     //bool m_isInitialShow = true;
     double m_zoomFactor = 2.3;
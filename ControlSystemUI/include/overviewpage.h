@@ -4,9 +4,11 @@
 
 #include <QWidget>
 #include <QList>
+#include <QSet>
 #include "MoverData.h"
 #include "LogWidget.h"
 #include "MainWindow.h"
+#include "ModbusManager.h"
 
 class TrackWidget;
 class MoverWidget;
@@ -27,17 +29,24 @@ public:
 
 public slots:
     void updateMovers(const QList<MoverData> &movers);
+    void onMoversChanged(const QVector<int> &changedIds, quint64 generation);
+    void onCollisionAlertsChanged(const QVector<CollisionAlert> &alerts);
     void onUserChanged(const QString& username);
     void addLogEntry(const QString &message, const QString &type = "info");
 
 private slots:
     void onMoverSelected(int id);
+    void onGroupMoveRequested();
+    void onGroupMoveFinished(quint16 sequence, bool success);
 
 private:
     void setupUI();
     void createMoverWidgets();
     void initializeTableWithData();       // 初始化表格数据
     void updateTableData(const QList<MoverData> &movers);  // 更新表格数据
+    void updateTableRow(int row, const MoverData &mover);  // 更新单行表格
+    void updateMoverWidget(int id);
+    QString validateGroupMove(const QVector<ModbusManager::GroupMoveCommand> &commands) const;
     MainWindow *m_mainWindow;
 
     // UI组件
@@ -54,5 +63,6 @@ private:
     QList<MoverData>* m_movers;
     QString m_currentUser;
     int m_selectedMover;
+    QSet<quint16> m_groupMoveSequences;     // 本页提交、尚未结束的协同定位序号
 };
 #endif // OVERVIEWPAGE_H
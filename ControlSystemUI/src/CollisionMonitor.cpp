@@ -0,0 +1,291 @@
+#include "CollisionMonitor.h"
+#include <QtMath>
+#include <cmath>
+
+CollisionMonitor::CollisionMonitor(double trackLength, double safetyDistance)
+    : m_index(trackLength)
+    , m_safetyDistance(safetyDistance)
+{
+}
+
+/**
+ * @brief 动子数量变化时重建索引并清空加速度估计与告警状态
+ */
+void CollisionMonitor::reset(const MoverTelemetryTable &telemetry)
+{
+    const int count = telemetry.size();
+    m_index.reset(telemetry.position);
+    m_acceleration.fill(0.0, count);
+    m_lastSpeed = telemetry.speed;
+    m_lastSampleMs = telemetry.lastUpdateMs;
+    m_pairLevel.fill(CollisionLevel::None, count);
+    m_pairAhead.fill(-1, count);
+    m_alerts.clear();
+    m_alerts.reserve(count);
+    m_escalations.clear();
+    m_escalations.reserve(count);
+}
+
+/**
+ * @brief 只把本周期变化的动子位置写入环线索引
+ *
+ * 关闭间距监视时主窗口仍每周期调用，使 checkProfile 等预览检查始终基于最新位置。
+ */
+void CollisionMonitor::updateIndex(const MoverTelemetryTable &telemetry, const QVector<int> &changedIds)
+{
+    const int count = telemetry.size();
+    if (count != m_index.size()) {
+        reset(telemetry);
+        return;
+    }
+    for (int id : changedIds) {
+        if (id >= 0 && id < count) {
+            m_index.updatePosition(id, telemetry.position[id]);
+        }
+    }
+}
+
+/**
+ * @brief 处理一个刷新周期的变化并重新评估全部相邻动子对
+ * @param telemetry 已写入本周期数据的遥测表
+ * @param changedIds 本周期位置、速度或状态发生变化的动子
+ * @return 告警动子对或其等级是否与上一周期不同
+ */
+bool CollisionMonitor::update(const MoverTelemetryTable &telemetry, const QVector<int> &changedIds)
+{
+    const int count = telemetry.size();
+    updateIndex(telemetry, changedIds);
+
+    for (int id : changedIds) {
+        if (id < 0 || id >= count) {
+            continue;
+        }
+
+        // 速度差分估计加速度；停止的动子不再减速，超过1秒未变化的样本不参与差分
+        const double speed = telemetry.speed[id];
+        const qint64 dtMs = telemetry.lastUpdateMs[id] - m_lastSampleMs[id];
+        if (speed == 0.0 || dtMs <= 0 || dtMs > 1000) {
+            m_acceleration[id] = 0.0;
+        } else {
+            const double raw = (speed - m_lastSpeed[id]) * 1000.0 / dtMs;
+            m_acceleration[id] += ACCEL_SMOOTHING * (raw - m_acceleration[id]);
+        }
+        m_lastSpeed[id] = speed;
+        m_lastSampleMs[id] = telemetry.lastUpdateMs[id];
+    }
+
+    m_alerts.clear();
+    m_escalations.clear();
+    bool changed = false;
+    if (count < 2) {
+        for (CollisionLevel &level : m_pairLevel) {
+            changed |= level != CollisionLevel::None;
+            level = CollisionLevel::None;
+        }
+        m_pairAhead.fill(-1);
+        return changed;
+    }
+
+    // 每个动子恰好是一对相邻关系中的后方动子
+    for (int behind = 0; behind < count; ++behind) {
+        const CollisionAlert alert = evaluatePair(telemetry, behind, m_index.aheadOf(behind));
+        // 前方动子变了（中间有动子移入或移出）时按新的一对处理，等级从无开始比较
+        const bool samePair = m_pairAhead[behind] == alert.aheadId;
+        const CollisionLevel previous = samePair ? m_pairLevel[behind] : CollisionLevel::None;
+        if (alert.level != CollisionLevel::None) {
+            m_alerts.append(alert);
+        }
+        if (alert.level > previous && alert.level >= CollisionLevel::Warning) {
+            m_escalations.append(alert);
+        }
+        changed |= alert.level != previous || (!samePair && m_pairLevel[behind] != CollisionLevel::None);
+        m_pairLevel[behind] = alert.level;
+        m_pairAhead[behind] = alert.aheadId;
+    }
+    return changed;
+}
+
+/**
+ * @brief 按匀加速模型求解后方动子追近前方动子、间距降到安全距离的时间
+ *
+ * 间距余量 m = gap - safety，接近速度 v 与接近加速度 a 取两者之差，
+ * 求 0.5·a·t² + v·t = m 的最小正根；接近速度先降到零则不会突破。
+ */
+CollisionAlert CollisionMonitor::evaluatePair(const MoverTelemetryTable &telemetry, int behindId, int aheadId) const
+{
+    CollisionAlert alert;
+    alert.behindId = behindId;
+    alert.aheadId = aheadId;
+    alert.gap = m_index.gapAhead(behindId);
+    alert.closingSpeed = telemetry.speed[behindId] - telemetry.speed[aheadId];
+
+    const double margin = alert.gap - m_safetyDistance;
+    const double v = alert.closingSpeed;
+    const double a = m_acceleration[behindId] - m_acceleration[aheadId];
+
+    if (margin <= 0.0) {
+        alert.timeToViolation = 0.0;
+    } else if (qAbs(a) < 1e-6) {
+        if (v > 0.0) {
+            alert.timeToViolation = margin / v;
+        }
+    } else {
+        const double discriminant = v * v + 2.0 * a * margin;
+        if (discriminant >= 0.0) {
+            // 数值稳定的求根写法，避免 -v + sqrt(...) 的相消
+            const double root = std::sqrt(discriminant);
+            const double q = v >= 0.0 ? v + root : v - root;
+            const double t1 = -q / a;
+            const double t2 = q != 0.0 ? 2.0 * margin / q : -1.0;
+            double t = std::numeric_limits<double>::infinity();
+            if (t1 > 0.0) t = qMin(t, t1);
+            if (t2 > 0.0) t = qMin(t, t2);
+            alert.timeToViolation = t;
+        }
+    }
+
+    alert.level = levelFor(alert.timeToViolation);
+    return alert;
+}
+
+/**
+ * @brief 检查一条运动曲线在执行期间是否与相邻动子突破安全距离
+ *
+ * 在曲线时长内均匀采样，动子自身位置取曲线，前后邻居按当前速度外推
+ * （运行中的邻居到达其目标后停止）。
+ * @return 最早的突破：timeToViolation 为自启动起的时间，level 为 Critical；
+ *         不会突破时返回 level 为 None、gap 为全程最小间距的结果
+ */
+CollisionAlert CollisionMonitor::checkProfile(int moverId, const MotionProfile &profile,
+                                              const MoverTelemetryTable &telemetry) const
+{
+    CollisionAlert result;
+    result.behindId = moverId;
+    const int count = telemetry.size();
+    if (!profile.isValid() || count < 2 || m_index.size() != count || moverId < 0 || moverId >= count) {
+        return result;
+    }
+
+    const double dir = profile.direction();
+    const int front = dir > 0 ? m_index.aheadOf(moverId) : m_index.behindOf(moverId);
+    const int rear = dir > 0 ? m_index.behindOf(moverId) : m_index.aheadOf(moverId);
+    const double frontGap = dir > 0 ? m_index.gapAhead(moverId) : m_index.gapBehind(moverId);
+    const double rearGap = dir > 0 ? m_index.gapBehind(moverId) : m_index.gapAhead(moverId);
+
+    result.gap = std::numeric_limits<double>::infinity();
+    for (int i = 0; i <= PROFILE_SAMPLES; ++i) {
+        const double t = profile.duration() * i / PROFILE_SAMPLES;
+        const double travelled = profile.travelledAt(t);
+        const double toFront = frontGap + dir * extrapolate(telemetry, front, t) - travelled;
+        const double fromRear = rearGap + travelled - dir * extrapolate(telemetry, rear, t);
+        const bool frontCloser = toFront <= fromRear;
+        const double gap = frontCloser ? toFront : fromRear;
+        if (gap < result.gap) {
+            result.gap = gap;
+            result.aheadId = frontCloser ? front : rear;
+        }
+        if (gap < m_safetyDistance) {
+            result.timeToViolation = t;
+            result.level = CollisionLevel::Critical;
+            return result;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 检查同一触发同时启动的一组运动曲线在执行期间是否突破安全距离
+ *
+ * 动子不能互相超越，只需看环线上的相邻动子对：参与的动子取各自曲线的有符号位移，
+ * 其余动子按当前速度外推。在最长曲线时长内均匀采样，最后一个采样即各曲线的终止状态。
+ * 按时间比较而不是比较扫掠区间，同向整体平移的一组动子只要全程保持间距即可通过。
+ * @return 最早的突破：behindId/aheadId 为该对动子，timeToViolation 为自触发起的时间，
+ *         level 为 Critical；不会突破时 level 为 None、gap 为全程最小间距
+ */
+CollisionAlert CollisionMonitor::checkGroup(const QVector<MotionProfile> &profiles,
+                                            const MoverTelemetryTable &telemetry) const
+{
+    CollisionAlert result;
+    const int count = telemetry.size();
+    if (count < 2 || m_index.size() != count || profiles.size() != count) {
+        return result;
+    }
+
+    double duration = 0.0;
+    for (const MotionProfile &profile : profiles) {
+        if (profile.isValid()) {
+            duration = qMax(duration, profile.duration());
+        }
+    }
+    auto displacement = [&](int id, double t) {
+        const MotionProfile &profile = profiles[id];
+        return profile.isValid() ? profile.direction() * profile.travelledAt(t) : extrapolate(telemetry, id, t);
+    };
+
+    result.gap = std::numeric_limits<double>::infinity();
+    for (int i = 0; i <= PROFILE_SAMPLES; ++i) {
+        const double t = duration * i / PROFILE_SAMPLES;
+        for (int behind = 0; behind < count; ++behind) {
+            const int ahead = m_index.aheadOf(behind);
+            if (!profiles[behind].isValid() && !profiles[ahead].isValid()) {
+                continue;
+            }
+            const double gap = m_index.gapAhead(behind) + displacement(ahead, t) - displacement(behind, t);
+            if (gap < result.gap) {
+                result.gap = gap;
+                result.behindId = behind;
+                result.aheadId = ahead;
+            }
+            if (gap < m_safetyDistance) {
+                result.timeToViolation = t;
+                result.level = CollisionLevel::Critical;
+                return result;
+            }
+        }
+    }
+    return result;
+}
+
+// 邻居在 t 秒内的有符号位移：按当前速度外推，运行中的动子不越过其目标
+double CollisionMonitor::extrapolate(const MoverTelemetryTable &telemetry, int id, double t) const
+{
+    const double displacement = telemetry.speed[id] * t;
+    if (telemetry.status[id] != MoverStatusCode::Running) {
+        return displacement;
+    }
+    const double toTarget = qAbs(m_index.signedDistance(m_index.position(id), telemetry.target[id]));
+    return qBound(-toTarget, displacement, toTarget);
+}
+
+CollisionLevel CollisionMonitor::levelFor(double timeToViolation) const
+{
+    if (timeToViolation <= m_thresholds.criticalSec) {
+        return CollisionLevel::Critical;
+    }
+    if (timeToViolation <= m_thresholds.warningSec) {
+        return CollisionLevel::Warning;
+    }
+    if (timeToViolation <= m_thresholds.advisorySec) {
+        return CollisionLevel::Advisory;
+    }
+    return CollisionLevel::None;
+}
+
+CollisionLevel CollisionMonitor::highestLevel() const
+{
+    CollisionLevel highest = CollisionLevel::None;
+    for (const CollisionAlert &alert : m_alerts) {
+        highest = qMax(highest, alert.level);
+    }
+    return highest;
+}
+
+QString CollisionMonitor::levelText(CollisionLevel level)
+{
+    switch (level) {
+    case CollisionLevel::Advisory: return "提示";
+    case CollisionLevel::Warning:  return "警告";
+    case CollisionLevel::Critical: return "严重";
+    default:                       return "正常";
+    }
+}
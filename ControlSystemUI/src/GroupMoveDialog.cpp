@@ -0,0 +1,212 @@
+#include "GroupMoveDialog.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QDoubleSpinBox>
+#include <QSpinBox>
+#include <QLabel>
+#include <QPushButton>
+#include <cmath>
+
+namespace {
+// 表格列
+enum Column {
+    SelectColumn = 0,
+    IdColumn,
+    PositionColumn,
+    TargetColumn,
+    SpeedColumn,
+    ColumnCount
+};
+}
+
+/**
+ * @brief 构造函数
+ * @param movers 动子数据（打开时的快照）
+ * @param preselected 默认勾选的动子编号
+ * @param trackLength 环线全长 (mm)，与主窗口的动子配置一致
+ * @param parent 父窗口指针
+ */
+GroupMoveDialog::GroupMoveDialog(const QList<MoverData> &movers, const QVector<int> &preselected,
+                                 double trackLength, QWidget *parent)
+    : QDialog(parent)
+    , m_table(nullptr)
+    , m_offsetSpin(nullptr)
+    , m_commonSpeedSpin(nullptr)
+    , m_statusLabel(nullptr)
+    , m_commitBtn(nullptr)
+    , m_trackLength(trackLength)
+{
+    setWindowTitle("多动子协同定位");
+    setModal(true);
+    setMinimumSize(560, 480);
+    setupUI(movers, preselected);
+    revalidate();
+}
+
+void GroupMoveDialog::setupUI(const QList<MoverData> &movers, const QVector<int> &preselected)
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    m_table = new QTableWidget(movers.size(), ColumnCount, this);
+    m_table->setHorizontalHeaderLabels({"参与", "ID", "当前位置(mm)", "目标位置(mm)", "速度(mm/s)"});
+    m_table->horizontalHeader()->setStretchLastSection(true);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->setSelectionMode(QAbstractItemView::NoSelection);
+
+    m_positions.resize(movers.size());
+    m_targetSpins.resize(movers.size());
+    m_speedSpins.resize(movers.size());
+    for (int row = 0; row < movers.size(); ++row) {
+        const MoverData &mover = movers[row];
+        m_positions[row] = mover.position;
+
+        QTableWidgetItem *selectItem = new QTableWidgetItem();
+        selectItem->setFlags(Qt::ItemIsUserCheckable | Qt::ItemIsEnabled);
+        selectItem->setCheckState(preselected.contains(mover.id) ? Qt::Checked : Qt::Unchecked);
+        m_table->setItem(row, SelectColumn, selectItem);
+
+        QTableWidgetItem *idItem = new QTableWidgetItem(QString::number(mover.id));
+        idItem->setFlags(Qt::ItemIsEnabled);
+        idItem->setData(Qt::UserRole, mover.id);
+        m_table->setItem(row, IdColumn, idItem);
+
+        QTableWidgetItem *positionItem = new QTableWidgetItem(QString::number(mover.position, 'f', 1));
+        positionItem->setFlags(Qt::ItemIsEnabled);
+        m_table->setItem(row, PositionColumn, positionItem);
+
+        QDoubleSpinBox *targetSpin = new QDoubleSpinBox();
+        targetSpin->setRange(0, m_trackLength);
+        targetSpin->setDecimals(1);
+        targetSpin->setValue(mover.target);
+        m_table->setCellWidget(row, TargetColumn, targetSpin);
+        m_targetSpins[row] = targetSpin;
+
+        QSpinBox *speedSpin = new QSpinBox();
+        speedSpin->setRange(10, 1000);
+        speedSpin->setValue(qBound(10, qRound(mover.targetSpeed), 1000));
+        m_table->setCellWidget(row, SpeedColumn, speedSpin);
+        m_speedSpins[row] = speedSpin;
+
+        connect(targetSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &GroupMoveDialog::revalidate);
+        connect(speedSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &GroupMoveDialog::revalidate);
+    }
+    connect(m_table, &QTableWidget::itemChanged, this, &GroupMoveDialog::revalidate);
+    mainLayout->addWidget(m_table);
+
+    // 批量设置：参与的动子统一按当前位置偏移、统一速度
+    QHBoxLayout *batchLayout = new QHBoxLayout();
+    m_offsetSpin = new QDoubleSpinBox();
+    m_offsetSpin->setRange(-m_trackLength / 2, m_trackLength / 2);
+    m_offsetSpin->setDecimals(1);
+    m_offsetSpin->setSuffix(" mm");
+    m_commonSpeedSpin = new QSpinBox();
+    m_commonSpeedSpin->setRange(10, 1000);
+    m_commonSpeedSpin->setValue(100);
+    m_commonSpeedSpin->setSuffix(" mm/s");
+    QPushButton *applyBtn = new QPushButton("应用到参与动子");
+    batchLayout->addWidget(new QLabel("整体偏移:"));
+    batchLayout->addWidget(m_offsetSpin);
+    batchLayout->addWidget(new QLabel("统一速度:"));
+    batchLayout->addWidget(m_commonSpeedSpin);
+    batchLayout->addWidget(applyBtn);
+    mainLayout->addLayout(batchLayout);
+    connect(applyBtn, &QPushButton::clicked, this, &GroupMoveDialog::onApplyOffset);
+
+    m_statusLabel = new QLabel();
+    m_statusLabel->setWordWrap(true);
+    mainLayout->addWidget(m_statusLabel);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    m_commitBtn = new QPushButton("同时启动");
+    QPushButton *cancelBtn = new QPushButton("取消");
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(m_commitBtn);
+    buttonLayout->addWidget(cancelBtn);
+    mainLayout->addLayout(buttonLayout);
+
+    connect(m_commitBtn, &QPushButton::clicked, this, &GroupMoveDialog::accept);
+    connect(cancelBtn, &QPushButton::clicked, this, &GroupMoveDialog::reject);
+}
+
+void GroupMoveDialog::setValidator(Validator validator)
+{
+    m_validator = std::move(validator);
+    revalidate();
+}
+
+bool GroupMoveDialog::isRowChecked(int row) const
+{
+    const QTableWidgetItem *item = m_table->item(row, SelectColumn);
+    return item && item->checkState() == Qt::Checked;
+}
+
+QVector<ModbusManager::GroupMoveCommand> GroupMoveDialog::commands() const
+{
+    QVector<ModbusManager::GroupMoveCommand> result;
+    for (int row = 0; row < m_table->rowCount(); ++row) {
+        if (!isRowChecked(row)) {
+            continue;
+        }
+        ModbusManager::GroupMoveCommand command;
+        command.moverId = m_table->item(row, IdColumn)->data(Qt::UserRole).toInt();
+        command.targetPosition = m_targetSpins[row]->value();
+        command.speed = quint16(m_speedSpins[row]->value());
+        result.append(command);
+    }
+    return result;
+}
+
+void GroupMoveDialog::onApplyOffset()
+{
+    const double offset = m_offsetSpin->value();
+    for (int row = 0; row < m_table->rowCount(); ++row) {
+        if (!isRowChecked(row)) {
+            continue;
+        }
+        double target = std::fmod(m_positions[row] + offset, m_trackLength);
+        if (target < 0) target += m_trackLength;
+        m_targetSpins[row]->blockSignals(true);
+        m_speedSpins[row]->blockSignals(true);
+        m_targetSpins[row]->setValue(target);
+        m_speedSpins[row]->setValue(m_commonSpeedSpin->value());
+        m_targetSpins[row]->blockSignals(false);
+        m_speedSpins[row]->blockSignals(false);
+    }
+    revalidate();
+}
+
+// 每次修改后重新校验，结果显示在状态栏并控制提交按钮
+void GroupMoveDialog::revalidate()
+{
+    if (!m_statusLabel || !m_commitBtn) return;
+
+    const QVector<ModbusManager::GroupMoveCommand> selected = commands();
+    QString error;
+    if (selected.isEmpty()) {
+        error = "请勾选参与协同定位的动子";
+    } else if (selected.size() > ModbusRegisters::GroupMove::MAX_ENTRIES) {
+        error = QString("一次最多%1个动子").arg(ModbusRegisters::GroupMove::MAX_ENTRIES);
+    } else if (m_validator) {
+        error = m_validator(selected);
+    }
+
+    if (error.isEmpty()) {
+        m_statusLabel->setText(QString("✔ %1个动子的路径互不冲突，将在同一PLC周期内启动").arg(selected.size()));
+        m_statusLabel->setStyleSheet("color: #22c55e;");
+    } else {
+        m_statusLabel->setText("✖ " + error);
+        m_statusLabel->setStyleSheet("color: #ef4444;");
+    }
+    m_commitBtn->setEnabled(error.isEmpty());
+}
+
+void GroupMoveDialog::accept()
+{
+    revalidate();
+    if (!m_commitBtn->isEnabled()) {
+        return;
+    }
+    QDialog::accept();
+}
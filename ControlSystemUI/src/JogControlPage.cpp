@@ -22,9 +22,11 @@
 #include <QDebug>
 #include <QCheckBox>
 #include <QGroupBox>
+#include <QtMath>
 
 const double JogControlPage::TRACK_LENGTH = 7455.75;
 const double JogControlPage::SAFETY_DISTANCE = 100.0;
+const double JogControlPage::PREVIEW_JERK = 10000.0;
 
 JogControlPage::JogControlPage(QList<MoverData> *movers, const QString& currentUser, ModbusManager *modbusManager, QWidget *parent)
     : QWidget(parent)
@@ -33,35 +35,36 @@ JogControlPage::JogControlPage(QList<MoverData> *movers, const QString& currentU
     , m_currentUser(currentUser)
     , m_modbusManager(modbusManager)
     , m_longPressTimer(new QTimer(this))
-    , m_continuousJogTimer(new QTimer(this))
-    , m_realTimeUpdateTimer(new QTimer(this))
     , m_isRealTimeEnabled(false)
     , m_isLongPressing(false)
     , m_isContinuousJogging(false)
     , m_jogDirection(true)
-    , m_autoRunTimer(new QTimer(this))
+    , m_programEngine(nullptr)
     , m_isAutoRunActive(false)
     , m_isAutoRunPaused(false)
+    , m_replayActive(false)
     , m_autoRunStartBtn(nullptr)
     , m_autoRunPauseBtn(nullptr)
     , m_autoRunStopBtn(nullptr)
     , m_autoRunGroup(nullptr)
     , m_autoRunEnableCheckBox(nullptr)
     , m_mainWindow(qobject_cast<MainWindow*>(parent))
+    , m_ringIndex(TRACK_LENGTH)
 {
     // 设置定时器
     m_longPressTimer->setSingleShot(true);
-    m_realTimeUpdateTimer->setSingleShot(false);
-    m_continuousJogTimer->setSingleShot(false);
-    m_autoRunTimer->setInterval(AUTO_RUN_INTERVAL);
 
     // 连接定时器信号
     connect(m_longPressTimer, &QTimer::timeout, this, &JogControlPage::startContinuousJog);
-    connect(m_continuousJogTimer, &QTimer::timeout, this, &JogControlPage::performContinuousJog);
-    connect(m_realTimeUpdateTimer, &QTimer::timeout, this, &JogControlPage::onRealTimeDataUpdate);
-    connect(m_autoRunTimer, &QTimer::timeout, this, &JogControlPage::performAutoRunStep);
+
+    // 自动运行程序引擎，由主窗口的动子状态变化驱动
+    m_programEngine = new ProgramEngine(m_modbusManager, m_mainWindow ? &m_mainWindow->moverTelemetry() : nullptr,
+                                        TRACK_LENGTH, this);
+    connect(m_programEngine, &ProgramEngine::programFinished, this, &JogControlPage::onProgramFinished);
+    connect(m_programEngine, &ProgramEngine::programAborted, this, &JogControlPage::onProgramAborted);
 
     setupUI();
+    rebuildRingIndex();
     updateMoverInfo();
 
     addLogEntry(QString("Jog控制页面已加载 - 操作员: %1").arg(m_currentUser), "success");
@@ -74,10 +77,17 @@ JogControlPage::JogControlPage(QList<MoverData> *movers, const QString& currentU
     }
 
 
+    if (m_modbusManager) {
+        connect(m_modbusManager, &ModbusManager::jogSessionAborted, this, &JogControlPage::onJogSessionAborted);
+        connect(m_modbusManager, &ModbusManager::connected, this, &JogControlPage::startRealTimeUpdates);
+        connect(m_modbusManager, &ModbusManager::disconnected, this, &JogControlPage::onModbusDisconnected);
+    }
+
     // 在构造函数的最后添加
     if (m_mainWindow) {
             connect(m_mainWindow, &MainWindow::emergencyStopTriggered, this, &JogControlPage::onEmergencyStopTriggered);
             connect(m_mainWindow, &MainWindow::emergencyStopReset, this, &JogControlPage::onEmergencyStopReset);
+            connect(m_mainWindow, &MainWindow::replayModeChanged, this, &JogControlPage::onReplayModeChanged);
     }
 
 }
@@ -85,6 +95,9 @@ JogControlPage::JogControlPage(QList<MoverData> *movers, const QString& currentU
 JogControlPage::~JogControlPage()
 {
     stopLongPressDetection();
+    if (m_programEngine) {
+        m_programEngine->stopAll();
+    }
 }
 
 void JogControlPage::setupUI()
@@ -301,6 +314,26 @@ void JogControlPage::setupUI()
     }
 )");
 
+    QLabel *profileLabel = new QLabel("运动曲线:");
+    profileLabel->setStyleSheet("color: white; font-size: 11px;");
+    m_profileShapeCombo = new QComboBox();
+    m_profileShapeCombo->addItem("梯形", MotionProfile::Trapezoidal);
+    m_profileShapeCombo->addItem("S形", MotionProfile::SCurve);
+    m_profileShapeCombo->setStyleSheet(R"(
+        QComboBox {
+            background-color: #16213e;
+            color: white;
+            border: 1px solid #533483;
+            padding: 3px;
+            border-radius: 4px;
+        }
+    )");
+
+    // 预计用时、行程与冲突提示，随输入实时刷新
+    m_profilePreviewLabel = new QLabel();
+    m_profilePreviewLabel->setWordWrap(true);
+    m_profilePreviewLabel->setStyleSheet("color: #c4b5fd; font-size: 11px;");
+
     m_goToBtn = new QPushButton("移动到位置");
     m_stopBtn = new QPushButton("停止");
 
@@ -323,8 +356,11 @@ void JogControlPage::setupUI()
     positionLayout->addWidget(m_targetPosSpinBox, 0, 1, 1, 2);
     positionLayout->addWidget(speedLabel2, 1, 0);
     positionLayout->addWidget(m_speedSpinBox, 1, 1, 1, 2);
-    positionLayout->addWidget(m_goToBtn, 2, 0, 1, 3);
-    positionLayout->addWidget(m_stopBtn, 3, 0, 1, 3);
+    positionLayout->addWidget(profileLabel, 2, 0);
+    positionLayout->addWidget(m_profileShapeCombo, 2, 1, 1, 2);
+    positionLayout->addWidget(m_profilePreviewLabel, 3, 0, 1, 3);
+    positionLayout->addWidget(m_goToBtn, 4, 0, 1, 3);
+    positionLayout->addWidget(m_stopBtn, 5, 0, 1, 3);
 
     // === JOG控制组 ===
     QGroupBox *jogGroup = new QGroupBox("Jog控制 (单击/长按)");
@@ -502,6 +538,13 @@ void JogControlPage::setupUI()
     connect(m_jogBackwardBtn, &QPushButton::pressed, this, &JogControlPage::onJogBackwardPressed);
     connect(m_jogBackwardBtn, &QPushButton::released, this, &JogControlPage::onJogBackwardReleased);
     connect(m_goToBtn, &QPushButton::clicked, this, &JogControlPage::onGoToPosition);
+    // 目标、速度或曲线类型变化时重算定位预览
+    connect(m_targetPosSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &JogControlPage::updateMotionPreview);
+    connect(m_speedSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &JogControlPage::updateMotionPreview);
+    connect(m_profileShapeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &JogControlPage::updateMotionPreview);
     connect(m_stopBtn, &QPushButton::clicked, this, &JogControlPage::onStopMover);
 
     connect(m_enableBtn, &QPushButton::clicked, this, [this]() {
@@ -708,20 +751,47 @@ void JogControlPage::connectAutoRunSignals()
 
 /**
  * @brief 开始自动运行
+ *
+ * 为当前选中的动子启动往返程序：当前位置与目标位置之间往返，两端停留后再出发。
+ * 其他动子的程序继续运行，可依次选择动子加入。
  */
 void JogControlPage::onAutoRunStart() {
     if (!m_modbusManager || !m_modbusManager->isConnected()) {
         QMessageBox::warning(this, "PLC未连接", "请先连接PLC设备！");
         return;
     }
+    if (m_programEngine->isRunning(m_selectedMover)) {
+        addLogEntry(QString("动子%1已在自动运行中").arg(m_selectedMover), "warning");
+        return;
+    }
+
+    // 往返两段都要检查：按方向规则，返程不一定沿去程原路返回
+    const double targetPos = m_targetPosSpinBox->value();
+    const MotionProfile outbound = planGoToProfile(m_selectedMover, targetPos);
+    const MotionProfile inbound = planMoveProfile(m_selectedMover, outbound.endPosition(), outbound.startPosition());
+    if (!checkCollision(m_selectedMover, {outbound, inbound})) {
+        QMessageBox::warning(this, "碰撞风险", QString("动子%1的往返路径与相邻动子的距离小于安全距离%2 mm，自动运行未启动。")
+                                                   .arg(m_selectedMover).arg(SAFETY_DISTANCE));
+        return;
+    }
+
+    const MotionProgram program = buildShuttleProgram(m_selectedMover, targetPos, quint16(m_speedSpinBox->value()));
+    const QString error = m_programEngine->validate(program);
+    if (!error.isEmpty() || !m_programEngine->start(m_selectedMover, program)) {
+        QString reason = error;
+        if (reason.isEmpty()) {
+            reason = m_programEngine->isSingleAxisMode() && m_programEngine->runningCount() > 0
+                         ? "PLC不支持协同定位，单轴定位只能运行一个动子" : "PLC未就绪";
+        }
+        addLogEntry(QString("动子%1自动运行启动失败: %2").arg(m_selectedMover).arg(reason), "error");
+        return;
+    }
+
     m_isAutoRunActive = true;
-    m_isAutoRunPaused = false;
-    m_autoRunTimer->start();
-    m_autoRunStartBtn->setEnabled(false);
     m_autoRunPauseBtn->setEnabled(true);
     m_autoRunStopBtn->setEnabled(true);
     m_autoRunEnableCheckBox->setEnabled(false);
-    addLogEntry("自动运行已启动", "success");
+    addLogEntry(QString("动子%1自动运行已启动，共%2个动子运行中").arg(m_selectedMover).arg(m_programEngine->runningCount()), "success");
 }
 
 /**
@@ -730,14 +800,14 @@ void JogControlPage::onAutoRunStart() {
 void JogControlPage::onAutoRunPause() {
     if (m_isAutoRunPaused) {
         m_isAutoRunPaused = false;
-        m_autoRunTimer->start();
+        m_programEngine->setPaused(false);
         m_autoRunPauseBtn->setText("暂停");
         addLogEntry("自动运行已恢复", "info");
     } else {
         m_isAutoRunPaused = true;
-        m_autoRunTimer->stop();
+        m_programEngine->setPaused(true);
         m_autoRunPauseBtn->setText("继续");
-        addLogEntry("自动运行已暂停", "warning");
+        addLogEntry("自动运行已暂停，当前定位完成后不再继续", "warning");
     }
 }
 
@@ -747,14 +817,12 @@ void JogControlPage::onAutoRunPause() {
 void JogControlPage::onAutoRunStop() {
     m_isAutoRunActive = false;
     m_isAutoRunPaused = false;
-    m_autoRunTimer->stop();
 
-    // 发送停止命令，确保动子停下
-    if (m_modbusManager && m_modbusManager->isConnected()) {
-        m_modbusManager->setSingleAxisJog(0);
-    }
+    // 停止全部程序，引擎负责让动子停下
+    m_programEngine->stopAll();
+    m_programEngine->setPaused(false);
 
-    m_autoRunStartBtn->setEnabled(true);
+    m_autoRunStartBtn->setEnabled(m_autoRunEnableCheckBox->isChecked());
     m_autoRunPauseBtn->setEnabled(false);
     m_autoRunPauseBtn->setText("暂停");
     m_autoRunStopBtn->setEnabled(false);
@@ -762,94 +830,116 @@ void JogControlPage::onAutoRunStop() {
     addLogEntry("自动运行已停止", "info");
 }
 
+void JogControlPage::onProgramFinished(int moverId)
+{
+    addLogEntry(QString("动子%1自动运行程序已完成").arg(moverId), "info");
+    if (m_isAutoRunActive && m_programEngine->runningCount() == 0) {
+        onAutoRunStop();
+    }
+}
+
+void JogControlPage::onProgramAborted(int moverId, const QString &reason)
+{
+    addLogEntry(QString("动子%1自动运行中止: %2").arg(moverId).arg(reason), "error");
+    if (m_isAutoRunActive && m_programEngine->runningCount() == 0) {
+        onAutoRunStop();
+    }
+}
 
 /**
- * @brief 自动运行的定时器执行函数
+ * @brief PLC断开时结束自动运行
  *
- * 此函数现在使用新的ModbusManager接口来发送周期性的JOG命令。
+ * 断开后不再有状态变化推进程序，等待到位的步骤会一直挂起，重连后又会继续发出定位命令。
  */
-void JogControlPage::performAutoRunStep()
+void JogControlPage::onModbusDisconnected()
 {
-    if (!m_isAutoRunActive || m_isAutoRunPaused || !m_modbusManager || !m_modbusManager->isConnected()) {
-        // 如果中途断开连接，则停止自动运行
-        if (m_isAutoRunActive) {
-            onAutoRunStop();
-            addLogEntry("PLC连接断开，自动运行已停止", "error");
-        }
-        return;
+    if (m_isAutoRunActive) {
+        onAutoRunStop();
+        addLogEntry("PLC连接断开，自动运行已停止", "error");
     }
+    stopRealTimeUpdates();
+}
 
-    // 这是一个非常简单的自动运行逻辑：持续向前JOG
-    // 可以在此基础上扩展更复杂的逻辑，例如到达边界后反向
-    bool isForward = true; // 可根据需要修改为更复杂的逻辑
-    int direction = isForward ? 2 : 1; // 2=前进, 1=后退
-
-    // 使用新的Modbus接口
-    m_modbusManager->setSingleAxisRunMode(false); // 确保是手动/点动模式
-    m_modbusManager->setSingleAxisJogSpeed(m_speedSpinBox->value());
-    m_modbusManager->setSingleAxisJog(direction);
+/**
+ * @brief 生成往返程序：到目标位置、到位后停留，回到出发位置、到位后停留，无限循环
+ */
+MotionProgram JogControlPage::buildShuttleProgram(int moverId, double targetPosition, quint16 speed) const
+{
+    const double origin = (m_movers && moverId < m_movers->size()) ? (*m_movers)[moverId].position : 0.0;
+    return {
+        ProgramStep::moveTo(targetPosition, speed),
+        ProgramStep::waitInPosition(),
+        ProgramStep::dwell(AUTO_RUN_DWELL_MS),
+        ProgramStep::moveTo(origin, speed),
+        ProgramStep::waitInPosition(),
+        ProgramStep::dwell(AUTO_RUN_DWELL_MS),
+        ProgramStep::loop(0)
+    };
 }
 
 /**
  * @brief 按下JOG按钮（前进/后退）
  *
+ * 按下即启动点动会话，松开时结束；会话期间由ModbusManager保活，不再周期重发点动命令。
  * 如果PLC未连接，则不执行任何操作。
  */
 void JogControlPage::onJogForwardPressed()
 {
-    if (!m_modbusManager || !m_modbusManager->isConnected()) return;
-
-    m_modbusManager->setSingleAxisRunMode(false); // 设置为手动模式
-    m_modbusManager->setSingleAxisJogSpeed(m_speedSpinBox->value());
-    m_modbusManager->setSingleAxisJogPosition(m_jogStepSpinBox->value());
-    m_modbusManager->setSingleAxisJog(2); // 2 = 向右/前进
-    addLogEntry("JOG前进按下", "info");
+    startLongPressDetection(true);
 }
 
 /**
  * @brief 松开JOG按钮
- *
- * 如果PLC未连接，则不执行任何操作。
  */
 void JogControlPage::onJogForwardReleased()
 {
-    if (!m_modbusManager || !m_modbusManager->isConnected()) return;
-    m_modbusManager->setSingleAxisJog(0); // 0 = 停止
-    addLogEntry("JOG前进松开", "info");
+    stopLongPressDetection();
 }
 
 void JogControlPage::onJogBackwardPressed()
 {
-    if (!m_modbusManager || !m_modbusManager->isConnected()) return;
-
-    m_modbusManager->setSingleAxisRunMode(false);
-    m_modbusManager->setSingleAxisJogSpeed(m_speedSpinBox->value());
-    m_modbusManager->setSingleAxisJogPosition(m_jogStepSpinBox->value());
-    m_modbusManager->setSingleAxisJog(1); // 1 = 向左/后退
-    addLogEntry("JOG后退按下", "info");
+    startLongPressDetection(false);
 }
 
 void JogControlPage::onJogBackwardReleased()
 {
-    if (!m_modbusManager || !m_modbusManager->isConnected()) return;
-    m_modbusManager->setSingleAxisJog(0); // 0 = 停止
-    addLogEntry("JOG后退松开", "info");
+    stopLongPressDetection();
 }
 
-void JogControlPage::startLongPressDetection(bool isForward)
+/**
+ * @brief 点动会话异常中止（保活失败或连接断开）
+ *
+ * PLC侧已由会话停止或保活超时停下，这里只复位界面状态。
+ */
+void JogControlPage::onJogSessionAborted(const QString &reason)
 {
+    m_isLongPressing = false;
+    m_isContinuousJogging = false;
+    m_longPressTimer->stop();
+    addLogEntry(QString("点动已中止：%1").arg(reason), "error");
+    updateMoverInfo();
+}
 
-    if (m_isContinuousJogging) {
-        return;  // 如果已经在连续JOG中，忽略新的按下事件
+void JogControlPage::startLongPressDetection(bool isForward)
+{
+    if (m_isLongPressing || m_isContinuousJogging) {
+        return;  // 已经在点动中，忽略新的按下事件
     }
+    if (!m_modbusManager || !m_modbusManager->isConnected()) return;
 
-    m_isLongPressing = true;
     m_jogDirection = isForward;
+    m_modbusManager->setSingleAxisRunMode(false); // 设置为手动模式
+    m_modbusManager->setSingleAxisJogSpeed(m_speedSpinBox->value());
+    m_modbusManager->setSingleAxisJogPosition(m_jogStepSpinBox->value());
+    if (!m_modbusManager->startJogSession(isForward ? 2 : 1)) { // 2 = 向右/前进, 1 = 向左/后退
+        addLogEntry(QString("JOG%1启动失败").arg(isForward ? "前进" : "后退"), "error");
+        return;
+    }
+    m_isLongPressing = true;
+    addLogEntry(QString("JOG%1按下").arg(isForward ? "前进" : "后退"), "info");
 
-    // 启动长按检测定时器
+    // 超过长按阈值仍未松开时视为连续点动，仅用于提示
     m_longPressTimer->start(LONG_PRESS_THRESHOLD);
-
-    //addLogEntry(QString("检测到%1按钮按下").arg(isForward ? "前进" : "后退"), "info"); 这个日志输出太频繁了，建议不要开启
 }
 
 void JogControlPage::stopLongPressDetection()
@@ -858,24 +948,20 @@ void JogControlPage::stopLongPressDetection()
     bool wasContinuous = m_isContinuousJogging;
 
     m_isLongPressing = false;
+    m_isContinuousJogging = false;
     m_longPressTimer->stop();
 
-    if (m_isContinuousJogging) {
-        // 停止连续JOG
-        m_isContinuousJogging = false;
-        m_continuousJogTimer->stop();
-        addLogEntry(QString("停止连续%1").arg(m_jogDirection ? "前进" : "后退"), "info");
-
-        // 确保在PLC模式下发送停止命令
-        if (m_modbusManager && m_modbusManager->isConnected()) {
-            m_modbusManager->setSingleAxisJog(0); // 0 = 停止
-        }
+    // 结束会话：停止请求插入发送队列队首
+    if ((wasLongPressing || wasContinuous) && m_modbusManager) {
+        m_modbusManager->stopJogSession();
+    }
 
+    if (wasContinuous) {
+        addLogEntry(QString("停止连续%1").arg(m_jogDirection ? "前进" : "后退"), "info");
         // 立即更新UI显示
         updateMoverInfo();
-
-    } else if (wasLongPressing && !wasContinuous) {
-        addLogEntry("完成一次单击JOG操作", "info");
+    } else if (wasLongPressing) {
+        addLogEntry(QString("JOG%1松开").arg(m_jogDirection ? "前进" : "后退"), "info");
     }
 }
 
@@ -885,20 +971,9 @@ void JogControlPage::startContinuousJog()
         return;  // 如果不在长按状态，不启动连续JOG
     }
 
+    // 会话已在按下时启动，由保活维持，无需周期重发点动命令
     m_isContinuousJogging = true;
     addLogEntry(QString("开始连续%1").arg(m_jogDirection ? "前进" : "后退"), "success");
-
-    // 立即执行一次JOG
-    performContinuousJog();
-
-    // 启动连续JOG定时器
-    m_continuousJogTimer->start(CONTINUOUS_JOG_INTERVAL);
-}
-
-void JogControlPage::performContinuousJog()
-{
-    if (!m_isContinuousJogging || !m_modbusManager || !m_modbusManager->isConnected()) return;
-    m_modbusManager->setSingleAxisJog(m_jogDirection ? 2 : 1);
 }
 
 void JogControlPage::onGoToPosition()
@@ -909,7 +984,15 @@ void JogControlPage::onGoToPosition()
     }
     double targetPos = m_targetPosSpinBox->value();
     qint32 targetSpeed = m_speedSpinBox->value();
-    addLogEntry(QString("发送绝对定位命令: 位置=%1 mm, 速度=%2 mm/s").arg(targetPos).arg(targetSpeed), "info");
+    const MotionProfile profile = planGoToProfile(m_selectedMover, targetPos);
+    if (!checkCollision(m_selectedMover, {profile})) {
+        addLogEntry(QString("动子%1前往%2 mm的路径与相邻动子距离不足，已取消").arg(m_selectedMover).arg(targetPos), "error");
+        QMessageBox::warning(this, "碰撞风险", QString("动子%1的运动路径与相邻动子的距离小于安全距离%2 mm，命令未发送。")
+                                                   .arg(m_selectedMover).arg(SAFETY_DISTANCE));
+        return;
+    }
+    addLogEntry(QString("发送绝对定位命令: 位置=%1 mm, 速度=%2 mm/s，预计用时 %3 s")
+                    .arg(targetPos).arg(targetSpeed).arg(profile.duration(), 0, 'f', 2), "info");
 
     // 使用新接口执行绝对定位
     m_modbusManager->setSingleAxisRunMode(true);
@@ -961,7 +1044,16 @@ void JogControlPage::updateMoverInfo()
     }
 }
 
-bool JogControlPage::checkCollision(int moverId, double targetPosition)
+/**
+ * @brief 检查动子从当前位置依次走完各段行程的路径是否与相邻动子冲突
+ *
+ * 各段按规划时的方向和行程累加，得到相对当前位置向前、向后扫过的最远距离，
+ * 再通过环线顺序索引只与前后两个邻居比较。
+ * 邻居的计划路径取自遥测表中的目标位置，间距下限为 SAFETY_DISTANCE。
+ * @param legs 依次执行的定位曲线，第一段从动子当前位置出发
+ * @return true 表示路径安全
+ */
+bool JogControlPage::checkCollision(int moverId, const QVector<MotionProfile> &legs)
 {
     if (!m_movers || moverId < 0 || moverId >= m_movers->size()) {
         return false;
@@ -972,25 +1064,135 @@ bool JogControlPage::checkCollision(int moverId, double targetPosition)
         return true;
     }
 
-    try {
-        // 多动子系统的碰撞检测
-        for (int i = 0; i < m_movers->size(); ++i) {
-            if (i == moverId) continue;
-
-            double otherPosition = (*m_movers)[i].position;
-            double distance = calculateShortestDistance(targetPosition, otherPosition);
-
-            if (distance < SAFETY_DISTANCE) {
-                qDebug() << QString("碰撞检测：动子%1目标位置%2mm与动子%3当前位置%4mm距离过近(%5mm < %6mm)")
-                                .arg(moverId).arg(targetPosition, 0, 'f', 1)
-                                .arg(i).arg(otherPosition, 0, 'f', 1)
-                                .arg(distance, 0, 'f', 1).arg(SAFETY_DISTANCE);
-                return false;
-            }
+    if (m_ringIndex.size() != m_movers->size()) {
+        rebuildRingIndex();
+    }
+
+    double offset = 0.0;
+    double backReach = 0.0;
+    double forwardReach = 0.0;
+    for (const MotionProfile &leg : legs) {
+        offset += leg.direction() * leg.distance();
+        backReach = qMin(backReach, offset);
+        forwardReach = qMax(forwardReach, offset);
+    }
+
+    const MoverRingIndex::Conflict conflict =
+        m_ringIndex.checkSpan(moverId, backReach, forwardReach, plannedTargets(), SAFETY_DISTANCE);
+    return !conflict.isValid();
+}
+
+/**
+ * @brief 以动子编号为下标的计划目标位置
+ *
+ * 运行中的动子取遥测表中的目标位置，其余视为停在原地（NaN）。
+ */
+QVector<double> JogControlPage::plannedTargets() const
+{
+    const int count = m_movers ? m_movers->size() : 0;
+    QVector<double> targets(count, qQNaN());
+    const MoverTelemetryTable *telemetry = m_mainWindow ? &m_mainWindow->moverTelemetry() : nullptr;
+    if (!telemetry || telemetry->size() != count) {
+        return targets;
+    }
+    for (int i = 0; i < count; ++i) {
+        if (telemetry->status[i] == MoverStatusCode::Running) {
+            targets[i] = telemetry->target[i];
         }
-        return true;
-    } catch (...) {
-        return false;
+    }
+    return targets;
+}
+
+/**
+ * @brief 按当前位置重建环线顺序索引（动子数量变化或整表刷新时）
+ */
+void JogControlPage::rebuildRingIndex()
+{
+    if (!m_movers) return;
+    const MoverTelemetryTable *telemetry = m_mainWindow ? &m_mainWindow->moverTelemetry() : nullptr;
+    if (telemetry && telemetry->size() == m_movers->size()) {
+        m_ringIndex.reset(telemetry->position);
+        return;
+    }
+    QVector<double> positions;
+    positions.reserve(m_movers->size());
+    for (const MoverData &mover : *m_movers) {
+        positions.append(mover.position);
+    }
+    m_ringIndex.reset(positions);
+}
+
+/**
+ * @brief 按选中动子的加速度、方向规则和界面上的速度规划定位曲线
+ */
+MotionProfile JogControlPage::planGoToProfile(int moverId, double targetPosition) const
+{
+    if (!m_movers || moverId < 0 || moverId >= m_movers->size()) {
+        return MotionProfile();
+    }
+    const MoverTelemetryTable *telemetry = m_mainWindow ? &m_mainWindow->moverTelemetry() : nullptr;
+    const double start = telemetry && telemetry->size() == m_movers->size()
+                             ? telemetry->position[moverId] : (*m_movers)[moverId].position;
+    return planMoveProfile(moverId, start, targetPosition);
+}
+
+/**
+ * @brief 按选中动子的参数规划从start出发的定位曲线（用于往返的返程等）
+ */
+MotionProfile JogControlPage::planMoveProfile(int moverId, double start, double targetPosition) const
+{
+    if (!m_movers || moverId < 0 || moverId >= m_movers->size()) {
+        return MotionProfile();
+    }
+    const MoverData &mover = (*m_movers)[moverId];
+
+    MotionProfile::Limits limits;
+    limits.maxSpeed = m_speedSpinBox ? m_speedSpinBox->value() : mover.targetSpeed;
+    limits.acceleration = mover.acceleration > 0.0 ? mover.acceleration : mover.targetAcceleration;
+    limits.jerk = PREVIEW_JERK;
+    const MotionProfile::Shape shape = m_profileShapeCombo
+        ? static_cast<MotionProfile::Shape>(m_profileShapeCombo->currentData().toInt())
+        : MotionProfile::Trapezoidal;
+    return MotionProfile::plan(start, targetPosition, TRACK_LENGTH, mover.movementDirection, shape, limits);
+}
+
+/**
+ * @brief 重算定位预览：用时、行程、虚影轨迹，并交给碰撞监视器推演
+ *
+ * 规划是解析计算，推演只看前后两个邻居，可以在每次输入变化时调用。
+ */
+void JogControlPage::updateMotionPreview()
+{
+    if (!m_profilePreviewLabel || !m_targetPosSpinBox) return;
+
+    const MotionProfile profile = planGoToProfile(m_selectedMover, m_targetPosSpinBox->value());
+    if (!profile.isValid() || profile.distance() <= 0.0) {
+        m_profilePreviewLabel->clear();
+        if (m_trackWidget) m_trackWidget->clearMotionPreview();
+        return;
+    }
+
+    CollisionAlert conflict;
+    if (m_mainWindow) {
+        conflict = m_mainWindow->collisionMonitor().checkProfile(m_selectedMover, profile,
+                                                                 m_mainWindow->moverTelemetry());
+    }
+    const bool hasConflict = conflict.level != CollisionLevel::None;
+
+    QString text = QString("预计用时 %1 s · %2 %3 mm · 峰值 %4 mm/s")
+                       .arg(profile.duration(), 0, 'f', 2)
+                       .arg(profile.direction() > 0 ? "前进" : "后退")
+                       .arg(profile.distance(), 0, 'f', 1)
+                       .arg(profile.peakSpeed(), 0, 'f', 0);
+    if (hasConflict) {
+        text += QString("\n⚠ 约 %1 s 后与动子%2间距小于安全距离")
+                    .arg(conflict.timeToViolation, 0, 'f', 2).arg(conflict.aheadId);
+    }
+    m_profilePreviewLabel->setText(text);
+    m_profilePreviewLabel->setStyleSheet(hasConflict ? "color: #f87171; font-size: 11px;"
+                                                     : "color: #c4b5fd; font-size: 11px;");
+    if (m_trackWidget) {
+        m_trackWidget->setMotionPreview(profile, hasConflict);
     }
 }
 
@@ -1014,7 +1216,11 @@ double JogControlPage::normalizePosition(double position)
 void JogControlPage::updateMovers(const QList<MoverData> &movers)
 {
     if (!m_movers) return;
-    *m_movers = movers;
+    // 信号携带的就是主窗口的列表本身，避免自赋值
+    if (&movers != m_movers) {
+        *m_movers = movers;
+    }
+    rebuildRingIndex();
     if (m_trackWidget) {
         m_trackWidget->updateMovers(*m_movers);
     }
@@ -1024,6 +1230,45 @@ void JogControlPage::updateMovers(const QList<MoverData> &movers)
     }
 }
 
+void JogControlPage::onMoversChanged(const QVector<int> &changedIds, quint64 generation)
+{
+    Q_UNUSED(generation)
+    if (!m_movers) return;
+
+    // 先推进自动运行程序，步骤间延迟只取决于这次状态反馈；回放帧不是实时反馈，不能推进程序
+    if (m_programEngine && !m_replayActive) {
+        m_programEngine->update(changedIds);
+    }
+
+    // 只把发生变化的动子在顺序索引中挪位
+    if (m_ringIndex.size() != m_movers->size()) {
+        rebuildRingIndex();
+    } else {
+        for (int id : changedIds) {
+            if (id >= 0 && id < m_movers->size()) {
+                m_ringIndex.updatePosition(id, (*m_movers)[id].position);
+            }
+        }
+    }
+
+    if (m_trackWidget) {
+        m_trackWidget->updateMovers(*m_movers, changedIds);
+    }
+    // 只有当前选中的动子变化时才刷新信息面板
+    if (changedIds.contains(m_selectedMover) && m_selectedMover < m_movers->size()) {
+        updateMoverInfo();
+        updateEnableStatusDisplay((*m_movers)[m_selectedMover].isEnabled);
+        updateMotionPreview();
+    }
+}
+
+void JogControlPage::onCollisionAlertsChanged(const QVector<CollisionAlert> &alerts)
+{
+    if (m_trackWidget) {
+        m_trackWidget->setCollisionAlerts(alerts);
+    }
+}
+
 void JogControlPage::onMoverSelectionChanged(int index)
 {
     if (!m_movers || index < 0 || index >= m_movers->size()) {
@@ -1041,6 +1286,7 @@ void JogControlPage::onMoverSelectionChanged(int index)
         if (m_targetPosSpinBox) {
             m_targetPosSpinBox->setValue((*m_movers)[index].position);
         }
+        updateMotionPreview();
 
         addLogEntry(QString("已选择动子 %1").arg(index), "info");
         // 在这里添加以下两行代码：
@@ -1148,23 +1394,44 @@ void JogControlPage::onEmergencyStopReset()
 {
     m_emergencyActive = false;
 
-    // 重新启用控制按钮
-    if (m_jogForwardBtn) m_jogForwardBtn->setEnabled(true);
-    if (m_jogBackwardBtn) m_jogBackwardBtn->setEnabled(true);
-    if (m_goToBtn) m_goToBtn->setEnabled(true);
-    if (m_enableBtn) m_enableBtn->setEnabled(true);
-    if (m_disableBtn) m_disableBtn->setEnabled(true);
+    // 重新启用控制按钮（轨迹回放期间保持禁用）
+    const bool controlsEnabled = !m_replayActive;
+    if (m_jogForwardBtn) m_jogForwardBtn->setEnabled(controlsEnabled);
+    if (m_jogBackwardBtn) m_jogBackwardBtn->setEnabled(controlsEnabled);
+    if (m_goToBtn) m_goToBtn->setEnabled(controlsEnabled);
+    if (m_enableBtn) m_enableBtn->setEnabled(controlsEnabled);
+    if (m_disableBtn) m_disableBtn->setEnabled(controlsEnabled);
     // 重新启用自动运行控件
-    if (m_autoRunGroup) m_autoRunGroup->setEnabled(true);
+    if (m_autoRunGroup) m_autoRunGroup->setEnabled(controlsEnabled);
 
     // 恢复正常背景
     setStyleSheet("");
     addLogEntry("✅ 急停已重置 - 操作权限已恢复", "success");
 }
 
+void JogControlPage::onReplayModeChanged(bool active)
+{
+    m_replayActive = active;
+    if (active) {
+        stopLongPressDetection();
+        if (m_isAutoRunActive) {onAutoRunStop();}
+    }
+
+    // 急停期间按钮保持禁用，由急停复位恢复
+    const bool controlsEnabled = !active && !m_emergencyActive;
+    if (m_jogForwardBtn) m_jogForwardBtn->setEnabled(controlsEnabled);
+    if (m_jogBackwardBtn) m_jogBackwardBtn->setEnabled(controlsEnabled);
+    if (m_goToBtn) m_goToBtn->setEnabled(controlsEnabled);
+    if (m_enableBtn) m_enableBtn->setEnabled(controlsEnabled);
+    if (m_disableBtn) m_disableBtn->setEnabled(controlsEnabled);
+    if (m_autoRunGroup) m_autoRunGroup->setEnabled(controlsEnabled);
+
+    addLogEntry(active ? "轨迹回放中，控制命令已禁用" : "退出轨迹回放，控制命令已恢复", "info");
+}
+
 // 启动实时数据更新
 /**
- * @brief 启动实时数据更新定时器
+ * @brief 连接可用时启用控制（动子数据由主窗口的moversChanged增量信号刷新）
  */
 void JogControlPage::startRealTimeUpdates()
 {
@@ -1190,20 +1457,7 @@ void JogControlPage::stopRealTimeUpdates()
     }
 }
 
-// 实时数据更新处理
-/**
- * @brief 定时器触发的实时数据更新函数
- *
- * 完全依赖ModbusManager从PLC批量读取所有动子的最新数据。
- */
-void JogControlPage::onRealTimeDataUpdate()
-{
-    if (!m_modbusManager || !m_modbusManager->isConnected() || !m_movers) {
-        stopRealTimeUpdates();
-        return;
-    }
-    m_modbusManager->readAllMoverData(*m_movers);
-    updateMovers(*m_movers);
+    // 数据刷新由主窗口的moversChanged增量信号驱动，这里只负责连接监视
 }
 
 void JogControlPage::addLogEntry(const QString &message, const QString &type)
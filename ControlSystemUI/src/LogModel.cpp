@@ -0,0 +1,163 @@
+#include "LogModel.h"
+#include <QPainter>
+#include <utility>
+
+// --- LogModel ---
+
+LogModel::LogModel(int capacity, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_records(qMax(1, capacity))
+{
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_count) {
+        return QVariant();
+    }
+
+    const LogRecord &record = m_records[physicalIndex(index.row())];
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::ToolTipRole:
+        return plainText(index.row());
+    case TimestampRole:
+        return record.timestamp;
+    case UserNameRole:
+        return record.user;
+    case LevelTextRole:
+        return record.levelText;
+    case LevelColorRole:
+        return record.levelColor;
+    case MessageRole:
+        return record.message;
+    default:
+        return QVariant();
+    }
+}
+
+bool LogModel::append(const LogRecord &record)
+{
+    bool evicted = false;
+    if (m_count == capacity()) {
+        // 淘汰最旧条目：只移动头指针，其占用的槽位随后被新条目复用
+        beginRemoveRows(QModelIndex(), 0, 0);
+        m_head = (m_head + 1) % capacity();
+        --m_count;
+        endRemoveRows();
+        evicted = true;
+    }
+
+    beginInsertRows(QModelIndex(), m_count, m_count);
+    m_records[physicalIndex(m_count)] = record;
+    ++m_count;
+    endInsertRows();
+    return evicted;
+}
+
+int LogModel::setCapacity(int capacity)
+{
+    capacity = qMax(1, capacity);
+    if (capacity == this->capacity()) {
+        return 0;
+    }
+
+    const int evicted = qMax(0, m_count - capacity);
+    if (evicted > 0) {
+        beginRemoveRows(QModelIndex(), 0, evicted - 1);
+    }
+
+    // 按逻辑顺序搬到新数组，头指针归零
+    QVector<LogRecord> records(capacity);
+    const int kept = m_count - evicted;
+    for (int i = 0; i < kept; ++i) {
+        records[i] = std::move(m_records[physicalIndex(evicted + i)]);
+    }
+    m_records = std::move(records);
+    m_head = 0;
+    m_count = kept;
+
+    if (evicted > 0) {
+        endRemoveRows();
+    }
+    return evicted;
+}
+
+void LogModel::clear()
+{
+    beginResetModel();
+    m_records = QVector<LogRecord>(capacity());
+    m_head = 0;
+    m_count = 0;
+    endResetModel();
+}
+
+QString LogModel::plainText(int row) const
+{
+    const LogRecord &record = m_records[physicalIndex(row)];
+    QString text;
+    if (!record.timestamp.isEmpty()) {
+        text += QString("[%1] ").arg(record.timestamp);
+    }
+    if (!record.user.isEmpty()) {
+        text += QString("[%1] ").arg(record.user);
+    }
+    text += QString("[%1] %2").arg(record.levelText, record.message);
+    return text;
+}
+
+// --- LogItemDelegate ---
+
+void LogItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    QStyleOptionViewItem opt = option;
+    initStyleOption(&opt, index);
+
+    painter->save();
+    if (opt.state & QStyle::State_Selected) {
+        painter->fillRect(opt.rect, opt.palette.highlight());
+    }
+    painter->setFont(opt.font);
+
+    const QFontMetrics fm(opt.font);
+    const int spacing = fm.horizontalAdvance(QLatin1Char(' '));
+    QRect textRect = opt.rect.adjusted(4, 0, -4, 0);
+
+    // 逐段绘制，空字段跳过
+    auto drawSegment = [&](const QString &text, const QColor &color) {
+        if (text.isEmpty() || textRect.width() <= 0) {
+            return;
+        }
+        painter->setPen(color);
+        const QString elided = fm.elidedText(text, Qt::ElideRight, textRect.width());
+        painter->drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter, elided);
+        textRect.setLeft(textRect.left() + fm.horizontalAdvance(elided) + spacing);
+    };
+
+    const QString timestamp = index.data(LogModel::TimestampRole).toString();
+    const QString user = index.data(LogModel::UserNameRole).toString();
+    const QColor levelColor = index.data(LogModel::LevelColorRole).value<QColor>();
+
+    if (!timestamp.isEmpty()) {
+        drawSegment(QString("[%1]").arg(timestamp), QColor("#888"));
+    }
+    if (!user.isEmpty()) {
+        drawSegment(QString("[%1]").arg(user), QColor("#3b82f6"));
+    }
+    drawSegment(QString("[%1]").arg(index.data(LogModel::LevelTextRole).toString()), levelColor);
+    drawSegment(index.data(LogModel::MessageRole).toString(), levelColor);
+
+    painter->restore();
+}
+
+QSize LogItemDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(index)
+    // 固定行高，视图按统一行高计算滚动范围
+    return QSize(option.rect.width(), option.fontMetrics.height() + 4);
+}
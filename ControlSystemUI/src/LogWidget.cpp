@@ -1,5 +1,4 @@
 #include "LogWidget.h"
-#include <QRegularExpression>
 
 LogWidget::LogWidget(const QString &title, QWidget *parent)
     : QWidget(parent)
@@ -7,8 +6,8 @@ LogWidget::LogWidget(const QString &title, QWidget *parent)
     , m_autoScroll(true)
     , m_showTimestamp(true)
     , m_showUser(true)
-    , m_currentLineCount(0)
     , m_title(title)
+    , m_model(nullptr)
 {
     setupUI();
     setupStyles();
@@ -30,10 +29,16 @@ void LogWidget::setupUI()
 
     QVBoxLayout *groupLayout = new QVBoxLayout(m_groupBox);
 
-    // 日志显示区域
-    m_logDisplay = new QTextEdit();
-    m_logDisplay->setReadOnly(true);
-    groupLayout->addWidget(m_logDisplay);
+    // 日志显示区域：统一行高的列表视图只绘制可见行
+    m_model = new LogModel(m_maxLines, this);
+    m_logView = new QListView();
+    m_logView->setModel(m_model);
+    m_logView->setItemDelegate(new LogItemDelegate(m_logView));
+    m_logView->setUniformItemSizes(true);
+    m_logView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_logView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_logView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    groupLayout->addWidget(m_logView);
 
     // 按钮布局
     m_buttonLayout = new QHBoxLayout();
@@ -73,7 +78,7 @@ void LogWidget::setupStyles()
     )";
 
     QString logDisplayStyle = R"(
-        QTextEdit {
+        QListView {
             background-color: #0a0e27;
             color: #00ff41;
             font-family: 'Consolas', monospace;
@@ -97,29 +102,22 @@ void LogWidget::setupStyles()
     )";
 
     m_groupBox->setStyleSheet(groupBoxStyle);
-    m_logDisplay->setStyleSheet(logDisplayStyle);
+    m_logView->setStyleSheet(logDisplayStyle);
     m_clearBtn->setStyleSheet(buttonStyle);
     m_exportBtn->setStyleSheet(buttonStyle);
 }
 
 void LogWidget::addLogEntry(const QString &message, LogLevel level, const QString &user)
 {
-    QString formattedEntry = formatLogEntry(message, level, user);
-
-    // 添加到缓存
-    m_logEntries.append(formattedEntry);
-
-    // 显示日志
-    m_logDisplay->append(formattedEntry);
-    m_currentLineCount++;
+    // 容量已满时模型在O(1)内淘汰最旧条目
+    if (m_model->append(makeRecord(message, level, user))) {
+        emit logLimitReached(m_maxLines);
+    }
 
     // 自动滚动到底部
     if (m_autoScroll) {
-        m_logDisplay->moveCursor(QTextCursor::End);
+        m_logView->scrollToBottom();
     }
-
-    // 检查是否需要裁剪
-    trimLogIfNeeded();
 }
 
 void LogWidget::addLogEntry(const QString &message, const QString &type, const QString &user)
@@ -128,46 +126,23 @@ void LogWidget::addLogEntry(const QString &message, const QString &type, const Q
     addLogEntry(message, level, user);
 }
 
-QString LogWidget::formatLogEntry(const QString &message, LogLevel level, const QString &user)
+LogModel::LogRecord LogWidget::makeRecord(const QString &message, LogLevel level, const QString &user) const
 {
-    QString timestamp = m_showTimestamp ?
-                            QDateTime::currentDateTime().toString("hh:mm:ss") : "";
-
-    QString levelColor = getLevelColor(level);
-    QString levelStr = getLevelString(level);
-
-    QString formattedEntry;
-
-    if (m_showTimestamp && m_showUser && !user.isEmpty()) {
-        formattedEntry = QString("<span style='color: #888;'>[%1]</span> "
-                                 "<span style='color: #3b82f6;'>[%2]</span> "
-                                 "<span style='color: %3;'>[%4]</span> "
-                                 "<span style='color: %3;'>%5</span>")
-                             .arg(timestamp,
-                                 user,
-                                 levelColor,
-                                 levelStr,
-                                 message);
-    } else if (m_showTimestamp) {
-        formattedEntry = QString("<span style='color: #888;'>[%1]</span> "
-                                 "<span style='color: %2;'>[%3]</span> "
-                                 "<span style='color: %2;'>%4</span>")
-                             .arg(timestamp,
-                             levelColor,
-                             levelStr,
-                             message);
-    } else {
-        formattedEntry = QString("<span style='color: %1;'>[%2]</span> "
-                                 "<span style='color: %1;'>%3</span>")
-                             .arg(levelColor,
-                                 levelStr,
-                                 message);
+    LogModel::LogRecord record;
+    if (m_showTimestamp) {
+        record.timestamp = QDateTime::currentDateTime().toString("hh:mm:ss");
+        // 用户只在同时显示时间戳时显示
+        if (m_showUser) {
+            record.user = user;
+        }
     }
-
-    return formattedEntry;
+    record.levelText = getLevelString(level);
+    record.levelColor = QColor(getLevelColor(level));
+    record.message = message;
+    return record;
 }
 
-QString LogWidget::getLevelColor(LogLevel level)
+QString LogWidget::getLevelColor(LogLevel level) const
 {
     switch (level) {
     case Info:    return "#3b82f6";
@@ -178,7 +153,7 @@ QString LogWidget::getLevelColor(LogLevel level)
     }
 }
 
-QString LogWidget::getLevelString(LogLevel level)
+QString LogWidget::getLevelString(LogLevel level) const
 {
     switch (level) {
     case Info:    return "信息";
@@ -197,32 +172,9 @@ LogWidget::LogLevel LogWidget::stringToLevel(const QString &type)
     else return Info;
 }
 
-void LogWidget::trimLogIfNeeded()
-{
-    if (m_currentLineCount > m_maxLines) {
-        // 移除前面的日志条目
-        int linesToRemove = m_currentLineCount - m_maxLines;
-        for (int i = 0; i < linesToRemove && !m_logEntries.isEmpty(); ++i) {
-            m_logEntries.removeFirst();
-        }
-
-        // 重新构建显示
-        m_logDisplay->clear();
-        for (const QString &entry : static_cast<const QStringList&>(m_logEntries)) {
-            m_logDisplay->append(entry);
-        }
-
-        m_currentLineCount = m_logEntries.size();
-
-        emit logLimitReached(m_maxLines);
-    }
-}
-
 void LogWidget::clearLog()
 {
-    m_logDisplay->clear();
-    m_logEntries.clear();
-    m_currentLineCount = 0;
+    m_model->clear();
     emit logCleared();
 }
 
@@ -257,15 +209,12 @@ bool LogWidget::saveLogToFile(const QString &fileName)
     // 写入头部信息
     out << QString("=== %1 日志导出 ===\n").arg(m_title);
     out << QString("导出时间: %1\n").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"));
-    out << QString("日志条目: %1 条\n").arg(m_logEntries.size());
+    out << QString("日志条目: %1 条\n").arg(m_model->rowCount());
     out << "======================================\n\n";
 
-    // 写入日志内容（去除HTML标签）
-    for (const QString &entry : static_cast<const QStringList&>(m_logEntries)) {
-        QString plainText = entry;
-        static const QRegularExpression regExp("<[^>]*>");
-        plainText.remove(regExp);
-        out << plainText << "\n";
+    // 写入日志内容
+    for (int row = 0; row < m_model->rowCount(); ++row) {
+        out << m_model->plainText(row) << "\n";
     }
 
     file.close();
@@ -276,7 +225,9 @@ bool LogWidget::saveLogToFile(const QString &fileName)
 void LogWidget::setMaxLines(int maxLines)
 {
     m_maxLines = maxLines;
-    trimLogIfNeeded();
+    if (m_model->setCapacity(maxLines) > 0) {
+        emit logLimitReached(m_maxLines);
+    }
 }
 
 void LogWidget::setAutoScroll(bool autoScroll)
@@ -301,18 +252,23 @@ void LogWidget::setGroupBoxStyle(const QString &style)
 
 QString LogWidget::getLogContent() const
 {
-    return m_logDisplay->toPlainText();
+    QStringList lines;
+    lines.reserve(m_model->rowCount());
+    for (int row = 0; row < m_model->rowCount(); ++row) {
+        lines.append(m_model->plainText(row));
+    }
+    return lines.join('\n');
 }
 
 int LogWidget::getLogCount() const
 {
-    return m_currentLineCount;
+    return m_model->rowCount();
 }
 
 // 槽函数实现
 void LogWidget::onClearLog()
 {
-    if (m_currentLineCount > 0) {
+    if (m_model->rowCount() > 0) {
         int ret = QMessageBox::question(this, "确认清空",
                                         "确定要清空所有日志吗？",
                                         QMessageBox::Yes | QMessageBox::No);
@@ -325,7 +281,7 @@ void LogWidget::onClearLog()
 
 void LogWidget::onExportLog()
 {
-    if (m_currentLineCount == 0) {
+    if (m_model->rowCount() == 0) {
         QMessageBox::information(this, "提示", "当前没有日志可以导出！");
         return;
     }
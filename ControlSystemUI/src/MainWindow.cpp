@@ -3,12 +3,15 @@
 #include "JogControlPage.h"
 #include "RecipeManagerPage.h"
 #include "ModbusManager.h"
+#include "MoverStatusDecoder.h"
 #include "LoginDialog.h"
 #include "LogWidget.h"
 #include "ModbusConfigDialog.h"
 #include "StyleUtils.h"
 #include "AnimatedButton.h"
+#include "ReplayController.h"
 #include <QSettings>
+#include <QStandardPaths>
 #include <QTabWidget>
 #include <QMenuBar>
 #include <QToolBar>
@@ -17,6 +20,7 @@
 #include <QLabel>
 #include <QTimer>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QMessageBox>
 #include <QAction>
 #include <QVBoxLayout>
@@ -170,11 +174,85 @@ bool MainWindow::isSimulationMode() const
     return !m_modbusConnected;
 }
 
+bool MainWindow::isReplayMode() const
+{
+    return m_replayController && m_replayController->isOpen();
+}
+
+// 打开轨迹回放：选择记录目录后，动子数据改由回放控制器驱动
+void MainWindow::openReplay()
+{
+    // 回放帧会驱动自动运行、间距告警等实时消费者，只允许在未连接PLC时回放
+    if (m_modbusConnected) {
+        addLogEntry("PLC已连接，无法进入轨迹回放", "warning");
+        QMessageBox::information(this, "轨迹回放", "回放会用历史数据驱动界面，请先断开PLC再打开轨迹回放。");
+        return;
+    }
+
+    if (!m_replayController) {
+        m_replayController = new ReplayController(this);
+        m_replayBar = new ReplayControlBar(m_replayController, this);
+        m_replayToolBar = new QToolBar("轨迹回放", this);
+        m_replayToolBar->setMovable(false);
+        m_replayToolBar->addWidget(m_replayBar);
+        addToolBar(Qt::BottomToolBarArea, m_replayToolBar);
+
+        connect(m_replayController, &ReplayController::frameReady,
+                this, &MainWindow::onReplayFrame, Qt::DirectConnection);
+        connect(m_replayBar, &ReplayControlBar::exitRequested, this, &MainWindow::exitReplay);
+        connect(m_replayBar, &ReplayControlBar::recordingOpened, this, [this](const QString &directory) {
+            m_statusLabel->setText("回放模式：界面显示历史轨迹");
+            addLogEntry(QString("进入轨迹回放：%1").arg(directory), "info");
+            if (m_replayController->moverCount() > m_movers.size()) {
+                addLogEntry(QString("回放记录包含%1个动子，只显示前%2个")
+                                .arg(m_replayController->moverCount()).arg(m_movers.size()), "warning");
+            }
+            emit replayModeChanged(true);
+        });
+    }
+
+    m_replayToolBar->show();
+    if (!isReplayMode()) {
+        QSettings settings;
+        const QString directory = settings.value("Telemetry/Directory",
+                                                  QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                                                      + "/telemetry").toString();
+        m_replayBar->openRecording(directory);
+    }
+}
+
+void MainWindow::exitReplay()
+{
+    const bool wasReplaying = isReplayMode();
+    if (m_replayController) {
+        m_replayController->close();
+    }
+    if (wasReplaying) {
+        // 间距监视中的速度、加速度估计来自历史帧，丢弃后由实时数据重新建立
+        m_collisionMonitor.reset(m_telemetry);
+        emit collisionAlertsChanged(m_collisionMonitor.alerts());
+        emit replayModeChanged(false);
+    }
+    if (m_replayToolBar) {
+        m_replayToolBar->hide();
+    }
+    m_statusLabel->setText(m_modbusConnected ? "PLC已连接，系统就绪" : "系统就绪");
+    addLogEntry("退出轨迹回放", "info");
+}
+
+// 回放帧与实时快照走同一条路径，下一个刷新周期按变化通知各页面
+void MainWindow::onReplayFrame(const MoverSnapshotFrame &frame)
+{
+    applySnapshotFrame(frame);
+}
+
 // 初始化Modbus连接
 void MainWindow::initializeModbus()
 {
     m_modbusManager = new ModbusManager(this);
     m_modbusManager->setMainWindow(this);
+    m_modbusManager->setMoverStatusBase(getMoverStatusBase());
+    m_modbusManager->setScanMoverCount(m_movers.size());
 
     // 连接Modbus信号
     connect(m_modbusManager, &ModbusManager::connected,
@@ -185,9 +263,22 @@ void MainWindow::initializeModbus()
             this, &MainWindow::onModbusError);
     connect(m_modbusManager, &ModbusManager::dataReceived,
             this, &MainWindow::onModbusDataReceived);
+    connect(m_modbusManager, &ModbusManager::moverSnapshotReady,
+            this, &MainWindow::onMoverSnapshotReady);
 
     addLogEntry("Modbus管理器已初始化", "info");
 
+    // 动子轨迹记录默认常开，磁盘占用由总大小上限约束
+    QSettings settings;
+    if (settings.value("Telemetry/Enabled", true).toBool()) {
+        TelemetryRecorder::Options options;
+        options.directory = settings.value("Telemetry/Directory",
+                                           QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                                               + "/telemetry").toString();
+        options.maxTotalBytes = settings.value("Telemetry/MaxTotalMB", 4096).toLongLong() * 1024 * 1024;
+        m_modbusManager->startTelemetryRecording(options);
+    }
+
     // 延迟尝试连接（可选）
     /*QTimer::singleShot(2000, this, [this]() {
             m_modbusManager->connectToDevice("192.168.1.100", 502, 1);
@@ -305,7 +396,7 @@ void MainWindow::onModbusDataReceived(int startAddress, const QVector<quint16> &
     QMutexLocker locker(&m_dataUpdateMutex);
     // 根据接收到的数据块的起始地址，判断其内容并分发处理
     // 使用新的寄存器地址表来判断数据类型
-    if (startAddress == ModbusRegisters::MoverStatus::BASE_ADDRESS) {
+    if (startAddress == m_modbusManager->moverStatusBase()) {
         processMoversStatusData(startAddress, data);
     }
     // 使用正确的 SystemStatus 命名空间来判断是否是系统状态数据
@@ -314,6 +405,32 @@ void MainWindow::onModbusDataReceived(int startAddress, const QVector<quint16> &
     }
 }
 
+// 动子快照处理：I/O线程已完成解码，这里只复制最新一帧
+void MainWindow::onMoverSnapshotReady()
+{
+    const MoverSnapshotFrame &frame = m_modbusManager->acquireMoverSnapshot();
+    if (isReplayMode()) {
+        return; // 取走快照以便继续接收通知，但不覆盖回放数据
+    }
+    applySnapshotFrame(frame);
+}
+
+/**
+ * @brief 把一帧动子快照合并到动子数据，实时扫描与轨迹回放共用
+ * @param frame 快照帧
+ */
+void MainWindow::applySnapshotFrame(const MoverSnapshotFrame &frame)
+{
+    QMutexLocker locker(&m_dataUpdateMutex);
+    for (int i = 0; i < frame.count; ++i) {
+        const MoverSnapshot &snapshot = frame.movers[i];
+        if (snapshot.id >= 0 && snapshot.id < m_movers.size()
+            && applyMoverSnapshot(snapshot.id, snapshot)) {
+            markMoverDirty(snapshot.id);
+        }
+    }
+}
+
 // 线圈数据接收处理
 void MainWindow::onModbusCoilsReceived(int startAddress, const QVector<bool> &data)
 {
@@ -427,6 +544,8 @@ void MainWindow::setupUI()
 
     // 连接信号
     connect(this, &MainWindow::moversUpdated, m_overviewPage, &OverviewPage::updateMovers);
+    connect(this, &MainWindow::moversChanged, m_overviewPage, &OverviewPage::onMoversChanged);
+    connect(this, &MainWindow::collisionAlertsChanged, m_overviewPage, &OverviewPage::onCollisionAlertsChanged);
     connect(this, &MainWindow::userChanged, m_overviewPage, &OverviewPage::onUserChanged);
     connect(this, &MainWindow::currentRecipeChanged,
             m_overviewPage, [this](int id, const QString &name) {
@@ -507,8 +626,10 @@ void MainWindow::createMenuBar()
     // 视图菜单
     QMenu *viewMenu = menuBar->addMenu("视图(&V)");
     QAction *systemLogAction = viewMenu->addAction("系统日志(&L)");
+    QAction *replayAction = viewMenu->addAction("轨迹回放(&P)");
     QAction *fullScreenAction = viewMenu->addAction("全屏(&F)");
     connect(systemLogAction, &QAction::triggered, this, &MainWindow::openSystemLog);
+    connect(replayAction, &QAction::triggered, this, &MainWindow::openReplay);
     connect(fullScreenAction, &QAction::triggered, this,[this]() {
         if (isFullScreen()) {
             showNormal();
@@ -746,6 +867,11 @@ void MainWindow::createStatusBar()
 // Modbus事件处理函数
 void MainWindow::onModbusConnected()
 {
+    if (isReplayMode()) {
+        exitReplay();
+        addLogEntry("PLC已连接，退出轨迹回放", "warning");
+    }
+
     m_modbusConnected = true;
     m_modbusStatusLabel->setText("Modbus: 已连接");
     m_modbusStatusLabel->setStyleSheet("color: #22c55e; font-weight: bold;");
@@ -754,6 +880,7 @@ void MainWindow::onModbusConnected()
     m_statusLabel->setText("PLC已连接，系统就绪");
 
     // 启动循环读取
+    m_modbusManager->setScanMoverCount(m_movers.size());
     m_modbusManager->startCyclicRead(200);  // 200ms间隔
 
     // 记录日志
@@ -779,67 +906,155 @@ void MainWindow::onModbusDisconnected()
 
 void MainWindow::processMoversStatusData(int startAddress, const QVector<quint16> &data)
 {
-    // 使用正确的寄存器命名空间
-    int baseAddr = ModbusRegisters::MoverStatus::BASE_ADDRESS;
-    // 注意：这里的解析逻辑需要根据PLC的真实数据结构来调整。
-    int registersPerMover = ModbusRegisters::MoverStatus::REGISTERS_PER_MOVER;
-    for (int i = 0; i < data.size(); i += 2) {
-        int registerAddr = startAddress + i;
-        int moverIndex = (registerAddr - baseAddr) / registersPerMover;
-        int registerOffset = (registerAddr - baseAddr) % registersPerMover;
-
-        if (moverIndex >= 0 && moverIndex < m_movers.size() && (i + 1) < data.size()) {
-            MoverData &mover = m_movers[moverIndex];
-            qint32 value = static_cast<qint32>((data[i+1] << 16) | data[i]);
-
-            switch (registerOffset) {
-            case ModbusRegisters::MoverStatus::POSITION_LOW:
-                mover.position = value / 1000.0; // 假设PLC以微米为单位
-                mover.lastUpdateTime = QDateTime::currentDateTime();
-                mover.plcConnected = true;
-                break;
-            case ModbusRegisters::MoverStatus::VELOCITY_LOW:
-                mover.speed = value / 1000.0; // 假设PLC以微米/秒为单位
-                break;
-            case ModbusRegisters::MoverStatus::TARGET_LOW:
-                mover.target = value / 1000.0;
-                break;
-            }
+    // 按字段表解码整段状态块，再写入对应的动子
+    QVector<MoverSnapshot> snapshots(data.size() / ModbusRegisters::MoverStatus::REGISTERS_PER_MOVER);
+    const int firstMover = (startAddress - m_modbusManager->moverStatusBase())
+                           / ModbusRegisters::MoverStatus::REGISTERS_PER_MOVER;
+    const int count = MoverStatusDecoder::decodeBlock(firstMover, data, snapshots.data(), snapshots.size(),
+                                                      QElapsedTimer::msecsSinceReference());
+    for (int i = 0; i < count; ++i) {
+        const MoverSnapshot &snapshot = snapshots.at(i);
+        if (snapshot.id >= 0 && snapshot.id < m_movers.size()
+            && applyMoverSnapshot(snapshot.id, snapshot)) {
+            markMoverDirty(snapshot.id);
+        }
+    }
+}
+
+// 将解码后的快照写入遥测表并同步到动子数据，返回界面可见的字段是否发生变化
+bool MainWindow::applyMoverSnapshot(int id, const MoverSnapshot &snapshot)
+{
+    MoverTelemetryTable &telemetry = m_telemetry;
+    MoverData &mover = m_movers[id];
+
+    // 先在连续的数值列上比较，未变化时不触碰任何字符串
+    const bool motionChanged = telemetry.position[id] != snapshot.position
+                               || telemetry.speed[id] != snapshot.speed
+                               || telemetry.target[id] != snapshot.target;
+    const bool statusChanged = telemetry.statusWord[id] != snapshot.statusWord
+                               || telemetry.errorCode[id] != snapshot.errorCode
+                               || mover.statusCode != telemetry.status[id];  // 本地改写过状态（如急停）
+    const bool firstSample = !mover.plcConnected;
+
+    telemetry.position[id] = snapshot.position;
+    telemetry.speed[id] = snapshot.speed;
+    telemetry.target[id] = snapshot.target;
+    telemetry.statusWord[id] = snapshot.statusWord;
+    telemetry.errorCode[id] = snapshot.errorCode;
+    telemetry.lastUpdateMs[id] = snapshot.timestampMs;
+    mover.lastUpdateMs = snapshot.timestampMs;
+
+    if (!motionChanged && !statusChanged && !firstSample) {
+        return false;
+    }
+
+    mover.position = snapshot.position;
+    mover.speed = snapshot.speed;
+    mover.target = snapshot.target;
+    if (statusChanged || firstSample) {
+        updateMoverStatus(mover, snapshot.statusWord);
+        updateMoverError(mover, snapshot.errorCode);
+        telemetry.status[id] = mover.statusCode;
+    }
+    mover.plcConnected = true;
+    return true;
+}
+
+void MainWindow::markMoverDirty(int id)
+{
+    if (id >= 0 && id < m_dirtyMovers.size()) {
+        m_dirtyMovers.setBit(id);
+    }
+}
+
+void MainWindow::markAllMoversDirty()
+{
+    m_dirtyMovers.fill(true);
+}
+
+// 发布自上次以来变化的动子；没有变化时不发信号，订阅者也就不重绘
+void MainWindow::publishMoverChanges()
+{
+    const int dirtyCount = m_dirtyMovers.count(true);
+    if (dirtyCount == 0) {
+        return;
+    }
+
+    QVector<int> changedIds;
+    changedIds.reserve(dirtyCount);
+    for (int i = 0; i < m_dirtyMovers.size(); ++i) {
+        if (m_dirtyMovers.testBit(i)) {
+            changedIds.append(i);
         }
     }
+    m_dirtyMovers.fill(false);
+
+    if (m_moverConfig.enableCollisionDetection) {
+        updateCollisionMonitor(changedIds);
+    } else {
+        // 不评估告警，但索引保持最新，供定位预览与协同定位校验使用
+        m_collisionMonitor.updateIndex(m_telemetry, changedIds);
+    }
+    emit moversChanged(changedIds, ++m_moversGeneration);
+}
+
+/**
+ * @brief 每个刷新周期评估相邻动子间距，等级升到警告以上时记录日志
+ */
+void MainWindow::updateCollisionMonitor(const QVector<int> &changedIds)
+{
+    m_collisionMonitor.setSafetyDistance(m_moverConfig.safetyDistance);
+    if (!m_collisionMonitor.update(m_telemetry, changedIds)) {
+        return;
+    }
+
+    for (const CollisionAlert &alert : m_collisionMonitor.escalations()) {
+        const QString timeText = alert.timeToViolation <= 0.0
+            ? QString("已小于安全距离")
+            : QString("预计%1 s后小于安全距离").arg(alert.timeToViolation, 0, 'f', 2);
+        addLogEntry(QString("间距%1：动子%2与前方动子%3相距%4 mm，接近速度%5 mm/s，%6")
+                        .arg(CollisionMonitor::levelText(alert.level))
+                        .arg(alert.behindId).arg(alert.aheadId)
+                        .arg(alert.gap, 0, 'f', 1).arg(alert.closingSpeed, 0, 'f', 1)
+                        .arg(timeText),
+                    alert.level == CollisionLevel::Critical ? "error" : "warning");
+    }
+    emit collisionAlertsChanged(m_collisionMonitor.alerts());
 }
 
 void MainWindow::updateMoverStatus(MoverData &mover, quint16 statusWord)
 {
-    QString oldStatus = mover.status;
+    const QString oldStatus = mover.status;
+    MoverStatusCode code;
     mover.hasError = false;
     mover.errorMessage = "";
 
     // 解析状态字 (根据PLC实际定义调整)
     if (statusWord & 0x0001) {  // 位0: 使能
         if (statusWord & 0x0002) {  // 位1: 运行中
-            mover.status = "运行中";
+            code = MoverStatusCode::Running;
         } else if (statusWord & 0x0004) {  // 位2: 到位
-            mover.status = "停止";
+            code = MoverStatusCode::Stopped;
             mover.inPosition = true;
         } else {
-            mover.status = "就绪";
+            code = MoverStatusCode::Ready;
         }
     } else {
-        mover.status = "禁用";
+        code = MoverStatusCode::Disabled;
     }
 
     if (statusWord & 0x0008) {  // 位3: 错误
         mover.hasError = true;
-        mover.status = "错误";
+        code = MoverStatusCode::Error;
     }
 
     if (statusWord & 0x0010) {  // 位4: 紧急停止
-        mover.status = "紧急停止";
+        code = MoverStatusCode::EmergencyStop;
     }
 
     // 记录状态变化
-    if (oldStatus != mover.status) {
+    if (mover.statusCode != code) {
+        mover.setStatus(code);
         addLogEntry(QString("动子%1 状态变化: %2 -> %3")
                         .arg(mover.id).arg(oldStatus).arg(mover.status), "info");
     }
@@ -908,8 +1123,10 @@ void MainWindow::onEmergencyStopFromPLC()
     // 同步本地状态
     for (auto &mover : m_movers) {
         mover.speed = 0;
-        mover.status = "紧急停止";
+        mover.setStatus(MoverStatusCode::EmergencyStop);
     }
+    markAllMoversDirty();
+    publishMoverChanges();
 
     m_statusLabel->setText("⚠️ PLC紧急停止");
     m_statusLabel->setStyleSheet("color: #ef4444; font-weight: bold;");
@@ -964,15 +1181,15 @@ void MainWindow::initializeMovers()
     qDebug() << "MainWindow::initializeMovers 开始";
     // 清空现有数据
     m_movers.clear();
-    // 修改为单动子系统，预留扩展接口
-    const int MOVER_COUNT = 1; // 可配置的动子数量，将来可通过配置文件设置
+    // 动子数量来自系统设置，受状态块基址下的容量限制（默认基址100时为10个），状态块按单帧上限分块读取
+    const int MOVER_COUNT = qBound(1, getMoverCount(), getMoverCapacity());
 
     // 初始化动子，确保每个动子都有有效的数据
     for (int i = 0; i < MOVER_COUNT; ++i) {
         MoverData mover(i, 0.0);  // 单动子从位置0开始
         mover.id = i;
         mover.temperature = 25.0;
-        mover.status = "停止";
+        mover.setStatus(MoverStatusCode::Stopped);
         mover.speed = 0.0;
         mover.targetSpeed = 100.0;
         mover.acceleration = 500.0;
@@ -980,8 +1197,7 @@ void MainWindow::initializeMovers()
         mover.inPosition = true;
         mover.hasError = false;
         mover.plcConnected = false;
-        mover.lastUpdateTime = QDateTime::currentDateTime();
-        mover.lastCommandTime = QDateTime::currentDateTime();
+        mover.lastCommandMs = mover.lastUpdateMs;
         mover.lastCommand = "初始化";
 
         m_movers.append(mover);
@@ -989,6 +1205,16 @@ void MainWindow::initializeMovers()
     }
 
     qDebug() << "动子初始化完成，总数：" << m_movers.size();
+    if (m_modbusManager) {
+        m_modbusManager->setMoverStatusBase(getMoverStatusBase());
+        m_modbusManager->setScanMoverCount(m_movers.size());
+    }
+    m_telemetry.resize(m_movers.size());
+    m_collisionMonitor.reset(m_telemetry);
+    emit collisionAlertsChanged(m_collisionMonitor.alerts());
+    // 结构变化：订阅者整体重建，之前累积的变更标记一并作废
+    m_dirtyMovers = QBitArray(m_movers.size());
+    ++m_moversGeneration;
     emit moversUpdated(m_movers);
 }
 
@@ -998,10 +1224,33 @@ int MainWindow::getMoverCount() const
     return settings.value("System/MoverCount", 1).toInt(); // 默认1个动子
 }
 
+/**
+ * @brief 动子状态块基址（系统设置System/MoverStatusBase，默认100）
+ */
+int MainWindow::getMoverStatusBase() const
+{
+    QSettings settings;
+    return settings.value("System/MoverStatusBase", ModbusRegisters::MoverStatus::BASE_ADDRESS).toInt();
+}
+
+/**
+ * @brief 状态块不与其他寄存器区重叠时可配置的最大动子数
+ */
+int MainWindow::getMoverCapacity() const
+{
+    int capacity = MoverStatusDecoder::capacityAt(getMoverStatusBase());
+    if (capacity < 1) {
+        // 基址配置无效时按默认基址计算，与ModbusManager拒绝该基址的行为一致
+        capacity = MoverStatusDecoder::capacityAt(ModbusRegisters::MoverStatus::BASE_ADDRESS);
+    }
+    return capacity;
+}
+
 void MainWindow::setMoverCount(int count)
 {
-    if (count < 1 || count > 8) { // 限制最大8个动子
-        qWarning() << "动子数量超出范围，使用默认值1";
+    const int capacity = getMoverCapacity();
+    if (count < 1 || count > capacity) { // 状态块不能覆盖系统状态等寄存器区
+        qWarning() << "动子数量超出状态块容量" << capacity << "，使用默认值1";
         count = 1;
     }
 
@@ -1027,13 +1276,8 @@ void MainWindow::updateSystemStatus()
     }
 
     try {
-        if (m_modbusConnected) {
-            // PLC连接模式：数据来自ModbusManager的信号
-            // 这里不需要做额外处理，数据通过信号更新
-            qDebug() << "PLC模式 - 数据通过Modbus信号更新";
-        }
-        // 发送更新信号（但要避免在JOG操作时产生冲突）
-        emit moversUpdated(m_movers);
+        // 只通知本周期内变化的动子；静止时不产生任何界面刷新
+        publishMoverChanges();
 
     } catch (const std::exception& e) {
         qCritical() << "系统状态更新异常：" << e.what();
@@ -1075,7 +1319,7 @@ void MainWindow::openJogControl()
         }
         // 确保状态字符串不为空
         if (mover.status.isEmpty()) {
-            mover.status = "停止";
+            mover.setStatus(MoverStatusCode::Stopped);
             needsValidation = true;
         }
         // 确保目标位置有效
@@ -1104,6 +1348,9 @@ void MainWindow::openJogControl()
 
         // 连接信号，确保数据同步
         connect(this, &MainWindow::moversUpdated, m_jogPage, &JogControlPage::updateMovers);
+        connect(this, &MainWindow::moversChanged, m_jogPage, &JogControlPage::onMoversChanged);
+        connect(this, &MainWindow::collisionAlertsChanged, m_jogPage, &JogControlPage::onCollisionAlertsChanged);
+        m_jogPage->onCollisionAlertsChanged(m_collisionMonitor.alerts());
 
         // 立即发送一次初始数据
         QTimer::singleShot(100, this, [this]() {
@@ -1190,11 +1437,12 @@ void MainWindow::onEmergencyStop()
 
             // 重置本地数据模型中动子的状态
             for (auto &mover : m_movers) {
-                if (mover.status == "紧急停止") {
-                    mover.status = "停止";
+                if (mover.statusCode == MoverStatusCode::EmergencyStop) {
+                    mover.setStatus(MoverStatusCode::Stopped);
                     mover.hasError = false;
                 }
             }
+            markAllMoversDirty();
 
             // 发射信号，通知其他页面急停已重置
             emit emergencyStopReset();
@@ -1213,7 +1461,7 @@ void MainWindow::onEmergencyStop()
             // 立即更新本地数据模型中所有动子的状态为“紧急停止”
             for (auto &mover : m_movers) {
                 mover.speed = 0;
-                mover.status = "紧急停止";
+                mover.setStatus(MoverStatusCode::EmergencyStop);
             }
 
             // 通过ModbusManager向PLC发送禁用命令，这是真正的急停操作
@@ -1222,7 +1470,8 @@ void MainWindow::onEmergencyStop()
             }
 
             // 立即更新UI，让用户看到状态变化
-            emit moversUpdated(m_movers);
+            markAllMoversDirty();
+            publishMoverChanges();
 
             // 发射信号，通知其他页面急停已触发
             emit emergencyStopTriggered();
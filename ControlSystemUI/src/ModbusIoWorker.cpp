@@ -0,0 +1,700 @@
+#include "ModbusIoWorker.h"
+#include "ModbusManager.h"
+#include "MoverStatusDecoder.h"
+#include <QSharedPointer>
+#include <algorithm>
+#include <QModbusTcpClient>
+#include <QModbusRtuSerialClient>
+#include <QSerialPort>
+#include <QDebug>
+
+// --- 构造函数与析构函数 ---
+
+/**
+ * @brief ModbusIoWorker类的构造函数
+ * @param snapshots 动子快照缓冲区（由ModbusManager持有）
+ * @param parent 父对象指针
+ */
+ModbusIoWorker::ModbusIoWorker(MoverSnapshotBuffer *snapshots, QObject *parent)
+    : QObject(parent)
+    , m_commandQueue(1024)
+    , m_wakePending(false)
+    , m_snapshots(snapshots)
+    , m_modbusClient(nullptr)
+    , m_deviceId(1)
+    , m_isConnected(false)
+    , m_maxInFlight(4)
+    , m_exclusiveInFlight(false)
+    , m_isDispatching(false)
+    , m_maskWriteUnsupported(false)
+    , m_lastExceptionCode(QModbusPdu::ExtendedException)
+    , m_scanTimer(new QTimer(this))
+    , m_scanActive(false)
+    , m_snapshotSequence(0)
+{
+    // 扫描定时器随工作对象一起移入I/O线程，按最近到期的扫描组单次触发
+    m_scanTimer->setSingleShot(true);
+    m_scanTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_scanTimer, &QTimer::timeout, this, &ModbusIoWorker::onScanTimer);
+}
+
+/**
+ * @brief ModbusIoWorker类的析构函数（在I/O线程中执行）
+ */
+ModbusIoWorker::~ModbusIoWorker()
+{
+    closeClient();
+}
+
+// --- 命令投递 ---
+
+/**
+ * @brief 投递一条命令到I/O线程
+ *
+ * 只能由一个线程调用。队列为空时才发出一次唤醒，连续投递的多条命令在I/O线程中一次取完。
+ * @param command 命令
+ * @return 命令是否已入队
+ */
+bool ModbusIoWorker::submit(ModbusCommand &&command)
+{
+    if (!m_commandQueue.tryPush(std::move(command))) {
+        return false;
+    }
+    if (!m_wakePending.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, &ModbusIoWorker::processCommands, Qt::QueuedConnection);
+    }
+    return true;
+}
+
+/**
+ * @brief 在I/O线程中取出并执行所有排队的命令
+ */
+void ModbusIoWorker::processCommands()
+{
+    // 先清除唤醒标志再取队列，之后投递的命令会重新唤醒
+    m_wakePending.exchange(false, std::memory_order_acq_rel);
+
+    ModbusCommand command;
+    while (m_commandQueue.tryPop(command)) {
+        executeCommand(command);
+    }
+    dispatchPendingRequests();
+}
+
+/**
+ * @brief 执行一条命令
+ * @param command 命令
+ */
+void ModbusIoWorker::executeCommand(const ModbusCommand &command)
+{
+    switch (command.type) {
+    case ModbusCommand::ConnectTcp:
+    case ModbusCommand::ConnectSerial:
+        openClient(command);
+        break;
+    case ModbusCommand::Disconnect:
+        stopScan();
+        failPendingRequests("连接已断开");
+        closeClient();
+        break;
+    case ModbusCommand::Read:
+    case ModbusCommand::Write: {
+        PendingRequest request;
+        request.type = (command.type == ModbusCommand::Read) ? PendingRequest::Read : PendingRequest::Write;
+        request.unit = command.unit;
+        const quint64 id = command.id;
+        request.handler = [this, id](bool success, const QModbusDataUnit &result, const QString &errorText) {
+            finishCommand(id, success, result, errorText);
+        };
+        enqueueRequest(request, command.urgent);
+        break;
+    }
+    case ModbusCommand::MaskWrite:
+        startMaskWrite(command.id, command.startAddress, command.andMask, command.orMask);
+        break;
+    case ModbusCommand::SetMaxInFlight:
+        m_maxInFlight = qMax(1, command.count);
+        break;
+    case ModbusCommand::ConfigureScanGroup:
+        configureScanGroup(command);
+        break;
+    case ModbusCommand::StartScan:
+        startScan();
+        break;
+    case ModbusCommand::StopScan:
+        stopScan();
+        break;
+    case ModbusCommand::StartRecording:
+        startRecording(command.recorderOptions);
+        break;
+    case ModbusCommand::StopRecording:
+        stopRecording();
+        break;
+    }
+}
+
+// --- 客户端管理 ---
+
+/**
+ * @brief 创建Modbus客户端并发起连接
+ * @param command 连接命令
+ */
+void ModbusIoWorker::openClient(const ModbusCommand &command)
+{
+    stopScan();
+    failPendingRequests("重新连接");
+    closeClient();
+
+    m_deviceId = command.deviceId;
+    m_maskWriteUnsupported = false;
+
+    if (command.type == ModbusCommand::ConnectTcp) {
+        m_modbusClient = new QModbusTcpClient(this);
+        m_modbusClient->setConnectionParameter(QModbusDevice::NetworkPortParameter, command.port);
+        m_modbusClient->setConnectionParameter(QModbusDevice::NetworkAddressParameter, command.address);
+    } else {
+        m_modbusClient = new QModbusRtuSerialClient(this);
+        m_modbusClient->setConnectionParameter(QModbusDevice::SerialPortNameParameter, command.address);
+        m_modbusClient->setConnectionParameter(QModbusDevice::SerialBaudRateParameter, command.port);
+        m_modbusClient->setConnectionParameter(QModbusDevice::SerialDataBitsParameter, QSerialPort::Data8);
+        m_modbusClient->setConnectionParameter(QModbusDevice::SerialParityParameter, QSerialPort::NoParity);
+        m_modbusClient->setConnectionParameter(QModbusDevice::SerialStopBitsParameter, QSerialPort::OneStop);
+    }
+    m_modbusClient->setTimeout(1000);
+    m_modbusClient->setNumberOfRetries(1);
+
+    connect(m_modbusClient, &QModbusDevice::errorOccurred,
+            this, &ModbusIoWorker::onClientError);
+    connect(m_modbusClient, &QModbusDevice::stateChanged,
+            this, &ModbusIoWorker::onClientStateChanged);
+
+    if (!m_modbusClient->connectDevice()) {
+        emit deviceError(QModbusDevice::ConnectionError, m_modbusClient->errorString());
+        closeClient();
+    }
+}
+
+/**
+ * @brief 断开并释放Modbus客户端
+ */
+void ModbusIoWorker::closeClient()
+{
+    // 应答对象归客户端所有，随客户端一起释放
+    for (auto it = m_inFlightRequests.cbegin(); it != m_inFlightRequests.cend(); ++it) {
+        it.key()->disconnect(this);
+    }
+    m_inFlightRequests.clear();
+    m_requestQueue.clear();
+    m_exclusiveInFlight = false;
+
+    if (m_modbusClient) {
+        m_modbusClient->disconnect(this);
+        if (m_modbusClient->state() != QModbusDevice::UnconnectedState) {
+            m_modbusClient->disconnectDevice();
+        }
+        m_modbusClient->deleteLater();
+        m_modbusClient = nullptr;
+    }
+    m_isConnected = false;
+}
+
+/**
+ * @brief Modbus客户端连接状态变化
+ * @param state 新的连接状态
+ */
+void ModbusIoWorker::onClientStateChanged(QModbusDevice::State state)
+{
+    if (state == QModbusDevice::ConnectedState) {
+        m_isConnected = true;
+        emit stateChanged(state);
+        dispatchPendingRequests();
+    } else if (state == QModbusDevice::UnconnectedState) {
+        const bool wasConnected = m_isConnected;
+        m_isConnected = false;
+        stopScan();
+        failPendingRequests("连接中断");
+        if (wasConnected) {
+            emit stateChanged(state);
+        }
+    }
+}
+
+/**
+ * @brief Modbus客户端发生错误
+ * @param error 错误类型
+ */
+void ModbusIoWorker::onClientError(QModbusDevice::Error error)
+{
+    emit deviceError(error, m_modbusClient ? m_modbusClient->errorString() : QString());
+}
+
+// --- 请求队列调度 ---
+
+/**
+ * @brief 将请求加入发送队列并尝试立即调度
+ * @param request 待发送的请求
+ * @param urgent true时插入队首（用于读-改-写等必须紧接着发出的后续请求，以及点动停止）
+ */
+void ModbusIoWorker::enqueueRequest(const PendingRequest &request, bool urgent)
+{
+    if (urgent) {
+        m_requestQueue.prepend(request);
+    } else {
+        m_requestQueue.enqueue(request);
+    }
+    dispatchPendingRequests();
+}
+
+/**
+ * @brief 按在途上限从队列中取出请求并发送
+ *
+ * Modbus TCP客户端按事务ID匹配应答，因此允许多个请求同时在途；
+ * 独占请求只在没有其他在途请求时发出，且在其完成前不会发出新的请求。
+ */
+void ModbusIoWorker::dispatchPendingRequests()
+{
+    if (m_isDispatching || !m_modbusClient || !m_isConnected) {
+        return;
+    }
+    m_isDispatching = true;
+
+    while (!m_requestQueue.isEmpty()
+           && !m_exclusiveInFlight
+           && m_inFlightRequests.size() < m_maxInFlight) {
+        if (m_requestQueue.head().exclusive && !m_inFlightRequests.isEmpty()) {
+            break; // 等待在途请求清空
+        }
+
+        const PendingRequest request = m_requestQueue.dequeue();
+        QModbusReply *reply = nullptr;
+        switch (request.type) {
+        case PendingRequest::Read:
+            reply = m_modbusClient->sendReadRequest(request.unit, m_deviceId);
+            break;
+        case PendingRequest::Write:
+            reply = m_modbusClient->sendWriteRequest(request.unit, m_deviceId);
+            break;
+        case PendingRequest::Raw:
+            reply = m_modbusClient->sendRawRequest(request.rawRequest, m_deviceId);
+            break;
+        }
+
+        if (!reply) {
+            if (request.handler) {
+                request.handler(false, QModbusDataUnit(), m_modbusClient->errorString());
+            }
+            continue;
+        }
+
+        if (reply->isFinished()) {
+            // 广播请求等情况下应答会立即完成
+            if (request.handler) {
+                request.handler(reply->error() == QModbusDevice::NoError, reply->result(), reply->errorString());
+            }
+            reply->deleteLater();
+            continue;
+        }
+
+        m_inFlightRequests.insert(reply, request);
+        if (request.exclusive) {
+            m_exclusiveInFlight = true;
+        }
+        connect(reply, &QModbusReply::finished, this, &ModbusIoWorker::onReplyFinished);
+    }
+
+    m_isDispatching = false;
+}
+
+/**
+ * @brief 所有请求应答的统一完成入口
+ */
+void ModbusIoWorker::onReplyFinished()
+{
+    auto *reply = qobject_cast<QModbusReply *>(sender());
+    if (!reply) {
+        return;
+    }
+
+    auto it = m_inFlightRequests.find(reply);
+    if (it == m_inFlightRequests.end()) {
+        reply->deleteLater();
+        return;
+    }
+
+    const PendingRequest request = it.value();
+    m_inFlightRequests.erase(it);
+    if (request.exclusive) {
+        m_exclusiveInFlight = false;
+    }
+
+    const bool success = reply->error() == QModbusDevice::NoError;
+    m_lastExceptionCode = reply->error() == QModbusDevice::ProtocolError
+                              ? reply->rawResult().exceptionCode() : QModbusPdu::ExtendedException;
+    if (request.handler) {
+        request.handler(success, success ? reply->result() : QModbusDataUnit(), reply->errorString());
+    }
+    m_lastExceptionCode = QModbusPdu::ExtendedException;
+    reply->deleteLater();
+
+    dispatchPendingRequests();
+}
+
+/**
+ * @brief 以失败结果结束所有排队和在途的请求
+ * @param reason 失败原因
+ */
+void ModbusIoWorker::failPendingRequests(const QString &reason)
+{
+    QList<PendingRequest> requests = m_inFlightRequests.values();
+    for (auto it = m_inFlightRequests.cbegin(); it != m_inFlightRequests.cend(); ++it) {
+        it.key()->disconnect(this);
+    }
+    m_inFlightRequests.clear();
+    m_exclusiveInFlight = false;
+
+    while (!m_requestQueue.isEmpty()) {
+        requests.append(m_requestQueue.dequeue());
+    }
+
+    for (const PendingRequest &request : requests) {
+        if (request.handler) {
+            request.handler(false, QModbusDataUnit(), reason);
+        }
+    }
+}
+
+/**
+ * @brief 将命令结果送回GUI线程
+ * @param id 命令编号（0表示I/O线程内部请求，不回送）
+ * @param success 是否成功
+ * @param result 读请求返回的数据单元
+ * @param errorText 失败时的错误描述
+ */
+void ModbusIoWorker::finishCommand(quint64 id, bool success, const QModbusDataUnit &result, const QString &errorText)
+{
+    if (id == 0) {
+        return;
+    }
+    emit requestFinished(id, success, result.startAddress(), result.values(), success ? QString() : errorText);
+}
+
+/**
+ * @brief 使用0x16掩码写修改寄存器，PLC不支持时退回读-改-写
+ * @param id 命令编号
+ * @param address 寄存器地址
+ * @param andMask 与掩码
+ * @param orMask 或掩码
+ */
+void ModbusIoWorker::startMaskWrite(quint64 id, int address, quint16 andMask, quint16 orMask)
+{
+    if (m_maskWriteUnsupported) {
+        startReadModifyWrite(id, address, andMask, orMask);
+        return;
+    }
+
+    PendingRequest request;
+    request.type = PendingRequest::Raw;
+    request.rawRequest = QModbusRequest(QModbusPdu::MaskWriteRegister, quint16(address), andMask, orMask);
+    request.handler = [this, id, address, andMask, orMask](bool success, const QModbusDataUnit &, const QString &errorText) {
+        if (success) {
+            finishCommand(id, true, QModbusDataUnit(QModbusDataUnit::HoldingRegisters, address, 0), QString());
+            return;
+        }
+        if (!m_isConnected) {
+            finishCommand(id, false, QModbusDataUnit(), errorText); // 连接断开导致的失败
+            return;
+        }
+        // 只有非法功能码说明PLC不支持0x16；超时、设备忙等临时错误只让本次命令退回读-改-写
+        if (m_lastExceptionCode == QModbusPdu::IllegalFunction) {
+            m_maskWriteUnsupported = true;
+        }
+        startReadModifyWrite(id, address, andMask, orMask);
+    };
+    enqueueRequest(request);
+}
+
+/**
+ * @brief 使用读-改-写修改寄存器
+ *
+ * 读取和写回均为独占请求，写回请求插入队首，保证两者之间不会插入其他请求。
+ * @param id 命令编号
+ * @param address 寄存器地址
+ * @param andMask 与掩码
+ * @param orMask 或掩码
+ */
+void ModbusIoWorker::startReadModifyWrite(quint64 id, int address, quint16 andMask, quint16 orMask)
+{
+    PendingRequest readRequest;
+    readRequest.type = PendingRequest::Read;
+    readRequest.unit = QModbusDataUnit(QModbusDataUnit::HoldingRegisters, address, 1);
+    readRequest.exclusive = true;
+    readRequest.handler = [this, id, address, andMask, orMask](bool success, const QModbusDataUnit &result, const QString &errorText) {
+        if (!success || result.valueCount() < 1) {
+            finishCommand(id, false, QModbusDataUnit(), errorText);
+            return;
+        }
+
+        const quint16 newValue = (result.value(0) & andMask) | orMask;
+        PendingRequest writeRequest;
+        writeRequest.type = PendingRequest::Write;
+        writeRequest.unit = QModbusDataUnit(QModbusDataUnit::HoldingRegisters, address, 1);
+        writeRequest.unit.setValue(0, newValue);
+        writeRequest.exclusive = true;
+        writeRequest.handler = [this, id, address, newValue](bool writeSuccess, const QModbusDataUnit &, const QString &writeError) {
+            // 成功时把写入的完整值带回，GUI据此重建镜像
+            QModbusDataUnit written(QModbusDataUnit::HoldingRegisters, address, 1);
+            written.setValue(0, newValue);
+            finishCommand(id, writeSuccess, writeSuccess ? written : QModbusDataUnit(), writeError);
+        };
+        enqueueRequest(writeRequest, true);
+    };
+    enqueueRequest(readRequest);
+}
+
+// --- 周期扫描 ---
+
+/**
+ * @brief 添加或修改扫描组
+ * @param command 扫描组配置命令
+ */
+void ModbusIoWorker::configureScanGroup(const ModbusCommand &command)
+{
+    if (command.groupId < 0) {
+        return;
+    }
+    if (command.groupId >= m_scanGroups.size()) {
+        m_scanGroups.resize(command.groupId + 1);
+    }
+
+    ScanGroup &group = m_scanGroups[command.groupId];
+    if (group.startAddress != command.startAddress || group.count != command.count
+        || group.enabled != command.enabled) {
+        group.lastValues.clear(); // 范围变化后重新建立变化检测基准
+    }
+    group.startAddress = command.startAddress;
+    group.count = command.count;
+    group.periodMs = qMax(10, command.periodMs);
+    group.enabled = command.enabled;
+
+    if (m_scanActive) {
+        scheduleNextScan();
+    }
+}
+
+/**
+ * @brief 开始周期扫描，清空变化检测基准使首个周期的数据总会发出
+ */
+void ModbusIoWorker::startScan()
+{
+    m_scanClock.start();
+    for (ScanGroup &group : m_scanGroups) {
+        group.inFlight = false;
+        group.nextDueMs = 0;
+        group.lastValues.clear();
+    }
+    m_scanActive = true;
+    scheduleNextScan();
+}
+
+/**
+ * @brief 停止周期扫描
+ */
+void ModbusIoWorker::stopScan()
+{
+    m_scanActive = false;
+    m_scanTimer->stop();
+}
+
+/**
+ * @brief 扫描定时器到期：发出所有到期扫描组的读取请求
+ */
+void ModbusIoWorker::onScanTimer()
+{
+    if (!m_scanActive || !m_isConnected) {
+        return;
+    }
+
+    const qint64 now = m_scanClock.elapsed();
+    for (int i = 0; i < m_scanGroups.size(); ++i) {
+        ScanGroup &group = m_scanGroups[i];
+        if (!group.enabled || group.nextDueMs > now) {
+            continue;
+        }
+        // 以理想到期时间递推，避免周期漂移；落后过多时从当前时间重新对齐
+        group.nextDueMs += group.periodMs;
+        if (group.nextDueMs <= now) {
+            group.nextDueMs = now + group.periodMs;
+        }
+        if (!group.inFlight) {
+            pollScanGroup(i);
+        }
+    }
+
+    scheduleNextScan();
+}
+
+/**
+ * @brief 按最近到期的扫描组重新设置扫描定时器
+ */
+void ModbusIoWorker::scheduleNextScan()
+{
+    if (!m_scanActive) {
+        return;
+    }
+
+    qint64 nextDue = -1;
+    for (const ScanGroup &group : m_scanGroups) {
+        if (group.enabled && group.count > 0 && (nextDue < 0 || group.nextDueMs < nextDue)) {
+            nextDue = group.nextDueMs;
+        }
+    }
+    if (nextDue < 0) {
+        m_scanTimer->stop();
+        return;
+    }
+
+    const qint64 delay = qMax<qint64>(0, nextDue - m_scanClock.elapsed());
+    m_scanTimer->start(static_cast<int>(delay));
+}
+
+/**
+ * @brief 读取一个扫描组，数据与上次不同时通知GUI线程
+ *
+ * 超过单帧上限的扫描组拆成多个读请求一次性排队，TCP下按事务ID流水线发送，
+ * 全部分块返回后拼接为完整数据再做变化检测。
+ * @param groupId 扫描组编号
+ */
+void ModbusIoWorker::pollScanGroup(int groupId)
+{
+    ScanGroup &group = m_scanGroups[groupId];
+    if (group.count <= 0) {
+        return;
+    }
+
+    QVector<MoverStatusDecoder::ReadChunk> chunks;
+    if (groupId == ModbusManager::MoverScanGroup) {
+        chunks = MoverStatusDecoder::planChunks(group.startAddress, group.count);
+    } else {
+        for (int offset = 0; offset < group.count; offset += ModbusRegisters::Limits::MAX_READ_REGISTERS) {
+            chunks.append({group.startAddress + offset,
+                           qMin(ModbusRegisters::Limits::MAX_READ_REGISTERS, group.count - offset)});
+        }
+    }
+
+    // 各分块共享的拼接缓冲
+    struct Assembly {
+        QVector<quint16> values;
+        int remaining = 0;
+        bool failed = false;
+    };
+    auto assembly = QSharedPointer<Assembly>::create();
+    assembly->values.resize(group.count);
+    assembly->remaining = chunks.size();
+
+    const int startAddress = group.startAddress;
+    const int count = group.count;
+    group.inFlight = true; // 入队可能同步失败并立即回调，须先置位
+    for (const MoverStatusDecoder::ReadChunk &chunk : chunks) {
+        PendingRequest request;
+        request.type = PendingRequest::Read;
+        request.unit = QModbusDataUnit(QModbusDataUnit::HoldingRegisters, chunk.startAddress, chunk.count);
+        request.handler = [this, groupId, startAddress, count, chunk, assembly](bool success, const QModbusDataUnit &result, const QString &) {
+            if (!success || static_cast<int>(result.valueCount()) != chunk.count) {
+                assembly->failed = true;
+            } else {
+                const QVector<quint16> chunkValues = result.values();
+                std::copy(chunkValues.cbegin(), chunkValues.cend(),
+                          assembly->values.begin() + (chunk.startAddress - startAddress));
+            }
+            if (--assembly->remaining > 0 || groupId >= m_scanGroups.size()) {
+                return;
+            }
+
+            ScanGroup &scanned = m_scanGroups[groupId];
+            scanned.inFlight = false;
+            // 扫描组配置在请求途中被修改时丢弃本次结果
+            if (assembly->failed || scanned.startAddress != startAddress || scanned.count != count) {
+                return;
+            }
+            if (assembly->values == scanned.lastValues) {
+                // 动子状态无变化：不发布快照，只在轨迹中记一个空帧
+                if (groupId == ModbusManager::MoverScanGroup && m_recorder.isRecording()
+                    && !m_recorder.recordIdle(QElapsedTimer::msecsSinceReference())) {
+                    emit recordingStateChanged(false, QString(), m_recorder.errorString());
+                }
+                return;
+            }
+            scanned.lastValues = assembly->values;
+
+            if (groupId == ModbusManager::MoverScanGroup) {
+                publishMoverSnapshot(assembly->values);
+            } else {
+                emit scanDataChanged(startAddress, assembly->values);
+            }
+        };
+        enqueueRequest(request);
+    }
+}
+
+/**
+ * @brief 解码动子状态块并发布到快照缓冲区
+ *
+ * 多次发布在GUI读取之前只发出一次moverSnapshotReady通知。
+ * 动子扫描组从状态块基址开始，第一个寄存器属于动子0。
+ * @param values 寄存器数据
+ */
+void ModbusIoWorker::publishMoverSnapshot(const QVector<quint16> &values)
+{
+    if (!m_snapshots) {
+        return;
+    }
+
+    const qint64 now = QElapsedTimer::msecsSinceReference();
+
+    MoverSnapshotFrame &frame = m_snapshots->writeFrame();
+    frame.sequence = ++m_snapshotSequence;
+    frame.timestampMs = now;
+    frame.count = MoverStatusDecoder::decodeBlock(0, values, frame.movers,
+                                                  MoverSnapshotFrame::MAX_MOVERS, now);
+
+    // 发布前写入轨迹：发布后该帧可能被GUI线程取走
+    if (m_recorder.isRecording() && !m_recorder.record(frame)) {
+        emit recordingStateChanged(false, QString(), m_recorder.errorString());
+    }
+    m_snapshots->publish();
+
+    if (m_snapshots->requestNotify()) {
+        emit moverSnapshotReady();
+    }
+}
+
+// --- 轨迹记录 ---
+
+/**
+ * @brief 开始记录动子轨迹
+ *
+ * 记录在I/O线程中随动子扫描同步进行，不经过GUI线程：有变化的扫描随快照发布写入，
+ * 无变化的扫描写一个空帧，因此每次成功的动子扫描都在轨迹中留下一帧，失败的扫描不留。
+ * @param options 记录参数
+ */
+void ModbusIoWorker::startRecording(const TelemetryRecorder::Options &options)
+{
+    if (m_recorder.start(options)) {
+        emit recordingStateChanged(true, options.directory, QString());
+    } else {
+        emit recordingStateChanged(false, QString(), m_recorder.errorString());
+    }
+}
+
+/**
+ * @brief 停止记录并关闭当前分段文件
+ */
+void ModbusIoWorker::stopRecording()
+{
+    if (!m_recorder.isRecording()) {
+        return;
+    }
+    const QString lastFile = m_recorder.currentFilePath();
+    m_recorder.stop();
+    emit recordingStateChanged(false, lastFile, QString());
+}
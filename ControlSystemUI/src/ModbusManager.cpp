@@ -1,32 +1,109 @@
 #include "ModbusManager.h"
+#include "ModbusIoWorker.h"
+#include "MoverStatusDecoder.h"
+#ifndef MODBUS_HEADLESS
 #include "MainWindow.h"
-#include "ModbusConfigDialog.h"
-#include <QModbusTcpClient>
-#include <QModbusRtuSerialClient>
-#include <QEventLoop>
+#endif
 #include <QThread>
+#include <QDateTime>
 #include <QSerialPort>
+#include <QSharedPointer>
+#include <algorithm>
 #include <QDebug>
 
+namespace {
+
+// 协同定位命令块 [序号, 条目数, 条目...] 中的条目数
+int groupMoveEntryCount(const QVector<quint16> &block)
+{
+    using namespace ModbusRegisters::GroupMove;
+    return (block.size() - ENTRIES) / REGISTERS_PER_ENTRY;
+}
+
+// 删除命令块中指定动子的条目并更新条目数，返回是否有条目被删除
+bool removeGroupMoveEntries(QVector<quint16> &block, int moverId)
+{
+    using namespace ModbusRegisters::GroupMove;
+    QVector<quint16> kept = block.mid(0, ENTRIES);
+    for (int offset = ENTRIES; offset < block.size(); offset += REGISTERS_PER_ENTRY) {
+        if (block.at(offset + ENTRY_MOVER_ID) != moverId) {
+            kept += block.mid(offset, REGISTERS_PER_ENTRY);
+        }
+    }
+    if (kept.size() == block.size()) {
+        return false;
+    }
+    kept[COUNT] = quint16(groupMoveEntryCount(kept));
+    block = kept;
+    return true;
+}
+
+} // namespace
+
 // --- 构造函数与析构函数 ---
 
 /**
  * @brief ModbusManager类的构造函数
+ *
+ * Modbus客户端运行在独立的I/O线程中，界面重绘不会推迟总线通信，
+ * PLC响应慢或超时也不会阻塞界面。
  * @param parent 父对象指针
  */
 ModbusManager::ModbusManager(QObject *parent)
     : QObject(parent)
-    , m_modbusClient(nullptr)
-    , m_cyclicTimer(new QTimer(this))
+    , m_ioThread(new QThread(this))
+    , m_worker(nullptr)
     , m_mainWindow(nullptr)
     , m_port(502)
     , m_deviceId(1)
+    , m_isSerial(false)
     , m_isConnected(false)
+    , m_connectRequested(false)
     , m_successfulOperations(0)
     , m_failedOperations(0)
+    , m_nextRequestId(0)
+    , m_moverReadPending(false)
+    , m_controlWordShadow(0)
+    , m_controlWordValid(false)
+    , m_pendingSetMask(0)
+    , m_pendingClearMask(0)
+    , m_controlWordFlushScheduled(false)
+    , m_controlWordWritesInFlight(0)
+    , m_scanMoverCount(1)
+    , m_moverStatusBase(ModbusRegisters::MoverStatus::BASE_ADDRESS)
+    , m_cyclicReadActive(false)
+    , m_telemetryRecording(false)
+    , m_groupMoveSequence(0)
+    , m_groupMoveSequenceValid(false)
+    , m_groupMoveInFlight(false)
+    , m_jogKeepAliveTimer(new QTimer(this))
+    , m_jogSessionActive(false)
+    , m_jogDirection(0)
+    , m_jogKeepAliveCounter(0)
+    , m_jogKeepAliveInFlight(false)
+    , m_jogStartPending(false)
+    , m_jogKeepAliveSupported(false)
 {
-    // 设置周期性读取定时器为非单次触发
-    m_cyclicTimer->setSingleShot(false);
+    m_worker = new ModbusIoWorker(&m_moverSnapshots);
+    m_worker->moveToThread(m_ioThread);
+    connect(m_ioThread, &QThread::finished, m_worker, &QObject::deleteLater);
+
+    // 跨线程信号均为队列连接，槽函数在GUI线程中执行
+    connect(m_worker, &ModbusIoWorker::stateChanged, this, &ModbusManager::onWorkerStateChanged);
+    connect(m_worker, &ModbusIoWorker::deviceError, this, &ModbusManager::onWorkerDeviceError);
+    connect(m_worker, &ModbusIoWorker::requestFinished, this, &ModbusManager::onWorkerRequestFinished);
+    connect(m_worker, &ModbusIoWorker::scanDataChanged, this, &ModbusManager::onScanDataChanged);
+    connect(m_worker, &ModbusIoWorker::moverSnapshotReady, this, &ModbusManager::moverSnapshotReady);
+    connect(m_worker, &ModbusIoWorker::recordingStateChanged, this, &ModbusManager::onWorkerRecordingStateChanged);
+
+    m_jogKeepAliveTimer->setTimerType(Qt::PreciseTimer);
+    m_jogKeepAliveTimer->setInterval(JOG_KEEPALIVE_INTERVAL);
+    connect(m_jogKeepAliveTimer, &QTimer::timeout, this, &ModbusManager::sendJogKeepAlive);
+
+    m_ioThread->setObjectName("ModbusIO");
+    m_ioThread->start(QThread::HighPriority);
+
+    initializeScanGroups();
 }
 
 /**
@@ -35,6 +112,10 @@ ModbusManager::ModbusManager(QObject *parent)
 ModbusManager::~ModbusManager()
 {
     cleanup(); // 清理资源
+
+    // 工作对象在I/O线程结束时释放，其析构函数负责断开客户端
+    m_ioThread->quit();
+    m_ioThread->wait();
 }
 
 
@@ -70,6 +151,7 @@ void ModbusManager::logOperation(const QString &operation, bool success, const Q
         qWarning() << logMessage;
     }
 
+#ifndef MODBUS_HEADLESS
     // 如果主窗口存在，则将日志添加到系统日志中
     if (m_mainWindow) {
         QString systemLogMessage = QString("[Modbus] %1").arg(operation);
@@ -80,6 +162,7 @@ void ModbusManager::logOperation(const QString &operation, bool success, const Q
         QString logType = success ? "success" : "error";
         m_mainWindow->addLogEntry(systemLogMessage, logType);
     }
+#endif
 }
 
 /**
@@ -93,13 +176,11 @@ QString ModbusManager::getConnectionInfo() const
     }
 
     QString info;
-    if (m_modbusClient) {
-        if (qobject_cast<QModbusTcpClient*>(m_modbusClient)) {
-            // TCP连接信息
-            info = QString("TCP: %1:%2").arg(m_host).arg(m_port);
-        }
-        info += QString(" | 设备ID: %1").arg(m_deviceId);
+    if (!m_isSerial) {
+        // TCP连接信息
+        info = QString("TCP: %1:%2").arg(m_host).arg(m_port);
     }
+    info += QString(" | 设备ID: %1").arg(m_deviceId);
 
     return info;
 }
@@ -108,6 +189,8 @@ QString ModbusManager::getConnectionInfo() const
 
 /**
  * @brief 通过TCP连接到Modbus设备
+ *
+ * 连接在I/O线程中异步建立，结果通过connected或connectionError信号通知。
  * @param host 主机地址
  * @param port 端口号
  * @param deviceId 设备ID
@@ -116,32 +199,27 @@ QString ModbusManager::getConnectionInfo() const
 bool ModbusManager::connectToDevice(const QString &host, int port, int deviceId)
 {
     logOperation(QString("TCP连接请求"), true, QString("目标: %1:%2, 设备ID: %3").arg(host).arg(port).arg(deviceId));
-    if (m_isConnected) {
+    if (m_connectRequested) {
         disconnectFromDevice();
     }
     m_host = host;
     m_port = port;
     m_deviceId = deviceId;
-
-    try {
-        m_modbusClient = new QModbusTcpClient(this);
-        setupModbusClient();
-        m_modbusClient->setConnectionParameter(QModbusDevice::NetworkPortParameter, port);
-        m_modbusClient->setConnectionParameter(QModbusDevice::NetworkAddressParameter, host);
-        m_modbusClient->setTimeout(1000);
-        m_modbusClient->setNumberOfRetries(1);
-
-        if (!m_modbusClient->connectDevice()) {
-            logOperation("TCP连接失败", false, m_modbusClient->errorString());
-            cleanup();
-            return false;
-        }
-        return true;
-    } catch (const std::exception& e) {
-        logOperation("TCP连接异常", false, e.what());
-        cleanup();
+    m_isSerial = false;
+
+    ModbusCommand command;
+    command.type = ModbusCommand::ConnectTcp;
+    command.address = host;
+    command.port = port;
+    command.deviceId = deviceId;
+    if (!submitCommand(command)) {
+        logOperation("TCP连接失败", false, "命令队列已满");
         return false;
     }
+
+    m_connectRequested = true;
+    setMaxInFlight(TCP_MAX_IN_FLIGHT);
+    return true;
 }
 
 /**
@@ -156,51 +234,33 @@ bool ModbusManager::connectToSerialDevice(const QString &portName, int baudRate,
     logOperation("串口连接请求", true, QString("端口: %1, 波特率: %2, 设备ID: %3").arg(portName).arg(baudRate).arg(deviceId));
 
     // 如果已存在连接，先断开
-    if (m_isConnected) {
+    if (m_connectRequested) {
         logOperation("断开现有连接", true, "为新连接做准备");
         disconnectFromDevice();
     }
 
     // 保存连接参数
+    m_host = portName;
+    m_port = baudRate;
     m_deviceId = deviceId;
-
-    try {
-        // 创建并设置串口Modbus客户端
-        m_modbusClient = new QModbusRtuSerialClient(this);
-        setupModbusClient();
-
-        // 设置串口参数
-        m_modbusClient->setConnectionParameter(QModbusDevice::SerialPortNameParameter, portName);
-        m_modbusClient->setConnectionParameter(QModbusDevice::SerialBaudRateParameter, baudRate);
-        m_modbusClient->setConnectionParameter(QModbusDevice::SerialDataBitsParameter, QSerialPort::Data8);
-        m_modbusClient->setConnectionParameter(QModbusDevice::SerialParityParameter, QSerialPort::NoParity);
-        m_modbusClient->setConnectionParameter(QModbusDevice::SerialStopBitsParameter, QSerialPort::OneStop);
-
-        // 设置超时和重试次数
-        m_modbusClient->setTimeout(1000);
-        m_modbusClient->setNumberOfRetries(1);
-
-        logOperation("串口客户端配置", true, QString("数据位: 8, 校验: 无, 停止位: 1, 超时: 1000ms"));
-
-        // 发起连接
-        if (!m_modbusClient->connectDevice()) {
-            QString error = m_modbusClient->errorString();
-            logOperation("串口连接失败", false, error);
-            emit connectionError(error);
-            cleanup();
-            return false;
-        }
-
-        logOperation("串口连接启动", true, QString("正在连接到 %1").arg(portName));
-        return true;
-
-    } catch (const std::exception& e) {
-        QString error = QString("串口连接异常: %1").arg(e.what());
-        logOperation("串口连接异常", false, error);
+    m_isSerial = true;
+
+    ModbusCommand command;
+    command.type = ModbusCommand::ConnectSerial;
+    command.address = portName;
+    command.port = baudRate;
+    command.deviceId = deviceId;
+    if (!submitCommand(command)) {
+        QString error = "命令队列已满";
+        logOperation("串口连接失败", false, error);
         emit connectionError(error);
-        cleanup();
         return false;
     }
+
+    m_connectRequested = true;
+    setMaxInFlight(SERIAL_MAX_IN_FLIGHT);
+    logOperation("串口连接启动", true, QString("正在连接到 %1 (数据位: 8, 校验: 无, 停止位: 1, 超时: 1000ms)").arg(portName));
+    return true;
 }
 
 /**
@@ -209,10 +269,26 @@ bool ModbusManager::connectToSerialDevice(const QString &portName, int baudRate,
 void ModbusManager::disconnectFromDevice()
 {
     stopCyclicRead();
-    if (m_modbusClient && m_modbusClient->state() == QModbusDevice::ConnectedState) {
-        m_modbusClient->disconnectDevice();
+    // 尽量先发出停止；没能送达时由PLC的保活超时停止
+    if (m_jogSessionActive) {
+        abortJogSession("连接已断开");
+    }
+
+    // 先标记为未连接，使回调中不会再排入新的请求
+    const bool wasConnected = m_isConnected;
+    m_isConnected = false;
+    failPendingRequests("连接已断开");
+
+    if (m_connectRequested) {
+        ModbusCommand command;
+        command.type = ModbusCommand::Disconnect;
+        submitCommand(command);
     }
     cleanup();
+
+    if (wasConnected) {
+        emit disconnected();
+    }
 }
 
 /**
@@ -267,19 +343,15 @@ bool ModbusManager::setSingleAxisManualControl(bool allow)
 bool ModbusManager::setSingleAxisJog(int direction)
 {
     logOperation(QString("发送JOG命令: 方向=%1").arg(direction), true);
-    bool success = true;
-    // JOG命令是脉冲式的，按下为1，松开为0，所以需要先清零另一个方向
+    const quint16 leftMask = 1 << ModbusRegisters::SingleAxis::JOG_LEFT_BIT;
+    const quint16 rightMask = 1 << ModbusRegisters::SingleAxis::JOG_RIGHT_BIT;
+    // JOG命令是脉冲式的，按下为1，松开为0，所以需要同时清零另一个方向
     if (direction == 1) { //向左
-        success &= setControlWordBit(ModbusRegisters::SingleAxis::JOG_RIGHT_BIT, false);
-        success &= setControlWordBit(ModbusRegisters::SingleAxis::JOG_LEFT_BIT, true);
+        return setControlWordBits(leftMask, rightMask);
     } else if (direction == 2) { //向右
-        success &= setControlWordBit(ModbusRegisters::SingleAxis::JOG_LEFT_BIT, false);
-        success &= setControlWordBit(ModbusRegisters::SingleAxis::JOG_RIGHT_BIT, true);
-    } else { //停止
-        success &= setControlWordBit(ModbusRegisters::SingleAxis::JOG_LEFT_BIT, false);
-        success &= setControlWordBit(ModbusRegisters::SingleAxis::JOG_RIGHT_BIT, false);
+        return setControlWordBits(rightMask, leftMask);
     }
-    return success;
+    return setControlWordBits(0, leftMask | rightMask); //停止
 }
 
 /**
@@ -326,55 +398,687 @@ bool ModbusManager::setSingleAxisJogSpeed(qint32 speed)
     return writeHoldingRegisterDINT(ModbusRegisters::SingleAxis::JOG_SPEED_LOW, speed);
 }
 
-// --- 内部辅助函数 ---
+// --- 点动会话 ---
+
+/**
+ * @brief 启动点动会话
+ *
+ * 先写入保活计数和超时时间，再置位点动方向位；之后每个保活周期只写一次保活计数（FC06），
+ * 不再重复读-改-写控制字。PLC超过超时时间未见新的保活计数即自行停止点动，
+ * 因此界面卡死或链路中断时动子也会在确定的时间内停下。会话进行中再次调用只切换方向。
+ * PLC不提供保活寄存器时退回普通点动，只置位点动位，由stopJogSession清除。
+ * @param direction 1: 左, 2: 右
+ * @return 是否成功发送命令
+ */
+bool ModbusManager::startJogSession(int direction)
+{
+    if (direction != 1 && direction != 2) {
+        logOperation("点动会话启动失败", false, QString("无效的方向: %1").arg(direction));
+        return false;
+    }
+    if (!isClientReady()) {
+        logOperation("点动会话启动失败", false, "客户端未连接");
+        return false;
+    }
+    if (m_jogSessionActive) {
+        if (direction == m_jogDirection) {
+            return true;
+        }
+        m_jogDirection = direction;
+        return setSingleAxisJog(direction);
+    }
 
-// ModbusManager.cpp
+    if (!m_jogKeepAliveSupported) {
+        // 普通点动：只置位点动位，松开时清除
+        m_jogSessionActive = true;
+        m_jogDirection = direction;
+        logOperation(QString("点动开始（PLC无保活寄存器）: 方向=%1").arg(direction), true);
+        return setSingleAxisJog(direction);
+    }
+
+    // 保活计数跳过0，0保留给会话结束
+    m_jogKeepAliveCounter = m_jogKeepAliveCounter == 0xFFFF ? 1 : m_jogKeepAliveCounter + 1;
+    const QVector<quint16> header{m_jogKeepAliveCounter, quint16(JOG_SESSION_TIMEOUT)};
+    const bool queued = writeRegistersAsync(ModbusRegisters::JogSession::KEEPALIVE, header,
+        [this](bool success, const QModbusDataUnit &) {
+            m_jogStartPending = false;
+            if (!success && isClientReady()) {
+                // 保活寄存器不可写：本次连接退回普通点动，随后排队的点动位照常生效
+                m_jogKeepAliveSupported = false;
+                m_jogKeepAliveTimer->stop();
+                logOperation("点动保活", false, "PLC保活寄存器不可写，本次连接改用普通点动");
+            }
+        });
+    if (!queued) {
+        return false;
+    }
+    m_jogStartPending = true;
+
+    m_jogSessionActive = true;
+    m_jogDirection = direction;
+    m_jogKeepAliveInFlight = false;
+    m_jogKeepAliveTimer->start();
+    logOperation(QString("点动会话开始: 方向=%1, 保活超时=%2 ms").arg(direction).arg(JOG_SESSION_TIMEOUT), true);
+    return setSingleAxisJog(direction);
+}
+
+/**
+ * @brief 结束点动会话
+ *
+ * 保活计数写0的请求插入I/O队列队首，松开到PLC停止只需等待一次往返；
+ * 随后再清除控制字中的点动位，使控制字与实际状态一致。
+ * 会话开始或保活的写入仍在队列中时不插队，按顺序排在它们之后，
+ * 否则先到的0会被随后写入的非零保活计数覆盖，PLC重新开始点动。
+ */
+void ModbusManager::stopJogSession()
+{
+    if (!m_jogSessionActive) {
+        return;
+    }
+    m_jogSessionActive = false;
+    m_jogKeepAliveTimer->stop();
+
+    if (!isClientReady()) {
+        return;
+    }
+    if (!m_jogKeepAliveSupported) {
+        setSingleAxisJog(0);
+        return;
+    }
+
+    ModbusCommand command;
+    command.type = ModbusCommand::Write;
+    command.urgent = !m_jogStartPending && !m_jogKeepAliveInFlight;
+    command.unit = QModbusDataUnit(QModbusDataUnit::HoldingRegisters, ModbusRegisters::JogSession::KEEPALIVE, 1);
+    command.unit.setValue(0, 0);
+
+    PendingRequest request;
+    request.operation = QString("点动会话停止");
+    submitRequest(command, request);
+
+    setSingleAxisJog(0);
+}
+
+/**
+ * @brief 连接后回读保活寄存器，确认PLC提供点动保活
+ *
+ * 回读成功前按普通点动处理；PLC不提供这两个寄存器时点动仍然可用，只是没有超时保护。
+ */
+void ModbusManager::probeJogKeepAlive()
+{
+    m_jogKeepAliveSupported = false;
+    readRegistersAsync(ModbusRegisters::JogSession::KEEPALIVE, 2, [this](bool success, const QModbusDataUnit &) {
+        m_jogKeepAliveSupported = success;
+        logOperation("点动保活探测", success, success ? "PLC支持点动保活" : "PLC无保活寄存器，点动不带超时保护");
+    });
+}
+
+// 会话异常结束：尽量发出停止，并通知界面复位按钮状态
+void ModbusManager::abortJogSession(const QString &reason)
+{
+    stopJogSession();
+    logOperation("点动会话中止", false, reason);
+    emit jogSessionAborted(reason);
+}
+
+/**
+ * @brief 写入下一个保活计数
+ *
+ * 上一次保活尚未应答时跳过本周期，慢应答不会让请求堆积；
+ * 连续跳过超过超时时间时由PLC停止点动。
+ */
+void ModbusManager::sendJogKeepAlive()
+{
+    if (!m_jogSessionActive || !m_jogKeepAliveSupported) {
+        return;
+    }
+    if (!isClientReady()) {
+        abortJogSession("客户端未连接");
+        return;
+    }
+    if (m_jogKeepAliveInFlight) {
+        return;
+    }
+
+    m_jogKeepAliveCounter = m_jogKeepAliveCounter == 0xFFFF ? 1 : m_jogKeepAliveCounter + 1;
+
+    ModbusCommand command;
+    command.type = ModbusCommand::Write;
+    command.unit = QModbusDataUnit(QModbusDataUnit::HoldingRegisters, ModbusRegisters::JogSession::KEEPALIVE, 1);
+    command.unit.setValue(0, m_jogKeepAliveCounter);
+
+    PendingRequest request;
+    request.operation = QString("点动保活");
+    request.logSuccess = false;
+    request.handler = [this](bool success, const QModbusDataUnit &) {
+        m_jogKeepAliveInFlight = false;
+        if (!success && m_jogSessionActive) {
+            abortJogSession("保活写入失败");
+        }
+    };
+    m_jogKeepAliveInFlight = submitRequest(command, request);
+}
+
+// --- 多动子控制高级接口实现 ---
+
+/**
+ * @brief 设置指定动子的使能状态
+ * @param moverId 动子编号
+ * @param enable true为使能，false为禁用
+ * @return 是否成功发送命令
+ */
+bool ModbusManager::setMultiAxisEnable(int moverId, bool enable)
+{
+    if (moverId < 0) {
+        logOperation("设置动子使能失败", false, QString("无效的动子编号: %1").arg(moverId));
+        return false;
+    }
+    logOperation(QString("设置动子%1使能: %2").arg(moverId).arg(enable ? "使能" : "禁用"), true);
+    return writeHoldingRegister(ModbusRegisters::MultiAxis::ENABLE_BASE_ADDRESS + moverId, enable ? 1 : 0);
+}
+
+/**
+ * @brief 设置指定动子的连续运行速度
+ * @param moverId 动子编号
+ * @param speed 速度 (mm/s)，0为停止
+ * @return 是否成功发送命令
+ */
+bool ModbusManager::setMultiAxisSpeed(int moverId, quint16 speed)
+{
+    if (moverId < 0) {
+        logOperation("设置动子速度失败", false, QString("无效的动子编号: %1").arg(moverId));
+        return false;
+    }
+    logOperation(QString("设置动子%1速度: %2").arg(moverId).arg(speed), true);
+    return writeHoldingRegister(ModbusRegisters::MultiAxis::SPEED_BASE_ADDRESS + moverId, speed);
+}
+
+/**
+ * @brief 提交一组协同定位命令
+ *
+ * 命令块为 [序号, 条目数, 条目...]。序号在提交时分配，lastGroupMoveSequence立即可用；
+ * 上一组尚未被PLC确认时本组先排队，确认后再写入，避免覆盖PLC尚未读取的条目。
+ * 结果通过groupMoveFinished信号返回。
+ * @return 命令是否已接受
+ */
+bool ModbusManager::commitGroupMove(const QVector<GroupMoveCommand> &commands)
+{
+    using namespace ModbusRegisters::GroupMove;
+    if (commands.isEmpty() || commands.size() > MAX_ENTRIES) {
+        logOperation("协同定位失败", false, QString("条目数无效: %1").arg(commands.size()));
+        return false;
+    }
+    if (!isClientReady()) {
+        logOperation("协同定位失败", false, "客户端未连接");
+        return false;
+    }
+    if (!m_groupMoveSequenceValid) {
+        // 未同步时使用的序号可能与PLC上次执行的相同而被忽略
+        logOperation("协同定位失败", false, "触发序号尚未与PLC同步");
+        return false;
+    }
+
+    // 序号跳过0，PLC以非零变化作为触发
+    m_groupMoveSequence = m_groupMoveSequence == 0xFFFF ? 1 : m_groupMoveSequence + 1;
+
+    GroupMoveJob job;
+    job.sequence = m_groupMoveSequence;
+    job.block.resize(ENTRIES + commands.size() * REGISTERS_PER_ENTRY);
+    job.block[SEQUENCE] = job.sequence;
+    job.block[COUNT] = quint16(commands.size());
+    for (int i = 0; i < commands.size(); ++i) {
+        const GroupMoveCommand &command = commands.at(i);
+        const int base = ENTRIES + i * REGISTERS_PER_ENTRY;
+        const quint32 target = quint32(qint32(qRound64(command.targetPosition * 1000.0)));
+        job.block[base + ENTRY_MOVER_ID] = quint16(command.moverId);
+        job.block[base + ENTRY_TARGET_LOW] = quint16(target & 0xFFFF);
+        job.block[base + ENTRY_TARGET_LOW + 1] = quint16(target >> 16);
+        job.block[base + ENTRY_SPEED] = command.speed;
+    }
+
+    logOperation(QString("提交协同定位: 序号=%1, 动子数=%2").arg(job.sequence).arg(commands.size()), true);
+    m_groupMoveQueue.enqueue(job);
+    if (!m_groupMoveInFlight) {
+        startNextGroupMove();
+    }
+    return true;
+}
+
+/**
+ * @brief 连接后读取PLC当前的触发序号，后续序号从它递增
+ *
+ * PLC忽略与上次相同的序号；上位机重启后若从0开始计数，第一组可能恰好等于PLC记住的序号而被丢弃。
+ */
+void ModbusManager::syncGroupMoveSequence()
+{
+    using namespace ModbusRegisters::GroupMove;
+    m_groupMoveSequenceValid = false;
+    readRegistersAsync(BASE_ADDRESS + SEQUENCE, 1, [this](bool success, const QModbusDataUnit &result) {
+        if (!success || result.valueCount() < 1) {
+            logOperation("同步协同定位序号", false, "读取PLC触发序号失败，协同定位不可用");
+            return;
+        }
+        m_groupMoveSequence = result.value(0);
+        m_groupMoveSequenceValid = true;
+        logOperation("同步协同定位序号", true, QString("PLC当前序号: %1").arg(m_groupMoveSequence));
+    });
+}
+
+/**
+ * @brief 从尚未触发的协同定位中移除指定动子
+ *
+ * 排队中的命令块直接删去该动子的条目，删空的命令块不再写出；
+ * 正在分块写入、触发帧尚未提交的命令块在条目写完后不触发，而是按删减后的内容重写。
+ * 触发帧已提交的命令块不受影响。
+ * @param moverId 动子编号
+ */
+void ModbusManager::cancelGroupMoveEntries(int moverId)
+{
+    QVector<quint16> cancelled;
+    for (auto it = m_groupMoveQueue.begin(); it != m_groupMoveQueue.end();) {
+        if (removeGroupMoveEntries(it->block, moverId) && groupMoveEntryCount(it->block) == 0) {
+            cancelled.append(it->sequence);
+            it = m_groupMoveQueue.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (m_groupMoveInFlight && !m_groupMoveCurrent.headSent
+        && removeGroupMoveEntries(m_groupMoveCurrent.block, moverId)) {
+        m_groupMoveCurrent.rewrite = true;
+    }
+
+    // 队列修改完成后再通知，槽函数中可能继续提交协同定位
+    for (quint16 sequence : cancelled) {
+        logOperation(QString("协同定位 序号=%1").arg(sequence), false, "条目已全部取消，未写入");
+        emit groupMoveFinished(sequence, false);
+    }
+}
+
+/**
+ * @brief 开始处理队首的一组协同定位
+ */
+void ModbusManager::startNextGroupMove()
+{
+    if (m_groupMoveQueue.isEmpty()) {
+        return;
+    }
+    m_groupMoveCurrent = m_groupMoveQueue.dequeue();
+    m_groupMoveInFlight = true;
+    writeGroupMoveBlock();
+}
+
+/**
+ * @brief 写入当前一组协同定位的命令块
+ *
+ * 能放进一帧（FC16最多123个寄存器）时，序号、条目数和全部条目在同一次多寄存器写中发出；
+ * 超出一帧时先流水线写入其余条目，全部成功后再写包含序号的首帧，
+ * 任何条目写入失败都不会发出触发。触发帧写入成功后回读ACK_SEQUENCE等待PLC确认。
+ */
+void ModbusManager::writeGroupMoveBlock()
+{
+    using namespace ModbusRegisters::GroupMove;
+    m_groupMoveCurrent.headSent = false;
+    m_groupMoveCurrent.rewrite = false;
+    const quint16 sequence = m_groupMoveCurrent.sequence;
+    const QVector<quint16> block = m_groupMoveCurrent.block;
+
+    // 首帧从序号开始，按整条目截断
+    const int maxWrite = ModbusRegisters::Limits::MAX_WRITE_REGISTERS;
+    const int entriesPerFrame = (maxWrite - ENTRIES) / REGISTERS_PER_ENTRY;
+    const int headLength = ENTRIES + qMin(groupMoveEntryCount(block), entriesPerFrame) * REGISTERS_PER_ENTRY;
+
+    if (headLength == block.size()) {
+        if (!sendGroupMoveHead(headLength)) {
+            finishGroupMove(sequence, false, "请求队列已满");
+        }
+        return;
+    }
+
+    // 其余条目流水线写入，全部成功后才发出触发帧
+    struct TailState {
+        int remaining = 0;
+        bool failed = false;
+        bool aborted = false;           // 有分块未能入队，已直接结束
+    };
+    auto state = QSharedPointer<TailState>::create();
+    const int entriesPerWrite = maxWrite / REGISTERS_PER_ENTRY;
+    for (int offset = headLength; offset < block.size(); offset += entriesPerWrite * REGISTERS_PER_ENTRY) {
+        const int length = qMin(entriesPerWrite * REGISTERS_PER_ENTRY, int(block.size()) - offset);
+        ++state->remaining;
+        const bool queued = writeRegistersAsync(BASE_ADDRESS + offset, block.mid(offset, length),
+            [this, state, headLength, sequence](bool success, const QModbusDataUnit &) {
+                state->failed |= !success;
+                if (--state->remaining > 0 || state->aborted) {
+                    return;
+                }
+                if (state->failed) {
+                    finishGroupMove(sequence, false, "条目写入失败，未触发");
+                } else if (m_groupMoveCurrent.rewrite) {
+                    // 写入期间有动子被取消：不发触发帧，按删减后的内容重写
+                    if (groupMoveEntryCount(m_groupMoveCurrent.block) == 0) {
+                        finishGroupMove(sequence, false, "条目已全部取消，未触发");
+                    } else {
+                        writeGroupMoveBlock();
+                    }
+                } else if (!sendGroupMoveHead(headLength)) {
+                    finishGroupMove(sequence, false, "请求队列已满");
+                }
+            });
+        if (!queued) {
+            // 已入队的条目回调仍会到达，标记后由这里统一结束
+            --state->remaining;
+            state->aborted = true;
+            finishGroupMove(sequence, false, "请求队列已满");
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 写入当前一组的首帧（含序号），PLC据此触发
+ * @param headLength 首帧寄存器数
+ * @return 请求是否已加入队列
+ */
+bool ModbusManager::sendGroupMoveHead(int headLength)
+{
+    using namespace ModbusRegisters::GroupMove;
+    const quint16 sequence = m_groupMoveCurrent.sequence;
+    m_groupMoveCurrent.headSent = true;
+    return writeRegistersAsync(BASE_ADDRESS, m_groupMoveCurrent.block.mid(0, headLength),
+        [this, sequence](bool success, const QModbusDataUnit &) {
+            if (!success) {
+                finishGroupMove(sequence, false, "触发帧写入失败");
+                return;
+            }
+            waitGroupMoveAck(sequence, moverClockMs() + GROUP_MOVE_ACK_TIMEOUT);
+        });
+}
+
+/**
+ * @brief 回读ACK_SEQUENCE直到PLC确认本组或超时
+ * @param sequence 等待确认的序号
+ * @param deadlineMs 截止时间（单调时钟毫秒，见moverClockMs），不受系统时间调整影响
+ */
+void ModbusManager::waitGroupMoveAck(quint16 sequence, qint64 deadlineMs)
+{
+    using namespace ModbusRegisters::GroupMove;
+    if (!m_groupMoveInFlight || m_groupMoveCurrent.sequence != sequence) {
+        return;     // 断线等原因已结束
+    }
+    const bool queued = readRegistersAsync(BASE_ADDRESS + ACK_SEQUENCE, 1,
+        [this, sequence, deadlineMs](bool success, const QModbusDataUnit &result) {
+            if (success && result.valueCount() >= 1 && result.value(0) == sequence) {
+                finishGroupMove(sequence, true);
+                return;
+            }
+            if (!isClientReady()) {
+                finishGroupMove(sequence, false, "连接中断");
+                return;
+            }
+            if (moverClockMs() >= deadlineMs) {
+                // 没有协同定位邮箱的PLC永远不会确认；本次连接不再使用，调用方改走单轴定位
+                m_groupMoveSequenceValid = false;
+                logOperation("协同定位", false, "PLC未确认执行，本次连接停用协同定位");
+                QVector<quint16> dropped;
+                while (!m_groupMoveQueue.isEmpty()) {
+                    dropped.append(m_groupMoveQueue.dequeue().sequence);
+                }
+                finishGroupMove(sequence, false, "PLC未确认执行");
+                for (quint16 queued : dropped) {
+                    emit groupMoveFinished(queued, false);
+                }
+                return;
+            }
+            QTimer::singleShot(GROUP_MOVE_ACK_POLL, this, [this, sequence, deadlineMs]() {
+                waitGroupMoveAck(sequence, deadlineMs);
+            });
+        });
+    if (!queued) {
+        finishGroupMove(sequence, false, "无法回读确认序号");
+    }
+}
+
+/**
+ * @brief 结束当前一组协同定位并开始下一组
+ * @param sequence 序号
+ * @param success PLC是否已确认执行
+ * @param reason 失败原因
+ */
+void ModbusManager::finishGroupMove(quint16 sequence, bool success, const QString &reason)
+{
+    if (!success) {
+        logOperation(QString("协同定位 序号=%1").arg(sequence), false, reason);
+    }
+    m_groupMoveInFlight = false;
+    emit groupMoveFinished(sequence, success);
+    startNextGroupMove();
+}
+
+// --- I/O线程交互 ---
+
+/**
+ * @brief 设置最大在途请求数
+ * @param count 同时等待应答的请求上限（TCP可按事务ID流水线发送，RTU只能为1）
+ */
+void ModbusManager::setMaxInFlight(int count)
+{
+    ModbusCommand command;
+    command.type = ModbusCommand::SetMaxInFlight;
+    command.count = qMax(1, count);
+    submitCommand(command);
+}
+
+/**
+ * @brief 开始记录动子轨迹
+ *
+ * 记录器只在I/O线程中访问，启动结果通过telemetryRecordingChanged信号返回。
+ * @param options 记录参数
+ * @return 命令是否已入队
+ */
+bool ModbusManager::startTelemetryRecording(const TelemetryRecorder::Options &options)
+{
+    ModbusCommand command;
+    command.type = ModbusCommand::StartRecording;
+    command.recorderOptions = options;
+    return submitCommand(command);
+}
+
+/**
+ * @brief 停止记录动子轨迹
+ */
+void ModbusManager::stopTelemetryRecording()
+{
+    ModbusCommand command;
+    command.type = ModbusCommand::StopRecording;
+    submitCommand(command);
+}
+
+/**
+ * @brief 检查是否可以发送请求
+ * @return 已连接时返回true
+ */
+bool ModbusManager::isClientReady() const
+{
+    return m_isConnected;
+}
+
+/**
+ * @brief 向I/O线程投递一条不需要回送结果的命令
+ * @param command 命令
+ * @return 命令是否已入队
+ */
+bool ModbusManager::submitCommand(ModbusCommand &command)
+{
+    if (!m_worker->submit(std::move(command))) {
+        qWarning() << "[MODBUS] 命令队列已满，命令被丢弃";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 向I/O线程投递一条请求，结果回送后调用请求的回调
+ * @param command 命令
+ * @param request 请求的日志信息和回调
+ * @return 请求是否已入队
+ */
+bool ModbusManager::submitRequest(ModbusCommand &command, const PendingRequest &request)
+{
+    command.id = ++m_nextRequestId;
+    const quint64 id = command.id;
+    m_pendingRequests.insert(id, request);
+
+    if (!submitCommand(command)) {
+        m_pendingRequests.remove(id);
+        logOperation(QString("%1 失败").arg(request.operation), false, "命令队列已满");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief I/O线程回送的请求结果
+ * @param id 请求编号
+ * @param success 是否成功
+ * @param startAddress 结果数据起始地址
+ * @param values 读取到的寄存器值
+ * @param errorText 失败时的错误描述
+ */
+void ModbusManager::onWorkerRequestFinished(quint64 id, bool success, int startAddress,
+                                            const QVector<quint16> &values, const QString &errorText)
+{
+    auto it = m_pendingRequests.find(id);
+    if (it == m_pendingRequests.end()) {
+        return; // 断开连接时已按失败处理
+    }
+    const PendingRequest request = it.value();
+    m_pendingRequests.erase(it);
+
+    if (!success) {
+        logOperation(QString("%1 失败").arg(request.operation), false, errorText);
+    } else if (request.logSuccess) {
+        logOperation(request.operation, true, request.details);
+    }
+
+    // 任何覆盖控制字的读取结果都用来刷新影子缓存
+    if (success && request.isRead) {
+        updateControlWordShadow(startAddress, values);
+    }
+
+    if (request.handler) {
+        request.handler(success, QModbusDataUnit(QModbusDataUnit::HoldingRegisters, startAddress, values));
+    }
+    emit requestCompleted(id, success);
+}
+
+/**
+ * @brief 以失败结果结束所有等待回送的请求
+ * @param reason 失败原因
+ */
+void ModbusManager::failPendingRequests(const QString &reason)
+{
+    const QHash<quint64, PendingRequest> requests = m_pendingRequests;
+    m_pendingRequests.clear();
+
+    for (auto it = requests.cbegin(); it != requests.cend(); ++it) {
+        if (it->handler) {
+            it->handler(false, QModbusDataUnit());
+        }
+        emit requestCompleted(it.key(), false);
+    }
+
+    if (!requests.isEmpty()) {
+        logOperation("取消未完成的请求", false, QString("%1, 共%2个").arg(reason).arg(requests.size()));
+    }
+}
+
+/**
+ * @brief 异步读取一段保持寄存器
+ * @param startAddress 起始地址
+ * @param count 寄存器数量
+ * @param handler 完成回调
+ * @return 请求是否已加入队列
+ */
+bool ModbusManager::readRegistersAsync(int startAddress, int count, ReplyHandler handler)
+{
+    if (!isClientReady() || count <= 0) {
+        logOperation("读取寄存器失败", false, "客户端未连接或数量无效");
+        return false;
+    }
+
+    ModbusCommand command;
+    command.type = ModbusCommand::Read;
+    command.unit = QModbusDataUnit(QModbusDataUnit::HoldingRegisters, startAddress, count);
+
+    PendingRequest request;
+    request.isRead = true;
+    request.operation = QString("读取寄存器 %1").arg(startAddress);
+    request.logSuccess = false;
+    request.handler = std::move(handler);
+    return submitRequest(command, request);
+}
+
+/**
+ * @brief 异步写入一段连续的保持寄存器
+ * @param startAddress 起始地址
+ * @param values 要写入的值
+ * @param handler 完成回调（可为空）
+ * @return 请求是否已加入队列
+ */
+bool ModbusManager::writeRegistersAsync(int startAddress, const QVector<quint16> &values, ReplyHandler handler)
+{
+    if (!isClientReady() || values.isEmpty()) {
+        logOperation("写入寄存器失败", false, "客户端未连接或数据为空");
+        return false;
+    }
+
+    ModbusCommand command;
+    command.type = ModbusCommand::Write;
+    command.unit = QModbusDataUnit(QModbusDataUnit::HoldingRegisters, startAddress, values);
+
+    PendingRequest request;
+    request.operation = QString("写入寄存器 %1").arg(startAddress);
+    request.details = QString("数量: %1").arg(values.size());
+    request.handler = std::move(handler);
+    return submitRequest(command, request);
+}
+
+// --- 内部辅助函数 ---
 
 /**
  * @brief 基础写操作：向单个保持寄存器写入一个16位值
  * @param address 寄存器地址
  * @param value 要写入的值
- * @return 操作是否成功
+ * @return 请求是否已加入队列
  */
 bool ModbusManager::writeHoldingRegister(int address, quint16 value)
 {
-    if (!m_modbusClient || m_modbusClient->state() != QModbusDevice::ConnectedState) {
+    if (!isClientReady()) {
         logOperation("写入单个寄存器失败", false, "客户端未连接");
         return false;
     }
 
-    QModbusDataUnit writeUnit(QModbusDataUnit::HoldingRegisters, address, 1);
-    writeUnit.setValue(0, value);
-
-    if (auto *reply = m_modbusClient->sendWriteRequest(writeUnit, m_deviceId)) {
-        // 使用事件循环等待异步操作完成
-        QEventLoop loop;
-        connect(reply, &QModbusReply::finished, &loop, &QEventLoop::quit);
-        loop.exec();
+    ModbusCommand command;
+    command.type = ModbusCommand::Write;
+    command.unit = QModbusDataUnit(QModbusDataUnit::HoldingRegisters, address, 1);
+    command.unit.setValue(0, value);
 
-        if (reply->error() == QModbusDevice::NoError) {
-            logOperation(QString("写入寄存器 %1").arg(address), true, QString("值: %2").arg(value));
-            reply->deleteLater();
-            return true;
-        } else {
-            logOperation(QString("写入寄存器 %1 失败").arg(address), false, reply->errorString());
-            reply->deleteLater();
-            return false;
-        }
-    }
-    logOperation(QString("写入寄存器 %1 失败").arg(address), false, "发送请求失败");
-    return false;
+    PendingRequest request;
+    request.operation = QString("写入寄存器 %1").arg(address);
+    request.details = QString("值: %1").arg(value);
+    return submitRequest(command, request);
 }
 
 /**
  * @brief 写入一个32位整数 (DINT)，它会占用两个连续的16位寄存器
  * @param address 起始寄存器地址 (低位)
  * @param value 要写入的32位值
- * @return 操作是否成功
+ * @return 请求是否已加入队列
  */
 bool ModbusManager::writeHoldingRegisterDINT(int address, qint32 value)
 {
-    if (!m_modbusClient || m_modbusClient->state() != QModbusDevice::ConnectedState) {
+    if (!isClientReady()) {
         logOperation("写入32位整数失败", false, "客户端未连接");
         return false;
     }
@@ -382,161 +1086,346 @@ bool ModbusManager::writeHoldingRegisterDINT(int address, qint32 value)
     quint16 lowWord = value & 0xFFFF;
     quint16 highWord = (value >> 16) & 0xFFFF;
 
-    QModbusDataUnit writeUnit(QModbusDataUnit::HoldingRegisters, address, 2);
-    writeUnit.setValue(0, lowWord);
-    writeUnit.setValue(1, highWord);
+    ModbusCommand command;
+    command.type = ModbusCommand::Write;
+    command.unit = QModbusDataUnit(QModbusDataUnit::HoldingRegisters, address, 2);
+    command.unit.setValue(0, lowWord);
+    command.unit.setValue(1, highWord);
 
-    if (auto *reply = m_modbusClient->sendWriteRequest(writeUnit, m_deviceId)) {
-        QEventLoop loop;
-        connect(reply, &QModbusReply::finished, &loop, &QEventLoop::quit);
-        loop.exec();
+    PendingRequest request;
+    request.operation = QString("写入32位整数到 %1").arg(address);
+    request.details = QString("值: %1").arg(value);
+    return submitRequest(command, request);
+}
 
-        if (reply->error() == QModbusDevice::NoError) {
-            logOperation(QString("写入32位整数到 %1").arg(address), true, QString("值: %1").arg(value));
-            reply->deleteLater();
-            return true;
-        } else {
-            logOperation(QString("写入32位整数到 %1 失败").arg(address), false, reply->errorString());
-            reply->deleteLater();
-            return false;
-        }
-    }
-    logOperation(QString("写入32位整数到 %1 失败").arg(address), false, "发送请求失败");
-    return false;
+/**
+ * @brief 异步读取一段保持寄存器，成功后通过dataReceived信号发出
+ * @param startAddress 起始地址
+ * @param count 寄存器数量
+ * @param handler 额外的完成回调（可为空）
+ * @return 请求是否已加入队列
+ */
+bool ModbusManager::readHoldingRegisters(int startAddress, int count, ReplyHandler handler)
+{
+    return readRegistersAsync(startAddress, count,
+        [this, startAddress, handler](bool success, const QModbusDataUnit &result) {
+            if (success) {
+                emit dataReceived(startAddress, result.values());
+            }
+            if (handler) {
+                handler(success, result);
+            }
+        });
 }
 
 /**
  * @brief 读取所有动子的状态数据
- * @param movers 动子数据列表，函数将用从PLC读取的数据更新此列表
- * @return 操作是否成功
+ *
+ * 超过单帧上限时按动子对齐拆分为多个读请求一次性排队（TCP下流水线发送），
+ * 全部返回后拼接为完整数据块，通过dataReceived(moverStatusBase(), ...)
+ * 交给主窗口解析。上一次读取尚未返回时不会重复排队。
+ * @param moverCount 动子数量
+ * @return 请求是否已加入队列（或已有读取在途）
  */
-bool ModbusManager::readAllMoverData(QList<MoverData> &movers)
+bool ModbusManager::readAllMoverData(int moverCount)
 {
-    if (!m_modbusClient || m_modbusClient->state() != QModbusDevice::ConnectedState || movers.isEmpty()) {
+    if (!isClientReady() || moverCount <= 0) {
         return false;
     }
-
-    const int startAddress = ModbusRegisters::MoverStatus::BASE_ADDRESS;
-    const int moverCount = movers.size();
-    const int registersPerMover = ModbusRegisters::MoverStatus::REGISTERS_PER_MOVER;
-    const int registerCount = moverCount * registersPerMover;
-
-    QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, startAddress, registerCount);
-
-    if (auto *reply = m_modbusClient->sendReadRequest(readUnit, m_deviceId)) {
-        QEventLoop loop;
-        connect(reply, &QModbusReply::finished, &loop, &QEventLoop::quit);
-        loop.exec();
-
-        if (reply->error() == QModbusDevice::NoError) {
-            const QVector<quint16> data = reply->result().values();
-            // 解析数据并更新movers列表 (这部分逻辑与MainWindow中的类似)
-            for (int i = 0; i < moverCount; ++i) {
-                int baseIdx = i * registersPerMover;
-                if (baseIdx + 3 < data.size()) { // 简单检查边界
-                    qint32 pos = (data[baseIdx + 1] << 16) | data[baseIdx];
-                    qint32 spd = (data[baseIdx + 3] << 16) | data[baseIdx + 2];
-                    movers[i].position = pos / 1000.0;
-                    movers[i].speed = spd / 1000.0;
+    if (m_moverReadPending) {
+        return true;
+    }
+    moverCount = qMin(moverCount, moverCapacity());
+
+    const int startAddress = m_moverStatusBase;
+    const int registerCount = moverCount * ModbusRegisters::MoverStatus::REGISTERS_PER_MOVER;
+    const QVector<MoverStatusDecoder::ReadChunk> chunks = MoverStatusDecoder::planChunks(startAddress, registerCount);
+
+    struct Assembly {
+        QVector<quint16> values;
+        int remaining = 0;
+        bool failed = false;
+    };
+    auto assembly = QSharedPointer<Assembly>::create();
+    assembly->values.resize(registerCount);
+    assembly->remaining = chunks.size();
+
+    m_moverReadPending = true;
+    for (int i = 0; i < chunks.size(); ++i) {
+        const MoverStatusDecoder::ReadChunk chunk = chunks.at(i);
+        const bool queued = readRegistersAsync(chunk.startAddress, chunk.count,
+            [this, chunk, startAddress, assembly](bool success, const QModbusDataUnit &result) {
+                if (!success || static_cast<int>(result.valueCount()) != chunk.count) {
+                    assembly->failed = true;
+                } else {
+                    const QVector<quint16> chunkValues = result.values();
+                    std::copy(chunkValues.cbegin(), chunkValues.cend(),
+                              assembly->values.begin() + (chunk.startAddress - startAddress));
+                }
+                if (--assembly->remaining > 0) {
+                    return;
                 }
+                m_moverReadPending = false;
+                if (!assembly->failed) {
+                    emit dataReceived(startAddress, assembly->values);
+                }
+            });
+        if (!queued) {
+            // 已排队的分块返回后按失败处理
+            assembly->failed = true;
+            assembly->remaining -= chunks.size() - i;
+            if (assembly->remaining <= 0) {
+                m_moverReadPending = false;
+                return false;
             }
-            reply->deleteLater();
-            return true;
-        } else {
-            logOperation("批量读取动子数据失败", false, reply->errorString());
-            reply->deleteLater();
+            break;
         }
     }
-    return false;
+    return m_moverReadPending;
 }
 
 /**
- * @brief 核心位操作函数：读取-修改-写回一个寄存器的特定位
+ * @brief 核心位操作函数：修改控制字的特定位
  * @param bit 要操作的位索引 (0-15)
  * @param value true表示置1，false表示清0
- * @return 操作是否成功
+ * @return 请求是否已加入队列
  */
 bool ModbusManager::setControlWordBit(int bit, bool value)
 {
-    if (!m_modbusClient || m_modbusClient->state() != QModbusDevice::ConnectedState || bit < 0 || bit > 15) {
-        logOperation("位操作失败", false, "客户端未连接或位索引无效");
+    if (bit < 0 || bit > 15) {
+        logOperation("位操作失败", false, "位索引无效");
         return false;
     }
+    const quint16 mask = 1 << bit;
+    return value ? setControlWordBits(mask, 0) : setControlWordBits(0, mask);
+}
 
-    // 1. 同步读取当前的控制字
-    quint16 currentWord = 0;
-    QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, ModbusRegisters::SingleAxis::CONTROL_WORD, 1);
-    if (auto *readReply = m_modbusClient->sendReadRequest(readUnit, m_deviceId)) {
-        QEventLoop loop;
-        connect(readReply, &QModbusReply::finished, &loop, &QEventLoop::quit);
-        loop.exec();
-
-        if (readReply->error() == QModbusDevice::NoError) {
-            currentWord = readReply->result().value(0);
-        } else {
-            logOperation("位操作读取阶段失败", false, readReply->errorString());
-            readReply->deleteLater();
-            return false;
-        }
-        readReply->deleteLater();
-    } else {
-        logOperation("位操作读取阶段失败", false, "发送请求失败");
+/**
+ * @brief 批量修改控制字的位
+ *
+ * 修改先记录到待写掩码中，在当前事件循环周期结束后合并为一次写入，
+ * 因此连续调用多个setSingleAxisXxx只产生一个Modbus事务。
+ * @param setMask 需要置1的位
+ * @param clearMask 需要清0的位
+ * @return 请求是否已加入队列
+ */
+bool ModbusManager::setControlWordBits(quint16 setMask, quint16 clearMask)
+{
+    if (!isClientReady()) {
+        logOperation("位操作失败", false, "客户端未连接");
         return false;
     }
 
-    // 2. 修改位
-    if (value) {
-        currentWord |= (1 << bit); // 置1
+    // 后到的修改覆盖先前对同一位的修改
+    m_pendingSetMask = (m_pendingSetMask & ~clearMask) | setMask;
+    m_pendingClearMask = (m_pendingClearMask & ~setMask) | clearMask;
+
+    if (!m_controlWordFlushScheduled) {
+        m_controlWordFlushScheduled = true;
+        QTimer::singleShot(0, this, &ModbusManager::flushControlWord);
+    }
+    return true;
+}
+
+/**
+ * @brief 将合并后的控制字修改写入PLC
+ *
+ * 影子缓存有效时直接写入完整控制字（一次FC06）；
+ * 缓存无效时交给I/O线程做0x16掩码写（PLC不支持时由I/O线程退回读-改-写）。
+ */
+void ModbusManager::flushControlWord()
+{
+    m_controlWordFlushScheduled = false;
+    const quint16 setMask = m_pendingSetMask;
+    const quint16 clearMask = m_pendingClearMask;
+    m_pendingSetMask = 0;
+    m_pendingClearMask = 0;
+
+    if ((setMask | clearMask) == 0 || !isClientReady()) {
+        return;
+    }
+
+    const quint16 andMask = static_cast<quint16>(~(setMask | clearMask));
+    const quint16 orMask = setMask;
+
+    ModbusCommand command;
+    PendingRequest request;
+
+    if (m_controlWordValid) {
+        const quint16 newWord = (m_controlWordShadow & andMask) | orMask;
+        m_controlWordShadow = newWord; // 乐观更新，失败时作废
+
+        command.type = ModbusCommand::Write;
+        command.unit = QModbusDataUnit(QModbusDataUnit::HoldingRegisters, ModbusRegisters::SingleAxis::CONTROL_WORD, 1);
+        command.unit.setValue(0, newWord);
+        request.operation = QString("写入控制字");
+        request.details = QString("值: 0x%1").arg(newWord, 4, 16, QChar('0'));
+        request.handler = [this](bool success, const QModbusDataUnit &) {
+            m_controlWordWritesInFlight--;
+            if (!success) {
+                invalidateControlWordShadow();
+            }
+        };
     } else {
-        currentWord &= ~(1 << bit); // 清0
+        command.type = ModbusCommand::MaskWrite;
+        command.startAddress = ModbusRegisters::SingleAxis::CONTROL_WORD;
+        command.andMask = andMask;
+        command.orMask = orMask;
+        request.operation = QString("掩码写控制字");
+        request.details = QString("AND: 0x%1, OR: 0x%2").arg(andMask, 4, 16, QChar('0')).arg(orMask, 4, 16, QChar('0'));
+        request.handler = [this](bool success, const QModbusDataUnit &result) {
+            m_controlWordWritesInFlight--;
+            if (!success) {
+                return;
+            }
+            if (result.valueCount() >= 1) {
+                // 退回读-改-写时I/O线程带回了写入的完整值
+                m_controlWordShadow = result.value(0);
+                m_controlWordValid = true;
+            } else {
+                // 0x16掩码写后PLC中的完整值未知，重新读取以建立镜像
+                refreshControlWordShadow();
+            }
+        };
     }
 
-    // 3. 写回修改后的值
-    return writeHoldingRegister(ModbusRegisters::SingleAxis::CONTROL_WORD, currentWord);
+    if (submitRequest(command, request)) {
+        m_controlWordWritesInFlight++;
+    } else {
+        m_controlWordValid = false;
+    }
 }
 
-
 /**
- * @brief 设置Modbus客户端的信号槽连接
+ * @brief 发起一次控制字读取以刷新影子缓存
  */
-void ModbusManager::setupModbusClient()
+void ModbusManager::refreshControlWordShadow()
 {
-    if (!m_modbusClient) return;
+    if (!isClientReady()) {
+        return;
+    }
+    // 结果在onWorkerRequestFinished中更新镜像
+    readRegistersAsync(ModbusRegisters::SingleAxis::CONTROL_WORD, 1, nullptr);
+}
 
-    // 连接错误和状态变化的信号
-    connect(m_modbusClient, &QModbusDevice::errorOccurred,
-            this, &ModbusManager::onModbusError);
+/**
+ * @brief 用读取结果刷新控制字影子缓存
+ *
+ * 有控制字写入在途或尚未发出时忽略读取结果，避免旧值覆盖乐观更新。
+ * @param startAddress 读取起始地址
+ * @param values 读取到的寄存器值
+ */
+void ModbusManager::updateControlWordShadow(int startAddress, const QVector<quint16> &values)
+{
+    const int offset = ModbusRegisters::SingleAxis::CONTROL_WORD - startAddress;
+    if (offset < 0 || offset >= values.size()) {
+        return;
+    }
+    if (m_controlWordWritesInFlight > 0 || m_controlWordFlushScheduled) {
+        return;
+    }
+    m_controlWordShadow = values.at(offset);
+    m_controlWordValid = true;
+}
 
-    logOperation("Modbus客户端事件绑定", true, "错误和状态变化监听已设置");
+/**
+ * @brief 作废控制字影子缓存并重新读取
+ */
+void ModbusManager::invalidateControlWordShadow()
+{
+    m_controlWordValid = false;
+    refreshControlWordShadow();
 }
 
+
 /**
- * @brief 清理Modbus客户端对象和缓存
+ * @brief 清理连接相关的状态
  */
 void ModbusManager::cleanup()
 {
-    if (m_modbusClient) {
-        m_modbusClient->deleteLater();
-        m_modbusClient = nullptr;
-    }
+    m_pendingRequests.clear();
+    m_moverReadPending = false;
+
+    // 新连接需要重新建立控制字镜像
+    m_controlWordValid = false;
+    m_pendingSetMask = 0;
+    m_pendingClearMask = 0;
+    m_controlWordWritesInFlight = 0;
+
+    m_connectRequested = false;
     m_isConnected = false;
-    logOperation("资源清理", true, "客户端对象和缓存已清理");
+    logOperation("资源清理", true, "连接状态和缓存已清理");
 }
 
 
 /**
- * @brief Modbus设备发生错误时的槽函数
+ * @brief I/O线程报告Modbus设备错误
  * @param error 错误类型
+ * @param errorText 客户端给出的错误描述
  */
-void ModbusManager::onModbusError(QModbusDevice::Error error)
+void ModbusManager::onWorkerDeviceError(int error, const QString &errorText)
 {
-    QString errorMsg = errorString(error);
-    logOperation("Modbus设备错误", false, QString("错误码: %1, 描述: %2").arg(error).arg(errorMsg));
+    QString errorMsg = errorString(static_cast<QModbusDevice::Error>(error));
+    logOperation("Modbus设备错误", false, QString("错误码: %1, 描述: %2 %3").arg(error).arg(errorMsg, errorText));
 
-    m_failedOperations++;
     emit connectionError(errorMsg);
 }
 
+/**
+ * @brief I/O线程报告轨迹记录状态变化
+ * @param recording 是否正在记录
+ * @param filePath 记录目录（开始时）或最后一个分段文件（停止时）
+ * @param errorText 失败原因，正常启停时为空
+ */
+void ModbusManager::onWorkerRecordingStateChanged(bool recording, const QString &filePath, const QString &errorText)
+{
+    m_telemetryRecording = recording;
+    if (errorText.isEmpty()) {
+        logOperation(recording ? "开始记录动子轨迹" : "停止记录动子轨迹", true, filePath);
+    } else {
+        logOperation("动子轨迹记录", false, errorText);
+    }
+    emit telemetryRecordingChanged(recording, filePath, errorText);
+}
+
+/**
+ * @brief I/O线程报告连接状态变化
+ * @param state 新的连接状态
+ */
+void ModbusManager::onWorkerStateChanged(int state)
+{
+    if (!m_connectRequested) {
+        return; // 已主动断开，忽略滞后的状态通知
+    }
+
+    if (state == QModbusDevice::ConnectedState) {
+        m_isConnected = true;
+        logOperation("设备已连接", true, getConnectionInfo());
+        emit connected();
+        refreshControlWordShadow();
+        probeJogKeepAlive();
+        syncGroupMoveSequence();
+    } else if (state == QModbusDevice::UnconnectedState && m_isConnected) {
+        m_isConnected = false;
+        stopCyclicRead();
+        if (m_jogSessionActive) {
+            abortJogSession(m_jogKeepAliveSupported ? "连接中断，PLC将在保活超时后停止点动"
+                                                    : "连接中断，PLC无保活寄存器，请确认动子已停止");
+        }
+        m_jogKeepAliveSupported = false;
+        m_groupMoveSequenceValid = false;
+        while (!m_groupMoveQueue.isEmpty()) {
+            emit groupMoveFinished(m_groupMoveQueue.dequeue().sequence, false);
+        }
+        failPendingRequests("连接中断");
+        m_moverReadPending = false;
+        m_controlWordValid = false;
+        m_controlWordWritesInFlight = 0;
+        logOperation("设备连接已断开", false);
+        emit disconnected();
+    }
+}
+
 /**
  * @brief 将Modbus错误枚举转换为字符串描述
  * @param error 错误类型
@@ -566,27 +1455,31 @@ QString ModbusManager::errorString(QModbusDevice::Error error) const
     }
 }
 
-// --- 参数设置命令实现 ---
-
-/**
- * @brief 设置系统中的动子数量
- * @param count 动子数量
- * @return 是否成功发送命令
- */
-
 // --- 周期性任务 ---
 
 /**
  * @brief 启动周期性读取任务
- * @param intervalMs 读取间隔，单位毫秒
+ *
+ * 动子状态块按intervalMs扫描，系统状态和控制字扫描周期为其5倍，
+ * 可通过setScanGroupPeriod单独调整。扫描在I/O线程中按各组周期进行。
+ * @param intervalMs 动子状态扫描间隔，单位毫秒
  */
 void ModbusManager::startCyclicRead(int intervalMs)
 {
-    if (m_cyclicTimer->isActive()) {
-        m_cyclicTimer->stop();
+    intervalMs = qMax(10, intervalMs);
+    m_scanGroups[MoverScanGroup].periodMs = intervalMs;
+    m_scanGroups[SystemScanGroup].periodMs = intervalMs * 5;
+    m_scanGroups[ControlWordScanGroup].periodMs = intervalMs * 5;
+    for (int i = 0; i < m_scanGroups.size(); ++i) {
+        submitScanGroup(i);
     }
-    m_cyclicTimer->start(intervalMs);
-    logOperation("开始周期性读取", true, QString("间隔: %1ms").arg(intervalMs));
+
+    ModbusCommand command;
+    command.type = ModbusCommand::StartScan;
+    submitCommand(command);
+
+    m_cyclicReadActive = true;
+    logOperation("开始周期性读取", true, QString("间隔: %1ms, 扫描组: %2").arg(intervalMs).arg(m_scanGroups.size()));
 }
 
 /**
@@ -594,8 +1487,142 @@ void ModbusManager::startCyclicRead(int intervalMs)
  */
 void ModbusManager::stopCyclicRead()
 {
-    if (m_cyclicTimer->isActive()) {
-        m_cyclicTimer->stop();
-        logOperation("停止周期性读取", true, "定时器已停止");
+    if (m_cyclicReadActive) {
+        m_cyclicReadActive = false;
+        ModbusCommand command;
+        command.type = ModbusCommand::StopScan;
+        submitCommand(command);
+        logOperation("停止周期性读取", true, "扫描已停止");
+    }
+}
+
+// --- 扫描组 ---
+
+/**
+ * @brief 建立默认扫描组：动子状态块、系统状态块、控制字
+ */
+void ModbusManager::initializeScanGroups()
+{
+    m_scanGroups.clear();
+    addScanGroup("动子状态", m_moverStatusBase,
+                 m_scanMoverCount * ModbusRegisters::MoverStatus::REGISTERS_PER_MOVER, 200);
+    addScanGroup("系统状态", ModbusRegisters::SystemStatus::SYSTEM_READY,
+                 ModbusRegisters::SystemStatus::MOVER_COUNT - ModbusRegisters::SystemStatus::SYSTEM_READY + 1, 1000);
+    addScanGroup("控制字", ModbusRegisters::SingleAxis::CONTROL_WORD, 1, 1000);
+}
+
+/**
+ * @brief 把扫描组配置同步到I/O线程
+ * @param groupId 扫描组编号
+ */
+void ModbusManager::submitScanGroup(int groupId)
+{
+    const ScanGroup &group = m_scanGroups.at(groupId);
+    ModbusCommand command;
+    command.type = ModbusCommand::ConfigureScanGroup;
+    command.groupId = groupId;
+    command.startAddress = group.startAddress;
+    command.count = group.count;
+    command.periodMs = group.periodMs;
+    command.enabled = group.enabled;
+    submitCommand(command);
+}
+
+/**
+ * @brief 添加一个扫描组
+ * @param name 扫描组名称（用于日志）
+ * @param startAddress 起始寄存器地址
+ * @param count 寄存器数量
+ * @param periodMs 扫描周期，单位毫秒
+ * @return 扫描组编号
+ */
+int ModbusManager::addScanGroup(const QString &name, int startAddress, int count, int periodMs)
+{
+    ScanGroup group;
+    group.name = name;
+    group.startAddress = startAddress;
+    group.count = count;
+    group.periodMs = qMax(10, periodMs);
+    m_scanGroups.append(group);
+
+    const int groupId = m_scanGroups.size() - 1;
+    submitScanGroup(groupId);
+    return groupId;
+}
+
+/**
+ * @brief 设置扫描组的扫描周期
+ * @param groupId 扫描组编号
+ * @param periodMs 扫描周期，单位毫秒
+ */
+void ModbusManager::setScanGroupPeriod(int groupId, int periodMs)
+{
+    if (groupId < 0 || groupId >= m_scanGroups.size()) {
+        return;
+    }
+    m_scanGroups[groupId].periodMs = qMax(10, periodMs);
+    submitScanGroup(groupId);
+}
+
+/**
+ * @brief 启用或禁用扫描组
+ * @param groupId 扫描组编号
+ * @param enabled 是否启用
+ */
+void ModbusManager::setScanGroupEnabled(int groupId, bool enabled)
+{
+    if (groupId < 0 || groupId >= m_scanGroups.size()) {
+        return;
+    }
+    m_scanGroups[groupId].enabled = enabled;
+    submitScanGroup(groupId);
+}
+
+/**
+ * @brief 设置动子状态扫描组覆盖的动子数量
+ * @param moverCount 动子数量
+ */
+void ModbusManager::setScanMoverCount(int moverCount)
+{
+    m_scanMoverCount = qBound(1, moverCount, moverCapacity());
+    m_scanGroups[MoverScanGroup].count = m_scanMoverCount * ModbusRegisters::MoverStatus::REGISTERS_PER_MOVER;
+    submitScanGroup(MoverScanGroup);
+}
+
+/**
+ * @brief 设置动子状态块基址
+ *
+ * 基址须保证至少一个动子的状态块不与其他寄存器区重叠；
+ * 扫描覆盖的动子数按新基址下的容量重新截取。
+ * @param baseAddress 状态块基址
+ * @return 基址是否可用
+ */
+bool ModbusManager::setMoverStatusBase(int baseAddress)
+{
+    if (MoverStatusDecoder::capacityAt(baseAddress) < 1) {
+        logOperation("设置动子状态基址", false,
+                     QString("基址 %1 与其他寄存器区重叠").arg(baseAddress));
+        return false;
     }
+
+    m_moverStatusBase = baseAddress;
+    m_scanGroups[MoverScanGroup].startAddress = baseAddress;
+    setScanMoverCount(m_scanMoverCount);
+    return true;
+}
+
+int ModbusManager::moverCapacity() const
+{
+    return MoverStatusDecoder::capacityAt(m_moverStatusBase);
+}
+
+/**
+ * @brief I/O线程报告扫描组数据变化
+ * @param startAddress 扫描组起始地址
+ * @param values 新的寄存器值
+ */
+void ModbusManager::onScanDataChanged(int startAddress, const QVector<quint16> &values)
+{
+    updateControlWordShadow(startAddress, values);
+    emit dataReceived(startAddress, values);
 }
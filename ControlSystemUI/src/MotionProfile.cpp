@@ -0,0 +1,184 @@
+#include "MotionProfile.h"
+#include <QtMath>
+#include <cmath>
+
+/**
+ * @brief 规划从 start 到 target 的静止到静止运动曲线
+ * @param trackLength 环线全长；不大于0时按直线处理
+ * @return 参数无效（速度或加速度不为正）时返回无效曲线
+ */
+MotionProfile MotionProfile::plan(double start, double target, double trackLength,
+                                  MoverData::MovementDirection direction,
+                                  Shape shape, const Limits &limits)
+{
+    MotionProfile profile;
+    if (limits.maxSpeed <= 0.0 || limits.acceleration <= 0.0) {
+        return profile;
+    }
+
+    profile.m_trackLength = trackLength;
+    profile.m_start = profile.wrap(start);
+    profile.m_end = profile.wrap(target);
+    profile.m_shape = (shape == SCurve && limits.jerk > 0.0) ? SCurve : Trapezoidal;
+
+    // 按方向规则确定行程
+    if (trackLength > 0.0) {
+        const double forward = profile.wrap(profile.m_end - profile.m_start);
+        const double backward = forward > 0.0 ? trackLength - forward : 0.0;
+        switch (direction) {
+        case MoverData::COUNTERCLOCKWISE:
+            profile.m_direction = 1.0;
+            profile.m_distance = forward;
+            break;
+        case MoverData::CLOCKWISE:
+            profile.m_direction = -1.0;
+            profile.m_distance = backward;
+            break;
+        default:
+            profile.m_direction = forward <= backward ? 1.0 : -1.0;
+            profile.m_distance = qMin(forward, backward);
+            break;
+        }
+    } else {
+        profile.m_direction = target >= start ? 1.0 : -1.0;
+        profile.m_distance = qAbs(target - start);
+    }
+
+    profile.m_valid = true;
+    const double D = profile.m_distance;
+    if (D <= 0.0) {
+        return profile;
+    }
+
+    const double A = limits.acceleration;
+    double V = limits.maxSpeed;
+
+    if (profile.m_shape == Trapezoidal) {
+        // 加速段走过 V²/2A，加减速两段之和超过行程时降低峰值速度
+        if (V * V / A > D) {
+            V = std::sqrt(D * A);
+        }
+        const double ta = V / A;
+        const double tv = (D - V * ta) / V;
+        profile.appendSegment(ta, A, 0.0);
+        profile.appendSegment(tv, 0.0, 0.0);
+        profile.appendSegment(ta, -A, 0.0);
+        profile.m_peakAcceleration = A;
+    } else {
+        const double J = limits.jerk;
+        // 对称S形加速段：达到 A 需 A/J；速度不足 A²/J 时加速度到不了 A
+        auto accelTime = [A, J](double v) {
+            return v >= A * A / J ? v / A + A / J : 2.0 * std::sqrt(v / J);
+        };
+        // 加速段行程为 v·Ta/2，加减速合计 v·Ta
+        if (V * accelTime(V) > D) {
+            const double k = A * A / J;
+            V = (-k + std::sqrt(k * k + 4.0 * D * A)) / 2.0;
+            if (V < k) {
+                V = std::pow(D * std::sqrt(J) / 2.0, 2.0 / 3.0);
+            }
+        }
+        const double ta = accelTime(V);
+        const double tj = V >= A * A / J ? A / J : ta / 2.0;
+        const double ap = J * tj;
+        const double tc = ta - 2.0 * tj;
+        const double tv = (D - V * ta) / V;
+
+        profile.appendSegment(tj, 0.0, J);
+        profile.appendSegment(tc, ap, 0.0);
+        profile.appendSegment(tj, ap, -J);
+        profile.appendSegment(tv, 0.0, 0.0);
+        profile.appendSegment(tj, 0.0, -J);
+        profile.appendSegment(tc, -ap, 0.0);
+        profile.appendSegment(tj, -ap, J);
+        profile.m_peakAcceleration = ap;
+    }
+    profile.m_peakSpeed = V;
+    return profile;
+}
+
+// 追加一段恒定加加速度的分段，起点状态取上一段的终点
+void MotionProfile::appendSegment(double duration, double a0, double jerk)
+{
+    if (duration <= 1e-9) {
+        return;
+    }
+    Segment segment;
+    segment.t0 = m_duration;
+    segment.duration = duration;
+    segment.a0 = a0;
+    segment.jerk = jerk;
+    if (!m_segments.isEmpty()) {
+        const Segment &prev = m_segments.last();
+        const double dt = prev.duration;
+        segment.s0 = prev.s0 + prev.v0 * dt + prev.a0 * dt * dt / 2.0 + prev.jerk * dt * dt * dt / 6.0;
+        segment.v0 = prev.v0 + prev.a0 * dt + prev.jerk * dt * dt / 2.0;
+    }
+    m_segments.append(segment);
+    m_duration += duration;
+}
+
+const MotionProfile::Segment *MotionProfile::segmentAt(double t) const
+{
+    for (const Segment &segment : m_segments) {
+        if (t < segment.t0 + segment.duration) {
+            return &segment;
+        }
+    }
+    return m_segments.isEmpty() ? nullptr : &m_segments.last();
+}
+
+double MotionProfile::travelledAt(double t) const
+{
+    if (t >= m_duration) {
+        return m_distance;
+    }
+    const Segment *segment = segmentAt(qMax(0.0, t));
+    if (!segment) {
+        return 0.0;
+    }
+    const double dt = qMax(0.0, t) - segment->t0;
+    const double s = segment->s0 + segment->v0 * dt + segment->a0 * dt * dt / 2.0
+                     + segment->jerk * dt * dt * dt / 6.0;
+    return qBound(0.0, s, m_distance);
+}
+
+double MotionProfile::speedAt(double t) const
+{
+    if (t <= 0.0 || t >= m_duration) {
+        return 0.0;
+    }
+    const Segment *segment = segmentAt(t);
+    const double dt = t - segment->t0;
+    return qMax(0.0, segment->v0 + segment->a0 * dt + segment->jerk * dt * dt / 2.0);
+}
+
+double MotionProfile::positionAt(double t) const
+{
+    return wrap(m_start + m_direction * travelledAt(t));
+}
+
+bool MotionProfile::envelopeContains(double position, double margin) const
+{
+    if (!m_valid) {
+        return false;
+    }
+    // 在运动方向坐标系中看 position 是否落在 [-margin, distance + margin]
+    double offset = m_direction * (position - m_start);
+    if (m_trackLength > 0.0) {
+        offset = wrap(offset + margin) - margin;
+    }
+    return offset >= -margin && offset <= m_distance + margin;
+}
+
+double MotionProfile::wrap(double position) const
+{
+    if (m_trackLength <= 0.0) {
+        return position;
+    }
+    double wrapped = std::fmod(position, m_trackLength);
+    if (wrapped < 0.0) {
+        wrapped += m_trackLength;
+    }
+    return wrapped >= m_trackLength ? 0.0 : wrapped;
+}
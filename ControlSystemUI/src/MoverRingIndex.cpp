@@ -0,0 +1,262 @@
+#include "MoverRingIndex.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+MoverRingIndex::MoverRingIndex(double trackLength)
+    : m_trackLength(trackLength)
+{
+}
+
+/**
+ * @brief 按给定位置重建整个索引（动子数量变化或整表刷新时调用），O(n log n)
+ */
+void MoverRingIndex::reset(const QVector<double> &positions)
+{
+    const int n = positions.size();
+    m_positions.resize(n);
+    for (int i = 0; i < n; ++i) {
+        m_positions[i] = wrap(positions[i]);
+    }
+
+    m_order.resize(n);
+    std::iota(m_order.begin(), m_order.end(), 0);
+    std::stable_sort(m_order.begin(), m_order.end(), [this](int a, int b) {
+        return m_positions[a] < m_positions[b];
+    });
+
+    m_rank.resize(n);
+    for (int r = 0; r < n; ++r) {
+        m_rank[m_order[r]] = r;
+    }
+}
+
+/**
+ * @brief 增量更新单个动子的位置
+ *
+ * 仍位于原先两个邻居之间时只改位置；否则二分查找新名次，
+ * 用rotate只搬动被越过的那一段并修正其名次。
+ * 越过轨道起点（0/全长接缝）时需要从序列一端搬到另一端，是少见的O(n)情况。
+ */
+void MoverRingIndex::updatePosition(int id, double position)
+{
+    if (id < 0 || id >= m_positions.size()) {
+        return;
+    }
+    m_positions[id] = wrap(position);
+    const double p = m_positions[id];
+    const int r = m_rank[id];
+    const int n = m_order.size();
+    auto byPosition = [this](double value, int other) { return value < m_positions[other]; };
+
+    if (r + 1 < n && p > m_positions[m_order[r + 1]]) {
+        // 向后移：在 (r, n) 中找第一个位置大于p的名次
+        const auto first = m_order.begin() + r + 1;
+        const auto it = std::upper_bound(first, m_order.end(), p, byPosition);
+        const int k = int(it - m_order.begin());
+        std::rotate(m_order.begin() + r, first, it);
+        for (int i = r; i < k; ++i) {
+            m_rank[m_order[i]] = i;
+        }
+    } else if (r > 0 && p < m_positions[m_order[r - 1]]) {
+        // 向前移：在 [0, r) 中找第一个位置不小于p的名次
+        const auto last = m_order.begin() + r;
+        const auto it = std::lower_bound(m_order.begin(), last, p, [this](int other, double value) {
+            return m_positions[other] < value;
+        });
+        const int k = int(it - m_order.begin());
+        std::rotate(it, last, last + 1);
+        for (int i = k; i <= r; ++i) {
+            m_rank[m_order[i]] = i;
+        }
+    }
+}
+
+int MoverRingIndex::aheadOf(int id) const
+{
+    const int n = m_order.size();
+    if (n < 2 || id < 0 || id >= n) {
+        return -1;
+    }
+    return m_order[(m_rank[id] + 1) % n];
+}
+
+int MoverRingIndex::behindOf(int id) const
+{
+    const int n = m_order.size();
+    if (n < 2 || id < 0 || id >= n) {
+        return -1;
+    }
+    return m_order[(m_rank[id] + n - 1) % n];
+}
+
+/**
+ * @brief 与正方向上相邻动子之间的距离；只有一个动子时返回整圈长度
+ */
+double MoverRingIndex::gapAhead(int id) const
+{
+    const int other = aheadOf(id);
+    if (other < 0) {
+        return m_trackLength;
+    }
+    return wrap(m_positions[other] - m_positions[id]);
+}
+
+double MoverRingIndex::gapBehind(int id) const
+{
+    const int other = behindOf(id);
+    if (other < 0) {
+        return m_trackLength;
+    }
+    return wrap(m_positions[id] - m_positions[other]);
+}
+
+int MoverRingIndex::firstAtOrAfter(double position) const
+{
+    if (m_order.isEmpty()) {
+        return -1;
+    }
+    const double p = wrap(position);
+    const auto it = std::lower_bound(m_order.begin(), m_order.end(), p, [this](int other, double value) {
+        return m_positions[other] < value;
+    });
+    // 越过末尾即绕回轨道起点
+    return it == m_order.end() ? m_order.first() : *it;
+}
+
+/**
+ * @brief 全线最小车距，O(n)；behindId返回该间隙后方的动子
+ */
+double MoverRingIndex::minimumGap(int *behindId) const
+{
+    double best = m_trackLength;
+    int bestId = -1;
+    for (int id : m_order) {
+        const double gap = gapAhead(id);
+        if (gap < best) {
+            best = gap;
+            bestId = id;
+        }
+    }
+    if (behindId) {
+        *behindId = bestId;
+    }
+    return best;
+}
+
+/**
+ * @brief 检查动子从当前位置沿最短路径移动到target的扫掠区间
+ *
+ * 以本动子的运动方向为正方向：
+ * - 前方邻居的扫掠区间（当前位置到计划目标）最靠近本动子的一端，
+ *   必须比本动子的行程终点再远minGap；
+ * - 后方邻居朝本动子追来的行程不能吃掉与本动子起点之间的minGap。
+ * 只看区间而不看时序，结果是保守的。
+ *
+ * @param plannedTargets 以动子编号为下标的计划目标位置；超出范围或为NaN时视为停在原地
+ * @return 冲突中净距最小的一项；无冲突时返回无效的Conflict
+ */
+MoverRingIndex::Conflict MoverRingIndex::checkMove(int id, double target,
+                                                   const QVector<double> &plannedTargets,
+                                                   double minGap) const
+{
+    if (id < 0 || id >= m_positions.size()) {
+        return Conflict();
+    }
+    const double travel = signedDistance(m_positions[id], target);
+    return checkSpan(id, qMin(0.0, travel), qMax(0.0, travel), plannedTargets, minGap);
+}
+
+/**
+ * @brief 检查动子从当前位置出发、扫过[backReach, forwardReach]的区间
+ *
+ * 偏移以正方向（逆时针）为正，backReach <= 0 <= forwardReach。
+ * 用于按指定方向规划的行程，以及往返等多段行程的合并区间。
+ * - 正方向邻居的扫掠区间最靠近本动子的一端，必须比forwardReach再远minGap；
+ * - 反方向邻居同理，必须比backReach再远minGap。
+ */
+MoverRingIndex::Conflict MoverRingIndex::checkSpan(int id, double backReach, double forwardReach,
+                                                   const QVector<double> &plannedTargets,
+                                                   double minGap) const
+{
+    Conflict worst;
+    if (id < 0 || id >= m_positions.size() || m_positions.size() < 2) {
+        return worst;
+    }
+
+    auto consider = [&](int other, double clearance) {
+        if (clearance < minGap && (!worst.isValid() || clearance < worst.clearance)) {
+            worst.moverId = id;
+            worst.otherId = other;
+            worst.clearance = clearance;
+        }
+    };
+
+    // 正方向邻居：起始间隙加上它朝本动子方向（反方向）的位移
+    const int ahead = aheadOf(id);
+    const double aheadTravel = signedDistance(m_positions[ahead], plannedTarget(ahead, plannedTargets));
+    consider(ahead, gapAhead(id) + qMin(0.0, aheadTravel) - qMax(0.0, forwardReach));
+
+    // 反方向邻居：起始间隙减去它朝本动子（正方向）追来的位移
+    const int behind = behindOf(id);
+    const double behindTravel = signedDistance(m_positions[behind], plannedTarget(behind, plannedTargets));
+    consider(behind, gapBehind(id) - qMax(0.0, behindTravel) + qMin(0.0, backReach));
+
+    return worst;
+}
+
+/**
+ * @brief 批量检查一组同时下发的移动，O(k)
+ *
+ * plannedTargets 中须已填入本批次所有动子的目标，使每个动子都与邻居的新计划路径比较。
+ * 返回第一个发现的冲突。
+ */
+MoverRingIndex::Conflict MoverRingIndex::checkBatch(const QVector<int> &ids,
+                                                    const QVector<double> &plannedTargets,
+                                                    double minGap) const
+{
+    for (int id : ids) {
+        if (id < 0 || id >= plannedTargets.size()) {
+            continue;
+        }
+        const Conflict conflict = checkMove(id, plannedTargets[id], plannedTargets, minGap);
+        if (conflict.isValid()) {
+            return conflict;
+        }
+    }
+    return Conflict();
+}
+
+double MoverRingIndex::wrap(double position) const
+{
+    if (m_trackLength <= 0.0) {
+        return position;
+    }
+    double wrapped = std::fmod(position, m_trackLength);
+    if (wrapped < 0.0) {
+        wrapped += m_trackLength;
+    }
+    // fmod的舍入可能得到恰好等于全长的值
+    return wrapped >= m_trackLength ? 0.0 : wrapped;
+}
+
+/**
+ * @brief from沿最短路径到to的有符号距离，范围 (-L/2, L/2]
+ */
+double MoverRingIndex::signedDistance(double from, double to) const
+{
+    double d = wrap(to - from);
+    if (d > m_trackLength / 2.0) {
+        d -= m_trackLength;
+    }
+    return d;
+}
+
+double MoverRingIndex::plannedTarget(int id, const QVector<double> &plannedTargets) const
+{
+    if (id < plannedTargets.size() && !qIsNaN(plannedTargets[id])) {
+        return plannedTargets[id];
+    }
+    return m_positions[id];
+}
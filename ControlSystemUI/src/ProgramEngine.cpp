@@ -0,0 +1,513 @@
+#include "ProgramEngine.h"
+#include <QTimer>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+const double ProgramEngine::IN_POSITION_TOLERANCE = 1.0;
+
+// --- 步骤构造 ---
+
+ProgramStep ProgramStep::moveTo(double position, quint16 speed)
+{
+    ProgramStep step;
+    step.type = MoveTo;
+    step.position = position;
+    step.speed = speed;
+    return step;
+}
+
+ProgramStep ProgramStep::dwell(int ms)
+{
+    ProgramStep step;
+    step.type = Dwell;
+    step.dwellMs = ms;
+    return step;
+}
+
+ProgramStep ProgramStep::waitInPosition()
+{
+    ProgramStep step;
+    step.type = WaitInPosition;
+    return step;
+}
+
+ProgramStep ProgramStep::loop(int jumpTo, int repeat)
+{
+    ProgramStep step;
+    step.type = Loop;
+    step.jumpTo = jumpTo;
+    step.repeat = repeat;
+    return step;
+}
+
+// --- 程序引擎 ---
+
+/**
+ * @brief 构造函数
+ * @param modbusManager 用于发送定位命令
+ * @param telemetry 主窗口维护的遥测表，判定到位与故障
+ * @param trackLength 环线全长 (mm)
+ * @param parent 父对象指针
+ */
+ProgramEngine::ProgramEngine(ModbusManager *modbusManager, const MoverTelemetryTable *telemetry,
+                             double trackLength, QObject *parent)
+    : QObject(parent)
+    , m_modbusManager(modbusManager)
+    , m_telemetry(telemetry)
+    , m_trackLength(trackLength)
+    , m_dwellTimer(new QTimer(this))
+    , m_paused(false)
+{
+    m_dwellTimer->setSingleShot(true);
+    m_dwellTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_dwellTimer, &QTimer::timeout, this, &ProgramEngine::onDwellTimeout);
+    if (m_modbusManager) {
+        connect(m_modbusManager, &ModbusManager::groupMoveFinished, this, &ProgramEngine::onGroupMoveFinished);
+    }
+}
+
+/**
+ * @brief 校验程序
+ *
+ * 每个循环体必须包含停留或等待到位步骤，否则循环会在一次推进中空转。
+ * @return 空字符串表示可以执行，否则为错误原因
+ */
+QString ProgramEngine::validate(const MotionProgram &program) const
+{
+    if (program.isEmpty()) {
+        return QString("程序为空");
+    }
+    for (int i = 0; i < program.size(); ++i) {
+        const ProgramStep &step = program.at(i);
+        switch (step.type) {
+        case ProgramStep::MoveTo:
+            if (step.position < 0.0 || step.position >= m_trackLength) {
+                return QString("第%1步：目标位置%2 mm超出轨道范围").arg(i + 1).arg(step.position);
+            }
+            if (step.speed == 0) {
+                return QString("第%1步：速度不能为0").arg(i + 1);
+            }
+            break;
+        case ProgramStep::Dwell:
+            if (step.dwellMs < 0) {
+                return QString("第%1步：停留时间不能为负").arg(i + 1);
+            }
+            break;
+        case ProgramStep::WaitInPosition:
+            break;
+        case ProgramStep::Loop: {
+            if (step.jumpTo < 0 || step.jumpTo >= i) {
+                return QString("第%1步：循环只能跳回之前的步骤").arg(i + 1);
+            }
+            if (step.repeat < 0) {
+                return QString("第%1步：循环次数不能为负").arg(i + 1);
+            }
+            bool waits = false;
+            for (int j = step.jumpTo; j < i && !waits; ++j) {
+                const ProgramStep &body = program.at(j);
+                waits = body.type == ProgramStep::WaitInPosition
+                        || (body.type == ProgramStep::Dwell && body.dwellMs > 0);
+            }
+            if (!waits) {
+                return QString("第%1步：循环体中没有停留或等待到位步骤").arg(i + 1);
+            }
+            break;
+        }
+        }
+    }
+    return QString();
+}
+
+/**
+ * @brief 为一个动子启动程序，已在运行的程序被替换
+ * @return 校验失败、动子编号无效、PLC未连接，或单轴模式下已有其他动子在运行时返回false
+ */
+bool ProgramEngine::start(int moverId, const MotionProgram &program)
+{
+    if (!m_telemetry || moverId < 0 || moverId >= m_telemetry->size()) {
+        return false;
+    }
+    if (!m_modbusManager || !m_modbusManager->isConnected() || !validate(program).isEmpty()) {
+        return false;
+    }
+    // 单轴控制字只能驱动一个动子
+    if (isSingleAxisMode() && !m_runs.isEmpty() && !m_runs.contains(moverId)) {
+        return false;
+    }
+
+    Run run;
+    run.program = program;
+    run.loopCounts.fill(0, program.size());
+    m_runs.insert(moverId, run);
+    emit stepStarted(moverId, 0);
+
+    if (!m_paused) {
+        QVector<ModbusManager::GroupMoveCommand> moves;
+        advance(moverId, moves);
+        flushMoves(moves);
+    }
+    scheduleDwellTimer();
+    return true;
+}
+
+// PLC没有可用的协同定位邮箱时，定位改走单轴控制字
+bool ProgramEngine::isSingleAxisMode() const
+{
+    return m_modbusManager && !m_modbusManager->isGroupMoveReady();
+}
+
+/**
+ * @brief 停止一个动子的程序，并让动子停在当前位置
+ */
+void ProgramEngine::stop(int moverId)
+{
+    auto it = m_runs.find(moverId);
+    if (it == m_runs.end()) {
+        return;
+    }
+    const Run run = it.value();
+    m_runs.erase(it);
+    QVector<ModbusManager::GroupMoveCommand> holds;
+    halt(moverId, run, holds);
+    flushHolds(holds);
+    scheduleDwellTimer();
+}
+
+void ProgramEngine::stopAll()
+{
+    // 先清空再停止：取消条目时发出的groupMoveFinished会回到本对象
+    const QHash<int, Run> runs = m_runs;
+    m_runs.clear();
+    QVector<ModbusManager::GroupMoveCommand> holds;
+    for (auto it = runs.cbegin(); it != runs.cend(); ++it) {
+        halt(it.key(), it.value(), holds);
+    }
+    flushHolds(holds);
+    scheduleDwellTimer();
+}
+
+/**
+ * @brief 暂停/恢复全部程序
+ *
+ * 暂停只停止推进步骤，已发出的定位命令照常执行完；恢复时立即重新评估所有动子。
+ */
+void ProgramEngine::setPaused(bool paused)
+{
+    if (m_paused == paused) {
+        return;
+    }
+    m_paused = paused;
+    if (!m_paused) {
+        QVector<ModbusManager::GroupMoveCommand> moves;
+        const QList<int> ids = m_runs.keys();
+        for (int id : ids) {
+            advance(id, moves);
+        }
+        flushMoves(moves);
+        scheduleDwellTimer();
+    }
+}
+
+int ProgramEngine::currentStep(int moverId) const
+{
+    auto it = m_runs.constFind(moverId);
+    return it == m_runs.constEnd() ? -1 : it->pc;
+}
+
+/**
+ * @brief 动子状态变化后推进相应程序
+ * @param changedIds 本次发生变化的动子
+ */
+void ProgramEngine::update(const QVector<int> &changedIds)
+{
+    if (m_paused || m_runs.isEmpty()) {
+        return;
+    }
+    QVector<ModbusManager::GroupMoveCommand> moves;
+    for (int id : changedIds) {
+        if (m_runs.contains(id)) {
+            advance(id, moves);
+        }
+    }
+    flushMoves(moves);
+    scheduleDwellTimer();
+}
+
+void ProgramEngine::onDwellTimeout()
+{
+    if (m_paused) {
+        return;
+    }
+    const qint64 now = moverClockMs();
+    QVector<int> due;
+    for (auto it = m_runs.cbegin(); it != m_runs.cend(); ++it) {
+        if (it->dwellUntilMs > 0 && it->dwellUntilMs <= now) {
+            due.append(it.key());
+        }
+    }
+    QVector<ModbusManager::GroupMoveCommand> moves;
+    for (int id : due) {
+        advance(id, moves);
+    }
+    flushMoves(moves);
+    scheduleDwellTimer();
+}
+
+// 协同定位写入失败时，中止在该次写入中下发定位的程序；
+// PLC不支持协同定位（未确认执行）且只有一个程序时，改经单轴控制字重发
+void ProgramEngine::onGroupMoveFinished(quint16 sequence, bool success)
+{
+    if (success) {
+        return;
+    }
+    QVector<int> failed;
+    for (auto it = m_runs.cbegin(); it != m_runs.cend(); ++it) {
+        if (!it->singleAxis && it->moveSequence == sequence) {
+            failed.append(it.key());
+        }
+    }
+    const bool fallback = isSingleAxisMode() && m_modbusManager->isConnected()
+                          && failed.size() == 1 && m_runs.size() == 1;
+    if (fallback) {
+        const Run &run = m_runs.value(failed.first());
+        sendSingleAxisMove(failed.first(), run.moveTarget, run.moveSpeed);
+        return;
+    }
+    for (int id : failed) {
+        abort(id, "定位命令写入失败");
+    }
+}
+
+/**
+ * @brief 从当前步骤开始执行，直到遇到需要等待的步骤
+ *
+ * 定位命令只收集到 moves 中，由调用方在本次事件结束时一次发出。
+ * 一次推进最多执行程序长度的步骤，循环体立即满足时剩余部分留给下一个事件。
+ */
+void ProgramEngine::advance(int moverId, QVector<ModbusManager::GroupMoveCommand> &moves)
+{
+    auto it = m_runs.find(moverId);
+    if (it == m_runs.end()) {
+        return;
+    }
+    const QString fault = faultReason(moverId);
+    if (!fault.isEmpty()) {
+        abort(moverId, fault);
+        return;
+    }
+
+    Run &run = it.value();
+    const int startPc = run.pc;
+    const qint64 now = moverClockMs();
+    bool blocked = false;
+
+    for (int executed = 0; !blocked && executed <= run.program.size(); ++executed) {
+        if (run.pc >= run.program.size()) {
+            m_runs.erase(it);
+            emit programFinished(moverId);
+            return;
+        }
+        const ProgramStep &step = run.program.at(run.pc);
+        switch (step.type) {
+        case ProgramStep::MoveTo: {
+            ModbusManager::GroupMoveCommand command;
+            command.moverId = moverId;
+            command.targetPosition = step.position;
+            command.speed = step.speed;
+            // 同一事件中同一动子只保留最后一个定位
+            auto existing = std::find_if(moves.begin(), moves.end(),
+                                         [moverId](const ModbusManager::GroupMoveCommand &c) { return c.moverId == moverId; });
+            if (existing != moves.end()) {
+                *existing = command;
+            } else {
+                moves.append(command);
+            }
+            run.moveTarget = step.position;
+            run.moveSpeed = step.speed;
+            run.hasMoveTarget = true;
+            ++run.pc;
+            break;
+        }
+        case ProgramStep::Dwell:
+            if (run.dwellUntilMs == 0) {
+                run.dwellUntilMs = now + step.dwellMs;
+            }
+            if (now < run.dwellUntilMs) {
+                blocked = true;
+            } else {
+                run.dwellUntilMs = 0;
+                ++run.pc;
+            }
+            break;
+        case ProgramStep::WaitInPosition:
+            if (isInPosition(moverId, run)) {
+                ++run.pc;
+            } else {
+                blocked = true;
+            }
+            break;
+        case ProgramStep::Loop:
+            if (step.repeat > 0 && ++run.loopCounts[run.pc] >= step.repeat) {
+                run.loopCounts[run.pc] = 0;
+                ++run.pc;
+            } else {
+                run.pc = step.jumpTo;
+            }
+            break;
+        }
+    }
+
+    if (run.pc != startPc) {
+        emit stepStarted(moverId, run.pc);
+    }
+}
+
+/**
+ * @brief 把本次事件收集到的定位命令作为一次协同定位发出，单轴模式下经控制字发出
+ */
+void ProgramEngine::flushMoves(const QVector<ModbusManager::GroupMoveCommand> &moves)
+{
+    if (moves.isEmpty()) {
+        return;
+    }
+    if (isSingleAxisMode()) {
+        for (const ModbusManager::GroupMoveCommand &command : moves) {
+            sendSingleAxisMove(command.moverId, command.targetPosition, command.speed);
+        }
+        return;
+    }
+    if (!m_modbusManager || !m_modbusManager->commitGroupMove(moves)) {
+        for (const ModbusManager::GroupMoveCommand &command : moves) {
+            abort(command.moverId, "定位命令发送失败");
+        }
+        return;
+    }
+    const quint16 sequence = m_modbusManager->lastGroupMoveSequence();
+    for (const ModbusManager::GroupMoveCommand &command : moves) {
+        auto it = m_runs.find(command.moverId);
+        if (it != m_runs.end()) {
+            it->moveSequence = sequence;
+            it->singleAxis = false;
+        }
+    }
+}
+
+/**
+ * @brief 经单轴控制字发出绝对定位，寄存器序列与点动页的定位按钮相同
+ */
+void ProgramEngine::sendSingleAxisMove(int moverId, double position, quint16 speed)
+{
+    auto it = m_runs.find(moverId);
+    if (it == m_runs.end()) {
+        return;
+    }
+    it->singleAxis = true;
+    it->moveSequence = 0;
+    const bool sent = m_modbusManager->setSingleAxisRunMode(true)
+                      && m_modbusManager->setSingleAxisAutoSpeed(speed)
+                      && m_modbusManager->setSingleAxisJogPosition(static_cast<qint16>(position))  // 位置寄存器为16位 (mm)
+                      && m_modbusManager->setSingleAxisAutoRun(true);
+    if (!sent) {
+        abort(moverId, "定位命令发送失败");
+    }
+}
+
+/**
+ * @brief 让程序被停止或中止的动子停下
+ *
+ * 单轴定位清除自动运行位，与点动页的停止按钮相同；协同定位先取消尚未触发的条目，
+ * 仍在运动的动子再以当前位置为目标收集到 holds 中，由调用方一次下发。
+ */
+void ProgramEngine::halt(int moverId, const Run &run, QVector<ModbusManager::GroupMoveCommand> &holds)
+{
+    if (!m_modbusManager || !m_modbusManager->isConnected() || !run.hasMoveTarget) {
+        return;
+    }
+    if (run.singleAxis) {
+        m_modbusManager->setSingleAxisAutoRun(false);
+        return;
+    }
+    m_modbusManager->cancelGroupMoveEntries(moverId);
+    if (faultReason(moverId).isEmpty() && !isInPosition(moverId, run)) {
+        ModbusManager::GroupMoveCommand command;
+        command.moverId = moverId;
+        command.targetPosition = m_telemetry->position[moverId];
+        command.speed = run.moveSpeed;
+        holds.append(command);
+    }
+}
+
+void ProgramEngine::flushHolds(const QVector<ModbusManager::GroupMoveCommand> &holds)
+{
+    if (!holds.isEmpty() && m_modbusManager->isGroupMoveReady()) {
+        m_modbusManager->commitGroupMove(holds);
+    }
+}
+
+/**
+ * @brief 动子是否已停在最近一次定位的目标处
+ *
+ * 状态为“停止”即PLC报告使能、未运行且到位；同时比较位置，
+ * 避免定位命令生效前仍然沿用上一个目标的到位状态。
+ */
+bool ProgramEngine::isInPosition(int moverId, const Run &run) const
+{
+    if (m_telemetry->status[moverId] != MoverStatusCode::Stopped) {
+        return false;
+    }
+    if (!run.hasMoveTarget) {
+        return true;
+    }
+    double distance = std::fmod(qAbs(m_telemetry->position[moverId] - run.moveTarget), m_trackLength);
+    distance = qMin(distance, m_trackLength - distance);
+    return distance <= IN_POSITION_TOLERANCE;
+}
+
+QString ProgramEngine::faultReason(int moverId) const
+{
+    if (!m_telemetry || moverId >= m_telemetry->size()) {
+        return QString("动子不存在");
+    }
+    switch (m_telemetry->status[moverId]) {
+    case MoverStatusCode::Error:
+        return QString("动子报错 (错误码 0x%1)").arg(m_telemetry->errorCode[moverId], 4, 16, QChar('0'));
+    case MoverStatusCode::EmergencyStop:
+        return QString("紧急停止");
+    case MoverStatusCode::Disabled:
+        return QString("动子未使能");
+    default:
+        return QString();
+    }
+}
+
+void ProgramEngine::abort(int moverId, const QString &reason)
+{
+    auto it = m_runs.find(moverId);
+    if (it == m_runs.end()) {
+        return;
+    }
+    const Run run = it.value();
+    m_runs.erase(it);
+    QVector<ModbusManager::GroupMoveCommand> holds;
+    halt(moverId, run, holds);
+    flushHolds(holds);
+    scheduleDwellTimer();
+    emit programAborted(moverId, reason);
+}
+
+// 定时器只对准最早到期的停留，没有停留时不运行
+void ProgramEngine::scheduleDwellTimer()
+{
+    qint64 earliest = 0;
+    for (auto it = m_runs.cbegin(); it != m_runs.cend(); ++it) {
+        if (it->dwellUntilMs > 0 && (earliest == 0 || it->dwellUntilMs < earliest)) {
+            earliest = it->dwellUntilMs;
+        }
+    }
+    if (earliest == 0 || m_paused) {
+        m_dwellTimer->stop();
+        return;
+    }
+    m_dwellTimer->start(int(qMax<qint64>(0, earliest - moverClockMs())));
+}
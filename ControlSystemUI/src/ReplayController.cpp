@@ -0,0 +1,243 @@
+#include "ReplayController.h"
+#include <QPushButton>
+#include <QComboBox>
+#include <QSlider>
+#include <QLabel>
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QDateTime>
+
+// --- ReplayController ---
+
+ReplayController::ReplayController(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_lastTickMs(0)
+    , m_replayTimeMs(0)
+    , m_speed(1.0)
+{
+    m_timer->setInterval(TICK_INTERVAL_MS);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &ReplayController::onTick);
+}
+
+/**
+ * @brief 打开记录目录并停在第一帧
+ * @param directory 记录目录
+ * @return 成功返回true，失败原因见errorString
+ */
+bool ReplayController::open(const QString &directory)
+{
+    pause();
+    if (!m_reader.open(directory)) {
+        return false;
+    }
+    m_replayTimeMs = m_reader.currentTimeMs();
+    emitFrame();
+    return true;
+}
+
+void ReplayController::close()
+{
+    pause();
+    m_reader.close();
+    m_replayTimeMs = 0;
+}
+
+void ReplayController::play()
+{
+    if (!isOpen() || isPlaying()) {
+        return;
+    }
+    // 已播放到末尾时从头开始
+    if (m_reader.nextTimeMs() < 0) {
+        seek(startTimeMs());
+    }
+    m_clock.start();
+    m_lastTickMs = 0;
+    m_timer->start();
+    emit playingChanged(true);
+}
+
+void ReplayController::pause()
+{
+    if (!isPlaying()) {
+        return;
+    }
+    m_timer->stop();
+    emit playingChanged(false);
+}
+
+void ReplayController::setSpeed(double speed)
+{
+    m_speed = qMax(0.1, speed);
+}
+
+/**
+ * @brief 跳转到指定时刻，通过块索引定位，与记录长度无关
+ * @param timeMs 墙上时间（毫秒）
+ */
+void ReplayController::seek(qint64 timeMs)
+{
+    if (!isOpen()) {
+        return;
+    }
+    timeMs = qBound(startTimeMs(), timeMs, endTimeMs());
+    if (m_reader.seek(timeMs)) {
+        m_replayTimeMs = timeMs;
+        emitFrame();
+    }
+}
+
+/**
+ * @brief 推进回放时钟，解码到期的帧；一个周期内的多帧只发出一次
+ */
+void ReplayController::onTick()
+{
+    const qint64 now = m_clock.elapsed();
+    m_replayTimeMs += qRound64((now - m_lastTickMs) * m_speed);
+    m_lastTickMs = now;
+
+    bool advanced = false;
+    qint64 next = m_reader.nextTimeMs();
+    while (next >= 0 && next <= m_replayTimeMs) {
+        m_reader.readNext();
+        advanced = true;
+        next = m_reader.nextTimeMs();
+    }
+
+    if (next < 0) {
+        m_replayTimeMs = m_reader.currentTimeMs();
+    }
+    if (advanced) {
+        emitFrame();
+    } else {
+        emit positionChanged(m_replayTimeMs);
+    }
+
+    if (next < 0) {
+        pause();
+        emit finished();
+    }
+}
+
+void ReplayController::emitFrame()
+{
+    m_output = m_reader.state();
+    const qint64 now = QElapsedTimer::msecsSinceReference();
+    m_output.timestampMs = now;
+    for (int i = 0; i < m_output.count; ++i) {
+        m_output.movers[i].timestampMs = now;
+    }
+    emit frameReady(m_output);
+    emit positionChanged(m_replayTimeMs);
+}
+
+// --- ReplayControlBar ---
+
+ReplayControlBar::ReplayControlBar(ReplayController *controller, QWidget *parent)
+    : QWidget(parent)
+    , m_controller(controller)
+{
+    QHBoxLayout *layout = new QHBoxLayout(this);
+    layout->setContentsMargins(4, 2, 4, 2);
+
+    m_openButton = new QPushButton("打开记录", this);
+    m_playButton = new QPushButton("播放", this);
+    m_speedCombo = new QComboBox(this);
+    m_speedCombo->addItem("1×", 1.0);
+    m_speedCombo->addItem("10×", 10.0);
+    m_speedCombo->addItem("100×", 100.0);
+    m_timeSlider = new QSlider(Qt::Horizontal, this);
+    m_timeSlider->setMinimumWidth(400);
+    m_timeLabel = new QLabel("--", this);
+    m_timeLabel->setMinimumWidth(150);
+    m_exitButton = new QPushButton("退出回放", this);
+
+    layout->addWidget(m_openButton);
+    layout->addWidget(m_playButton);
+    layout->addWidget(m_speedCombo);
+    layout->addWidget(m_timeSlider, 1);
+    layout->addWidget(m_timeLabel);
+    layout->addWidget(m_exitButton);
+
+    connect(m_openButton, &QPushButton::clicked, this, [this]() { openRecording(m_lastDirectory); });
+    connect(m_playButton, &QPushButton::clicked, this, &ReplayControlBar::onPlayPauseClicked);
+    connect(m_speedCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &ReplayControlBar::onSpeedChanged);
+    connect(m_timeSlider, &QSlider::sliderMoved, this, &ReplayControlBar::onSliderMoved);
+    connect(m_exitButton, &QPushButton::clicked, this, &ReplayControlBar::exitRequested);
+    connect(m_controller, &ReplayController::positionChanged, this, &ReplayControlBar::onPositionChanged);
+    connect(m_controller, &ReplayController::playingChanged, this, &ReplayControlBar::onPlayingChanged);
+
+    updateRange();
+}
+
+/**
+ * @brief 选择记录目录并打开
+ * @param defaultDirectory 对话框的初始目录
+ * @return 成功打开返回true
+ */
+bool ReplayControlBar::openRecording(const QString &defaultDirectory)
+{
+    const QString directory = QFileDialog::getExistingDirectory(this, "选择轨迹记录目录", defaultDirectory);
+    if (directory.isEmpty()) {
+        return false;
+    }
+    if (!m_controller->open(directory)) {
+        QMessageBox::warning(this, "打开失败", m_controller->errorString());
+        return false;
+    }
+    m_lastDirectory = directory;
+    updateRange();
+    emit recordingOpened(directory);
+    return true;
+}
+
+void ReplayControlBar::onPlayPauseClicked()
+{
+    if (m_controller->isPlaying()) {
+        m_controller->pause();
+    } else {
+        m_controller->play();
+    }
+}
+
+void ReplayControlBar::onSpeedChanged(int index)
+{
+    m_controller->setSpeed(m_speedCombo->itemData(index).toDouble());
+}
+
+// 滑块以秒为单位，24小时的记录也在int范围内
+void ReplayControlBar::onSliderMoved(int value)
+{
+    m_controller->seek(m_controller->startTimeMs() + qint64(value) * 1000);
+}
+
+void ReplayControlBar::onPositionChanged(qint64 timeMs)
+{
+    if (!m_timeSlider->isSliderDown()) {
+        m_timeSlider->setValue(int((timeMs - m_controller->startTimeMs()) / 1000));
+    }
+    m_timeLabel->setText(formatTime(timeMs));
+}
+
+void ReplayControlBar::onPlayingChanged(bool playing)
+{
+    m_playButton->setText(playing ? "暂停" : "播放");
+}
+
+void ReplayControlBar::updateRange()
+{
+    const bool open = m_controller->isOpen();
+    m_playButton->setEnabled(open);
+    m_timeSlider->setEnabled(open);
+    m_timeSlider->setRange(0, open ? int((m_controller->endTimeMs() - m_controller->startTimeMs()) / 1000) : 0);
+    m_timeLabel->setText(open ? formatTime(m_controller->currentTimeMs()) : "--");
+}
+
+QString ReplayControlBar::formatTime(qint64 timeMs)
+{
+    return QDateTime::fromMSecsSinceEpoch(timeMs).toString("yyyy-MM-dd hh:mm:ss.zzz");
+}
@@ -0,0 +1,279 @@
+#include "TelemetryReader.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QDebug>
+#include <algorithm>
+
+using namespace TelemetryFormat;
+
+// --- 构造函数与析构函数 ---
+
+TelemetryReader::TelemetryReader()
+    : m_chunk(0)
+    , m_offset(0)
+    , m_currentTimeMs(0)
+{
+}
+
+TelemetryReader::~TelemetryReader()
+{
+    close();
+}
+
+// --- 打开与关闭 ---
+
+/**
+ * @brief 打开目录内的所有轨迹分段
+ * @param directory 记录目录
+ * @param baseName 分段文件名前缀
+ * @return 至少有一个可用的数据块时返回true
+ */
+bool TelemetryReader::open(const QString &directory, const QString &baseName)
+{
+    close();
+    m_errorString.clear();
+
+    QDir dir(directory);
+    const QFileInfoList files = dir.entryInfoList(
+        QStringList() << (baseName + "_*" + TelemetryRecorder::FILE_SUFFIX), QDir::Files, QDir::Name);
+
+    for (const QFileInfo &info : files) {
+        if (!openSegment(info.absoluteFilePath())) {
+            qWarning() << "跳过无效的轨迹分段：" << info.absoluteFilePath() << m_errorString;
+        }
+    }
+
+    if (m_chunks.isEmpty()) {
+        m_errorString = QString("目录中没有可用的轨迹记录：%1").arg(directory);
+        close();
+        return false;
+    }
+
+    std::stable_sort(m_chunks.begin(), m_chunks.end(), [](const ChunkRef &a, const ChunkRef &b) {
+        return a.firstTimeMs < b.firstTimeMs;
+    });
+    m_errorString.clear();
+    return seek(startTimeMs());
+}
+
+/**
+ * @brief 解除所有分段的映射
+ */
+void TelemetryReader::close()
+{
+    for (Segment &segment : m_segments) {
+        segment.file->unmap(const_cast<uchar *>(segment.map));
+        segment.file->close();
+    }
+    m_segments.clear();
+    m_chunks.clear();
+    m_chunk = 0;
+    m_offset = 0;
+    m_currentTimeMs = 0;
+}
+
+/**
+ * @brief 映射一个分段并登记其中已提交的数据块
+ *
+ * 正在被记录的分段也可以打开，只读取打开时已提交的部分。
+ * @param path 分段文件路径
+ * @return 文件头有效时返回true
+ */
+bool TelemetryReader::openSegment(const QString &path)
+{
+    QSharedPointer<QFile> file(new QFile(path));
+    if (!file->open(QIODevice::ReadOnly)) {
+        m_errorString = file->errorString();
+        return false;
+    }
+    const qint64 size = file->size();
+    if (size < qint64(sizeof(SegmentHeader))) {
+        m_errorString = "文件过小";
+        return false;
+    }
+    const uchar *map = file->map(0, size);
+    if (!map) {
+        m_errorString = file->errorString();
+        return false;
+    }
+
+    const SegmentHeader *header = reinterpret_cast<const SegmentHeader *>(map);
+    const quint64 indexEnd = sizeof(SegmentHeader) + quint64(header->indexCapacity) * sizeof(ChunkIndexEntry);
+    const quint64 dataEnd = header->dataEnd;
+    if (header->magic != MAGIC || header->version != VERSION || header->headerSize != sizeof(SegmentHeader)
+        || header->dataOffset < indexEnd || dataEnd > quint64(size) || header->chunkCount > header->indexCapacity) {
+        m_errorString = "文件头无效";
+        file->unmap(const_cast<uchar *>(map));
+        return false;
+    }
+
+    Segment segment;
+    segment.file = file;
+    segment.map = map;
+    segment.dataEnd = dataEnd;
+    segment.clockOffsetMs = header->wallClockStartMs - header->monotonicStartMs;
+
+    const int segmentIndex = m_segments.size();
+    const ChunkIndexEntry *index = reinterpret_cast<const ChunkIndexEntry *>(map + sizeof(SegmentHeader));
+    for (quint32 i = 0; i < header->chunkCount; ++i) {
+        const ChunkIndexEntry &entry = index[i];
+        if (entry.bytes == 0 || entry.offset < header->dataOffset || entry.offset >= dataEnd) {
+            continue;
+        }
+        // 索引先于文件头提交，正在写入的块以dataEnd为准
+        const quint64 end = qMin(entry.offset + entry.bytes, dataEnd);
+        m_chunks.append({entry.firstTimestampMs + segment.clockOffsetMs,
+                         entry.lastTimestampMs + segment.clockOffsetMs,
+                         segmentIndex, entry.offset, end});
+    }
+
+    m_segments.append(segment);
+    return true;
+}
+
+// --- 时间线 ---
+
+qint64 TelemetryReader::startTimeMs() const
+{
+    return m_chunks.isEmpty() ? 0 : m_chunks.first().firstTimeMs;
+}
+
+qint64 TelemetryReader::endTimeMs() const
+{
+    qint64 end = 0;
+    for (const ChunkRef &chunk : m_chunks) {
+        end = qMax(end, chunk.lastTimeMs);
+    }
+    return end;
+}
+
+/**
+ * @brief 定位到指定时刻
+ *
+ * 二分查找起始时间不晚于timeMs的最后一个块，从其关键帧解码到timeMs为止。
+ * 早于时间线起点时停在第一帧。
+ * @param timeMs 墙上时间（毫秒）
+ * @return 定位成功返回true
+ */
+bool TelemetryReader::seek(qint64 timeMs)
+{
+    if (m_chunks.isEmpty()) {
+        return false;
+    }
+
+    auto it = std::upper_bound(m_chunks.cbegin(), m_chunks.cend(), timeMs,
+                               [](qint64 time, const ChunkRef &chunk) { return time < chunk.firstTimeMs; });
+    const int chunk = qMax(0, int(it - m_chunks.cbegin()) - 1);
+
+    m_state.count = 0;
+    for (int i = 0; i < MoverSnapshotFrame::MAX_MOVERS; ++i) {
+        m_state.movers[i] = MoverSnapshot();
+        m_state.movers[i].id = i;
+    }
+    if (!positionAt(chunk)) {
+        return false;
+    }
+
+    // 至少解码关键帧，保证状态完整
+    bool applied = false;
+    while (const FrameHeader *frame = peekFrame()) {
+        const qint64 frameTime = frame->timestampMs + m_segments[m_chunks[m_chunk].segment].clockOffsetMs;
+        if (applied && frameTime > timeMs) {
+            break;
+        }
+        applyFrame(frame);
+        applied = true;
+    }
+    return applied;
+}
+
+bool TelemetryReader::readNext()
+{
+    const FrameHeader *frame = peekFrame();
+    if (!frame) {
+        return false;
+    }
+    applyFrame(frame);
+    return true;
+}
+
+qint64 TelemetryReader::nextTimeMs() const
+{
+    const FrameHeader *frame = peekFrame();
+    if (!frame) {
+        return -1;
+    }
+    return frame->timestampMs + m_segments[m_chunks[m_chunk].segment].clockOffsetMs;
+}
+
+// --- 帧解码 ---
+
+/**
+ * @brief 把游标移到指定块的开头，并跳过之后不完整的块
+ * @param chunk 块下标
+ * @return 仍有可读的帧时返回true
+ */
+bool TelemetryReader::positionAt(int chunk)
+{
+    m_chunk = chunk;
+    m_offset = (chunk < m_chunks.size()) ? m_chunks[chunk].offset : 0;
+
+    // 帧不完整或损坏时放弃该块的剩余部分，从下一个块的关键帧继续
+    while (m_chunk < m_chunks.size() && !peekFrame()) {
+        ++m_chunk;
+        if (m_chunk < m_chunks.size()) {
+            m_offset = m_chunks[m_chunk].offset;
+        }
+    }
+    return m_chunk < m_chunks.size();
+}
+
+/**
+ * @brief 游标处的帧，帧头或记录越过块边界时返回nullptr
+ */
+const FrameHeader *TelemetryReader::peekFrame() const
+{
+    if (m_chunk >= m_chunks.size()) {
+        return nullptr;
+    }
+    const ChunkRef &chunk = m_chunks[m_chunk];
+    if (m_offset + sizeof(FrameHeader) > chunk.end) {
+        return nullptr;
+    }
+    const FrameHeader *frame = reinterpret_cast<const FrameHeader *>(m_segments[chunk.segment].map + m_offset);
+    if (frame->recordCount > MoverSnapshotFrame::MAX_MOVERS
+        || m_offset + sizeof(FrameHeader) + frame->recordCount * sizeof(MoverRecord) > chunk.end) {
+        return nullptr;
+    }
+    return frame;
+}
+
+/**
+ * @brief 把一帧的变化合并到当前状态并前移游标
+ * @param frame 游标处的帧
+ */
+void TelemetryReader::applyFrame(const FrameHeader *frame)
+{
+    const qint64 frameTime = frame->timestampMs + m_segments[m_chunks[m_chunk].segment].clockOffsetMs;
+    const MoverRecord *records = reinterpret_cast<const MoverRecord *>(frame + 1);
+
+    int index = 0;
+    for (int word = 0; word < MASK_WORDS && index < frame->recordCount; ++word) {
+        quint64 bits = frame->changedMask[word];
+        while (bits && index < frame->recordCount) {
+            const int id = word * 64 + qCountTrailingZeroBits(bits);
+            bits &= bits - 1;
+            decodeRecord(records[index++], id, frameTime, m_state.movers[id]);
+            m_state.count = qMax(m_state.count, id + 1);
+        }
+    }
+
+    m_state.sequence = frame->sequence;
+    m_state.timestampMs = frameTime;
+    m_currentTimeMs = frameTime;
+
+    m_offset += sizeof(FrameHeader) + frame->recordCount * sizeof(MoverRecord);
+    if (!peekFrame()) {
+        positionAt(m_chunk + 1);
+    }
+}
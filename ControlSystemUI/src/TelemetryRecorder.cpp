@@ -0,0 +1,367 @@
+#include "TelemetryRecorder.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDebug>
+#include <cstring>
+
+using namespace TelemetryFormat;
+
+namespace {
+
+// 一帧最多占用的字节数（所有动子都有变化）
+qint64 maxFrameBytes(int moverCount)
+{
+    return sizeof(FrameHeader) + qint64(moverCount) * sizeof(MoverRecord);
+}
+
+quint64 dataOffsetFor(int indexCapacity)
+{
+    const quint64 raw = sizeof(SegmentHeader) + quint64(indexCapacity) * sizeof(ChunkIndexEntry);
+    return (raw + 63) & ~quint64(63);
+}
+
+} // namespace
+
+// --- 构造函数与析构函数 ---
+
+TelemetryRecorder::TelemetryRecorder()
+    : m_map(nullptr)
+    , m_recording(false)
+    , m_writeOffset(0)
+    , m_currentChunk(-1)
+    , m_lastSequence(0)
+    , m_framesWritten(0)
+{
+    std::memset(m_knownMask, 0, sizeof(m_knownMask));
+}
+
+TelemetryRecorder::~TelemetryRecorder()
+{
+    stop();
+}
+
+// --- 启停 ---
+
+/**
+ * @brief 开始记录
+ *
+ * 分段文件在收到第一帧时才创建，这样分段的起始时间与第一帧一致。
+ * @param options 记录参数
+ * @return 参数有效且目录可用时返回true
+ */
+bool TelemetryRecorder::start(const Options &options)
+{
+    stop();
+    m_errorString.clear();
+
+    if (options.directory.isEmpty() || options.baseName.isEmpty()) {
+        m_errorString = "记录目录或文件名前缀为空";
+        return false;
+    }
+    if (options.indexCapacity <= 0 || options.chunkBytes <= 0 || options.chunkSpanMs <= 0) {
+        m_errorString = "记录参数无效";
+        return false;
+    }
+    const qint64 minimumBytes = qint64(dataOffsetFor(options.indexCapacity))
+                                + 2 * maxFrameBytes(MoverSnapshotFrame::MAX_MOVERS);
+    if (options.segmentBytes < minimumBytes || options.maxTotalBytes < options.segmentBytes) {
+        m_errorString = QString("分段大小至少为%1字节且不能超过总大小上限").arg(minimumBytes);
+        return false;
+    }
+    if (!QDir().mkpath(options.directory)) {
+        m_errorString = QString("无法创建记录目录：%1").arg(options.directory);
+        return false;
+    }
+
+    m_options = options;
+    m_framesWritten = 0;
+    m_recording = true;
+    return true;
+}
+
+/**
+ * @brief 停止记录，关闭当前分段
+ */
+void TelemetryRecorder::stop()
+{
+    closeSegment();
+    m_recording = false;
+}
+
+// --- 写入 ---
+
+/**
+ * @brief 追加一帧快照
+ *
+ * 单帧路径只做编码、比较和memcpy；只有块切换和分段切换时才更新索引或创建文件。
+ * 所有动子都没有变化时只写帧头。
+ * @param frame 快照帧
+ * @return 写入成功返回true
+ */
+bool TelemetryRecorder::record(const MoverSnapshotFrame &frame)
+{
+    if (!m_recording) {
+        return false;
+    }
+
+    bool needChunk = m_currentChunk < 0
+                     || indexEntry(m_currentChunk)->bytes >= quint32(m_options.chunkBytes)
+                     || frame.timestampMs - indexEntry(m_currentChunk)->firstTimestampMs >= m_options.chunkSpanMs;
+    const bool needSegment = !m_file.isOpen()
+                             || m_writeOffset + maxFrameBytes(frame.count) > quint64(m_options.segmentBytes)
+                             || (needChunk && m_currentChunk + 1 >= m_options.indexCapacity);
+
+    if (needSegment) {
+        // 分段写满或块索引已用完：切换到新分段
+        closeSegment();
+        if (!openSegment(frame.timestampMs)) {
+            qWarning() << "轨迹记录停止：" << m_errorString;
+            m_recording = false;
+            return false;
+        }
+        needChunk = true;
+    }
+    if (needChunk) {
+        beginChunk(frame.timestampMs);
+    }
+
+    const bool keyframe = indexEntry(m_currentChunk)->frameCount == 0;
+
+    // 记录直接编码到映射区，帧头最后填写
+    uchar *frameStart = m_map + m_writeOffset;
+    FrameHeader *frameHeader = reinterpret_cast<FrameHeader *>(frameStart);
+    MoverRecord *out = reinterpret_cast<MoverRecord *>(frameStart + sizeof(FrameHeader));
+    quint64 changedMask[MASK_WORDS] = {};
+    int recordCount = 0;
+
+    for (int i = 0; i < frame.count; ++i) {
+        const MoverSnapshot &snapshot = frame.movers[i];
+        if (snapshot.id < 0 || snapshot.id >= MoverSnapshotFrame::MAX_MOVERS) {
+            continue;
+        }
+        const int word = snapshot.id / 64;
+        const quint64 bit = quint64(1) << (snapshot.id % 64);
+
+        const MoverRecord encoded = encodeRecord(snapshot);
+        MoverRecord &last = m_lastRecords[snapshot.id];
+        if ((m_knownMask[word] & bit) && std::memcmp(&last, &encoded, sizeof(MoverRecord)) == 0) {
+            continue;
+        }
+        last = encoded;
+        m_knownMask[word] |= bit;
+        changedMask[word] |= bit;
+        ++recordCount;
+    }
+
+    // 按编号递增写出，读端按changedMask的置位顺序还原编号
+    int written = 0;
+    for (int word = 0; word < MASK_WORDS; ++word) {
+        quint64 bits = changedMask[word];
+        while (bits) {
+            const int id = word * 64 + qCountTrailingZeroBits(bits);
+            bits &= bits - 1;
+            out[written++] = m_lastRecords[id];
+        }
+    }
+
+    frameHeader->timestampMs = frame.timestampMs;
+    frameHeader->recordCount = quint16(recordCount);
+    frameHeader->flags = keyframe ? FLAG_KEYFRAME : 0;
+    frameHeader->sequence = quint32(frame.sequence);
+    std::memcpy(frameHeader->changedMask, changedMask, sizeof(changedMask));
+
+    const quint32 frameBytes = quint32(sizeof(FrameHeader) + recordCount * sizeof(MoverRecord));
+    m_writeOffset += frameBytes;
+
+    // 数据写完后再提交索引和文件头
+    ChunkIndexEntry *entry = indexEntry(m_currentChunk);
+    entry->lastTimestampMs = frame.timestampMs;
+    entry->bytes += frameBytes;
+    ++entry->frameCount;
+    header()->dataEnd = m_writeOffset;
+
+    m_lastSequence = frame.sequence;
+    ++m_framesWritten;
+    return true;
+}
+
+/**
+ * @brief 追加一帧无变化的扫描
+ *
+ * 寄存器与上一次扫描完全相同时I/O线程不发布快照，只调用此函数写一个空帧。
+ * 块的第一帧必须是关键帧，因此需要开始新块或新分段时，用各动子最近一次的记录重建整帧写入。
+ * @param timestampMs 采样时间
+ * @return 写入成功（或尚未记录过任何帧）返回true
+ */
+bool TelemetryRecorder::recordIdle(qint64 timestampMs)
+{
+    if (!m_recording) {
+        return false;
+    }
+    if (!m_file.isOpen() || m_currentChunk < 0) {
+        return true;    // 还没有记录过状态，空帧没有意义
+    }
+
+    const ChunkIndexEntry *entry = indexEntry(m_currentChunk);
+    const bool needChunk = entry->bytes >= quint32(m_options.chunkBytes)
+                           || timestampMs - entry->firstTimestampMs >= m_options.chunkSpanMs;
+    if (needChunk || m_writeOffset + sizeof(FrameHeader) > quint64(m_options.segmentBytes)) {
+        MoverSnapshotFrame frame;
+        frame.sequence = m_lastSequence;
+        frame.timestampMs = timestampMs;
+        for (int id = 0; id < MoverSnapshotFrame::MAX_MOVERS; ++id) {
+            if (m_knownMask[id / 64] & (quint64(1) << (id % 64))) {
+                decodeRecord(m_lastRecords[id], id, timestampMs, frame.movers[frame.count++]);
+            }
+        }
+        return record(frame);
+    }
+
+    FrameHeader *frameHeader = reinterpret_cast<FrameHeader *>(m_map + m_writeOffset);
+    std::memset(frameHeader, 0, sizeof(FrameHeader));
+    frameHeader->timestampMs = timestampMs;
+    frameHeader->sequence = quint32(m_lastSequence);
+    m_writeOffset += sizeof(FrameHeader);
+
+    ChunkIndexEntry *current = indexEntry(m_currentChunk);
+    current->lastTimestampMs = timestampMs;
+    current->bytes += quint32(sizeof(FrameHeader));
+    ++current->frameCount;
+    header()->dataEnd = m_writeOffset;
+
+    ++m_framesWritten;
+    return true;
+}
+
+// --- 分段管理 ---
+
+/**
+ * @brief 创建并映射新的分段文件
+ * @param timestampMs 第一帧的采样时间
+ * @return 成功返回true，失败时设置errorString
+ */
+bool TelemetryRecorder::openSegment(qint64 timestampMs)
+{
+    enforceRetention();
+
+    const QDateTime now = QDateTime::currentDateTime();
+    const QString stem = QString("%1/%2_%3").arg(m_options.directory, m_options.baseName,
+                                                 now.toString("yyyyMMdd_HHmmss_zzz"));
+    QString path = stem + FILE_SUFFIX;
+    for (int n = 1; QFileInfo::exists(path); ++n) {
+        path = QString("%1_%2%3").arg(stem).arg(n).arg(FILE_SUFFIX);
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        m_errorString = QString("无法创建记录文件 %1：%2").arg(path, m_file.errorString());
+        return false;
+    }
+    // 扩展出的部分由文件系统填零，索引表无需显式清空
+    if (!m_file.resize(m_options.segmentBytes)) {
+        m_errorString = QString("无法预分配记录文件 %1：%2").arg(path, m_file.errorString());
+        m_file.close();
+        m_file.remove();
+        return false;
+    }
+    m_map = m_file.map(0, m_options.segmentBytes);
+    if (!m_map) {
+        m_errorString = QString("无法映射记录文件 %1：%2").arg(path, m_file.errorString());
+        m_file.close();
+        m_file.remove();
+        return false;
+    }
+
+    const quint64 dataOffset = dataOffsetFor(m_options.indexCapacity);
+    SegmentHeader *segment = header();
+    std::memset(segment, 0, sizeof(SegmentHeader));
+    segment->magic = MAGIC;
+    segment->version = VERSION;
+    segment->headerSize = sizeof(SegmentHeader);
+    segment->indexCapacity = quint32(m_options.indexCapacity);
+    segment->chunkCount = 0;
+    segment->dataOffset = dataOffset;
+    segment->dataEnd = dataOffset;
+    segment->monotonicStartMs = timestampMs;
+    segment->wallClockStartMs = now.toMSecsSinceEpoch();
+    segment->state = SEGMENT_OPEN;
+
+    m_writeOffset = dataOffset;
+    m_currentChunk = -1;
+    return true;
+}
+
+/**
+ * @brief 关闭当前分段并截断未使用的预分配空间
+ */
+void TelemetryRecorder::closeSegment()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    const qint64 used = qint64(header()->dataEnd);
+    header()->state = SEGMENT_CLOSED;
+    m_file.unmap(m_map);
+    m_map = nullptr;
+    m_file.resize(used);
+    m_file.close();
+    m_currentChunk = -1;
+}
+
+/**
+ * @brief 删除最旧的分段，直到加上即将创建的分段后总大小不超过上限
+ */
+void TelemetryRecorder::enforceRetention()
+{
+    QDir dir(m_options.directory);
+    const QFileInfoList segments = dir.entryInfoList(
+        QStringList() << (m_options.baseName + "_*" + FILE_SUFFIX), QDir::Files, QDir::Name);
+
+    qint64 total = m_options.segmentBytes;
+    for (const QFileInfo &info : segments) {
+        total += info.size();
+    }
+
+    // 文件名以时间开头，按名称排序即按时间排序
+    for (const QFileInfo &info : segments) {
+        if (total <= m_options.maxTotalBytes) {
+            break;
+        }
+        const qint64 size = info.size();
+        if (QFile::remove(info.absoluteFilePath())) {
+            total -= size;
+        } else {
+            qWarning() << "无法删除旧的轨迹记录：" << info.absoluteFilePath();
+        }
+    }
+}
+
+/**
+ * @brief 开始新块：登记索引并清空变化检测状态，使下一帧成为关键帧
+ * @param timestampMs 块内第一帧的采样时间
+ */
+void TelemetryRecorder::beginChunk(qint64 timestampMs)
+{
+    ++m_currentChunk;
+    ChunkIndexEntry *entry = indexEntry(m_currentChunk);
+    entry->firstTimestampMs = timestampMs;
+    entry->lastTimestampMs = timestampMs;
+    entry->offset = m_writeOffset;
+    entry->bytes = 0;
+    entry->frameCount = 0;
+    header()->chunkCount = quint32(m_currentChunk + 1);
+
+    std::memset(m_knownMask, 0, sizeof(m_knownMask));
+}
+
+SegmentHeader *TelemetryRecorder::header() const
+{
+    return reinterpret_cast<SegmentHeader *>(m_map);
+}
+
+ChunkIndexEntry *TelemetryRecorder::indexEntry(int chunk) const
+{
+    return reinterpret_cast<ChunkIndexEntry *>(m_map + sizeof(SegmentHeader)) + chunk;
+}
@@ -4,7 +4,10 @@
 #include <QPen>
 #include <QBrush>
 #include <qmath.h>
+#include <cmath>
 #include <QScrollArea>
+#include <QRegion>
+#include <QPaintEvent>
 
 // 实际轨道尺寸 (mm)
 const double TrackWidget::TRACK_LENGTH = 7455.75;  // 2段直线(2000*2) + 2段半圆(π*550*2) ≈ 7455.75mm
@@ -22,32 +25,173 @@ TrackWidget::TrackWidget(QWidget *parent)
 
 void TrackWidget::updateMovers(const QList<MoverData> &movers)
 {
-    m_movers = movers;
     // 添加调试信息
-    for (int i = 0; i < m_movers.size(); ++i) {
-        auto& mover = m_movers[i];
+    for (int i = 0; i < movers.size(); ++i) {
+        const auto& mover = movers[i];
         if (mover.status == "紧急停止") {
             qDebug() << QString("TrackWidget收到动子%1急停状态").arg(mover.id);
         }
     }
-    update();  // 触发重绘
+
+    if (movers.size() != m_movers.size()) {
+        m_movers = movers;
+        update();  // 数量变化，整体重绘
+        return;
+    }
+
+    // 只重绘变化动子的新旧区域
+    ensureTrackLut();
+    QRegion dirty = collisionAlertsRegion();
+    for (int i = 0; i < movers.size(); ++i) {
+        if (moverChanged(m_movers[i], movers[i])) {
+            dirty += moverBounds(m_movers[i]);
+            dirty += moverBounds(movers[i]);
+        }
+    }
+    m_movers = movers;
+    dirty += collisionAlertsRegion();
+    if (!dirty.isEmpty()) {
+        update(dirty);
+    }
+}
+
+void TrackWidget::updateMovers(const QList<MoverData> &movers, const QVector<int> &changedIds)
+{
+    if (movers.size() != m_movers.size()) {
+        updateMovers(movers);
+        return;
+    }
+
+    ensureTrackLut();
+    // 告警连线随动子移动，连同新旧位置一起重绘
+    QRegion dirty = collisionAlertsRegion();
+    for (int id : changedIds) {
+        if (id >= 0 && id < m_movers.size()) {
+            dirty += moverBounds(m_movers[id]);
+            m_movers[id] = movers[id];
+            dirty += moverBounds(m_movers[id]);
+        }
+    }
+    dirty += collisionAlertsRegion();
+    if (!dirty.isEmpty()) {
+        update(dirty);  // 只重绘变化动子的新旧区域
+    }
+}
+
+void TrackWidget::setMotionPreview(const MotionProfile &profile, bool conflict)
+{
+    ensureTrackLut();
+    QRegion dirty = previewBounds();
+    m_previewProfile = profile;
+    m_previewConflict = conflict;
+    dirty += previewBounds();
+    if (!dirty.isEmpty()) {
+        update(dirty);
+    }
+}
+
+void TrackWidget::clearMotionPreview()
+{
+    setMotionPreview(MotionProfile(), false);
+}
+
+void TrackWidget::setCollisionAlerts(const QVector<CollisionAlert> &alerts)
+{
+    ensureTrackLut();
+    QRegion dirty = collisionAlertsRegion();
+    m_collisionAlerts = alerts;
+    dirty += collisionAlertsRegion();
+    if (!dirty.isEmpty()) {
+        update(dirty);
+    }
 }
 
 void TrackWidget::paintEvent(QPaintEvent *event)
 {
-    Q_UNUSED(event)
+    const qreal dpr = devicePixelRatioF();
+    if (!m_staticLayerValid || m_staticLayer.size() != size() * dpr) {
+        renderStaticLayer();
+    }
+
+    ensureTrackLut();
 
     QPainter painter(this);
+    // 静态层直接贴图，逐帧只绘制与重绘区域相交的动子
+    painter.drawPixmap(0, 0, m_staticLayer);
     painter.setRenderHint(QPainter::Antialiasing);
 
+    // 当前位置与目标位置一次批量映射到屏幕坐标
+    const int count = m_movers.size();
+    m_paintPositions.resize(count * 2);
+    m_paintX.resize(count * 2);
+    m_paintY.resize(count * 2);
+    for (int i = 0; i < count; ++i) {
+        m_paintPositions[i] = m_movers[i].position;
+        m_paintPositions[count + i] = m_movers[i].target;
+    }
+    mapTrackPositions(m_paintPositions.constData(), m_paintX.data(), m_paintY.data(), count * 2);
+
+    const QRect dirtyRect = event->rect();
+    if (m_previewProfile.isValid() && previewBounds().intersects(dirtyRect)) {
+        drawMotionPreview(painter);
+    }
+    // 告警标记画在动子下方，动子主体仍清晰可见
+    for (const CollisionAlert &alert : m_collisionAlerts) {
+        if (alert.behindId < 0 || alert.behindId >= count || alert.aheadId < 0 || alert.aheadId >= count) {
+            continue;
+        }
+        const QPointF behindPos(m_paintX[alert.behindId], m_paintY[alert.behindId]);
+        const QPointF aheadPos(m_paintX[alert.aheadId], m_paintY[alert.aheadId]);
+        if (alertBounds(behindPos, aheadPos).intersects(dirtyRect)) {
+            drawCollisionAlert(painter, alert, behindPos, aheadPos);
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        const MoverData &mover = m_movers[i];
+        const QPointF currentPos(m_paintX[i], m_paintY[i]);
+        const QPointF targetPos(m_paintX[count + i], m_paintY[count + i]);
+        if (moverBounds(mover, currentPos, targetPos).intersects(dirtyRect)) {
+            drawMover(painter, mover, currentPos, targetPos);
+        }
+    }
+}
+
+// 缩放比例 - 适应实际轨道尺寸
+double TrackWidget::trackScale() const
+{
+    const double baseSize = qMin(width(), height());
+    return (baseSize / 2800.0) * m_zoomFactor;
+}
+
+QPointF TrackWidget::trackCenter() const
+{
+    return QPointF(rect().adjusted(50, 50, -50, -50).center());
+}
+
+void TrackWidget::invalidateStaticLayer()
+{
+    m_staticLayerValid = false;
+    update();
+}
+
+// 把网格、轨道、刻度、信息面板和方向指示画进缓存，只在尺寸、缩放或主题变化后重画
+void TrackWidget::renderStaticLayer()
+{
+    const qreal dpr = devicePixelRatioF();
+    m_staticLayer = QPixmap(size() * dpr);
+    m_staticLayer.setDevicePixelRatio(dpr);
+    m_staticLayer.fill(Qt::transparent);
+
+    QPainter painter(&m_staticLayer);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setFont(font());
+
     // 计算绘制区域
     QRect drawRect = rect().adjusted(50, 50, -50, -50);
-    double centerX = drawRect.center().x();
-    double centerY = drawRect.center().y();
-
-    // 缩放比例 - 适应实际轨道尺寸
-    double baseSize = qMin(width(), height());
-    double scale = (baseSize / 2800.0) * m_zoomFactor;
+    const QPointF center = trackCenter();
+    double centerX = center.x();
+    double centerY = center.y();
+    double scale = trackScale();
 
     // 缩放后的轨道参数
     double scaledLength = STRAIGHT_LENGTH * scale;
@@ -164,165 +308,6 @@ void TrackWidget::paintEvent(QPaintEvent *event)
         painter.drawText(textRect, Qt::AlignCenter, distText);
     }
 
-    // 绘制动子
-    for (int i = 0; i < m_movers.size(); ++i) {
-        const MoverData &mover = m_movers[i];
-        const double moverRadius = 20.0; //动子半径
-
-        QPointF currentPos = getTrackPosition(mover.position);
-        currentPos = currentPos * scale + QPointF(centerX, centerY);
-
-        // 绘制目标位置（如果不同于当前位置）
-        if (qAbs(mover.target - mover.position) > 5.0) {
-            QPointF targetPos = getTrackPosition(mover.target);
-            targetPos = targetPos * scale + QPointF(centerX, centerY);
-            // 目标位置指示圆
-            painter.setBrush(QBrush(QColor(59, 130, 246, 100)));
-            painter.setPen(QPen(QColor(59, 130, 246), 2 * scale, Qt::DashLine));
-            painter.drawEllipse(targetPos, 12 * scale, 12 * scale);
-
-            // 目标位置标签
-            painter.setPen(QPen(QColor(59, 130, 246)));
-            QFont targetFont = painter.font();
-            targetFont.setPointSize(7);
-            targetFont.setBold(true);
-            painter.setFont(targetFont);
-            painter.drawText(targetPos.x() - 15 * scale, targetPos.y() - 15 * scale, "目标");
-
-            // 绘制从当前位置到目标位置的连接线
-            painter.setPen(QPen(QColor(59, 130, 246, 150), 2 * scale, Qt::DotLine));
-            painter.drawLine(currentPos, targetPos);
-        }
-
-        // 动子颜色
-        QColor moverColor;
-        if (mover.status == "紧急停止") {
-            moverColor = QColor(239, 68, 68);  // 红色 - 紧急停止优先
-        } else if (mover.isSelected) {
-            moverColor = QColor(59, 130, 246);  // 蓝色 - 选中状态
-        } else if (mover.status == "运行中") {
-            moverColor = QColor(16, 185, 129);  // 绿色 - 运行中
-        } else {
-            moverColor = QColor(107, 114, 128);  // 灰色 - 其他状态
-        }
-        // 动子阴影
-        painter.setBrush(QBrush(QColor(0, 0, 0, 80)));
-        painter.setPen(Qt::NoPen);
-        painter.drawEllipse(currentPos + QPointF(1.5 * scale, 1.5 * scale), 14 * scale, 14 * scale);
-
-        // 动子主体
-        painter.setBrush(QBrush(moverColor));
-        painter.setPen(QPen(Qt::white, 2 * scale));
-        painter.drawEllipse(currentPos, 25 * scale, 25 * scale);
-
-        // 如果是紧急停止状态，添加闪烁的红色边框
-        if (mover.status == "紧急停止") {
-            // 创建一个更粗的红色边框
-            painter.setBrush(Qt::NoBrush);
-            painter.setPen(QPen(QColor(239, 68, 68), 4 * scale));
-            painter.drawEllipse(currentPos, 28 * scale, 28 * scale);
-
-            // 可选：添加警告图标或文字
-            painter.setPen(QPen(Qt::white));
-            QFont warningFont = painter.font();
-            warningFont.setBold(true);
-            warningFont.setPointSize(10);
-            painter.setFont(warningFont);
-            painter.drawText(currentPos.x() - 5 * scale, currentPos.y() + 3 * scale, "!");
-        }
-
-        // 动子内圈
-        painter.setBrush(QBrush(moverColor.lighter(130)));
-        painter.setPen(QPen(moverColor.darker(120), 1));
-        painter.drawEllipse(currentPos, 8 * scale, 8 * scale);
-
-        // 动子编号
-        painter.setPen(QPen(Qt::white));
-        QFont moverFont = painter.font();
-        moverFont.setBold(true);
-        moverFont.setPointSize(9);
-        painter.setFont(moverFont);
-
-        // 1. 定义编号文字
-        QString idText = QString("M%1").arg(mover.id);
-
-        // 2. 计算文字的边界矩形
-        QFontMetrics idFm(moverFont);
-        QRect idRect = idFm.boundingRect(idText);
-
-        // 3. 将矩形中心移动到动子正上方
-        //    下方位置标签的Y坐标是 currentPos.y() + 22 * scale
-        //    用对称的负值将其移动到上方
-        idRect.moveCenter(QPoint(currentPos.x(), currentPos.y() - 80 * scale));
-
-        // 4. 为编号添加一个与下方位置标签类似的背景，以提高可读性
-        painter.setBrush(QBrush(QColor(0, 0, 0, 180)));
-        painter.setPen(QPen(moverColor, 1));
-        painter.drawRoundedRect(idRect.adjusted(-4, -2, 4, 2), 3, 3);
-
-        // 5. 在计算好的矩形内居中绘制文字
-        painter.setPen(QPen(QColor(255, 255, 255)));
-        painter.drawText(idRect, Qt::AlignCenter, idText);
-
-        // 优化的位置显示
-        QString posText = QString("%1mm").arg((int)mover.position);
-        QFont posFont = painter.font();
-        posFont.setBold(false);
-        posFont.setPointSize(8);
-        painter.setFont(posFont);
-
-        QFontMetrics fm(posFont);
-        QRect posRect = fm.boundingRect(posText);
-        posRect.moveCenter(QPoint(currentPos.x(), currentPos.y() - 200 * scale));
-
-        // 位置标签背景
-        painter.setBrush(QBrush(QColor(0, 0, 0, 180)));
-        painter.setPen(QPen(moverColor, 1));
-        painter.drawRoundedRect(posRect.adjusted(-4, -2, 4, 2), 3, 3);
-
-        painter.setPen(QPen(QColor(255, 255, 255)));
-        painter.drawText(posRect, Qt::AlignCenter, posText);
-
-        // 优化的选中效果（更小的外圈）
-        if (mover.isSelected) {
-            painter.setBrush(Qt::NoBrush);
-            painter.setPen(QPen(QColor(59, 130, 246), 2 * scale, Qt::DashLine));
-            painter.drawEllipse(currentPos, 18 * scale, 18 * scale);  // 减小选中圈
-        }
-
-        // 速度指示器
-        if (mover.speed > 0) {
-            painter.setPen(QPen(moverColor, 3 * scale));
-
-            // 计算运动方向
-            QPointF targetPoint = getTrackPosition(mover.target);
-            targetPoint.setX(centerX + (targetPoint.x() - 1200) * scale);
-            targetPoint.setY(centerY + (targetPoint.y() - 200) * scale);
-
-            QPointF direction = targetPoint - currentPos;
-            double length = sqrt(direction.x() * direction.x() + direction.y() * direction.y());
-            if (length > 0) {
-                direction = direction / length;
-
-                // 速度比例指示（箭头长度）
-                double speedRatio = mover.speed / mover.targetSpeed;
-                double arrowLength = 15 * scale * speedRatio;
-
-                QPointF arrowStart = currentPos + direction * 10 * scale;
-                QPointF arrowEnd = arrowStart + direction * arrowLength;
-
-                painter.drawLine(arrowStart, arrowEnd);
-
-                // 箭头头部
-                QPointF perpendicular(-direction.y(), direction.x());
-                QPointF head1 = arrowEnd - direction * 5 * scale + perpendicular * 3 * scale;
-                QPointF head2 = arrowEnd - direction * 5 * scale - perpendicular * 3 * scale;
-                painter.drawLine(arrowEnd, head1);
-                painter.drawLine(arrowEnd, head2);
-            }
-        }
-    }
-
     // 绘制轨道信息面板
     int infoX = 20;
     int infoY = 30;
@@ -392,9 +377,409 @@ void TrackWidget::paintEvent(QPaintEvent *event)
     arrowFont.setBold(true);
     painter.setFont(arrowFont);
     painter.drawText(arrowStartX - 60 * scale, arrowY + 150 * scale, "运动方向");
+
+    m_staticLayerValid = true;
 }
 
-QPointF TrackWidget::getTrackPosition(double position)
+void TrackWidget::drawMover(QPainter &painter, const MoverData &mover,
+                            const QPointF &currentPos, const QPointF &targetPos)
+{
+    const double scale = trackScale();
+
+    painter.setFont(font());
+
+    // 绘制目标位置（如果不同于当前位置）
+    if (qAbs(mover.target - mover.position) > 5.0) {
+        // 目标位置指示圆
+        painter.setBrush(QBrush(QColor(59, 130, 246, 100)));
+        painter.setPen(QPen(QColor(59, 130, 246), 2 * scale, Qt::DashLine));
+        painter.drawEllipse(targetPos, 12 * scale, 12 * scale);
+
+        // 目标位置标签
+        painter.setPen(QPen(QColor(59, 130, 246)));
+        QFont targetFont = painter.font();
+        targetFont.setPointSize(7);
+        targetFont.setBold(true);
+        painter.setFont(targetFont);
+        painter.drawText(targetPos.x() - 15 * scale, targetPos.y() - 15 * scale, "目标");
+
+        // 绘制从当前位置到目标位置的连接线
+        painter.setPen(QPen(QColor(59, 130, 246, 150), 2 * scale, Qt::DotLine));
+        painter.drawLine(currentPos, targetPos);
+    }
+
+    // 动子颜色
+    QColor moverColor;
+    if (mover.status == "紧急停止") {
+        moverColor = QColor(239, 68, 68);  // 红色 - 紧急停止优先
+    } else if (mover.isSelected) {
+        moverColor = QColor(59, 130, 246);  // 蓝色 - 选中状态
+    } else if (mover.status == "运行中") {
+        moverColor = QColor(16, 185, 129);  // 绿色 - 运行中
+    } else {
+        moverColor = QColor(107, 114, 128);  // 灰色 - 其他状态
+    }
+    // 动子阴影
+    painter.setBrush(QBrush(QColor(0, 0, 0, 80)));
+    painter.setPen(Qt::NoPen);
+    painter.drawEllipse(currentPos + QPointF(1.5 * scale, 1.5 * scale), 14 * scale, 14 * scale);
+
+    // 动子主体
+    painter.setBrush(QBrush(moverColor));
+    painter.setPen(QPen(Qt::white, 2 * scale));
+    painter.drawEllipse(currentPos, 25 * scale, 25 * scale);
+
+    // 如果是紧急停止状态，添加闪烁的红色边框
+    if (mover.status == "紧急停止") {
+        // 创建一个更粗的红色边框
+        painter.setBrush(Qt::NoBrush);
+        painter.setPen(QPen(QColor(239, 68, 68), 4 * scale));
+        painter.drawEllipse(currentPos, 28 * scale, 28 * scale);
+
+        // 可选：添加警告图标或文字
+        painter.setPen(QPen(Qt::white));
+        QFont warningFont = painter.font();
+        warningFont.setBold(true);
+        warningFont.setPointSize(10);
+        painter.setFont(warningFont);
+        painter.drawText(currentPos.x() - 5 * scale, currentPos.y() + 3 * scale, "!");
+    }
+
+    // 动子内圈
+    painter.setBrush(QBrush(moverColor.lighter(130)));
+    painter.setPen(QPen(moverColor.darker(120), 1));
+    painter.drawEllipse(currentPos, 8 * scale, 8 * scale);
+
+    // 动子编号
+    painter.setPen(QPen(Qt::white));
+    QFont moverFont = painter.font();
+    moverFont.setBold(true);
+    moverFont.setPointSize(9);
+    painter.setFont(moverFont);
+
+    // 1. 定义编号文字
+    QString idText = QString("M%1").arg(mover.id);
+
+    // 2. 计算文字的边界矩形
+    QFontMetrics idFm(moverFont);
+    QRect idRect = idFm.boundingRect(idText);
+
+    // 3. 将矩形中心移动到动子正上方
+    //    下方位置标签的Y坐标是 currentPos.y() + 22 * scale
+    //    用对称的负值将其移动到上方
+    idRect.moveCenter(QPoint(currentPos.x(), currentPos.y() - 80 * scale));
+
+    // 4. 为编号添加一个与下方位置标签类似的背景，以提高可读性
+    painter.setBrush(QBrush(QColor(0, 0, 0, 180)));
+    painter.setPen(QPen(moverColor, 1));
+    painter.drawRoundedRect(idRect.adjusted(-4, -2, 4, 2), 3, 3);
+
+    // 5. 在计算好的矩形内居中绘制文字
+    painter.setPen(QPen(QColor(255, 255, 255)));
+    painter.drawText(idRect, Qt::AlignCenter, idText);
+
+    // 优化的位置显示
+    QString posText = QString("%1mm").arg((int)mover.position);
+    QFont posFont = painter.font();
+    posFont.setBold(false);
+    posFont.setPointSize(8);
+    painter.setFont(posFont);
+
+    QFontMetrics fm(posFont);
+    QRect posRect = fm.boundingRect(posText);
+    posRect.moveCenter(QPoint(currentPos.x(), currentPos.y() - 200 * scale));
+
+    // 位置标签背景
+    painter.setBrush(QBrush(QColor(0, 0, 0, 180)));
+    painter.setPen(QPen(moverColor, 1));
+    painter.drawRoundedRect(posRect.adjusted(-4, -2, 4, 2), 3, 3);
+
+    painter.setPen(QPen(QColor(255, 255, 255)));
+    painter.drawText(posRect, Qt::AlignCenter, posText);
+
+    // 优化的选中效果（更小的外圈）
+    if (mover.isSelected) {
+        painter.setBrush(Qt::NoBrush);
+        painter.setPen(QPen(QColor(59, 130, 246), 2 * scale, Qt::DashLine));
+        painter.drawEllipse(currentPos, 18 * scale, 18 * scale);  // 减小选中圈
+    }
+
+    // 速度指示器
+    if (mover.speed > 0) {
+        painter.setPen(QPen(moverColor, 3 * scale));
+
+        // 计算运动方向
+        QPointF targetPoint = targetPos - QPointF(1200 * scale, 200 * scale);
+
+        QPointF direction = targetPoint - currentPos;
+        double length = sqrt(direction.x() * direction.x() + direction.y() * direction.y());
+        if (length > 0) {
+            direction = direction / length;
+
+            // 速度比例指示（箭头长度），设上限以保证箭头落在动子的重绘区域内
+            double speedRatio = mover.targetSpeed > 0 ? qMin(mover.speed / mover.targetSpeed, MAX_SPEED_RATIO)
+                                                      : MAX_SPEED_RATIO;
+            double arrowLength = 15 * scale * speedRatio;
+
+            QPointF arrowStart = currentPos + direction * 10 * scale;
+            QPointF arrowEnd = arrowStart + direction * arrowLength;
+
+            painter.drawLine(arrowStart, arrowEnd);
+
+            // 箭头头部
+            QPointF perpendicular(-direction.y(), direction.x());
+            QPointF head1 = arrowEnd - direction * 5 * scale + perpendicular * 3 * scale;
+            QPointF head2 = arrowEnd - direction * 5 * scale - perpendicular * 3 * scale;
+            painter.drawLine(arrowEnd, head1);
+            painter.drawLine(arrowEnd, head2);
+        }
+    }
+}
+
+// 动子在屏幕上占用的区域：本体、速度箭头、上方标签以及目标指示
+QRect TrackWidget::moverBounds(const MoverData &mover) const
+{
+    return moverBounds(mover, trackPointAt(mover.position), trackPointAt(mover.target));
+}
+
+QRect TrackWidget::moverBounds(const MoverData &mover, const QPointF &currentPos, const QPointF &targetPos) const
+{
+    const double scale = trackScale();
+
+    const double radius = (10.0 + 15.0 * MAX_SPEED_RATIO + 5.0) * scale + 4.0;
+    QRectF bounds(currentPos.x() - radius, currentPos.y() - radius, radius * 2, radius * 2);
+    bounds |= QRectF(currentPos.x() - LABEL_HALF_WIDTH, currentPos.y() - 200 * scale - LABEL_HALF_HEIGHT,
+                     LABEL_HALF_WIDTH * 2, 200 * scale + LABEL_HALF_HEIGHT * 2);
+
+    if (qAbs(mover.target - mover.position) > 5.0) {
+        const double targetRadius = 12 * scale + 4.0;
+        bounds |= QRectF(currentPos, targetPos).normalized();
+        bounds |= QRectF(targetPos.x() - targetRadius, targetPos.y() - targetRadius,
+                         targetRadius * 2, targetRadius * 2);
+        bounds |= QRectF(targetPos.x() - 15 * scale - 2, targetPos.y() - 15 * scale - LABEL_HALF_HEIGHT,
+                         LABEL_HALF_WIDTH, LABEL_HALF_HEIGHT + 4);
+    }
+    return bounds.toAlignedRect().adjusted(-2, -2, 2, 2);
+}
+
+void TrackWidget::drawCollisionAlert(QPainter &painter, const CollisionAlert &alert,
+                                     const QPointF &behindPos, const QPointF &aheadPos)
+{
+    const double scale = trackScale();
+
+    QColor color;
+    switch (alert.level) {
+    case CollisionLevel::Critical: color = QColor(239, 68, 68);  break;  // 红色 - 严重
+    case CollisionLevel::Warning:  color = QColor(249, 115, 22); break;  // 橙色 - 警告
+    default:                       color = QColor(250, 204, 21); break;  // 黄色 - 提示
+    }
+
+    // 连接两车的粗线与两车外圈
+    painter.setPen(QPen(color, 6 * scale, Qt::SolidLine, Qt::RoundCap));
+    painter.drawLine(behindPos, aheadPos);
+    painter.setBrush(Qt::NoBrush);
+    painter.setPen(QPen(color, 3 * scale, Qt::DashLine));
+    painter.drawEllipse(behindPos, 34 * scale, 34 * scale);
+    painter.drawEllipse(aheadPos, 34 * scale, 34 * scale);
+
+    // 中点标注等级；告警只在等级变化时下发，不标注随每帧变化的剩余时间
+    const QString text = CollisionMonitor::levelText(alert.level);
+    QFont alertFont = painter.font();
+    alertFont.setPointSize(8);
+    alertFont.setBold(true);
+    painter.setFont(alertFont);
+    painter.setPen(QPen(color));
+    const QPointF mid = (behindPos + aheadPos) / 2.0;
+    painter.drawText(QRectF(mid.x() - LABEL_HALF_WIDTH, mid.y() + 30 * scale,
+                            LABEL_HALF_WIDTH * 2, LABEL_HALF_HEIGHT * 2),
+                     Qt::AlignHCenter | Qt::AlignTop, text);
+}
+
+QRect TrackWidget::alertBounds(const QPointF &behindPos, const QPointF &aheadPos) const
+{
+    const double scale = trackScale();
+    const double ringRadius = 34 * scale + 4.0;
+    QRectF bounds = QRectF(behindPos, aheadPos).normalized()
+                        .adjusted(-ringRadius, -ringRadius, ringRadius, ringRadius);
+    const QPointF mid = (behindPos + aheadPos) / 2.0;
+    bounds |= QRectF(mid.x() - LABEL_HALF_WIDTH, mid.y() + 30 * scale,
+                     LABEL_HALF_WIDTH * 2, LABEL_HALF_HEIGHT * 2);
+    return bounds.toAlignedRect().adjusted(-2, -2, 2, 2);
+}
+
+QRegion TrackWidget::collisionAlertsRegion() const
+{
+    QRegion region;
+    const int count = m_movers.size();
+    for (const CollisionAlert &alert : m_collisionAlerts) {
+        if (alert.behindId < 0 || alert.behindId >= count || alert.aheadId < 0 || alert.aheadId >= count) {
+            continue;
+        }
+        region += alertBounds(trackPointAt(m_movers[alert.behindId].position),
+                              trackPointAt(m_movers[alert.aheadId].position));
+    }
+    return region;
+}
+
+// 沿轨道采样的折线与等时间间隔的刻度点（屏幕坐标）
+void TrackWidget::buildPreviewGeometry(QPolygonF &path, QVector<QPointF> &ticks) const
+{
+    const MotionProfile &profile = m_previewProfile;
+    path.clear();
+    ticks.clear();
+    if (!profile.isValid()) {
+        return;
+    }
+    for (int i = 0; i <= PREVIEW_PATH_SAMPLES; ++i) {
+        const double travelled = profile.distance() * i / PREVIEW_PATH_SAMPLES;
+        path << trackPointAt(profile.startPosition() + profile.direction() * travelled);
+    }
+    const double tick = qMax(PREVIEW_TICK_SEC, profile.duration() / PREVIEW_MAX_TICKS);
+    for (double t = tick; t < profile.duration(); t += tick) {
+        ticks << trackPointAt(profile.positionAt(t));
+    }
+}
+
+QRect TrackWidget::previewBounds() const
+{
+    if (!m_previewProfile.isValid()) {
+        return QRect();
+    }
+    QPolygonF path;
+    QVector<QPointF> ticks;
+    buildPreviewGeometry(path, ticks);
+    const double scale = trackScale();
+    const double radius = 28 * scale + 4.0;
+    QRectF bounds = path.boundingRect().adjusted(-radius, -radius, radius, radius);
+    const QPointF end = path.last();
+    bounds |= QRectF(end.x() - LABEL_HALF_WIDTH, end.y() + 30 * scale,
+                     LABEL_HALF_WIDTH * 2, LABEL_HALF_HEIGHT * 2);
+    return bounds.toAlignedRect().adjusted(-2, -2, 2, 2);
+}
+
+void TrackWidget::drawMotionPreview(QPainter &painter)
+{
+    const double scale = trackScale();
+    QPolygonF path;
+    QVector<QPointF> ticks;
+    buildPreviewGeometry(path, ticks);
+
+    const QColor color = m_previewConflict ? QColor(239, 68, 68) : QColor(168, 85, 247);  // 红色 - 冲突，紫色 - 正常
+
+    // 虚影轨迹
+    painter.setBrush(Qt::NoBrush);
+    painter.setPen(QPen(QColor(color.red(), color.green(), color.blue(), 160), 5 * scale, Qt::DashLine, Qt::RoundCap));
+    painter.drawPolyline(path);
+
+    // 等时间刻度点：越密表示越慢
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(color);
+    for (const QPointF &tick : ticks) {
+        painter.drawEllipse(tick, 4 * scale + 1, 4 * scale + 1);
+    }
+
+    // 终点处的动子虚影与用时
+    const QPointF end = path.last();
+    painter.setBrush(QColor(color.red(), color.green(), color.blue(), 70));
+    painter.setPen(QPen(color, 2 * scale, Qt::DashLine));
+    painter.drawEllipse(end, 25 * scale, 25 * scale);
+
+    QFont previewFont = painter.font();
+    previewFont.setPointSize(8);
+    previewFont.setBold(true);
+    painter.setFont(previewFont);
+    painter.setPen(QPen(color));
+    painter.drawText(QRectF(end.x() - LABEL_HALF_WIDTH, end.y() + 30 * scale,
+                            LABEL_HALF_WIDTH * 2, LABEL_HALF_HEIGHT * 2),
+                     Qt::AlignHCenter | Qt::AlignTop,
+                     QString("%1 s").arg(m_previewProfile.duration(), 0, 'f', 2));
+}
+
+bool TrackWidget::moverChanged(const MoverData &a, const MoverData &b)
+{
+    return a.id != b.id
+           || a.position != b.position
+           || a.target != b.target
+           || a.speed != b.speed
+           || a.targetSpeed != b.targetSpeed
+           || a.isSelected != b.isSelected
+           || a.status != b.status;
+}
+
+void TrackWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    m_staticLayerValid = false;
+}
+
+void TrackWidget::changeEvent(QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::StyleChange:
+    case QEvent::PaletteChange:
+    case QEvent::FontChange:
+        invalidateStaticLayer();
+        break;
+    default:
+        break;
+    }
+    QWidget::changeEvent(event);
+}
+
+// 按固定分辨率对轨道采样，样本直接存屏幕坐标；缩放或尺寸变化后重建
+void TrackWidget::ensureTrackLut()
+{
+    const double scale = trackScale();
+    const QPointF center = trackCenter();
+    if (m_lutX.size() == LUT_SEGMENTS + 1 && scale == m_lutScale && center == m_lutCenter) {
+        return;
+    }
+
+    m_lutX.resize(LUT_SEGMENTS + 1);
+    m_lutY.resize(LUT_SEGMENTS + 1);
+    for (int i = 0; i <= LUT_SEGMENTS; ++i) {
+        // 最后一个样本回到起点，插值时无需单独处理首尾相接
+        const double position = (i == LUT_SEGMENTS) ? 0.0 : TRACK_LENGTH * i / LUT_SEGMENTS;
+        const QPointF point = getTrackPosition(position) * scale + center;
+        m_lutX[i] = point.x();
+        m_lutY[i] = point.y();
+    }
+    m_lutScale = scale;
+    m_lutCenter = center;
+}
+
+/**
+ * 批量把轨道位置映射为屏幕坐标
+ * 循环体无分支：取模归一化、截断取下标、线性插值，便于编译器展开和向量化。
+ * 调用前需保证查找表已由 ensureTrackLut 建好。
+ */
+void TrackWidget::mapTrackPositions(const double *positions, double *xs, double *ys, int count) const
+{
+    const double *lutX = m_lutX.constData();
+    const double *lutY = m_lutY.constData();
+    const double samplesPerMm = LUT_SEGMENTS / TRACK_LENGTH;
+    // 略小于LUT_SEGMENTS，保证idx + 1不越界；非法值(NaN)被夹到0
+    const double maxIndex = LUT_SEGMENTS - 1e-9;
+
+    for (int i = 0; i < count; ++i) {
+        const double wrapped = positions[i] - std::floor(positions[i] / TRACK_LENGTH) * TRACK_LENGTH;
+        const double f = qBound(0.0, wrapped * samplesPerMm, maxIndex);
+        const int idx = static_cast<int>(f);
+        const double t = f - idx;
+        xs[i] = lutX[idx] + (lutX[idx + 1] - lutX[idx]) * t;
+        ys[i] = lutY[idx] + (lutY[idx + 1] - lutY[idx]) * t;
+    }
+}
+
+QPointF TrackWidget::trackPointAt(double position) const
+{
+    double x = 0.0;
+    double y = 0.0;
+    mapTrackPositions(&position, &x, &y, 1);
+    return QPointF(x, y);
+}
+
+QPointF TrackWidget::getTrackPosition(double position) const
 {
     // 归一化位置
     double normalizedPos = position;
@@ -439,7 +824,7 @@ void TrackWidget::zoomIn()
     }
     m_zoomFactor *= 1.25;
     updateGeometry(); // 通知布局系统尺寸提示已改变
-    update();
+    invalidateStaticLayer();
 }
 
 void TrackWidget::zoomOut()
@@ -450,7 +835,7 @@ void TrackWidget::zoomOut()
     m_zoomFactor /= 1.25;
     if (m_zoomFactor < 0.2) m_zoomFactor = 0.2;
     updateGeometry();
-    update();
+    invalidateStaticLayer();
 }
 
 void TrackWidget::resetZoom()
@@ -461,7 +846,7 @@ void TrackWidget::resetZoom()
     }
     emit viewReset(); // 发送信号，让父控件处理后续
     updateGeometry();
-    update();
+    invalidateStaticLayer();
 }
 
 
@@ -4,6 +4,7 @@
 #include "TrackWidget.h"
 #include "MoverWidget.h"
 #include "LogWidget.h"
+#include "GroupMoveDialog.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGridLayout>
@@ -16,11 +17,14 @@
 #include <QHeaderView>
 #include <QScrollArea>
 #include <QScrollBar>
+#include <QMessageBox>
+#include <QtMath>
 #include <QDebug>
 
 // 构造函数接收一个指向动子数据列表的指针
 OverviewPage::OverviewPage(QList<MoverData>* movers, const QString& currentUser, QWidget *parent)
     : QWidget(parent)
+    , m_mainWindow(qobject_cast<MainWindow*>(parent))
     , m_movers(movers) // 初始化指针
     , m_currentUser(currentUser)
     , m_selectedMover(0) // 默认选中第一个动子
@@ -155,7 +159,20 @@ void OverviewPage::setupUI()
         onMoverSelected(row);
     });
 
+    // 多选行后可一次下发协同定位
+    m_statusTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_statusTable->setSelectionMode(QAbstractItemView::ExtendedSelection);
+
     tableLayout->addWidget(m_statusTable);
+
+    QPushButton *groupMoveBtn = new QPushButton("协同定位...");
+    groupMoveBtn->setStyleSheet(zoomBtnStyle);
+    groupMoveBtn->setToolTip("为选中的多个动子设置目标与速度，在同一PLC周期内同时启动");
+    QHBoxLayout *tableButtonLayout = new QHBoxLayout();
+    tableButtonLayout->addStretch();
+    tableButtonLayout->addWidget(groupMoveBtn);
+    tableLayout->addLayout(tableButtonLayout);
+    connect(groupMoveBtn, &QPushButton::clicked, this, &OverviewPage::onGroupMoveRequested);
     leftLayout->addWidget(trackGroup, 2);
     leftLayout->addWidget(tableGroup, 1);
 
@@ -269,14 +286,174 @@ void OverviewPage::updateMovers(const QList<MoverData> &movers)
 
     int moverCount = qMin(m_movers->size(), m_moverWidgets.size());
     for (int i = 0; i < moverCount; ++i) {
-        if (m_moverWidgets[i]) {
-            MoverData moverData = (*m_movers)[i];
-            moverData.isSelected = (i == m_selectedMover);
-            m_moverWidgets[i]->updateMover(moverData);
+        updateMoverWidget(i);
+    }
+}
+
+// 增量刷新：只更新本周期变化的动子对应的轨道、表格行和卡片
+void OverviewPage::onMoversChanged(const QVector<int> &changedIds, quint64 generation)
+{
+    Q_UNUSED(generation)
+
+    if (!m_movers || m_movers->isEmpty()) {
+        return;
+    }
+    // 表格行数与动子数量不一致说明错过了结构变化，整体重建
+    if (m_statusTable && m_statusTable->rowCount() != m_movers->size()) {
+        updateMovers(*m_movers);
+        return;
+    }
+
+    if (m_trackWidget) {
+        m_trackWidget->updateMovers(*m_movers, changedIds);
+    }
+
+    if (m_statusTable) {
+        m_statusTable->blockSignals(true);
+    }
+    for (int id : changedIds) {
+        if (id < 0 || id >= m_movers->size()) {
+            continue;
+        }
+        if (m_statusTable) {
+            updateTableRow(id, (*m_movers)[id]);
         }
+        updateMoverWidget(id);
+    }
+    if (m_statusTable) {
+        m_statusTable->blockSignals(false);
     }
 }
 
+// 间距告警只需在轨道视图上标出动子对
+void OverviewPage::onCollisionAlertsChanged(const QVector<CollisionAlert> &alerts)
+{
+    if (m_trackWidget) {
+        m_trackWidget->setCollisionAlerts(alerts);
+    }
+}
+
+/**
+ * @brief 打开协同定位对话框，校验通过后一次提交全部命令
+ */
+void OverviewPage::onGroupMoveRequested()
+{
+    ModbusManager *modbus = m_mainWindow ? m_mainWindow->getModbusManager() : nullptr;
+    if (!modbus || !modbus->isConnected()) {
+        QMessageBox::warning(this, "PLC未连接", "请先连接PLC设备！");
+        return;
+    }
+    if (!m_movers || m_movers->isEmpty()) {
+        return;
+    }
+
+    QVector<int> preselected;
+    const QList<QTableWidgetSelectionRange> ranges = m_statusTable->selectedRanges();
+    for (const QTableWidgetSelectionRange &range : ranges) {
+        for (int row = range.topRow(); row <= range.bottomRow(); ++row) {
+            preselected.append(row);
+        }
+    }
+
+    GroupMoveDialog dialog(*m_movers, preselected, m_mainWindow->collisionMonitor().ringIndex().trackLength(), this);
+    dialog.setValidator([this](const QVector<ModbusManager::GroupMoveCommand> &commands) {
+        return validateGroupMove(commands);
+    });
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    const QVector<ModbusManager::GroupMoveCommand> commands = dialog.commands();
+    // 提交前用最新位置再校验一次
+    const QString error = validateGroupMove(commands);
+    if (!error.isEmpty()) {
+        QMessageBox::warning(this, "碰撞风险", error + "\n命令未发送。");
+        return;
+    }
+
+    // 自动运行等其他来源的协同定位也经过同一信号，只记录本页提交的序号
+    connect(modbus, &ModbusManager::groupMoveFinished, this, &OverviewPage::onGroupMoveFinished, Qt::UniqueConnection);
+    if (modbus->commitGroupMove(commands)) {
+        m_groupMoveSequences.insert(modbus->lastGroupMoveSequence());
+        addLogEntry(QString("协同定位 #%1 已提交：%2个动子").arg(modbus->lastGroupMoveSequence()).arg(commands.size()), "info");
+    } else {
+        addLogEntry("协同定位提交失败", "error");
+    }
+}
+
+void OverviewPage::onGroupMoveFinished(quint16 sequence, bool success)
+{
+    if (!m_groupMoveSequences.remove(sequence)) {
+        return;
+    }
+    if (success) {
+        addLogEntry(QString("协同定位 #%1 已由PLC确认，所有动子同时启动").arg(sequence), "success");
+    } else {
+        addLogEntry(QString("协同定位 #%1 失败或未获PLC确认").arg(sequence), "error");
+    }
+}
+
+/**
+ * @brief 按时间推演检查协同定位
+ *
+ * 全部条目由同一个触发同时启动，按各自的梯形曲线（条目没有方向字段，PLC沿最短路径运动）
+ * 推演，与相邻动子逐时刻比较间距；未参与的动子按当前速度外推。
+ * @return 空字符串表示无冲突，否则为冲突描述
+ */
+QString OverviewPage::validateGroupMove(const QVector<ModbusManager::GroupMoveCommand> &commands) const
+{
+    if (!m_mainWindow || !m_movers) {
+        return QString();
+    }
+    const MoverTelemetryTable &telemetry = m_mainWindow->moverTelemetry();
+    const CollisionMonitor &monitor = m_mainWindow->collisionMonitor();
+    const int count = m_movers->size();
+    if (telemetry.size() != count || monitor.ringIndex().size() != count) {
+        return QString("动子数据尚未就绪");
+    }
+
+    QVector<MotionProfile> profiles(count);
+    QVector<bool> seen(count, false);
+    for (const ModbusManager::GroupMoveCommand &command : commands) {
+        if (command.moverId < 0 || command.moverId >= count) {
+            return QString("无效的动子编号 %1").arg(command.moverId);
+        }
+        if (seen[command.moverId]) {
+            return QString("动子%1重复").arg(command.moverId);
+        }
+        seen[command.moverId] = true;
+
+        const MoverData &mover = (*m_movers)[command.moverId];
+        MotionProfile::Limits limits;
+        limits.maxSpeed = command.speed;
+        limits.acceleration = mover.acceleration > 0.0 ? mover.acceleration : mover.targetAcceleration;
+        profiles[command.moverId] = MotionProfile::plan(telemetry.position[command.moverId], command.targetPosition,
+                                                        monitor.ringIndex().trackLength(), MoverData::AUTO,
+                                                        MotionProfile::Trapezoidal, limits);
+        if (!profiles[command.moverId].isValid()) {
+            return QString("动子%1的速度或加速度无效").arg(command.moverId);
+        }
+    }
+
+    const CollisionAlert alert = monitor.checkGroup(profiles, telemetry);
+    if (alert.level != CollisionLevel::None) {
+        return QString("启动后%1 s动子%2与前方动子%3的间距降到%4 mm，小于安全距离%5 mm")
+            .arg(alert.timeToViolation, 0, 'f', 2).arg(alert.behindId).arg(alert.aheadId)
+            .arg(alert.gap, 0, 'f', 1).arg(monitor.safetyDistance(), 0, 'f', 1);
+    }
+    return QString();
+}
+
+void OverviewPage::updateMoverWidget(int id)
+{
+    if (id < 0 || id >= m_moverWidgets.size() || id >= m_movers->size() || !m_moverWidgets[id]) {
+        return;
+    }
+    MoverData moverData = (*m_movers)[id];
+    moverData.isSelected = (id == m_selectedMover);
+    m_moverWidgets[id]->updateMover(moverData);
+}
+
 void OverviewPage::updateTableData(const QList<MoverData> &data)
 {
     // 这个函数现在由 updateMovers 调用，参数 data 是 *m_movers
@@ -284,28 +461,31 @@ void OverviewPage::updateTableData(const QList<MoverData> &data)
     m_statusTable->blockSignals(true); // 更新期间禁止信号
 
     for (int i = 0; i < data.size(); ++i) {
-        const MoverData &mover = data[i];
+        updateTableRow(i, data[i]);
+    }
+    m_statusTable->blockSignals(false); // 恢复信号
+}
 
-        // 确保单元格存在
-        for (int j = 0; j < 4; ++j) {
-            if (!m_statusTable->item(i, j)) {
-                m_statusTable->setItem(i, j, new QTableWidgetItem());
-            }
+void OverviewPage::updateTableRow(int row, const MoverData &mover)
+{
+    // 确保单元格存在
+    for (int j = 0; j < 4; ++j) {
+        if (!m_statusTable->item(row, j)) {
+            m_statusTable->setItem(row, j, new QTableWidgetItem());
         }
+    }
 
-        // 更新数据
-        m_statusTable->item(i, 0)->setText(QString::number(mover.id));
-        m_statusTable->item(i, 1)->setText(QString::number(mover.position, 'f', 1));
-        m_statusTable->item(i, 2)->setText(QString::number(mover.target, 'f', 1));
-        m_statusTable->item(i, 3)->setText(QString::number(mover.speed, 'f', 1));
+    // 更新数据
+    m_statusTable->item(row, 0)->setText(QString::number(mover.id));
+    m_statusTable->item(row, 1)->setText(QString::number(mover.position, 'f', 1));
+    m_statusTable->item(row, 2)->setText(QString::number(mover.target, 'f', 1));
+    m_statusTable->item(row, 3)->setText(QString::number(mover.speed, 'f', 1));
 
-        // 更新颜色和背景
-        QColor bgColor = (i == m_selectedMover) ? QColor(83, 52, 131, 80) : QColor();
-        for (int j = 0; j < 4; ++j) {
-            m_statusTable->item(i, j)->setBackground(bgColor);
-        }
+    // 更新颜色和背景
+    QColor bgColor = (row == m_selectedMover) ? QColor(83, 52, 131, 80) : QColor();
+    for (int j = 0; j < 4; ++j) {
+        m_statusTable->item(row, j)->setBackground(bgColor);
     }
-    m_statusTable->blockSignals(false); // 恢复信号
 }
 
 void OverviewPage::onMoverSelected(int id)
@@ -633,7 +633,7 @@ void RecipeManagerPage::onApplyRecipe()
                     bool success = true;
 
                     // 发送目标位置 (假设PLC有专门的目标位置寄存器)
-                    int posRegister = ModbusRegisters::MoverStatus::BASE_ADDRESS +
+                    int posRegister = m_modbusManager->moverStatusBase() +
                                       moverId * ModbusRegisters::MoverStatus::REGISTERS_PER_MOVER +
                                       ModbusRegisters::MoverStatus::TARGET_LOW;
 
@@ -650,8 +650,11 @@ void RecipeManagerPage::onApplyRecipe()
                         mover.commandedSpeed = targetSpeed;
                         mover.targetAcceleration = targetAccel;
                         mover.lastCommand = QString("配方:%1").arg(recipe.name);
-                        mover.lastCommandTime = QDateTime::currentDateTime();
-                        mover.status = "运行中";
+                        mover.lastCommandMs = moverClockMs();
+                        mover.setStatus(MoverStatusCode::Running);
+                        if (m_mainWindow) {
+                            m_mainWindow->markMoverDirty(moverId);
+                        }
 
                         addLogEntry(QString("PLC - 动子%1: 位置=%2mm, 速度=%3mm/s, 加速度=%4mm/s²")
                                         .arg(moverId).arg(targetPos).arg(targetSpeed).arg(targetAccel), "success");
@@ -709,16 +712,19 @@ void RecipeManagerPage::onApplyRecipe()
                         mover.targetSpeed = targetSpeed;
                         mover.acceleration = targetAccel;
                         mover.targetAcceleration = targetAccel;
-                        mover.status = "运行中";
+                        mover.setStatus(MoverStatusCode::Running);
                         mover.inPosition = false;
                         mover.hasError = false;
                         mover.speed = targetSpeed;
                         mover.lastCommand = QString("配方:%1").arg(recipe.name);
-                        mover.lastCommandTime = QDateTime::currentDateTime();
+                        mover.lastCommandMs = moverClockMs();
 
                         // 重置命令状态
                         mover.commandedTarget = targetPos;
                         mover.commandedSpeed = targetSpeed;
+                        if (m_mainWindow) {
+                            m_mainWindow->markMoverDirty(moverId);
+                        }
 
                         // *** 添加调试输出 ***
                         qDebug() << QString("配方应用 - 动子%1: 当前位置=%2, 目标位置=%3, 速度=%4, 状态=%5")
@@ -732,7 +738,7 @@ void RecipeManagerPage::onApplyRecipe()
                         if (delay > 0) {
                             addLogEntry(QString("模拟 - 动子%1 配置延时 %2ms").arg(moverId).arg(delay), "info");
                             // 在模拟模式中，我们可以设置一个延迟启动时间而不是阻塞线程
-                            mover.lastCommandTime = mover.lastCommandTime.addMSecs(delay);
+                            mover.lastCommandMs += delay;
                         }
 
                     } catch (const std::exception& e) {
@@ -14,8 +14,11 @@ SOURCES += \
     src/main.cpp \
     src/mainwindow.cpp \
     src/modbusmanager.cpp \
+    src/modbusioworker.cpp \
+    src/heartbeatscheduler.cpp \
     src/basecontroller.cpp \
     src/logmanager.cpp \
+    src/logfilewriter.cpp \
     src/logwindow.cpp \
     src/stylemanager.cpp \
     src/thememanager.cpp \
@@ -29,8 +32,14 @@ SOURCES += \
 HEADERS += \
     include/mainwindow.h \
     include/modbusmanager.h \
+    include/modbusioworker.h \
+    include/heartbeatscheduler.h \
+    include/spscqueue.h \
+    include/moversnapshotbuffer.h \
     include/basecontroller.h \
     include/logmanager.h \
+    include/logfilewriter.h \
+    include/mpscqueue.h \
     include/logwindow.h \
     include/stylemanager.h \
     include/thememanager.h \
@@ -0,0 +1,441 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+#include <QHash>
+#include <QFile>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#include "modbusmanager.h"
+
+/**
+ * modbusbench
+ * 职责：无界面基准测试，连接本地模拟PLC（PlcSimulator）逐个测量 ModbusManager 接口的
+ * 调用速率与往返时间百分位，再开启动子轮询统计快照到达间隔的抖动，结果以 JSON 输出。
+ * 同步接口按调用前后的墙钟计时；异步 writeRegister 按 requestCompleted 回送计时。
+ */
+
+namespace {
+
+struct BenchConfig
+{
+    QString host = "127.0.0.1";
+    int port = 5020;
+    int unitId = 1;
+    int iterations = 2000;
+    int warmup = 100;
+    int depth = 1;              // writeRegister同时在途的调用数
+    int moverCount = 10;
+    int statusBase = ModbusManager::kMoverStatusBaseAddress;    // 动子状态块基址，与模拟PLC的--status-base一致
+    int writeAddress = 0x24;    // 配方区：模拟PLC中写入不会触发运动
+    int pollIntervalMs = 20;
+    int pollDurationMs = 10000;
+    int timeoutMs = 2000;
+};
+
+/**
+ * LatencySamples
+ * 职责：收集往返时间样本（纳秒），输出调用速率与最近秩百分位（微秒）。
+ */
+class LatencySamples
+{
+public:
+    void add(qint64 ns) { m_samples.append(ns); }
+    void addFailure() { ++m_failures; }
+
+    QJsonObject toJson(qint64 elapsedNs) const
+    {
+        QVector<qint64> sorted = m_samples;
+        std::sort(sorted.begin(), sorted.end());
+
+        QJsonObject latency;
+        latency["min"] = toUs(sorted.isEmpty() ? 0 : sorted.first());
+        latency["mean"] = toUs(mean(sorted));
+        latency["p50"] = toUs(percentile(sorted, 0.50));
+        latency["p99"] = toUs(percentile(sorted, 0.99));
+        latency["p999"] = toUs(percentile(sorted, 0.999));
+        latency["max"] = toUs(sorted.isEmpty() ? 0 : sorted.last());
+
+        QJsonObject result;
+        result["calls"] = sorted.size() + m_failures;
+        result["failures"] = m_failures;
+        result["durationMs"] = elapsedNs / 1e6;
+        result["callsPerSec"] = elapsedNs > 0 ? sorted.size() * 1e9 / elapsedNs : 0.0;
+        result["latencyUs"] = latency;
+        return result;
+    }
+
+    static double percentile(const QVector<qint64>& sorted, double p)
+    {
+        if (sorted.isEmpty()) {
+            return 0.0;
+        }
+        const int rank = qBound(1, static_cast<int>(std::ceil(p * sorted.size())), sorted.size());
+        return sorted.at(rank - 1);
+    }
+
+    static double mean(const QVector<qint64>& samples)
+    {
+        if (samples.isEmpty()) {
+            return 0.0;
+        }
+        double sum = 0.0;
+        for (qint64 sample : samples) {
+            sum += sample;
+        }
+        return sum / samples.size();
+    }
+
+    static double toUs(double ns) { return std::round(ns / 100.0) / 10.0; }
+
+private:
+    QVector<qint64> m_samples;
+    int m_failures = 0;
+};
+
+
+// 同步接口：每次调用的墙钟时间即往返时间（含局部事件循环的调度开销）
+QJsonObject measureSync(int iterations, const std::function<bool(int index)>& call)
+{
+    LatencySamples samples;
+    QElapsedTimer clock;
+    clock.start();
+    for (int i = 0; i < iterations; ++i) {
+        const qint64 start = clock.nsecsElapsed();
+        if (call(i)) {
+            samples.add(clock.nsecsElapsed() - start);
+        } else {
+            samples.addFailure();
+        }
+    }
+    return samples.toJson(clock.nsecsElapsed());
+}
+
+
+// 异步接口：保持depth个调用在途，requestCompleted回送后记一次往返时间并补发下一个；
+// 超过timeoutMs没有任何回送时放弃剩余调用并计为失败
+QJsonObject measureAsync(ModbusManager& manager, const BenchConfig& config, int iterations,
+                         const std::function<bool(int index)>& issue)
+{
+    LatencySamples samples;
+    QHash<quint64, qint64> startTimes;  // 请求编号 -> 投递时间
+    QElapsedTimer clock;
+    QEventLoop loop;
+    QTimer watchdog;
+    int issued = 0;
+    int finished = 0;
+
+    auto issueNext = [&]() {
+        while (startTimes.size() < config.depth && issued < iterations) {
+            const int index = issued++;
+            const quint64 before = manager.lastRequestId();
+            const qint64 start = clock.nsecsElapsed();
+            if (!issue(index) || manager.lastRequestId() == before) {
+                samples.addFailure();
+                ++finished;
+                continue;
+            }
+            startTimes.insert(manager.lastRequestId(), start);
+        }
+        if (finished >= iterations) {
+            loop.quit();
+        }
+    };
+
+    const QMetaObject::Connection connection = QObject::connect(&manager, &ModbusManager::requestCompleted,
+        [&](quint64 id, bool success) {
+            const auto it = startTimes.find(id);
+            if (it == startTimes.end()) {
+                return;
+            }
+            if (success) {
+                samples.add(clock.nsecsElapsed() - it.value());
+            } else {
+                samples.addFailure();
+            }
+            startTimes.erase(it);
+            ++finished;
+            watchdog.start();
+            issueNext();
+        });
+
+    watchdog.setSingleShot(true);
+    watchdog.setInterval(config.timeoutMs);
+    QObject::connect(&watchdog, &QTimer::timeout, &loop, &QEventLoop::quit);
+
+    clock.start();
+    watchdog.start();
+    issueNext();
+    if (finished < iterations) {
+        loop.exec();
+    }
+    const qint64 elapsedNs = clock.nsecsElapsed();
+    QObject::disconnect(connection);
+
+    for (int i = finished; i < iterations; ++i) {
+        samples.addFailure();
+    }
+
+    QJsonObject result = samples.toJson(elapsedNs);
+    result["depth"] = config.depth;
+    return result;
+}
+
+
+// 动子轮询抖动：在GUI线程收到moverSnapshotReady时计时（含跨线程通知延迟），
+// 帧序号不连续说明有帧被合并，跳过该间隔并计入missedFrames
+QJsonObject measurePolling(ModbusManager& manager, const BenchConfig& config)
+{
+    QVector<qint64> intervals;
+    QElapsedTimer clock;
+    qint64 lastArrivalNs = -1;
+    quint64 lastSequence = 0;
+    quint64 missedFrames = 0;
+    int frames = 0;
+
+    const QMetaObject::Connection connection = QObject::connect(&manager, &ModbusManager::moverSnapshotReady,
+        [&]() {
+            const qint64 now = clock.nsecsElapsed();
+            const MoverSnapshotFrame& frame = manager.acquireMoverSnapshot();
+            if (frame.sequence == lastSequence) {
+                return;
+            }
+            if (lastArrivalNs >= 0) {
+                if (frame.sequence == lastSequence + 1) {
+                    intervals.append(now - lastArrivalNs);
+                } else {
+                    missedFrames += frame.sequence - lastSequence - 1;
+                }
+            }
+            lastSequence = frame.sequence;
+            lastArrivalNs = now;
+            ++frames;
+        });
+
+    clock.start();
+    manager.setMoverPolling(true, config.moverCount, config.pollIntervalMs, config.statusBase);
+
+    QEventLoop loop;
+    QTimer::singleShot(config.pollDurationMs, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    manager.setMoverPolling(false, config.moverCount, config.pollIntervalMs, config.statusBase);
+    QObject::disconnect(connection);
+
+    std::sort(intervals.begin(), intervals.end());
+    const qint64 periodNs = static_cast<qint64>(config.pollIntervalMs) * 1000000;
+    const double meanNs = LatencySamples::mean(intervals);
+    double variance = 0.0;
+    QVector<qint64> deviations;
+    deviations.reserve(intervals.size());
+    for (qint64 interval : intervals) {
+        variance += (interval - meanNs) * (interval - meanNs);
+        deviations.append(std::llabs(interval - periodNs));
+    }
+    variance = intervals.isEmpty() ? 0.0 : variance / intervals.size();
+    std::sort(deviations.begin(), deviations.end());
+
+    QJsonObject interval;
+    interval["mean"] = LatencySamples::toUs(meanNs);
+    interval["p50"] = LatencySamples::toUs(LatencySamples::percentile(intervals, 0.50));
+    interval["p99"] = LatencySamples::toUs(LatencySamples::percentile(intervals, 0.99));
+    interval["p999"] = LatencySamples::toUs(LatencySamples::percentile(intervals, 0.999));
+    interval["max"] = LatencySamples::toUs(intervals.isEmpty() ? 0 : intervals.last());
+
+    QJsonObject jitter;
+    jitter["stddev"] = LatencySamples::toUs(std::sqrt(variance));
+    jitter["p99AbsDeviation"] = LatencySamples::toUs(LatencySamples::percentile(deviations, 0.99));
+    jitter["maxAbsDeviation"] = LatencySamples::toUs(deviations.isEmpty() ? 0 : deviations.last());
+
+    QJsonObject result;
+    result["periodMs"] = config.pollIntervalMs;
+    result["moverCount"] = config.moverCount;
+    result["frames"] = frames;
+    result["missedFrames"] = static_cast<qint64>(missedFrames);
+    result["intervalUs"] = interval;
+    result["jitterUs"] = jitter;
+    return result;
+}
+
+
+bool waitForConnection(ModbusManager& manager, const BenchConfig& config, QString* errorText)
+{
+    QEventLoop loop;
+    QObject::connect(&manager, &ModbusManager::stateChanged, &loop, [&](QModbusDevice::State state) {
+        if (state == QModbusDevice::ConnectedState || state == QModbusDevice::UnconnectedState) {
+            loop.quit();
+        }
+    });
+    QObject::connect(&manager, &ModbusManager::errorOccurred, &loop, [&](const QString& error) {
+        *errorText = error;
+    });
+    QTimer::singleShot(config.timeoutMs * 2, &loop, &QEventLoop::quit);
+
+    manager.setUnitId(config.unitId);
+    if (!manager.connectToDevice(config.host, config.port)) {
+        *errorText = QStringLiteral("无法发起连接");
+        return false;
+    }
+    loop.exec();
+
+    if (manager.connectionState() == QModbusDevice::ConnectedState) {
+        return true;
+    }
+    if (errorText->isEmpty()) {
+        *errorText = manager.errorString().isEmpty() ? QStringLiteral("连接超时") : manager.errorString();
+    }
+    return false;
+}
+
+
+// 默认屏蔽每次写入成功的qDebug输出，避免终端输出拖慢测量
+bool g_verbose = false;
+
+void messageHandler(QtMsgType type, const QMessageLogContext&, const QString& message)
+{
+    if (!g_verbose && (type == QtDebugMsg || type == QtInfoMsg)) {
+        return;
+    }
+    std::fprintf(stderr, "%s\n", qPrintable(message));
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("modbusbench");
+
+    BenchConfig config;
+    QCommandLineParser parser;
+    parser.setApplicationDescription("MaglevControl ModbusManager 基准测试，结果以 JSON 输出");
+    parser.addHelpOption();
+    const QCommandLineOption hostOption("host", "PLC地址", "host", config.host);
+    const QCommandLineOption portOption("port", "Modbus TCP端口", "port", QString::number(config.port));
+    const QCommandLineOption unitOption("unit", "从站地址", "id", QString::number(config.unitId));
+    const QCommandLineOption iterationsOption("iterations", "每个接口的测量调用次数", "n", QString::number(config.iterations));
+    const QCommandLineOption warmupOption("warmup", "每个接口测量前丢弃的预热调用次数", "n", QString::number(config.warmup));
+    const QCommandLineOption depthOption("depth", "writeRegister同时在途的调用数", "n", QString::number(config.depth));
+    const QCommandLineOption moversOption("movers", "动子数量（批量读取和轮询）", "count", QString::number(config.moverCount));
+    const QCommandLineOption statusBaseOption("status-base", "动子状态块基址", "address", QString::number(config.statusBase));
+    const QCommandLineOption addressOption("address", "写测试使用的寄存器地址", "address", QString::number(config.writeAddress));
+    const QCommandLineOption pollIntervalOption("poll-interval", "动子轮询周期 (ms)", "ms", QString::number(config.pollIntervalMs));
+    const QCommandLineOption pollDurationOption("poll-duration", "动子轮询测量时长 (ms)", "ms", QString::number(config.pollDurationMs));
+    const QCommandLineOption timeoutOption("timeout", "请求超时 (ms)", "ms", QString::number(config.timeoutMs));
+    const QCommandLineOption outputOption({"o", "output"}, "结果文件，缺省输出到标准输出", "file");
+    const QCommandLineOption verboseOption("verbose", "输出ModbusManager的调试日志");
+    parser.addOptions({hostOption, portOption, unitOption, iterationsOption, warmupOption, depthOption, moversOption,
+                       statusBaseOption, addressOption, pollIntervalOption, pollDurationOption, timeoutOption, outputOption, verboseOption});
+    parser.process(app);
+
+    config.host = parser.value(hostOption);
+    config.port = parser.value(portOption).toInt();
+    config.unitId = parser.value(unitOption).toInt();
+    config.iterations = qMax(1, parser.value(iterationsOption).toInt());
+    config.warmup = qMax(0, parser.value(warmupOption).toInt());
+    config.depth = qMax(1, parser.value(depthOption).toInt());
+    config.moverCount = qBound(1, parser.value(moversOption).toInt(), MoverSnapshotFrame::MAX_MOVERS);
+    config.statusBase = parser.value(statusBaseOption).toInt(nullptr, 0);
+    config.writeAddress = parser.value(addressOption).toInt(nullptr, 0);
+    config.pollIntervalMs = qMax(1, parser.value(pollIntervalOption).toInt());
+    config.pollDurationMs = qMax(100, parser.value(pollDurationOption).toInt());
+    config.timeoutMs = qMax(100, parser.value(timeoutOption).toInt());
+    g_verbose = parser.isSet(verboseOption);
+    qInstallMessageHandler(messageHandler);
+
+    ModbusManager manager;
+    QString errorText;
+    if (!waitForConnection(manager, config, &errorText)) {
+        std::fprintf(stderr, "连接 %s:%d 失败: %s\n", qPrintable(config.host), config.port, qPrintable(errorText));
+        return 1;
+    }
+
+    const int address = config.writeAddress;
+    const int statusRegisters = config.moverCount * ModbusManager::kMoverStatusRegistersPerMover;
+    const std::function<bool(int)> writeAsync = [&](int index) {
+        return manager.writeRegister(address, static_cast<quint16>(index));
+    };
+    const std::function<bool(int)> writeSync = [&](int index) {
+        return manager.writeRegisterSync(address, static_cast<quint16>(index), config.timeoutMs);
+    };
+    // 在相邻寄存器上交替置位/清零bit0
+    const std::function<bool(int)> maskWrite = [&](int index) {
+        return manager.maskWriteRegisterSync(address + 1, 0xFFFE, static_cast<quint16>(index & 1), config.timeoutMs);
+    };
+    const std::function<bool(int)> readMovers = [&](int) {
+        QVector<quint16> values;
+        return manager.readRegistersSync(config.statusBase, statusRegisters, values, config.timeoutMs);
+    };
+
+    QJsonObject results;
+    measureAsync(manager, config, config.warmup, writeAsync);
+    results["writeRegister"] = measureAsync(manager, config, config.iterations, writeAsync);
+    measureSync(config.warmup, writeSync);
+    results["writeRegisterSync"] = measureSync(config.iterations, writeSync);
+    measureSync(config.warmup, maskWrite);
+    results["maskWriteRegisterSync"] = measureSync(config.iterations, maskWrite);
+    measureSync(config.warmup, readMovers);
+    results["readRegistersSync"] = measureSync(config.iterations, readMovers);
+
+    QJsonObject configJson;
+    configJson["iterations"] = config.iterations;
+    configJson["warmup"] = config.warmup;
+    configJson["depth"] = config.depth;
+    configJson["moverCount"] = config.moverCount;
+    configJson["statusBase"] = config.statusBase;
+    configJson["writeAddress"] = config.writeAddress;
+    configJson["pollIntervalMs"] = config.pollIntervalMs;
+    configJson["pollDurationMs"] = config.pollDurationMs;
+    configJson["timeoutMs"] = config.timeoutMs;
+
+    QJsonObject report;
+    report["benchmark"] = "MaglevControl/ModbusManager";
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["qtVersion"] = QString::fromLatin1(qVersion());
+    report["host"] = config.host;
+    report["port"] = config.port;
+    report["unitId"] = config.unitId;
+    report["maskWriteStrategy"] = manager.maskWriteStrategy() == ModbusManager::MaskWriteFc22 ? "fc22"
+                                : manager.maskWriteStrategy() == ModbusManager::MaskWriteReadModifyWrite ? "readModifyWrite"
+                                : "unknown";
+    report["config"] = configJson;
+    report["results"] = results;
+    report["scan"] = measurePolling(manager, config);
+
+    // 测量期间后台心跳的链路统计（心跳在连接后自动启动）
+    const LinkQualityMetrics& link = manager.linkQuality();
+    QJsonObject heartbeat;
+    heartbeat["intervalMs"] = link.intervalMs;
+    heartbeat["sent"] = static_cast<qint64>(link.sent);
+    heartbeat["failed"] = static_cast<qint64>(link.failed);
+    heartbeat["skipped"] = static_cast<qint64>(link.skipped);
+    heartbeat["missedDeadlines"] = static_cast<qint64>(link.missedDeadlines);
+    heartbeat["meanRttMs"] = link.meanRttMs;
+    heartbeat["maxRttMs"] = link.maxRttMs;
+    heartbeat["jitterMs"] = link.jitterMs;
+    heartbeat["maxLatenessMs"] = link.maxLatenessMs;
+    report["heartbeat"] = heartbeat;
+
+    manager.disconnectDevice();
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+            std::fprintf(stderr, "写入结果文件失败: %s\n", qPrintable(file.errorString()));
+            return 1;
+        }
+    } else {
+        std::fwrite(json.constData(), 1, json.size(), stdout);
+    }
+    return 0;
+}
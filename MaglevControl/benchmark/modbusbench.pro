@@ -0,0 +1,27 @@
+QT       += core serialbus
+QT       -= gui
+
+TARGET = modbusbench
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+# 无界面基准测试：只编译 ModbusManager 与 I/O 线程，连接本地 PlcSimulator
+INCLUDEPATH += ../include
+
+SOURCES += \
+    modbusbench.cpp \
+    ../src/modbusmanager.cpp \
+    ../src/modbusioworker.cpp \
+    ../src/heartbeatscheduler.cpp
+
+HEADERS += \
+    ../include/modbusmanager.h \
+    ../include/modbusioworker.h \
+    ../include/heartbeatscheduler.h \
+    ../include/spscqueue.h \
+    ../include/moversnapshotbuffer.h
+
+win32: {
+    msvc: QMAKE_CXXFLAGS += /utf-8
+}
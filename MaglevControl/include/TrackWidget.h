@@ -8,11 +8,15 @@
 
 #include <QWidget>
 #include <QList>
+#include <QVector>
 #include <QWheelEvent>
 #include <QShowEvent>
+#include <QPixmap>
 #include <QString>
 #include <QColor>
 
+class QPainter;
+
 // 动子数据结构
 struct MoverData {
     int id;                    // 动子ID
@@ -53,16 +57,16 @@ public:
      * 若未设置（QColor::isValid()==false），绘制时将回退到 QPalette 派生的颜色。
      */
     QColor panelBackgroundColor() const { return m_panelBackgroundColor; }
-    void setPanelBackgroundColor(const QColor& c) { m_panelBackgroundColor = c; }
+    void setPanelBackgroundColor(const QColor& c) { m_panelBackgroundColor = c; invalidateStaticLayer(); }
 
     QColor panelBorderColor() const { return m_panelBorderColor; }
-    void setPanelBorderColor(const QColor& c) { m_panelBorderColor = c; }
+    void setPanelBorderColor(const QColor& c) { m_panelBorderColor = c; invalidateStaticLayer(); }
 
     QColor panelTitleColor() const { return m_panelTitleColor; }
-    void setPanelTitleColor(const QColor& c) { m_panelTitleColor = c; }
+    void setPanelTitleColor(const QColor& c) { m_panelTitleColor = c; invalidateStaticLayer(); }
 
     QColor panelTextColor() const { return m_panelTextColor; }
-    void setPanelTextColor(const QColor& c) { m_panelTextColor = c; }
+    void setPanelTextColor(const QColor& c) { m_panelTextColor = c; invalidateStaticLayer(); }
 
 public slots: // 公共槽函数，用于从外部控制缩放
     void zoomIn();
@@ -75,10 +79,45 @@ signals:
 protected:
     void paintEvent(QPaintEvent *event) override;
     void wheelEvent(QWheelEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
     //void showEvent(QShowEvent *event) override;
 
 private:
-    QPointF getTrackPosition(double position);
+    QPointF getTrackPosition(double position) const;
+    QPointF trackCenter() const;
+    double trackScale() const;
+
+    // 静态层：网格、轨道、刻度、信息面板，缓存为位图，尺寸/缩放/主题变化时失效
+    void invalidateStaticLayer();
+    void renderStaticLayer();
+
+    // 轨道位置→屏幕坐标查找表：等距采样，线性插值
+    static constexpr int LUT_SEGMENTS = 2048;
+    void ensureTrackLut();
+    void mapTrackPositions(const double *positions, double *xs, double *ys, int count) const;
+    QPointF trackPointAt(double position) const;
+
+    // 动态层：逐帧只绘制动子及其目标指示
+    void drawMover(QPainter &painter, const MoverData &mover,
+                   const QPointF &currentPos, const QPointF &targetPos);
+    QRect moverBounds(const MoverData &mover) const;
+    QRect moverBounds(const MoverData &mover, const QPointF &currentPos, const QPointF &targetPos) const;
+    static bool moverChanged(const MoverData &a, const MoverData &b);
+
+    static constexpr double MAX_SPEED_RATIO = 2.0;     // 速度箭头长度上限（相对目标速度）
+    static constexpr double LABEL_HALF_WIDTH = 40.0;   // 动子标签的估计半宽 (px)
+    static constexpr double LABEL_HALF_HEIGHT = 14.0;  // 动子标签的估计半高 (px)
+
+    QPixmap m_staticLayer;
+    bool m_staticLayerValid = false;
+    QVector<double> m_lutX;            // 查找表样本（屏幕坐标）
+    QVector<double> m_lutY;
+    double m_lutScale = 0.0;           // 建表时的缩放比例
+    QPointF m_lutCenter;               // 建表时的轨道中心
+    QVector<double> m_paintPositions;  // 绘制时批量映射的暂存，避免逐帧分配
+    QVector<double> m_paintX;
+    QVector<double> m_paintY;
     QList<MoverData> m_movers;
     //QSize m_originalSize;
     //bool m_isInitialShow = true;
@@ -45,6 +45,9 @@ private slots:
     void onManualModeClicked();
     void onAutoModeClicked();
 
+    // I/O线程发布了新的动子快照
+    void onMoverSnapshotReady();
+
 private:
     // 16位寄存器
     uint16_t m_register;
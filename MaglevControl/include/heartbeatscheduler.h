@@ -0,0 +1,114 @@
+#ifndef HEARTBEATSCHEDULER_H
+#define HEARTBEATSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QMetaType>
+
+// 心跳链路质量统计（POD，可按值跨线程传递）
+struct LinkQualityMetrics
+{
+    static constexpr int kRttBucketCount = 10;
+    // 往返时间直方图各桶上限 (ms)，最后一桶收纳更大的值
+    static constexpr int kRttBucketUpperMs[kRttBucketCount - 1] = { 1, 2, 5, 10, 20, 50, 100, 200, 500 };
+
+    int intervalMs = 0;             // 心跳周期
+    quint64 sent = 0;               // 已发出的心跳
+    quint64 succeeded = 0;          // PLC成功应答
+    quint64 failed = 0;             // 应答错误或超时
+    quint64 skipped = 0;            // 周期到达时上一次心跳仍在途而跳过的周期
+    quint64 missedDeadlines = 0;    // 未在下一周期开始前成功完成的心跳（含跳过的周期）
+
+    double lastRttMs = 0.0;         // 最近一次成功心跳的往返时间（发出到应答）
+    double meanRttMs = 0.0;
+    double maxRttMs = 0.0;
+    double jitterMs = 0.0;          // 发出时刻相对计划时刻偏差的平滑抖动（RFC 3550算法）
+    double maxLatenessMs = 0.0;     // 发出时刻相对计划时刻的最大延迟
+    bool lastSucceeded = false;
+
+    quint32 rttHistogram[kRttBucketCount] = {};
+
+    static int bucketFor(double rttMs)
+    {
+        for (int i = 0; i < kRttBucketCount - 1; ++i) {
+            if (rttMs < kRttBucketUpperMs[i]) {
+                return i;
+            }
+        }
+        return kRttBucketCount - 1;
+    }
+
+    // 按直方图估计百分位，返回所在桶的上限（溢出桶返回最大值）
+    double rttPercentileMs(double p) const
+    {
+        if (succeeded == 0) {
+            return 0.0;
+        }
+        const double target = p * succeeded;
+        quint64 cumulative = 0;
+        for (int i = 0; i < kRttBucketCount - 1; ++i) {
+            cumulative += rttHistogram[i];
+            if (cumulative >= target) {
+                return kRttBucketUpperMs[i];
+            }
+        }
+        return maxRttMs;
+    }
+};
+
+Q_DECLARE_METATYPE(LinkQualityMetrics)
+
+/**
+ * HeartbeatScheduler
+ * 职责：运行在 I/O 线程中的心跳调度器。
+ * 按绝对截止时间排程（下一次 = 上一次计划时刻 + 周期），处理耗时不会累积成周期漂移；
+ * 线程被长时间阻塞后不补发积压的周期，只记为错过。
+ * 每个心跳的截止时间为下一周期开始前，统计往返时间直方图、发出抖动与错过的截止时间。
+ * 本类只负责计时与统计，实际发送由 ModbusIoWorker 在 heartbeatDue 中完成，
+ * 发出和完成时分别回调 markSent / markCompleted。
+ */
+class HeartbeatScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HeartbeatScheduler(QObject* parent = nullptr);
+
+    // firstDelayMs < 0 表示第一次心跳在一个周期后发出
+    void start(int intervalMs, int firstDelayMs = -1);
+    void stop();
+    bool isActive() const { return m_active; }
+    bool isInFlight() const { return m_inFlight; }
+    int intervalMs() const { return m_metrics.intervalMs; }
+
+    void markSent();
+    void markCompleted(bool success);
+
+    const LinkQualityMetrics& metrics() const { return m_metrics; }
+    void resetMetrics();
+
+signals:
+    void heartbeatDue();
+    void metricsChanged(const LinkQualityMetrics& metrics);
+
+private slots:
+    void onTimer();
+
+private:
+    qint64 nowUs() const { return m_clock.nsecsElapsed() / 1000; }
+    void arm();
+
+    QTimer* m_timer;
+    QElapsedTimer m_clock;
+    bool m_active;
+    bool m_inFlight;                // 当前心跳已排程、尚未完成
+    bool m_deadlineMissed;          // 当前心跳是否已计入错过
+    qint64 m_nextDueUs;             // 下一次心跳的计划时刻
+    qint64 m_scheduledUs;           // 当前心跳的计划时刻
+    qint64 m_sentUs;                // 当前心跳的实际发出时刻（-1表示尚未发出）
+    qint64 m_lastLatenessUs;        // 上一次心跳的发出延迟，用于抖动计算
+    LinkQualityMetrics m_metrics;
+};
+
+#endif // HEARTBEATSCHEDULER_H
@@ -0,0 +1,86 @@
+#ifndef LOGFILEWRITER_H
+#define LOGFILEWRITER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QFile>
+#include <QDate>
+#include <QString>
+#include <QByteArray>
+#include <atomic>
+
+#include "mpscqueue.h"
+
+/**
+ * LogFileWriter
+ * 职责：后台写盘线程。任意线程通过 enqueue 无锁投递已格式化的日志行，
+ * 写盘线程按字节数/时间阈值成批写入文件，并按日期和文件大小滚动。
+ * flush 是一个屏障：返回时此前投递的日志均已写入并刷新到文件。
+ */
+class LogFileWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        QString directory = "logs";
+        QString baseName = "MaglevControl";
+        qint64 maxFileBytes = 10 * 1024 * 1024;  // 单个文件上限，超过后滚动到新文件
+        int batchBytes = 64 * 1024;              // 缓冲达到该字节数立即写盘
+        int flushIntervalMs = 200;               // 缓冲最长停留时间
+        int queueCapacity = 8192;                // 待写队列容量
+    };
+
+    explicit LogFileWriter(const Options& options, QObject* parent = nullptr);
+    ~LogFileWriter() override;
+
+    // 任意线程调用，不加锁；队列满时丢弃并计数，不阻塞调用方
+    bool enqueue(QString line);
+
+    // 等待此前投递的日志全部落盘，超时返回false（用于关机与崩溃路径）
+    bool flush(int timeoutMs = 2000);
+
+    // 写完剩余日志后结束线程
+    void stop();
+
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+    QString currentFilePath() const;
+
+protected:
+    void run() override;
+
+private:
+    bool drainQueue();
+    void writeBuffer();
+    bool openFileFor(const QDate& date);
+    void rotateIfNeeded();
+    QString filePathFor(const QDate& date, int index) const;
+    void wakeWriter();
+
+    Options m_options;
+    MpscQueue<QString> m_queue;
+
+    // 写盘线程独占
+    QFile m_file;
+    QDate m_fileDate;
+    int m_fileIndex = 0;
+    QByteArray m_buffer;
+    quint64 m_bufferedLines = 0;
+
+    // 计数：投递成功、已落盘、因队列满丢弃
+    std::atomic<quint64> m_enqueued{0};
+    std::atomic<quint64> m_written{0};
+    std::atomic<quint64> m_dropped{0};
+    std::atomic<quint64> m_flushTarget{0};      // 有flush等待时需要达到的落盘计数
+    std::atomic<int> m_pendingBytes{0};         // 估算的队列积压字节，用于提前唤醒
+    std::atomic<bool> m_stopRequested{false};
+
+    // 只用于休眠/唤醒，不在投递路径上持有
+    mutable QMutex m_wakeMutex;
+    QWaitCondition m_wakeCondition;
+    QWaitCondition m_flushedCondition;
+    QString m_currentPath;
+};
+
+#endif // LOGFILEWRITER_H
@@ -4,10 +4,10 @@
 #include <QObject>
 #include <QTextEdit>
 #include <QDateTime>
-#include <QFile>
-#include <QTextStream>
-#include <QDir>
 #include <QMutex>
+#include <QSharedPointer>
+
+#include "logfilewriter.h"
 
 class LogManager : public QObject
 {
@@ -27,8 +27,11 @@ public:
     // 设置日志显示控件
     void setLogWidget(QTextEdit* logWidget);
     
-    // 启用/禁用文件日志
+    // 启用/禁用文件日志（后台线程成批写盘，按日期和大小滚动）
     void setFileLogging(bool enabled, const QString& logDir = "logs");
+
+    // 等待已记录的日志全部写入文件，用于退出和异常处理路径
+    bool flush(int timeoutMs = 2000);
     
     // 设置日志级别
     void setLogLevel(LogLevel level);
@@ -51,9 +54,8 @@ signals:
 
 private:
     QTextEdit* m_logWidget;
-    QFile* m_logFile;
-    QTextStream* m_logStream;
-    QMutex m_mutex;
+    QSharedPointer<LogFileWriter> m_fileWriter;  // flush在锁外等待时持有引用，关闭文件日志不会释放正在等待的写入器
+    QMutex m_mutex;             // 保护日志控件与文件写入器的开关
     
     bool m_fileLoggingEnabled;
     LogLevel m_currentLogLevel;
@@ -66,7 +68,6 @@ private:
     void writeToFile(const QString& formattedMessage);
     void initFileLogging();
     void closeFileLogging();
-    QString generateLogFileName() const;
 };
 
 #endif // LOGMANAGER_H
\ No newline at end of file
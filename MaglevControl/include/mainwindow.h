@@ -26,7 +26,7 @@
 
 // 引入模块
 #include "modbusmanager.h"
-// #include "logmanager.h"  // LogManager暂时不存在，先注释掉
+#include "logmanager.h"
 #include "stylemanager.h"
 #include "thememanager.h"
 #include "recipemanager.h"
@@ -58,7 +58,7 @@ private slots:
 private:
     // 核心模块
     ModbusManager* m_modbusManager;
-    // LogManager* m_logManager;  // 暂时移除LogManager
+    LogManager* m_logManager { nullptr };       // 日志文件记录，界面日志仍由LogWindow显示
     RecipeManager* m_recipeManager;
     RecipeWidget* m_recipeWidget;
     ControlPanel* m_controlPanel;
@@ -94,6 +94,12 @@ private:
 
     QModbusDevice::State previousState = QModbusDevice::UnconnectedState; // 记录上一状态
     void onModbusStateChanged(QModbusDevice::State newState);
+    void startMoverPolling();
+
+    // 状态栏：心跳链路质量
+    QLabel* m_linkQualityLabel { nullptr };
+    quint64 m_lastMissedDeadlines { 0 };
+    void onLinkQualityChanged(const LinkQualityMetrics& metrics);
 
     // 初始化方法
     void initModules();
@@ -0,0 +1,176 @@
+#ifndef MODBUSIOWORKER_H
+#define MODBUSIOWORKER_H
+
+#include <QObject>
+#include <QModbusTcpClient>
+#include <QModbusDataUnit>
+#include <QModbusReply>
+#include <QTimer>
+#include <QQueue>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QHash>
+#include <atomic>
+
+#include "spscqueue.h"
+#include "moversnapshotbuffer.h"
+#include "heartbeatscheduler.h"
+
+// GUI线程投递给I/O线程的命令
+struct ModbusCommand
+{
+    enum Type {
+        Connect,
+        Disconnect,
+        SetUnitId,
+        Read,
+        Write,
+        MaskWrite,          // 优先0x16，失败降级为读-改-写
+        StartHeartbeat,
+        StopHeartbeat,
+        ConfigureHeartbeat,
+        ConfigureMoverPoll
+    };
+
+    Type type = Read;
+    quint64 id = 0;             // 请求编号，完成时原样返回（0表示不需要回送）
+    int address = 0;
+    int count = 1;
+    QVector<quint16> values;    // Write使用
+    quint16 andMask = 0xFFFF;   // MaskWrite使用
+    quint16 orMask = 0;
+
+    QString host;               // Connect使用
+    int port = 502;
+    int unitId = 1;
+
+    int intervalMs = 0;         // 心跳/动子轮询周期
+    int registersPerMover = 0;  // 动子轮询每个动子占用的寄存器数
+    bool enabled = true;
+};
+
+/**
+ * ModbusIoWorker
+ * 职责：运行在独立线程中，独占 QModbusTcpClient、心跳定时器与动子状态轮询。
+ * 命令经 SPSC 无锁队列进入，请求结果经队列连接的信号返回；
+ * 动子状态解码后写入 MoverSnapshotBuffer，由 GUI 线程按需取最新帧。
+ * 请求在 I/O 线程内逐个发送，读-改-写降级不会与其他写操作交错。
+ * 心跳由 HeartbeatScheduler 按截止时间排程；有其他请求在途时心跳作为独立事务直接发出，
+ * 不排在配方批量写入之后。
+ * 连接建立后先以空操作的0x16探测PLC的掩码写能力，结果按“端点/从站地址”缓存，
+ * 不支持0x16的PLC此后直接走读-改-写，不再每次等待0x16失败；断线重连后重新探测。
+ * 只有非法功能码异常才确定不支持；连续超时只暂时按不支持处理，之后定期重新探测。
+ */
+class ModbusIoWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ModbusIoWorker(MoverSnapshotBuffer* snapshots, QObject* parent = nullptr);
+    ~ModbusIoWorker();
+
+    // 由GUI线程（唯一生产者）调用，队列满时返回false
+    bool submit(ModbusCommand&& command);
+
+    static constexpr int kRequestTimeoutMs = 1000;  // 单次请求超时
+    static constexpr int kMaxReadRegisters = 125;   // 单次FC03最多读取的寄存器数
+    static constexpr int kMaskTimeoutLimit = 3;         // 0x16连续超时达到该次数才按不支持处理
+    static constexpr int kMaskReprobeIntervalMs = 60000; // 因超时降级后重新探测0x16的间隔
+
+signals:
+    void stateChanged(int state, const QString& errorString);
+    void requestFinished(quint64 id, bool success, int address,
+                         const QVector<quint16>& values, const QString& errorText);
+    void moverSnapshotReady();
+    void linkQualityChanged(const LinkQualityMetrics& metrics);
+    void maskWriteStrategyChanged(int strategy);   // ModbusManager::MaskWriteStrategy
+    void maskWriteFellBack(int address, const QString& errorText);  // 单次0x16失败，改走读-改-写
+
+private slots:
+    void processCommands();
+    void onReplyFinished();
+    void onClientStateChanged(QModbusDevice::State state);
+    void onHeartbeatDue();
+    void onHeartbeatReplyFinished();
+    void onMoverPollTimeout();
+    void onMaskReprobeTimeout();
+
+private:
+    // I/O线程内部排队的请求
+    struct Request {
+        enum Kind { Read, Write, MaskWrite, Heartbeat, MoverPoll, MaskProbe };
+        enum Stage { Direct, MaskFc22, MaskRead, MaskWriteBack };
+        Kind kind = Read;
+        Stage stage = Direct;
+        quint64 id = 0;
+        int address = 0;
+        int count = 1;
+        QVector<quint16> values;
+        quint16 andMask = 0xFFFF;
+        quint16 orMask = 0;
+    };
+
+    void executeCommand(const ModbusCommand& command);
+    void ensureClient();
+    bool isConnected() const;
+
+    void enqueue(const Request& request, bool urgent = false);
+    void dispatchNext();
+    QModbusReply* sendRequest(const Request& request);
+    void processReply(QModbusReply* reply);
+    void handleReply(Request request, QModbusReply* reply);
+    void sendHeartbeatDirect(const Request& request);
+
+    // 掩码写能力缓存
+    QString capabilityKey() const;
+    int maskWriteStrategy() const;
+    void setMaskWriteStrategy(int strategy);
+    Request::Stage firstMaskStage() const;
+    void probeMaskWrite();
+    void noteMaskWriteFailure(bool illegalFunction, bool timedOut);
+    static bool isIllegalFunction(QModbusReply* reply);
+    void finishRequest(const Request& request, bool success,
+                       const QVector<quint16>& values, const QString& errorText);
+    void failAllRequests(const QString& reason);
+    QString describeError(QModbusReply* reply) const;
+
+    void publishMoverSnapshot(const QVector<quint16>& values);
+
+    SpscQueue<ModbusCommand> m_commandQueue;
+    std::atomic<bool> m_wakePending;
+    MoverSnapshotBuffer* m_snapshots;
+
+    QModbusTcpClient* m_modbusClient;
+    int m_unitId;
+    QString m_endpoint;                     // host:port
+    QHash<QString, int> m_maskStrategies;   // "host:port/unitId" -> ModbusManager::MaskWriteStrategy
+    int m_maskTimeouts;                     // 当前端点0x16连续超时次数
+    QTimer* m_maskReprobeTimer;             // 因超时降级后的重新探测
+
+    QQueue<Request> m_requestQueue;     // 等待发送的请求
+    Request m_currentRequest;           // 已发送、等待应答的请求
+    QModbusReply* m_currentReply;
+    bool m_isDispatching;
+
+    // 心跳：仅翻转 bit15，不影响其他位
+    HeartbeatScheduler* m_heartbeat;
+    int m_heartbeatRegisterAddress;
+    bool m_heartbeatToggleEnabled;
+    bool m_heartbeatToggleState;
+    int m_heartbeatIntervalMs;
+    Request m_heartbeatRequest;         // 绕过队列直接发出的心跳
+    QModbusReply* m_heartbeatReply;
+
+    // 动子状态轮询（默认关闭）
+    QTimer* m_moverPollTimer;
+    int m_moverPollAddress;
+    int m_moverPollCount;
+    int m_moverRegistersPerMover;
+    int m_moverPollOutstanding;         // 本轮尚未返回的分段读取
+    bool m_moverPollFailed;             // 本轮有分段失败或配置已变化，不发布
+    QVector<quint16> m_moverPollValues; // 按偏移拼接的整块状态寄存器
+    QElapsedTimer m_clock;
+    quint64 m_snapshotSequence;
+};
+
+#endif // MODBUSIOWORKER_H
@@ -2,17 +2,27 @@
 #define MODBUSMANAGER_H
 
 #include <QObject>
-#include <QModbusTcpClient>
+#include <QModbusDevice>
 #include <QModbusDataUnit>
-#include <QModbusReply>
+#include <QHash>
+#include <QMap>
 #include <QTimer>
 #include <QDebug>
 #include <QVariant>
-#include <QMutex>
+#include <functional>
+
+#include "moversnapshotbuffer.h"
+#include "heartbeatscheduler.h"
+
+class QThread;
+class ModbusIoWorker;
+struct ModbusCommand;
 
 /**
  * ModbusManager
  * 职责：集中管理 Modbus TCP 连接与寄存器读写；提供心跳掩码写（优先0x16，失败降级“读-改-写”）。
+ * 客户端与心跳运行在独立的 I/O 线程（ModbusIoWorker）中，本类在 GUI 线程中转发命令和结果；
+ * 同步接口在局部事件循环中等待结果，PLC应答慢或超时不会冻结界面。
  */
 class ModbusManager : public QObject
 {
@@ -33,31 +43,62 @@ public:
     QString errorString() const;
 
     // 从站地址（Unit ID）管理
-    void setUnitId(int unitId) { m_unitId = unitId; }
+    void setUnitId(int unitId);
     int unitId() const { return m_unitId; }
 
     // 寄存器读写
     bool writeRegister(int address, quint16 value);
     bool writeRegisterSync(int address, quint16 value, int timeoutMs = 5000);
     void readRegister(int address);
+
+    // 最近一次投递的请求编号；异步接口调用前后各取一次，即为该调用产生的请求范围
+    quint64 lastRequestId() const { return m_nextRequestId; }
     bool readRegisterSync(int address, quint16& value, int timeoutMs = 5000);
 
+    // 连续寄存器块读写：按单帧上限拆分后一次性投递给I/O线程，帧之间不经过GUI线程往返
+    static constexpr int kMaxWriteRegisters = 123;  // FC16单帧最多写入的寄存器数
+    static constexpr int kMaxReadRegisters = 125;   // FC03单帧最多读取的寄存器数
+    bool writeRegistersSync(int address, const QVector<quint16>& values, int timeoutMs = 5000);
+    bool writeRegisterBlocksSync(const QMap<int, QVector<quint16>>& blocks, int timeoutMs = 5000); // 起始地址 -> 数据
+    bool readRegistersSync(int address, int count, QVector<quint16>& values, int timeoutMs = 5000);
+
     // 心跳（默认2秒，可自定义）
     void startHeartbeat(int intervalMs = kHeartbeatIntervalMs);
     void stopHeartbeat();
 
     // 心跳写控制
-    void setHeartbeatRegisterAddress(int address) { m_heartbeatRegisterAddress = address; }
-    void setHeartbeatToggleEnabled(bool enabled) { m_heartbeatToggleEnabled = enabled; }
+    void setHeartbeatRegisterAddress(int address);
+    void setHeartbeatToggleEnabled(bool enabled);
+
+    // 心跳链路质量（I/O线程每次心跳结束后回送）
+    const LinkQualityMetrics& linkQuality() const { return m_linkQuality; }
+
+    // 动子状态轮询（默认关闭）：在I/O线程中周期读取状态块，结果写入快照缓冲区
+    // 默认基址100之后是系统状态块(200)，超过10个动子时PLC须把状态块放到空闲区并传入对应基址
+    static constexpr int kMoverStatusBaseAddress = 100;      // 动子状态块默认起始地址
+    static constexpr int kMoverStatusRegistersPerMover = 10; // 每个动子占用的寄存器数
+    void setMoverPolling(bool enabled, int moverCount, int intervalMs = 100,
+                         int baseAddress = kMoverStatusBaseAddress);
+
+    // 最新的动子状态快照（仅限GUI线程调用，返回的引用在下次调用前有效）
+    const MoverSnapshotFrame& acquireMoverSnapshot() { return m_moverSnapshots.acquireLatest(); }
 
     /**
      * 掩码写（0x16）同步接口，必要时自动降级为“读-改-写”。
-     * 1) 优先尝试功能码0x16；
+     * 1) 优先尝试功能码0x16（已探测到PLC不支持时跳过）；
      * 2) 若失败（无效响应/协议错误/超时等），读取当前值并按 (old & andMask) | orMask 写回；
      * 3) 仅当两条路径均失败时才触发错误信号。
      */
     bool maskWriteRegisterSync(int address, quint16 andMask, quint16 orMask, int timeoutMs = 5000);
 
+    // 掩码写策略：连接后由I/O线程探测，按端点和从站地址缓存，断线重连后重新探测
+    enum MaskWriteStrategy {
+        MaskWriteUnknown = 0,       // 尚未探测：先试0x16，失败再读-改-写
+        MaskWriteFc22,              // PLC支持功能码0x16（FC22 Mask Write Register），单帧原子完成
+        MaskWriteReadModifyWrite    // 不支持0x16：直接读-改-写，不再等待0x16失败
+    };
+    MaskWriteStrategy maskWriteStrategy() const { return m_maskWriteStrategy; }
+
 signals:
     // 连接状态变化
     void stateChanged(QModbusDevice::State newState);
@@ -65,31 +106,59 @@ signals:
     void registerDataRead(quint16 value, int address);
     // 错误信息
     void errorOccurred(const QString& errorMessage);
+    // 新的动子状态快照可用（多次发布只通知一次）
+    void moverSnapshotReady();
+    // 每个请求结束时发出（含超时后才回送的结果），用于统计往返时间
+    void requestCompleted(quint64 id, bool success);
+    // 心跳链路质量更新
+    void linkQualityChanged(const LinkQualityMetrics& metrics);
+    // 掩码写策略探测结果变化
+    void maskWriteStrategyChanged(ModbusManager::MaskWriteStrategy strategy);
+    // 单次掩码写的0x16失败，本次改走读-改-写（读-改-写的结果仍经请求应答返回）
+    void maskWriteFellBack(int address, const QString& errorText);
 
 private slots:
-    void onStateChanged(QModbusDevice::State newState);
-    void onHeartbeatTimeout();
+    void onWorkerStateChanged(int state, const QString& errorString);
+    void onWorkerLinkQualityChanged(const LinkQualityMetrics& metrics);
+    void onWorkerMaskWriteStrategyChanged(int strategy);
+    void onWorkerRequestFinished(quint64 id, bool success, int address,
+                                 const QVector<quint16>& values, const QString& errorText);
 
 private:
-    QModbusTcpClient* m_modbusClient;
-    QTimer* m_heartbeatTimer;
+    using ReplyHandler = std::function<void(bool success, const QVector<quint16>& values, const QString& errorText)>;
+
+    bool submitCommand(ModbusCommand& command);
+    bool submitRequest(ModbusCommand& command, ReplyHandler handler);
+    bool waitForRequest(ModbusCommand& command, int timeoutMs, QVector<quint16>* values, QString* errorText);
+    bool waitForRequests(QVector<ModbusCommand>& commands, int timeoutMs, QVector<quint16>* values, QString* errorText);
+    void configureHeartbeat();
+
+    // I/O线程
+    QThread* m_ioThread;
+    ModbusIoWorker* m_worker;
+    MoverSnapshotBuffer m_moverSnapshots;   // I/O线程写入、GUI线程读取的动子快照
+
+    // I/O线程回送的连接状态
+    QModbusDevice::State m_state = QModbusDevice::UnconnectedState;
+    QString m_errorString;
+    LinkQualityMetrics m_linkQuality;
+    MaskWriteStrategy m_maskWriteStrategy = MaskWriteUnknown;
+
+    // 等待I/O线程回送结果的请求
+    QHash<quint64, ReplyHandler> m_pendingRequests;
+    quint64 m_nextRequestId = 0;
+    bool m_syncWaitActive = false;          // 同步接口正在局部事件循环中等待，拒绝重入
 
     // 最近连接参数（用于重连或诊断）
     QString m_lastIP;
     int m_lastPort;
 
-    void setupHeartbeat();
-
-    // 心跳写：仅翻转 bit15，不影响其他位
+    // 心跳写：仅翻转 bit15，不影响其他位（在I/O线程中执行）
     int m_heartbeatRegisterAddress = kHeartbeatRegisterAddress;
-    bool m_heartbeatToggleEnabled = true; // 启用bit15翻转心跳（已添加互斥锁保护）
-    bool m_heartbeatToggleState = false;  // false->写0x0000, true->写0x8000
+    bool m_heartbeatToggleEnabled = true; // 启用bit15翻转心跳
 
     // Modbus TCP 从站地址（Unit ID），默认1
     int m_unitId = 1;
-    
-    // 寄存器访问互斥锁（防止心跳与控制操作冲突）
-    QMutex m_registerMutex;
 };
 
 #endif // MODBUSMANAGER_H
@@ -0,0 +1,93 @@
+#ifndef MOVERSNAPSHOTBUFFER_H
+#define MOVERSNAPSHOTBUFFER_H
+
+#include <QtGlobal>
+#include <atomic>
+
+// 单个动子的状态快照（POD，可在线程间按值复制）
+struct MoverSnapshot
+{
+    int id = 0;
+    double position = 0.0;      // 位置 (mm)
+    double speed = 0.0;         // 速度 (mm/s)
+    double target = 0.0;        // 目标位置 (mm)
+    quint16 statusWord = 0;     // PLC状态字
+    quint16 errorCode = 0;      // PLC错误码
+    qint64 timestampMs = 0;     // 采样时间（单调时钟，毫秒）
+};
+
+// 一次完整扫描得到的所有动子快照
+struct MoverSnapshotFrame
+{
+    static constexpr int MAX_MOVERS = 128;
+
+    quint64 sequence = 0;       // 帧序号，每次发布递增
+    qint64 timestampMs = 0;     // 采样时间（单调时钟，毫秒）
+    int count = 0;              // 有效动子数量
+    MoverSnapshot movers[MAX_MOVERS];
+};
+
+/**
+ * MoverSnapshotBuffer
+ * 职责：动子快照三缓冲区。
+ * I/O线程写入后台帧并发布，GUI线程读取最新帧，两端均不加锁、不阻塞：
+ * 写端永远不会等待读端，读端拿到的帧在下一次acquireLatest之前保持不变。
+ * 只允许一个写线程和一个读线程。
+ */
+class MoverSnapshotBuffer
+{
+public:
+    MoverSnapshotBuffer()
+        : m_middle(1)
+        , m_back(0)
+        , m_front(2)
+        , m_notifyPending(false)
+    {
+    }
+
+    MoverSnapshotBuffer(const MoverSnapshotBuffer &) = delete;
+    MoverSnapshotBuffer &operator=(const MoverSnapshotBuffer &) = delete;
+
+    // --- 写线程接口 ---
+    MoverSnapshotFrame &writeFrame() { return m_frames[m_back]; }
+
+    void publish()
+    {
+        const int previous = m_middle.exchange(m_back | DIRTY_FLAG, std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+
+    // 返回true表示读端尚未被通知，需要发出一次通知（多次发布只通知一次）
+    bool requestNotify()
+    {
+        return !m_notifyPending.exchange(true, std::memory_order_acq_rel);
+    }
+
+    // --- 读线程接口 ---
+    bool hasNewFrame() const
+    {
+        return (m_middle.load(std::memory_order_acquire) & DIRTY_FLAG) != 0;
+    }
+
+    const MoverSnapshotFrame &acquireLatest()
+    {
+        m_notifyPending.store(false, std::memory_order_release);
+        if (hasNewFrame()) {
+            const int previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+            m_front = previous & INDEX_MASK;
+        }
+        return m_frames[m_front];
+    }
+
+private:
+    static constexpr int INDEX_MASK = 0x3;
+    static constexpr int DIRTY_FLAG = 0x4;
+
+    MoverSnapshotFrame m_frames[3];
+    std::atomic<int> m_middle;          // 中间帧索引 | 是否有未读新帧
+    int m_back;                         // 写线程私有
+    int m_front;                        // 读线程私有
+    std::atomic<bool> m_notifyPending;
+};
+
+#endif // MOVERSNAPSHOTBUFFER_H
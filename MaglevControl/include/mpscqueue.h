@@ -0,0 +1,99 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * MpscQueue
+ * 职责：多生产者单消费者有界无锁队列（任意线程写日志，后台写盘线程取出）。
+ * 每个槽位带序号：生产者用CAS抢占写入位置，写完后发布序号；消费者按序号判断槽位是否就绪。
+ * 容量向上取整为2的幂，队列满时tryPush返回false，由调用方决定丢弃或降级。
+ * tryPop只允许一个线程调用。
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+    explicit MpscQueue(std::size_t capacity = 4096)
+        : m_mask(roundUpPowerOfTwo(capacity) - 1)
+        , m_cells(new Cell[m_mask + 1])
+        , m_enqueuePos(0)
+        , m_dequeuePos(0)
+    {
+        for (std::size_t i = 0; i <= m_mask; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    // 任意生产者线程调用
+    bool tryPush(T &&item)
+    {
+        Cell *cell = nullptr;
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                // 槽位空闲，尝试占用
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // 队列已满
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed); // 被其他生产者抢先
+            }
+        }
+        cell->data = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者线程调用
+    bool tryPop(T &item)
+    {
+        const std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell &cell = m_cells[pos & m_mask];
+        const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1) < 0) {
+            return false; // 队列为空，或生产者尚未写完
+        }
+        item = std::move(cell.data);
+        cell.data = T(); // 及时释放元素持有的资源
+        cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    std::size_t capacity() const { return m_mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+    static std::size_t roundUpPowerOfTwo(std::size_t value)
+    {
+        std::size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const std::size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    alignas(64) std::atomic<std::size_t> m_enqueuePos;  // 生产者共享的写入位置
+    alignas(64) std::atomic<std::size_t> m_dequeuePos;  // 消费者读取位置
+};
+
+#endif // MPSCQUEUE_H
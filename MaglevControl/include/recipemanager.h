@@ -173,9 +173,29 @@ signals:
     // Modbus地址计算
     int getStationBaseAddr(int stationIndex) const;
     
+    // 寄存器映像编码：工位总数[35]紧邻配方基址[36]，整张配方表是一段连续寄存器
+    QVector<quint16> encodeStation(const StationRecipe& recipe) const;
+    QVector<quint16> encodeRecipeImage(const QVector<StationRecipe>& stations) const;
+    
     // Modbus写入方法
     bool writeStationToModbus(int stationIndex, const StationRecipe& recipe);
-    bool writeStationCountToModbus(int stationCount);
+    bool writeRecipeImageToModbus(const QVector<StationRecipe>& stations);
+    bool verifyRegisters(int address, const QVector<quint16>& expected);
+    
+    // 增量下发：与设备寄存器映像比较，只写变化的寄存器区间
+    struct RegisterRange {
+        int offset;     // 相对STATION_COUNT_ADDR的偏移
+        int count;
+    };
+    static const int MERGE_GAP = 2;  // 间隔不超过该值的变化区间合并为一次写入（间隔内为已知值，重写无副作用）
+    QVector<RegisterRange> diffRegisterImage(const QVector<quint16>& current, const QVector<quint16>& target) const;
+    bool loadDeviceImage(int registerCount);
+    void invalidateDeviceImage();
+    bool checkDeviceIdle();
+    
+    QVector<quint16> m_deviceImage;   // 设备寄存器映像（从STATION_COUNT_ADDR开始），回读或上次下发后缓存
+    bool m_deviceImageValid = false;
+    bool m_deviceTransferActive = false;  // 同步下发进行中，拒绝重入的保存/应用请求
 };
 
 #endif // RECIPEMANAGER_H
@@ -5,6 +5,26 @@
 #include <QLabel>
 #include <QMessageBox>
 
+namespace {
+// 动子状态字：位0使能、位1运行中、位2到位、位3错误、位4紧急停止
+QString moverStatusText(quint16 statusWord)
+{
+    if (statusWord & 0x0010) {
+        return QStringLiteral("紧急停止");
+    }
+    if (statusWord & 0x0008) {
+        return QStringLiteral("错误");
+    }
+    if (!(statusWord & 0x0001)) {
+        return QStringLiteral("禁用");
+    }
+    if (statusWord & 0x0002) {
+        return QStringLiteral("运行中");
+    }
+    return (statusWord & 0x0004) ? QStringLiteral("停止") : QStringLiteral("就绪");
+}
+} // namespace
+
 ControlPanel::ControlPanel(QWidget *parent)
     : QWidget(parent),
       m_register(0),
@@ -195,6 +215,26 @@ void ControlPanel::updateButtonStates()
 void ControlPanel::setModbusManager(ModbusManager* modbusManager)
 {
     m_modbusManager = modbusManager;
+    if (m_modbusManager) {
+        connect(m_modbusManager, &ModbusManager::moverSnapshotReady,
+                this, &ControlPanel::onMoverSnapshotReady, Qt::UniqueConnection);
+    }
+}
+
+// 取最新一帧动子快照刷新轨道视图（快照已在I/O线程中解码）
+void ControlPanel::onMoverSnapshotReady()
+{
+    if (!m_modbusManager) return;
+
+    const MoverSnapshotFrame& frame = m_modbusManager->acquireMoverSnapshot();
+    QList<MoverData> movers;
+    movers.reserve(frame.count);
+    for (int i = 0; i < frame.count; ++i) {
+        const MoverSnapshot& snapshot = frame.movers[i];
+        movers.append(MoverData(snapshot.id, snapshot.position, snapshot.target,
+                                moverStatusText(snapshot.statusWord), false, snapshot.speed));
+    }
+    m_trackWidget->updateMovers(movers);
 }
 
 // 更新连接状态
@@ -0,0 +1,148 @@
+#include "heartbeatscheduler.h"
+#include <cstdlib>
+
+HeartbeatScheduler::HeartbeatScheduler(QObject* parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_active(false)
+    , m_inFlight(false)
+    , m_deadlineMissed(false)
+    , m_nextDueUs(0)
+    , m_scheduledUs(0)
+    , m_sentUs(-1)
+    , m_lastLatenessUs(-1)
+{
+    // 单次定时器逐次对准绝对截止时间；PreciseTimer避免粗精度定时器带来的数毫秒偏差
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &HeartbeatScheduler::onTimer);
+    m_clock.start();
+}
+
+
+void HeartbeatScheduler::start(int intervalMs, int firstDelayMs)
+{
+    m_metrics.intervalMs = qMax(1, intervalMs);
+    m_active = true;
+    m_inFlight = false;
+    m_lastLatenessUs = -1;
+    m_nextDueUs = nowUs() + qint64(firstDelayMs < 0 ? m_metrics.intervalMs : firstDelayMs) * 1000;
+    arm();
+}
+
+
+void HeartbeatScheduler::stop()
+{
+    m_active = false;
+    m_inFlight = false;
+    m_timer->stop();
+}
+
+
+void HeartbeatScheduler::resetMetrics()
+{
+    const int intervalMs = m_metrics.intervalMs;
+    m_metrics = LinkQualityMetrics();
+    m_metrics.intervalMs = intervalMs;
+    m_lastLatenessUs = -1;
+    emit metricsChanged(m_metrics);
+}
+
+
+void HeartbeatScheduler::arm()
+{
+    const qint64 remainingUs = m_nextDueUs - nowUs();
+    m_timer->start(int(qMax<qint64>(0, (remainingUs + 999) / 1000)));
+}
+
+
+void HeartbeatScheduler::onTimer()
+{
+    if (!m_active) {
+        return;
+    }
+
+    const qint64 now = nowUs();
+    const qint64 intervalUs = qint64(m_metrics.intervalMs) * 1000;
+    const qint64 dueUs = m_nextDueUs;
+    m_nextDueUs += intervalUs;
+
+    bool changed = false;
+    // 线程被阻塞超过一个周期：不补发积压的心跳，只记为错过
+    while (m_nextDueUs <= now) {
+        m_nextDueUs += intervalUs;
+        ++m_metrics.skipped;
+        ++m_metrics.missedDeadlines;
+        changed = true;
+    }
+
+    if (m_inFlight) {
+        // 上一次心跳到下一周期仍未完成：截止时间已过，本周期跳过
+        if (!m_deadlineMissed) {
+            m_deadlineMissed = true;
+            ++m_metrics.missedDeadlines;
+        }
+        ++m_metrics.skipped;
+        emit metricsChanged(m_metrics);
+    } else {
+        if (changed) {
+            emit metricsChanged(m_metrics);
+        }
+        m_inFlight = true;
+        m_deadlineMissed = false;
+        m_scheduledUs = dueUs;
+        m_sentUs = -1;
+        emit heartbeatDue();
+    }
+
+    if (m_active) {
+        arm();
+    }
+}
+
+
+void HeartbeatScheduler::markSent()
+{
+    if (!m_inFlight || m_sentUs >= 0) {
+        return;
+    }
+    m_sentUs = nowUs();
+    ++m_metrics.sent;
+
+    const qint64 latenessUs = m_sentUs - m_scheduledUs;
+    m_metrics.maxLatenessMs = qMax(m_metrics.maxLatenessMs, latenessUs / 1000.0);
+    if (m_lastLatenessUs >= 0) {
+        const double deltaMs = std::llabs(latenessUs - m_lastLatenessUs) / 1000.0;
+        m_metrics.jitterMs += (deltaMs - m_metrics.jitterMs) / 16.0;
+    }
+    m_lastLatenessUs = latenessUs;
+}
+
+
+void HeartbeatScheduler::markCompleted(bool success)
+{
+    if (!m_inFlight) {
+        return;
+    }
+    m_inFlight = false;
+
+    const qint64 now = nowUs();
+    m_metrics.lastSucceeded = success;
+    if (success) {
+        const double rttMs = (now - (m_sentUs >= 0 ? m_sentUs : m_scheduledUs)) / 1000.0;
+        ++m_metrics.succeeded;
+        m_metrics.lastRttMs = rttMs;
+        m_metrics.meanRttMs += (rttMs - m_metrics.meanRttMs) / m_metrics.succeeded;
+        m_metrics.maxRttMs = qMax(m_metrics.maxRttMs, rttMs);
+        ++m_metrics.rttHistogram[LinkQualityMetrics::bucketFor(rttMs)];
+    } else {
+        ++m_metrics.failed;
+    }
+
+    const bool late = now > m_scheduledUs + qint64(m_metrics.intervalMs) * 1000;
+    if ((!success || late) && !m_deadlineMissed) {
+        m_deadlineMissed = true;
+        ++m_metrics.missedDeadlines;
+    }
+    emit metricsChanged(m_metrics);
+}
@@ -0,0 +1,215 @@
+#include "logfilewriter.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QDeadlineTimer>
+#include <QMutexLocker>
+
+LogFileWriter::LogFileWriter(const Options& options, QObject* parent)
+    : QThread(parent)
+    , m_options(options)
+    , m_queue(static_cast<std::size_t>(qMax(2, options.queueCapacity)))
+{
+    m_buffer.reserve(m_options.batchBytes * 2);
+}
+
+LogFileWriter::~LogFileWriter()
+{
+    stop();
+}
+
+bool LogFileWriter::enqueue(QString line)
+{
+    const int bytes = static_cast<int>(line.size()) + 1;
+    if (!m_queue.tryPush(std::move(line))) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    m_enqueued.fetch_add(1, std::memory_order_release);
+
+    // 积压达到批量阈值时提前唤醒写盘线程，否则由定时写盘处理
+    if (m_pendingBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes >= m_options.batchBytes) {
+        m_pendingBytes.store(0, std::memory_order_relaxed);
+        wakeWriter();
+    }
+    return true;
+}
+
+bool LogFileWriter::flush(int timeoutMs)
+{
+    const quint64 target = m_enqueued.load(std::memory_order_acquire);
+    if (!isRunning()) {
+        return m_written.load(std::memory_order_acquire) >= target;
+    }
+
+    QDeadlineTimer deadline(timeoutMs);
+    QMutexLocker locker(&m_wakeMutex);
+
+    // 登记需要达到的落盘计数，写盘线程看到后立即写盘
+    quint64 current = m_flushTarget.load(std::memory_order_relaxed);
+    while (current < target
+           && !m_flushTarget.compare_exchange_weak(current, target, std::memory_order_release)) {
+    }
+    m_wakeCondition.wakeOne();
+
+    while (m_written.load(std::memory_order_acquire) < target) {
+        if (!m_flushedCondition.wait(&m_wakeMutex, deadline)) {
+            return m_written.load(std::memory_order_acquire) >= target;
+        }
+    }
+    return true;
+}
+
+void LogFileWriter::stop()
+{
+    if (!isRunning()) {
+        return;
+    }
+    m_stopRequested.store(true, std::memory_order_release);
+    wakeWriter();
+    wait();
+}
+
+QString LogFileWriter::currentFilePath() const
+{
+    QMutexLocker locker(&m_wakeMutex);
+    return m_currentPath;
+}
+
+void LogFileWriter::run()
+{
+    QElapsedTimer bufferAge;    // 缓冲中最早一行的停留时间
+
+    for (;;) {
+        const bool stopping = m_stopRequested.load(std::memory_order_acquire);
+
+        const bool wasEmpty = m_buffer.isEmpty();
+        if (drainQueue() && wasEmpty) {
+            bufferAge.start();
+        }
+
+        const bool flushRequested = m_flushTarget.load(std::memory_order_acquire)
+                                    > m_written.load(std::memory_order_relaxed);
+        if (!m_buffer.isEmpty()
+            && (stopping || flushRequested
+                || m_buffer.size() >= m_options.batchBytes
+                || bufferAge.elapsed() >= m_options.flushIntervalMs)) {
+            writeBuffer();
+        }
+
+        if (stopping) {
+            break;
+        }
+
+        // 有缓冲时最多等到它超时，否则等一个完整周期；唤醒丢失时也不会超过该周期
+        int waitMs = m_options.flushIntervalMs;
+        if (!m_buffer.isEmpty()) {
+            waitMs = qMax(1, m_options.flushIntervalMs - static_cast<int>(bufferAge.elapsed()));
+        }
+
+        QMutexLocker locker(&m_wakeMutex);
+        if (!m_stopRequested.load(std::memory_order_acquire)
+            && m_flushTarget.load(std::memory_order_acquire) <= m_written.load(std::memory_order_relaxed)) {
+            m_wakeCondition.wait(&m_wakeMutex, static_cast<unsigned long>(waitMs));
+        }
+    }
+
+    m_file.close();
+}
+
+bool LogFileWriter::drainQueue()
+{
+    bool drained = false;
+    QString line;
+    while (m_queue.tryPop(line)) {
+        m_buffer += line.toUtf8();
+        m_buffer += '\n';
+        ++m_bufferedLines;
+        drained = true;
+
+        // 日志风暴时不让缓冲无限增长
+        if (m_buffer.size() >= m_options.batchBytes * 2) {
+            writeBuffer();
+        }
+    }
+    m_pendingBytes.store(0, std::memory_order_relaxed);
+    return drained;
+}
+
+void LogFileWriter::writeBuffer()
+{
+    if (m_buffer.isEmpty()) {
+        return;
+    }
+
+    rotateIfNeeded();
+    if (m_file.isOpen()) {
+        m_file.write(m_buffer);
+        m_file.flush();
+    }
+    // 文件无法打开时这批日志被丢弃，但仍计入已处理，避免flush一直等待
+    m_buffer.clear();
+    m_written.fetch_add(m_bufferedLines, std::memory_order_release);
+    m_bufferedLines = 0;
+
+    QMutexLocker locker(&m_wakeMutex);
+    m_flushedCondition.wakeAll();
+}
+
+void LogFileWriter::rotateIfNeeded()
+{
+    const QDate today = QDate::currentDate();
+    if (!m_file.isOpen() || today != m_fileDate) {
+        // 跨天：换到新日期的文件
+        openFileFor(today);
+        return;
+    }
+
+    if (m_file.size() > 0 && m_file.size() + m_buffer.size() > m_options.maxFileBytes) {
+        // 超过大小上限：换到同一天的下一个序号
+        ++m_fileIndex;
+        openFileFor(today);
+    }
+}
+
+bool LogFileWriter::openFileFor(const QDate& date)
+{
+    m_file.close();
+    if (date != m_fileDate) {
+        m_fileIndex = 0;
+    }
+    m_fileDate = date;
+
+    QDir dir;
+    if (!dir.exists(m_options.directory)) {
+        dir.mkpath(m_options.directory);
+    }
+
+    // 重启后接着写当天未写满的文件
+    QString path = filePathFor(date, m_fileIndex);
+    while (QFileInfo(path).size() >= m_options.maxFileBytes) {
+        path = filePathFor(date, ++m_fileIndex);
+    }
+
+    m_file.setFileName(path);
+    const bool opened = m_file.open(QIODevice::WriteOnly | QIODevice::Append);
+
+    QMutexLocker locker(&m_wakeMutex);
+    m_currentPath = opened ? path : QString();
+    return opened;
+}
+
+QString LogFileWriter::filePathFor(const QDate& date, int index) const
+{
+    QString fileName = QString("%1_%2").arg(m_options.baseName, date.toString("yyyy-MM-dd"));
+    if (index > 0) {
+        fileName += QString("_%1").arg(index);
+    }
+    return QDir(m_options.directory).filePath(fileName + ".log");
+}
+
+void LogFileWriter::wakeWriter()
+{
+    QMutexLocker locker(&m_wakeMutex);
+    m_wakeCondition.wakeOne();
+}
@@ -6,8 +6,6 @@
 LogManager::LogManager(QObject *parent)
     : QObject(parent)
     , m_logWidget(nullptr)
-    , m_logFile(nullptr)
-    , m_logStream(nullptr)
     , m_fileLoggingEnabled(false)
     , m_currentLogLevel(Info)
     , m_logDirectory("logs")
@@ -48,6 +46,17 @@ void LogManager::setFileLogging(bool enabled, const QString& logDir)
     }
 }
 
+bool LogManager::flush(int timeoutMs)
+{
+    // 只在锁内取写入器；等待落盘期间不持锁，其他线程照常记录日志
+    QSharedPointer<LogFileWriter> writer;
+    {
+        QMutexLocker locker(&m_mutex);
+        writer = m_fileWriter;
+    }
+    return writer ? writer->flush(timeoutMs) : true;
+}
+
 void LogManager::setLogLevel(LogLevel level)
 {
     m_currentLogLevel = level;
@@ -80,14 +89,14 @@ void LogManager::log(LogLevel level, const QString& message)
         return;
     }
     
-    QMutexLocker locker(&m_mutex);
-    
     QString formattedMessage = formatMessage(level, message);
-    
+
+    QMutexLocker locker(&m_mutex);
+
     // 写入UI控件
     writeToWidget(formattedMessage, level);
-    
-    // 写入文件
+
+    // 写入文件：只投递到后台队列，不在调用线程上做磁盘I/O
     if (m_fileLoggingEnabled) {
         writeToFile(formattedMessage);
     }
@@ -169,64 +178,40 @@ void LogManager::writeToWidget(const QString& formattedMessage, LogLevel level)
 
 void LogManager::writeToFile(const QString& formattedMessage)
 {
-    if (!m_logStream || !m_logFile || !m_logFile->isOpen()) {
-        return;
+    if (m_fileWriter) {
+        m_fileWriter->enqueue(formattedMessage);
     }
-    
-    *m_logStream << formattedMessage << Qt::endl;
-    m_logStream->flush();
 }
 
 void LogManager::initFileLogging()
 {
-    // 创建日志目录
-    QDir dir;
-    if (!dir.exists(m_logDirectory)) {
-        dir.mkpath(m_logDirectory);
-    }
-    
-    // 关闭现有文件
+    // 关闭现有写入器
     closeFileLogging();
-    
-    // 生成日志文件名
-    QString fileName = generateLogFileName();
-    QString fullPath = QDir(m_logDirectory).filePath(fileName);
-    
-    // 创建新的日志文件
-    m_logFile = new QFile(fullPath, this);
-    if (m_logFile->open(QIODevice::WriteOnly | QIODevice::Append)) {
-        m_logStream = new QTextStream(m_logFile);
-        m_logStream->setEncoding(QStringConverter::Utf8);
-        
-        // 写入启动信息
-        QString startMessage = formatMessage(Info, "=== 日志记录开始 ===");
-        writeToFile(startMessage);
-    } else {
-        delete m_logFile;
-        m_logFile = nullptr;
-        m_fileLoggingEnabled = false;
-    }
+
+    LogFileWriter::Options options;
+    options.directory = m_logDirectory;
+    options.baseName = "MaglevControl";
+
+    m_fileWriter.reset(new LogFileWriter(options));
+    m_fileWriter->start(QThread::LowPriority);
+
+    // 写入启动信息
+    writeToFile(formatMessage(Info, "=== 日志记录开始 ==="));
 }
 
 void LogManager::closeFileLogging()
 {
-    if (m_logStream) {
-        QString endMessage = formatMessage(Info, "=== 日志记录结束 ===");
-        writeToFile(endMessage);
-        
-        delete m_logStream;
-        m_logStream = nullptr;
+    if (!m_fileWriter) {
+        return;
     }
-    
-    if (m_logFile) {
-        m_logFile->close();
-        delete m_logFile;
-        m_logFile = nullptr;
+
+    writeToFile(formatMessage(Info, "=== 日志记录结束 ==="));
+    const quint64 dropped = m_fileWriter->droppedCount();
+    if (dropped > 0) {
+        writeToFile(formatMessage(Warning, QString("写盘队列已满，丢弃日志 %1 条").arg(dropped)));
     }
-}
 
-QString LogManager::generateLogFileName() const
-{
-    QString dateStr = QDateTime::currentDateTime().toString("yyyy-MM-dd");
-    return QString("MaglevControl_%1.log").arg(dateStr);
-}
\ No newline at end of file
+    // stop会先写完队列中剩余的日志
+    m_fileWriter->stop();
+    m_fileWriter.reset();
+}
@@ -11,6 +11,25 @@
 #include <QStyle>
 #include <QSettings>
 #include <QDateTime>
+#include <QStatusBar>
+#include <QCoreApplication>
+
+namespace {
+// qFatal在abort之前经由消息处理器，借此把已记录的日志写入文件
+LogManager* g_crashLogManager = nullptr;
+QtMessageHandler g_previousMessageHandler = nullptr;
+
+void crashFlushMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message)
+{
+    if (type == QtFatalMsg && g_crashLogManager) {
+        g_crashLogManager->logError("程序异常终止: " + message);
+        g_crashLogManager->flush(500);
+    }
+    if (g_previousMessageHandler) {
+        g_previousMessageHandler(type, context, message);
+    }
+}
+} // namespace
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -46,13 +65,24 @@ MainWindow::~MainWindow()
     if (m_modbusManager) {
         m_modbusManager->disconnectDevice();
     }
+    if (m_logManager) {
+        qInstallMessageHandler(g_previousMessageHandler);
+        g_crashLogManager = nullptr;
+        m_logManager->logInfo("程序退出");
+        m_logManager->flush();
+    }
 }
 
 void MainWindow::initModules()
 {
     // 创建核心模块
     m_modbusManager = new ModbusManager(this);
-    // 日志由面板管理
+
+    // 界面日志由LogWindow显示，LogManager只负责写入日志文件
+    m_logManager = new LogManager(this);
+    m_logManager->setFileLogging(true, QCoreApplication::applicationDirPath() + "/logs");
+    g_crashLogManager = m_logManager;
+    g_previousMessageHandler = qInstallMessageHandler(crashFlushMessageHandler);
     m_recipeManager = new RecipeManager(m_modbusManager, this);
     m_recipeWidget = new RecipeWidget(m_recipeManager, this);
     
@@ -74,6 +104,24 @@ void MainWindow::connectSignals()
     // 连接Modbus管理器错误信号
     connect(m_modbusManager, &ModbusManager::errorOccurred,
             this, &MainWindow::onModbusError);
+
+    // 心跳链路质量显示在状态栏
+    connect(m_modbusManager, &ModbusManager::linkQualityChanged,
+            this, &MainWindow::onLinkQualityChanged);
+
+    connect(m_modbusManager, &ModbusManager::maskWriteStrategyChanged,
+            this, [this](ModbusManager::MaskWriteStrategy strategy) {
+                if (strategy == ModbusManager::MaskWriteFc22) {
+                    appendLog("[INFO] PLC支持掩码写(0x16)，心跳与位操作单帧完成");
+                } else if (strategy == ModbusManager::MaskWriteReadModifyWrite) {
+                    appendLog("[INFO] PLC不支持掩码写(0x16)，心跳与位操作改用读-改-写");
+                }
+            });
+    connect(m_modbusManager, &ModbusManager::maskWriteFellBack,
+            this, [this](int address, const QString& errorText) {
+                appendLog(QString("[WARN] 寄存器0x%1掩码写(0x16)失败，改用读-改-写: %2")
+                              .arg(address, 4, 16, QChar('0')).arg(errorText));
+            });
     
     // 连接配方管理器错误信号（状态信息通过RecipeWidget统一发送）
     connect(m_recipeManager, &RecipeManager::errorOccurred,
@@ -178,6 +226,10 @@ void MainWindow::initUI()
     
     // 延迟初始化日志窗口（在主窗口显示后）
     m_logWindow = nullptr;
+
+    // 状态栏：心跳链路质量
+    m_linkQualityLabel = new QLabel(QStringLiteral("心跳：--"), this);
+    statusBar()->addPermanentWidget(m_linkQualityLabel);
     
     // 初始化闪烁定时器
     m_blinkTimer = new QTimer(this);
@@ -269,6 +321,8 @@ void MainWindow::onModbusStateChanged(QModbusDevice::State newState)
             buttonText = "连接";
             appendLog("[INFO] Modbus连接已断开");
             m_controlPanel->updateConnectionState(false);
+            m_linkQualityLabel->setText(QStringLiteral("心跳：--"));
+            m_linkQualityLabel->setStyleSheet(QString());
             break;
         case QModbusDevice::ConnectingState:
             statusText = "状态：连接中...";
@@ -282,6 +336,7 @@ void MainWindow::onModbusStateChanged(QModbusDevice::State newState)
             buttonText = "断开";
             appendLog(QString("[SUCCESS] 成功连接到 %1:%2").arg(ipLineEdit->text()).arg(portSpinBox->value()));
             m_controlPanel->updateConnectionState(true);
+            startMoverPolling();
             break;
         case QModbusDevice::ClosingState:
             statusText = "状态：断开中...";
@@ -296,6 +351,74 @@ void MainWindow::onModbusStateChanged(QModbusDevice::State newState)
     previousState = newState;
 }
 
+void MainWindow::onLinkQualityChanged(const LinkQualityMetrics& metrics)
+{
+    if (previousState != QModbusDevice::ConnectedState) {
+        return;
+    }
+    if (metrics.sent == 0 && metrics.skipped == 0) {
+        // 新连接的统计刚清零
+        m_lastMissedDeadlines = 0;
+        m_linkQualityLabel->setText(QStringLiteral("心跳：等待首次应答"));
+        m_linkQualityLabel->setStyleSheet(QString());
+        return;
+    }
+
+    m_linkQualityLabel->setText(QString("心跳 RTT %1 ms (p99≤%2 ms) | 抖动 %3 ms | 错过 %4/%5")
+                                .arg(metrics.lastRttMs, 0, 'f', 1)
+                                .arg(metrics.rttPercentileMs(0.99), 0, 'f', 0)
+                                .arg(metrics.jitterMs, 0, 'f', 1)
+                                .arg(metrics.missedDeadlines)
+                                .arg(metrics.sent + metrics.skipped));
+
+    // 本次心跳错过截止时间为红色；往返时间超过周期的1/4为橙色
+    QString color = "#4caf50";
+    if (metrics.missedDeadlines > m_lastMissedDeadlines || !metrics.lastSucceeded) {
+        color = "#f44336";
+    } else if (metrics.lastRttMs > metrics.intervalMs / 4.0) {
+        color = "#ff9800";
+    }
+    m_lastMissedDeadlines = metrics.missedDeadlines;
+    m_linkQualityLabel->setStyleSheet(QString("color: %1;").arg(color));
+
+    QStringList histogram;
+    for (int i = 0; i < LinkQualityMetrics::kRttBucketCount; ++i) {
+        const QString range = i < LinkQualityMetrics::kRttBucketCount - 1
+                ? QString("<%1 ms").arg(LinkQualityMetrics::kRttBucketUpperMs[i])
+                : QString("≥%1 ms").arg(LinkQualityMetrics::kRttBucketUpperMs[i - 1]);
+        histogram << QString("%1: %2").arg(range, -8).arg(metrics.rttHistogram[i]);
+    }
+    m_linkQualityLabel->setToolTip(QString("周期 %1 ms，发出 %2，成功 %3，失败 %4，跳过 %5\n"
+                                           "RTT 平均 %6 ms，最大 %7 ms；发出最大延迟 %8 ms\n\n%9")
+                                   .arg(metrics.intervalMs).arg(metrics.sent).arg(metrics.succeeded)
+                                   .arg(metrics.failed).arg(metrics.skipped)
+                                   .arg(metrics.meanRttMs, 0, 'f', 1).arg(metrics.maxRttMs, 0, 'f', 1)
+                                   .arg(metrics.maxLatenessMs, 0, 'f', 1)
+                                   .arg(histogram.join('\n')));
+}
+
+/**
+ * 连接后开启动子状态轮询（断开时I/O线程自行停止）。
+ * 动子数量、周期和状态块基址取自设置项 MoverPolling 组，默认10个动子、100ms、基址100；
+ * 动子数量为0时不轮询。
+ */
+void MainWindow::startMoverPolling()
+{
+    QSettings settings;
+    settings.beginGroup("MoverPolling");
+    const int moverCount = settings.value("moverCount", 10).toInt();
+    const int intervalMs = settings.value("intervalMs", 100).toInt();
+    const int baseAddress = settings.value("baseAddress", ModbusManager::kMoverStatusBaseAddress).toInt();
+    settings.endGroup();
+
+    if (moverCount <= 0) {
+        return;
+    }
+    m_modbusManager->setMoverPolling(true, moverCount, intervalMs, baseAddress);
+    appendLog(QString("[INFO] 动子状态轮询: %1个动子, 周期%2ms, 基址%3")
+                  .arg(moverCount).arg(intervalMs).arg(baseAddress));
+}
+
 void MainWindow::onModbusError(const QString& error)
 {
     appendLog("[ERROR] " + error);
@@ -355,6 +478,7 @@ QVBoxLayout* MainWindow::createStandardVBoxLayout()
  * 追加日志到底部面板，并按级别路由到对应页签。
  * 识别规则：包含 [ERROR]→错误；包含 [WARN]/[WARNING]→警告；否则→消息。
  * 同时总是写入“全部”。会在最前添加本地时间戳 HH:mm:ss.zzz。
+ * 同一条日志按相同级别写入日志文件。
  */
 void MainWindow::appendLog(const QString& text)
 {
@@ -380,17 +504,26 @@ void MainWindow::appendLog(const QString& text)
             m_logWindow->getLogErrorWidget()->append(line);
         }
         startBlinking("red");
+        if (m_logManager) {
+            m_logManager->logError(text);
+        }
     } else if (upper.contains("[WARN]") || upper.contains("[WARNING]")) {
         // 警告消息：黄色闪烁
         if (m_logWindow->getLogWarnWidget()) {
             m_logWindow->getLogWarnWidget()->append(line);
         }
         startBlinking("yellow");
+        if (m_logManager) {
+            m_logManager->logWarning(text);
+        }
     } else {
         // 普通消息：不闪烁
         if (m_logWindow->getLogInfoWidget()) {
             m_logWindow->getLogInfoWidget()->append(line);
         }
+        if (m_logManager) {
+            m_logManager->logInfo(text);
+        }
     }
 }
 
@@ -0,0 +1,660 @@
+#include "modbusioworker.h"
+#include "modbusmanager.h"
+#include <QModbusPdu>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// 动子状态块中各字段的偏移（DINT，低字在前），单位为 μm 与 μm/s；状态字和错误码各占一个寄存器
+constexpr int kMoverPositionOffset = 0;
+constexpr int kMoverSpeedOffset = 2;
+constexpr int kMoverStatusWordOffset = 4;
+constexpr int kMoverErrorCodeOffset = 5;
+constexpr int kMoverTargetOffset = 8;
+
+qint32 readDint(const QVector<quint16>& values, int index)
+{
+    return static_cast<qint32>((quint32(values.at(index + 1)) << 16) | values.at(index));
+}
+}
+
+ModbusIoWorker::ModbusIoWorker(MoverSnapshotBuffer* snapshots, QObject* parent)
+    : QObject(parent)
+    , m_commandQueue(256)
+    , m_wakePending(false)
+    , m_snapshots(snapshots)
+    , m_modbusClient(nullptr)
+    , m_unitId(1)
+    , m_maskTimeouts(0)
+    , m_maskReprobeTimer(new QTimer(this))
+    , m_currentReply(nullptr)
+    , m_isDispatching(false)
+    , m_heartbeat(new HeartbeatScheduler(this))
+    , m_heartbeatRegisterAddress(0)
+    , m_heartbeatToggleEnabled(true)
+    , m_heartbeatToggleState(false)
+    , m_heartbeatIntervalMs(3000)
+    , m_heartbeatReply(nullptr)
+    , m_moverPollTimer(new QTimer(this))
+    , m_moverPollAddress(0)
+    , m_moverPollCount(0)
+    , m_moverRegistersPerMover(0)
+    , m_moverPollOutstanding(0)
+    , m_moverPollFailed(false)
+    , m_snapshotSequence(0)
+{
+    // 定时器随本对象一起移动到I/O线程，超时在I/O线程中处理，不受界面重绘影响
+    connect(m_heartbeat, &HeartbeatScheduler::heartbeatDue, this, &ModbusIoWorker::onHeartbeatDue);
+    connect(m_heartbeat, &HeartbeatScheduler::metricsChanged, this, &ModbusIoWorker::linkQualityChanged);
+    connect(m_moverPollTimer, &QTimer::timeout, this, &ModbusIoWorker::onMoverPollTimeout);
+    m_maskReprobeTimer->setSingleShot(true);
+    connect(m_maskReprobeTimer, &QTimer::timeout, this, &ModbusIoWorker::onMaskReprobeTimeout);
+    m_clock.start();
+}
+
+
+ModbusIoWorker::~ModbusIoWorker()
+{
+    if (m_modbusClient && m_modbusClient->state() != QModbusDevice::UnconnectedState) {
+        m_modbusClient->disconnectDevice();
+    }
+}
+
+
+bool ModbusIoWorker::submit(ModbusCommand&& command)
+{
+    if (!m_commandQueue.tryPush(std::move(command))) {
+        return false;
+    }
+    // 一批命令只唤醒一次I/O线程
+    if (!m_wakePending.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, &ModbusIoWorker::processCommands, Qt::QueuedConnection);
+    }
+    return true;
+}
+
+
+void ModbusIoWorker::processCommands()
+{
+    // 先清除唤醒标志再取命令，保证之后入队的命令一定会再唤醒一次
+    m_wakePending.store(false, std::memory_order_release);
+
+    ModbusCommand command;
+    while (m_commandQueue.tryPop(command)) {
+        executeCommand(command);
+    }
+}
+
+
+void ModbusIoWorker::executeCommand(const ModbusCommand& command)
+{
+    switch (command.type) {
+    case ModbusCommand::Connect:
+        ensureClient();
+        if (m_modbusClient->state() != QModbusDevice::UnconnectedState) {
+            emit stateChanged(m_modbusClient->state(), m_modbusClient->errorString());
+            break;
+        }
+        m_unitId = command.unitId;
+        m_endpoint = QString("%1:%2").arg(command.host).arg(command.port);
+        m_modbusClient->setConnectionParameter(QModbusDevice::NetworkAddressParameter, QVariant(command.host));
+        m_modbusClient->setConnectionParameter(QModbusDevice::NetworkPortParameter, QVariant(command.port));
+        if (!m_modbusClient->connectDevice()) {
+            emit stateChanged(QModbusDevice::UnconnectedState, m_modbusClient->errorString());
+        }
+        break;
+
+    case ModbusCommand::Disconnect:
+        m_heartbeat->stop();
+        m_moverPollTimer->stop();
+        if (m_modbusClient && m_modbusClient->state() != QModbusDevice::UnconnectedState) {
+            m_modbusClient->disconnectDevice();
+        }
+        break;
+
+    case ModbusCommand::SetUnitId:
+        m_unitId = command.unitId;
+        // 不同从站可能是不同的设备，各自探测
+        m_maskTimeouts = 0;
+        m_maskReprobeTimer->stop();
+        emit maskWriteStrategyChanged(maskWriteStrategy());
+        if (isConnected() && maskWriteStrategy() == ModbusManager::MaskWriteUnknown) {
+            probeMaskWrite();
+        }
+        break;
+
+    case ModbusCommand::Read:
+    case ModbusCommand::Write:
+    case ModbusCommand::MaskWrite: {
+        Request request;
+        request.id = command.id;
+        request.address = command.address;
+        if (command.type == ModbusCommand::Read) {
+            request.kind = Request::Read;
+            request.count = command.count;
+        } else if (command.type == ModbusCommand::Write) {
+            request.kind = Request::Write;
+            request.values = command.values;
+            request.count = command.values.size();
+        } else {
+            request.kind = Request::MaskWrite;
+            request.stage = firstMaskStage();
+            request.andMask = command.andMask;
+            request.orMask = command.orMask;
+        }
+        enqueue(request);
+        break;
+    }
+
+    case ModbusCommand::StartHeartbeat:
+        if (command.intervalMs > 0) {
+            m_heartbeatIntervalMs = command.intervalMs;
+        }
+        m_heartbeat->start(m_heartbeatIntervalMs);
+        break;
+
+    case ModbusCommand::StopHeartbeat:
+        m_heartbeat->stop();
+        break;
+
+    case ModbusCommand::ConfigureHeartbeat:
+        m_heartbeatRegisterAddress = command.address;
+        m_heartbeatToggleEnabled = command.enabled;
+        break;
+
+    case ModbusCommand::ConfigureMoverPoll:
+        m_moverPollAddress = command.address;
+        m_moverRegistersPerMover = qBound(1, command.registersPerMover, kMaxReadRegisters);
+        // 受快照帧容量限制；超过单次FC03上限的状态块分成多次读取
+        m_moverPollCount = qBound(0, command.count, int(MoverSnapshotFrame::MAX_MOVERS));
+        // 配置变化前发出的分段按旧布局读取，整轮丢弃
+        m_moverPollFailed = m_moverPollOutstanding > 0;
+        if (command.enabled && m_moverPollCount > 0 && command.intervalMs > 0) {
+            m_moverPollTimer->start(command.intervalMs);
+        } else {
+            m_moverPollTimer->stop();
+        }
+        break;
+    }
+}
+
+
+void ModbusIoWorker::ensureClient()
+{
+    if (m_modbusClient) {
+        return;
+    }
+    // 在I/O线程中创建客户端，其套接字与定时器都归属本线程
+    m_modbusClient = new QModbusTcpClient(this);
+    m_modbusClient->setTimeout(kRequestTimeoutMs);
+    m_modbusClient->setNumberOfRetries(1);
+    connect(m_modbusClient, &QModbusDevice::stateChanged,
+            this, &ModbusIoWorker::onClientStateChanged);
+}
+
+
+bool ModbusIoWorker::isConnected() const
+{
+    return m_modbusClient && m_modbusClient->state() == QModbusDevice::ConnectedState;
+}
+
+
+void ModbusIoWorker::onClientStateChanged(QModbusDevice::State state)
+{
+    emit stateChanged(state, m_modbusClient->errorString());
+
+    if (state == QModbusDevice::ConnectedState) {
+        // 连接成功后延时启动心跳（给网关/PLC预热时间），链路统计从新连接开始
+        m_heartbeatToggleState = false;
+        // 重连后PLC可能已更换或升级，丢弃缓存重新探测；探测在首次心跳之前完成
+        m_maskStrategies.remove(capabilityKey());
+        m_maskTimeouts = 0;
+        emit maskWriteStrategyChanged(ModbusManager::MaskWriteUnknown);
+        probeMaskWrite();
+        m_heartbeat->resetMetrics();
+        m_heartbeat->start(m_heartbeatIntervalMs, 400);
+    } else if (state == QModbusDevice::UnconnectedState) {
+        // 先以失败结束在途心跳再停止调度，断线计入链路统计
+        failAllRequests(QStringLiteral("设备未连接"));
+        m_heartbeat->stop();
+        m_maskReprobeTimer->stop();
+    }
+}
+
+
+// --- 请求调度 ---
+
+void ModbusIoWorker::enqueue(const Request& request, bool urgent)
+{
+    if (urgent) {
+        m_requestQueue.prepend(request);
+    } else {
+        m_requestQueue.enqueue(request);
+    }
+    dispatchNext();
+}
+
+
+void ModbusIoWorker::dispatchNext()
+{
+    if (m_isDispatching) {
+        return;
+    }
+    m_isDispatching = true;
+
+    while (!m_currentReply && !m_requestQueue.isEmpty()) {
+        if (!isConnected()) {
+            failAllRequests(QStringLiteral("设备未连接"));
+            break;
+        }
+
+        m_currentRequest = m_requestQueue.dequeue();
+        QModbusReply* reply = sendRequest(m_currentRequest);
+        if (!reply) {
+            finishRequest(m_currentRequest, false, {},
+                          QString("发送请求失败: %1").arg(m_modbusClient->errorString()));
+            continue;
+        }
+
+        if (m_currentRequest.kind == Request::Heartbeat) {
+            m_heartbeat->markSent();
+        }
+
+        m_currentReply = reply;
+        if (reply->isFinished()) {
+            // 广播请求会立即完成
+            processReply(reply);
+        } else {
+            connect(reply, &QModbusReply::finished, this, &ModbusIoWorker::onReplyFinished);
+        }
+    }
+
+    m_isDispatching = false;
+}
+
+
+QModbusReply* ModbusIoWorker::sendRequest(const Request& request)
+{
+    switch (request.stage) {
+    case Request::MaskFc22:
+        return m_modbusClient->sendRawRequest(
+            QModbusRequest(QModbusPdu::MaskWriteRegister, quint16(request.address),
+                           request.andMask, request.orMask),
+            m_unitId);
+    case Request::MaskRead:
+        return m_modbusClient->sendReadRequest(
+            QModbusDataUnit(QModbusDataUnit::HoldingRegisters, request.address, 1), m_unitId);
+    case Request::MaskWriteBack:
+        break;
+    case Request::Direct:
+        if (request.kind != Request::Write) {
+            return m_modbusClient->sendReadRequest(
+                QModbusDataUnit(QModbusDataUnit::HoldingRegisters, request.address, request.count), m_unitId);
+        }
+        break;
+    }
+
+    QModbusDataUnit unit(QModbusDataUnit::HoldingRegisters, request.address, request.values.size());
+    unit.setValues(request.values);
+    return m_modbusClient->sendWriteRequest(unit, m_unitId);
+}
+
+
+void ModbusIoWorker::onReplyFinished()
+{
+    QModbusReply* reply = qobject_cast<QModbusReply*>(sender());
+    if (!reply || reply != m_currentReply) {
+        if (reply) {
+            reply->deleteLater();
+        }
+        return;
+    }
+    processReply(reply);
+    dispatchNext();
+}
+
+
+void ModbusIoWorker::processReply(QModbusReply* reply)
+{
+    const Request request = m_currentRequest;
+    m_currentReply = nullptr;
+    handleReply(request, reply);
+}
+
+
+void ModbusIoWorker::handleReply(Request request, QModbusReply* reply)
+{
+    const bool success = reply->error() == QModbusDevice::NoError;
+    const QString errorText = success ? QString() : describeError(reply);
+    const bool illegalFunction = !success && isIllegalFunction(reply);
+    const bool timedOut = reply->error() == QModbusDevice::TimeoutError;
+    const QModbusDataUnit result = reply->result();
+    reply->deleteLater();
+
+    switch (request.stage) {
+    case Request::Direct:
+        finishRequest(request, success, request.kind == Request::Write ? request.values : result.values(), errorText);
+        break;
+
+    case Request::MaskFc22:
+        if (success) {
+            m_maskTimeouts = 0;
+            m_maskReprobeTimer->stop();
+            setMaskWriteStrategy(ModbusManager::MaskWriteFc22);
+            finishRequest(request, true, {}, QString());
+            break;
+        }
+        noteMaskWriteFailure(illegalFunction, timedOut);
+        if (request.kind == Request::MaskProbe) {
+            finishRequest(request, false, {}, errorText);
+            break;
+        }
+        // 0x16失败（网关不支持/超时等）：降级为读-改-写，插到队首保证紧接着执行
+        emit maskWriteFellBack(request.address, errorText);
+        request.stage = Request::MaskRead;
+        m_requestQueue.prepend(request);
+        break;
+
+    case Request::MaskRead:
+        if (!success || result.valueCount() < 1) {
+            finishRequest(request, false, {},
+                          QString("掩码写失败: 读取寄存器0x%1失败")
+                          .arg(request.address, 4, 16, QChar('0')));
+            break;
+        }
+        request.stage = Request::MaskWriteBack;
+        request.values = { quint16((result.value(0) & request.andMask) | request.orMask) };
+        m_requestQueue.prepend(request);
+        break;
+
+    case Request::MaskWriteBack:
+        finishRequest(request, success, request.values,
+                      success ? QString()
+                              : QString("掩码写失败且降级写回失败: addr=0x%1, 错误=%2")
+                                .arg(request.address, 4, 16, QChar('0')).arg(errorText));
+        break;
+    }
+}
+
+
+void ModbusIoWorker::finishRequest(const Request& request, bool success,
+                                   const QVector<quint16>& values, const QString& errorText)
+{
+    if (request.kind == Request::Heartbeat) {
+        m_heartbeat->markCompleted(success);
+        if (!success) {
+            qDebug() << "心跳写入失败:" << errorText;
+        }
+    } else if (request.kind == Request::MoverPoll) {
+        const int offset = request.address - m_moverPollAddress;
+        if (success && offset >= 0 && offset + values.size() <= m_moverPollValues.size()) {
+            std::copy(values.cbegin(), values.cend(), m_moverPollValues.begin() + offset);
+        } else {
+            m_moverPollFailed = true;
+        }
+        // 一轮的各分段都返回后才发布，任一分段失败则整轮丢弃
+        if (--m_moverPollOutstanding == 0 && !m_moverPollFailed) {
+            publishMoverSnapshot(m_moverPollValues);
+        }
+    }
+
+    if (request.id != 0) {
+        emit requestFinished(request.id, success, request.address, values, errorText);
+    }
+}
+
+
+void ModbusIoWorker::failAllRequests(const QString& reason)
+{
+    if (m_currentReply) {
+        // 应答对象由客户端在断开时结束，这里只解除关联
+        disconnect(m_currentReply, nullptr, this, nullptr);
+        m_currentReply->deleteLater();
+        m_currentReply = nullptr;
+        finishRequest(m_currentRequest, false, {}, reason);
+    }
+    if (m_heartbeatReply) {
+        disconnect(m_heartbeatReply, nullptr, this, nullptr);
+        m_heartbeatReply->deleteLater();
+        m_heartbeatReply = nullptr;
+        finishRequest(m_heartbeatRequest, false, {}, reason);
+    }
+    while (!m_requestQueue.isEmpty()) {
+        finishRequest(m_requestQueue.dequeue(), false, {}, reason);
+    }
+}
+
+
+QString ModbusIoWorker::describeError(QModbusReply* reply) const
+{
+    if (reply->error() == QModbusDevice::ProtocolError) {
+        const QModbusResponse response = reply->rawResult();
+        if (response.isException()) {
+            return QString("Modbus异常应答, 码: %1").arg(response.exceptionCode());
+        }
+    }
+    if (reply->error() == QModbusDevice::TimeoutError) {
+        return QStringLiteral("timeout");
+    }
+    return reply->errorString();
+}
+
+
+// --- 掩码写能力缓存 ---
+
+QString ModbusIoWorker::capabilityKey() const
+{
+    return QString("%1/%2").arg(m_endpoint).arg(m_unitId);
+}
+
+
+int ModbusIoWorker::maskWriteStrategy() const
+{
+    return m_maskStrategies.value(capabilityKey(), ModbusManager::MaskWriteUnknown);
+}
+
+
+void ModbusIoWorker::setMaskWriteStrategy(int strategy)
+{
+    if (maskWriteStrategy() == strategy) {
+        return;
+    }
+    m_maskStrategies.insert(capabilityKey(), strategy);
+    emit maskWriteStrategyChanged(strategy);
+}
+
+
+// 已确认不支持0x16时直接从读取开始，省去每次等待0x16失败
+ModbusIoWorker::Request::Stage ModbusIoWorker::firstMaskStage() const
+{
+    return maskWriteStrategy() == ModbusManager::MaskWriteReadModifyWrite ? Request::MaskRead : Request::MaskFc22;
+}
+
+
+// 0x16失败后更新能力缓存；已确认支持时的偶发失败不改变缓存
+void ModbusIoWorker::noteMaskWriteFailure(bool illegalFunction, bool timedOut)
+{
+    if (maskWriteStrategy() == ModbusManager::MaskWriteFc22) {
+        return;
+    }
+    if (illegalFunction) {
+        // PLC明确拒绝该功能码，本次连接内不再探测
+        m_maskReprobeTimer->stop();
+        setMaskWriteStrategy(ModbusManager::MaskWriteReadModifyWrite);
+    } else if (timedOut) {
+        // 部分网关对不认识的功能码不应答，但单次超时也可能只是链路抖动：
+        // 连续超时才改走读-改-写，并在稍后重新探测
+        if (++m_maskTimeouts >= kMaskTimeoutLimit) {
+            setMaskWriteStrategy(ModbusManager::MaskWriteReadModifyWrite);
+            m_maskReprobeTimer->start(kMaskReprobeIntervalMs);
+        }
+    }
+}
+
+
+// 因超时降级的端点定期重新探测；探测期间掩码写仍走读-改-写
+void ModbusIoWorker::onMaskReprobeTimeout()
+{
+    if (isConnected() && maskWriteStrategy() == ModbusManager::MaskWriteReadModifyWrite) {
+        probeMaskWrite();
+    }
+}
+
+
+// 对心跳寄存器做一次空操作的0x16（AND=0xFFFF, OR=0），寄存器值不变
+void ModbusIoWorker::probeMaskWrite()
+{
+    Request request;
+    request.kind = Request::MaskProbe;
+    request.stage = Request::MaskFc22;
+    request.address = m_heartbeatRegisterAddress;
+    request.andMask = 0xFFFF;
+    request.orMask = 0x0000;
+    enqueue(request, true);
+}
+
+
+bool ModbusIoWorker::isIllegalFunction(QModbusReply* reply)
+{
+    if (reply->error() == QModbusDevice::ProtocolError) {
+        const QModbusResponse response = reply->rawResult();
+        return response.isException() && response.exceptionCode() == QModbusPdu::IllegalFunction;
+    }
+    return false;
+}
+
+
+// --- 心跳与动子轮询 ---
+
+void ModbusIoWorker::onHeartbeatDue()
+{
+    if (!isConnected()) {
+        // 未发出的心跳按失败结束，调度器才会排程下一次
+        m_heartbeat->markCompleted(false);
+        return;
+    }
+
+    Request request;
+    request.kind = Request::Heartbeat;
+    request.address = m_heartbeatRegisterAddress;
+
+    if (m_heartbeatToggleEnabled) {
+        // 仅翻转 bit15，不影响其他位
+        m_heartbeatToggleState = !m_heartbeatToggleState;
+        request.stage = firstMaskStage();
+        request.andMask = m_heartbeatToggleState ? 0xFFFF : 0x7FFF;
+        request.orMask = m_heartbeatToggleState ? 0x8000 : 0x0000;
+    } else {
+        // 仅读取作为保活
+        request.count = 1;
+    }
+
+    // 有其他请求在途时作为独立事务直接发出（Modbus TCP按事务ID匹配应答），不等待在途的批量写入；
+    // 在途请求涉及心跳寄存器或心跳需要读-改-写时插到队首，保证读-改-写不与其他写操作交错
+    const bool overlapsCurrent = m_currentReply
+            && m_heartbeatRegisterAddress >= m_currentRequest.address
+            && m_heartbeatRegisterAddress < m_currentRequest.address + qMax(1, m_currentRequest.count);
+    if (m_currentReply && !m_heartbeatReply && !overlapsCurrent && request.stage != Request::MaskRead) {
+        sendHeartbeatDirect(request);
+    } else {
+        enqueue(request, true);
+    }
+}
+
+
+void ModbusIoWorker::sendHeartbeatDirect(const Request& request)
+{
+    QModbusReply* reply = sendRequest(request);
+    if (!reply) {
+        finishRequest(request, false, {}, QString("发送心跳失败: %1").arg(m_modbusClient->errorString()));
+        return;
+    }
+    m_heartbeat->markSent();
+
+    m_heartbeatRequest = request;
+    m_heartbeatReply = reply;
+    if (reply->isFinished()) {
+        m_heartbeatReply = nullptr;
+        handleReply(request, reply);
+        dispatchNext();
+    } else {
+        connect(reply, &QModbusReply::finished, this, &ModbusIoWorker::onHeartbeatReplyFinished);
+    }
+}
+
+
+void ModbusIoWorker::onHeartbeatReplyFinished()
+{
+    QModbusReply* reply = qobject_cast<QModbusReply*>(sender());
+    if (!reply || reply != m_heartbeatReply) {
+        if (reply) {
+            reply->deleteLater();
+        }
+        return;
+    }
+    m_heartbeatReply = nullptr;
+    // 0x16失败时降级的读-改-写阶段插到普通队列队首，按顺序执行
+    handleReply(m_heartbeatRequest, reply);
+    dispatchNext();
+}
+
+
+void ModbusIoWorker::onMoverPollTimeout()
+{
+    if (!isConnected() || m_moverPollOutstanding > 0 || m_moverPollCount <= 0) {
+        return;
+    }
+
+    // 按整个动子切分，每段不超过单次FC03上限
+    const int moversPerRead = kMaxReadRegisters / m_moverRegistersPerMover;
+    m_moverPollValues.fill(0, m_moverPollCount * m_moverRegistersPerMover);
+    m_moverPollFailed = false;
+
+    for (int first = 0; first < m_moverPollCount; first += moversPerRead) {
+        Request request;
+        request.kind = Request::MoverPoll;
+        request.address = m_moverPollAddress + first * m_moverRegistersPerMover;
+        request.count = qMin(moversPerRead, m_moverPollCount - first) * m_moverRegistersPerMover;
+        ++m_moverPollOutstanding;
+        enqueue(request);
+    }
+}
+
+
+void ModbusIoWorker::publishMoverSnapshot(const QVector<quint16>& values)
+{
+    MoverSnapshotFrame& frame = m_snapshots->writeFrame();
+    const qint64 now = m_clock.elapsed();
+    const int count = qMin(m_moverPollCount, int(values.size() / m_moverRegistersPerMover));
+
+    frame.sequence = ++m_snapshotSequence;
+    frame.timestampMs = now;
+    frame.count = count;
+
+    for (int i = 0; i < count; ++i) {
+        const int base = i * m_moverRegistersPerMover;
+        MoverSnapshot& mover = frame.movers[i];
+        mover.id = i;
+        mover.timestampMs = now;
+        if (base + kMoverPositionOffset + 1 < values.size()) {
+            mover.position = readDint(values, base + kMoverPositionOffset) / 1000.0;
+        }
+        if (base + kMoverSpeedOffset + 1 < values.size()) {
+            mover.speed = readDint(values, base + kMoverSpeedOffset) / 1000.0;
+        }
+        if (base + kMoverStatusWordOffset < values.size()) {
+            mover.statusWord = values.at(base + kMoverStatusWordOffset);
+        }
+        if (base + kMoverErrorCodeOffset < values.size()) {
+            mover.errorCode = values.at(base + kMoverErrorCodeOffset);
+        }
+        if (base + kMoverTargetOffset + 1 < values.size()) {
+            mover.target = readDint(values, base + kMoverTargetOffset) / 1000.0;
+        }
+    }
+
+    m_snapshots->publish();
+    if (m_snapshots->requestNotify()) {
+        emit moverSnapshotReady();
+    }
+}
@@ -1,153 +1,272 @@
 #include "modbusmanager.h"
+#include "modbusioworker.h"
 #include <QEventLoop>
+#include <QThread>
 
 ModbusManager::ModbusManager(QObject *parent)
     : QObject(parent)
-    , m_modbusClient(nullptr)
-    , m_heartbeatTimer(nullptr)
+    , m_ioThread(new QThread(this))
+    , m_worker(nullptr)
     , m_lastPort(0)
 {
-    m_modbusClient = new QModbusTcpClient(this);
+    qRegisterMetaType<LinkQualityMetrics>();
+
+    m_worker = new ModbusIoWorker(&m_moverSnapshots);
+    m_worker->moveToThread(m_ioThread);
+    connect(m_ioThread, &QThread::finished, m_worker, &QObject::deleteLater);
+
+    // 跨线程信号均为队列连接，槽函数在GUI线程中执行
+    connect(m_worker, &ModbusIoWorker::stateChanged,
+            this, &ModbusManager::onWorkerStateChanged);
+    connect(m_worker, &ModbusIoWorker::requestFinished,
+            this, &ModbusManager::onWorkerRequestFinished);
+    connect(m_worker, &ModbusIoWorker::moverSnapshotReady,
+            this, &ModbusManager::moverSnapshotReady);
+    connect(m_worker, &ModbusIoWorker::linkQualityChanged,
+            this, &ModbusManager::onWorkerLinkQualityChanged);
+    connect(m_worker, &ModbusIoWorker::maskWriteStrategyChanged,
+            this, &ModbusManager::onWorkerMaskWriteStrategyChanged);
+    connect(m_worker, &ModbusIoWorker::maskWriteFellBack,
+            this, &ModbusManager::maskWriteFellBack);
+
+    m_ioThread->setObjectName("ModbusIO");
+    m_ioThread->start(QThread::HighPriority);
+}
 
-    // 连接状态变化信号
-    connect(m_modbusClient, &QModbusDevice::stateChanged,
-            this, &ModbusManager::onStateChanged);
 
-    setupHeartbeat();
+ModbusManager::~ModbusManager()
+{
+    // 工作对象在I/O线程结束时释放，其析构函数负责断开客户端
+    m_ioThread->quit();
+    m_ioThread->wait();
 }
 
 
-ModbusManager::~ModbusManager()
+bool ModbusManager::submitCommand(ModbusCommand& command)
+{
+    if (!m_worker->submit(std::move(command))) {
+        qDebug() << "[MODBUS] 命令队列已满，命令被丢弃";
+        return false;
+    }
+    return true;
+}
+
+
+bool ModbusManager::submitRequest(ModbusCommand& command, ReplyHandler handler)
+{
+    command.id = ++m_nextRequestId;
+    const quint64 id = command.id;
+    m_pendingRequests.insert(id, std::move(handler));
+
+    if (!submitCommand(command)) {
+        m_pendingRequests.remove(id);
+        return false;
+    }
+    return true;
+}
+
+
+// 在局部事件循环中等待I/O线程回送结果；等待期间界面照常刷新
+bool ModbusManager::waitForRequest(ModbusCommand& command, int timeoutMs, QVector<quint16>* values, QString* errorText)
+{
+    QVector<ModbusCommand> commands;
+    commands.append(std::move(command));
+    return waitForRequests(commands, timeoutMs, values, errorText);
+}
+
+
+// 一次投递多条请求并等待全部完成；读请求的结果按投递顺序拼接到values中
+bool ModbusManager::waitForRequests(QVector<ModbusCommand>& commands, int timeoutMs, QVector<quint16>* values, QString* errorText)
+{
+    struct WaitState {
+        int remaining = 0;
+        bool success = true;
+        QVector<QVector<quint16>> results;
+        QString errorText;
+        QEventLoop loop;
+    };
+    // 局部事件循环会派发其他界面事件；若其中再次发起同步请求，外层等待会被嵌套阻塞，
+    // 且调用方的状态可能在等待期间被改写，因此同一时刻只允许一个同步等待
+    if (m_syncWaitActive) {
+        if (values) values->clear();
+        if (errorText) *errorText = QStringLiteral("上一个同步请求尚未完成");
+        return false;
+    }
+    m_syncWaitActive = true;
+
+    WaitState state;
+    state.results.resize(commands.size());
+
+    QVector<quint64> ids;
+    for (int i = 0; i < commands.size(); ++i) {
+        const bool queued = submitRequest(commands[i], [&state, i](bool success, const QVector<quint16>& v, const QString& err) {
+            state.results[i] = v;
+            if (!success && state.success) {
+                state.success = false;
+                state.errorText = err;
+            }
+            if (--state.remaining == 0) {
+                state.loop.quit();
+            }
+        });
+        if (!queued) {
+            state.success = false;
+            state.errorText = QStringLiteral("命令队列已满");
+            break;
+        }
+        ids.append(commands[i].id);
+        ++state.remaining;
+    }
+
+    if (state.remaining > 0) {
+        QTimer timer;
+        timer.setSingleShot(true);
+        QObject::connect(&timer, &QTimer::timeout, &state.loop, &QEventLoop::quit);
+        timer.start(timeoutMs > 0 ? timeoutMs : 5000);
+        state.loop.exec();
+    }
+    m_syncWaitActive = false;
+
+    if (state.remaining > 0) {
+        // 超时或投递失败：丢弃回调，I/O线程稍后回送的结果将被忽略
+        for (quint64 id : ids) {
+            m_pendingRequests.remove(id);
+        }
+        if (state.success) {
+            state.success = false;
+            state.errorText = QStringLiteral("timeout");
+        }
+    }
+
+    if (values) {
+        values->clear();
+        for (const QVector<quint16>& result : state.results) {
+            values->append(result);
+        }
+    }
+    if (errorText) *errorText = state.errorText;
+    return state.success;
+}
+
+
+void ModbusManager::onWorkerRequestFinished(quint64 id, bool success, int address,
+                                            const QVector<quint16>& values, const QString& errorText)
+{
+    Q_UNUSED(address);
+    ReplyHandler handler = m_pendingRequests.take(id);
+    if (handler) {
+        handler(success, values, errorText);
+    }
+    emit requestCompleted(id, success);
+}
+
+
+void ModbusManager::onWorkerStateChanged(int state, const QString& errorString)
+{
+    m_state = static_cast<QModbusDevice::State>(state);
+    m_errorString = errorString;
+    emit stateChanged(m_state);
+}
+
+
+void ModbusManager::onWorkerLinkQualityChanged(const LinkQualityMetrics& metrics)
+{
+    m_linkQuality = metrics;
+    emit linkQualityChanged(m_linkQuality);
+}
+
+
+void ModbusManager::onWorkerMaskWriteStrategyChanged(int strategy)
 {
-    if (m_modbusClient && m_modbusClient->state() == QModbusDevice::ConnectedState) {
-        m_modbusClient->disconnectDevice();
+    const MaskWriteStrategy newStrategy = static_cast<MaskWriteStrategy>(strategy);
+    if (newStrategy == m_maskWriteStrategy) {
+        return;
     }
+    m_maskWriteStrategy = newStrategy;
+    emit maskWriteStrategyChanged(m_maskWriteStrategy);
 }
 
 
 bool ModbusManager::connectToDevice(const QString& ip, int port)
 {
-    if (m_modbusClient->state() == QModbusDevice::ConnectedState) {
+    if (m_state == QModbusDevice::ConnectedState) {
         return true;
     }
 
-    m_modbusClient->setConnectionParameter(QModbusDevice::NetworkAddressParameter, QVariant(ip));
-    m_modbusClient->setConnectionParameter(QModbusDevice::NetworkPortParameter, QVariant(port));
-
     // 记录最近连接参数，便于重连
     m_lastIP = ip;
     m_lastPort = port;
 
-    return m_modbusClient->connectDevice();
+    configureHeartbeat();
+
+    ModbusCommand command;
+    command.type = ModbusCommand::Connect;
+    command.host = ip;
+    command.port = port;
+    command.unitId = m_unitId;
+    return submitCommand(command);
 }
 
 
 void ModbusManager::disconnectDevice()
 {
-    stopHeartbeat();
-    if (m_modbusClient && m_modbusClient->state() == QModbusDevice::ConnectedState) {
-        m_modbusClient->disconnectDevice();
-    } else if (m_modbusClient && m_modbusClient->state() == QModbusDevice::ConnectingState) {
-        m_modbusClient->disconnectDevice();
-    }
+    ModbusCommand command;
+    command.type = ModbusCommand::Disconnect;
+    submitCommand(command);
 }
 
 
 QModbusDevice::State ModbusManager::connectionState() const
 {
-    return m_modbusClient ? m_modbusClient->state() : QModbusDevice::UnconnectedState;
+    return m_state;
 }
 
 
 QString ModbusManager::errorString() const
 {
-    return m_modbusClient ? m_modbusClient->errorString() : QString("Client not initialized");
+    return m_errorString;
+}
+
+
+void ModbusManager::setUnitId(int unitId)
+{
+    m_unitId = unitId;
+
+    ModbusCommand command;
+    command.type = ModbusCommand::SetUnitId;
+    command.unitId = unitId;
+    submitCommand(command);
 }
 
 
-// 掩码写（0x16）同步；失败时自动降级为读-改-写
+// 掩码写同步；按探测到的策略执行，未探测时先试0x16，失败由I/O线程自动降级为读-改-写
 bool ModbusManager::maskWriteRegisterSync(int address, quint16 andMask, quint16 orMask, int timeoutMs)
 {
-    if (!m_modbusClient || m_modbusClient->state() != QModbusDevice::ConnectedState) {
+    if (m_state != QModbusDevice::ConnectedState) {
         emit errorOccurred(QStringLiteral("设备未连接"));
         return false;
     }
 
-    // 超时分配：优先保证降级路径有充足时间（适配部分网关对0x16慢/不稳定）
-    const int base = (timeoutMs > 0 ? timeoutMs : 2800);
-    int t1 = qMax(400, (base * 4) / 10); // 约40%给0x16
-    int t2 = base - t1;                  // 约60%给降级
-
-    auto tryMask16 = [&]() -> bool {
-        QByteArray payload;
-        payload.append(char((address >> 8) & 0xFF));
-        payload.append(char(address & 0xFF));
-        payload.append(char((andMask >> 8) & 0xFF));
-        payload.append(char(andMask & 0xFF));
-        payload.append(char((orMask >> 8) & 0xFF));
-        payload.append(char(orMask & 0xFF));
-
-        QModbusRequest req(QModbusPdu::MaskWriteRegister, payload);
-        if (QModbusReply* r = m_modbusClient->sendRawRequest(req, m_unitId)) {
-            QEventLoop loop; QTimer timer; timer.setSingleShot(true);
-            bool tmo = false; QModbusDevice::Error err = QModbusDevice::NoError; QString errStr;
-            QObject::connect(&timer, &QTimer::timeout, [&](){ tmo = true; loop.quit(); });
-            QObject::connect(r, &QModbusReply::finished, [&](){ err = r->error(); errStr = r->errorString(); loop.quit(); });
-            timer.start(t1);
-            loop.exec();
-            r->deleteLater();
-            if (!tmo && err == QModbusDevice::NoError) return true;
-            qDebug() << "[MASK16] fail:" << (tmo ? "timeout" : errStr);
-            return false;
-        }
-        qDebug() << "[MASK16] send fail:" << m_modbusClient->errorString();
-        return false;
-    };
-
-    if (tryMask16()) return true;
+    ModbusCommand command;
+    command.type = ModbusCommand::MaskWrite;
+    command.address = address;
+    command.andMask = andMask;
+    command.orMask = orMask;
 
-    // 降级：读-改-写
-    quint16 oldVal = 0;
-    // 降级读-改-写：读写分别分配较宽的超时，避免“读取超时”
-    int readT = qMax(800, (t2 * 2) / 3);
-    int writeT = qMax(600, t2 - readT);
-
-    if (!readRegisterSync(address, oldVal, readT)) {
-        emit errorOccurred(QString("掩码写失败: 0x16失败且读取寄存器0x%1失败")
-                           .arg(address, 4, 16, QChar('0')));
-        return false;
-    }
-    quint16 newVal = (oldVal & andMask) | orMask;
-
-    QModbusDataUnit unit(QModbusDataUnit::HoldingRegisters, address, 1);
-    unit.setValue(0, newVal);
-    if (QModbusReply* w = m_modbusClient->sendWriteRequest(unit, m_unitId)) {
-        QEventLoop loop; QTimer timer; timer.setSingleShot(true);
-        bool tmo = false; QModbusDevice::Error err = QModbusDevice::NoError; QString errStr;
-        QObject::connect(&timer, &QTimer::timeout, [&](){ tmo = true; loop.quit(); });
-        QObject::connect(w, &QModbusReply::finished, [&](){ err = w->error(); errStr = w->errorString(); loop.quit(); });
-        timer.start(writeT);
-        loop.exec();
-        w->deleteLater();
-        if (!tmo && err == QModbusDevice::NoError) return true; // 降级成功
-
-        emit errorOccurred(QString("掩码写失败且降级写回失败: addr=0x%1, 错误=%2")
-                           .arg(address, 4, 16, QChar('0'))
-                           .arg(tmo ? "timeout" : errStr));
-        return false;
-    } else {
-        emit errorOccurred(QString("掩码写失败且降级发送失败: %1").arg(m_modbusClient->errorString()));
-        return false;
+    QString errorText;
+    if (waitForRequest(command, timeoutMs > 0 ? timeoutMs : 2800, nullptr, &errorText)) {
+        return true;
     }
+    emit errorOccurred(errorText == QLatin1String("timeout")
+                       ? QString("掩码写超时: addr=0x%1").arg(address, 4, 16, QChar('0'))
+                       : errorText);
+    return false;
 }
 
 
 bool ModbusManager::writeRegister(int address, quint16 value)
 {
-    // 对寄存器[0]添加互斥锁保护，避免与心跳冲突
-    QMutexLocker locker(address == m_heartbeatRegisterAddress ? &m_registerMutex : nullptr);
-    
-    if (!m_modbusClient || m_modbusClient->state() != QModbusDevice::ConnectedState) {
+    if (m_state != QModbusDevice::ConnectedState) {
         emit errorOccurred(QStringLiteral("设备未连接"));
         return false;
     }
@@ -157,246 +276,231 @@ bool ModbusManager::writeRegister(int address, quint16 value)
         emit errorOccurred(QString("寄存器地址 0x%1 越界").arg(address, 4, 16, QChar('0')));
         return false;
     }
-    
+
     // 如果是心跳寄存器，添加调试信息
     if (address == m_heartbeatRegisterAddress) {
         qDebug() << "控制寄存器写入，值:" << QString("0x%1").arg(value, 4, 16, QChar('0'));
     }
 
-    QModbusDataUnit unit(QModbusDataUnit::HoldingRegisters, address, 1);
-    unit.setValue(0, value);
-
-    if (QModbusReply* reply = m_modbusClient->sendWriteRequest(unit, m_unitId)) {
-        if (!reply->isFinished()) {
-            connect(reply, &QModbusReply::finished, this, [this, reply, address, value]() {
-                if (reply->error() != QModbusDevice::NoError) {
-                    QString errorMsg = QString("寄存器 0x%1 写入失败: %2")
-                                       .arg(address, 4, 16, QChar('0'))
-                                       .arg(reply->errorString());
-                    emit errorOccurred(errorMsg);
-                } else {
-                    qDebug() << QString("寄存器 0x%1 写入成功, 值: %2")
-                                .arg(address, 4, 16, QChar('0'))
-                                .arg(value);
-                }
-                reply->deleteLater();
-            });
+    ModbusCommand command;
+    command.type = ModbusCommand::Write;
+    command.address = address;
+    command.values = { value };
+
+    const bool queued = submitRequest(command, [this, address, value](bool success, const QVector<quint16>&, const QString& errorText) {
+        if (!success) {
+            emit errorOccurred(QString("寄存器 0x%1 写入失败: %2")
+                               .arg(address, 4, 16, QChar('0'))
+                               .arg(errorText));
         } else {
-            // 已完成（广播写或立即完成）
-            reply->deleteLater();
+            qDebug() << QString("寄存器 0x%1 写入成功, 值: %2")
+                        .arg(address, 4, 16, QChar('0'))
+                        .arg(value);
         }
-        return true;
+    });
+    if (!queued) {
+        emit errorOccurred(QStringLiteral("发送写请求失败: 命令队列已满"));
     }
-
-    emit errorOccurred(QString("发送写请求失败: %1").arg(m_modbusClient->errorString()));
-    return false;
+    return queued;
 }
 
 
 bool ModbusManager::writeRegisterSync(int address, quint16 value, int timeoutMs)
 {
-    if (!m_modbusClient || m_modbusClient->state() != QModbusDevice::ConnectedState) {
+    if (m_state != QModbusDevice::ConnectedState) {
         emit errorOccurred(QStringLiteral("设备未连接"));
         return false;
     }
-    QModbusDataUnit unit(QModbusDataUnit::HoldingRegisters, address, 1);
-    unit.setValue(0, value);
-    if (QModbusReply* reply = m_modbusClient->sendWriteRequest(unit, 1)) {
-        QEventLoop loop; QTimer timer; timer.setSingleShot(true);
-        bool timeoutOccurred = false; QModbusDevice::Error err = QModbusDevice::NoError; QString errStr;
-        QObject::connect(&timer, &QTimer::timeout, [&](){ timeoutOccurred = true; loop.quit(); });
-        QObject::connect(reply, &QModbusReply::finished, [&](){ err = reply->error(); errStr = reply->errorString(); loop.quit(); });
-        timer.start(timeoutMs);
-        loop.exec();
-        reply->deleteLater();
-        if (!timeoutOccurred && err == QModbusDevice::NoError) return true;
-        emit errorOccurred(QString("寄存器 0x%1 同步写失败: %2")
-                           .arg(address, 4, 16, QChar('0')).arg(timeoutOccurred ? "timeout" : errStr));
-        return false;
+
+    ModbusCommand command;
+    command.type = ModbusCommand::Write;
+    command.address = address;
+    command.values = { value };
+
+    QString errorText;
+    if (waitForRequest(command, timeoutMs, nullptr, &errorText)) {
+        return true;
     }
-    emit errorOccurred(QString("发送写请求失败: %1").arg(m_modbusClient->errorString()));
+    emit errorOccurred(QString("寄存器 0x%1 同步写失败: %2")
+                       .arg(address, 4, 16, QChar('0')).arg(errorText));
     return false;
 }
 
 
 bool ModbusManager::readRegisterSync(int address, quint16& value, int timeoutMs)
 {
-    if (!m_modbusClient || m_modbusClient->state() != QModbusDevice::ConnectedState) {
+    if (m_state != QModbusDevice::ConnectedState) {
         emit errorOccurred(QStringLiteral("设备未连接"));
         return false;
     }
 
-    QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, address, 1);
-    if (QModbusReply* reply = m_modbusClient->sendReadRequest(readUnit, m_unitId)) {
-        if (reply->isFinished()) {
-            reply->deleteLater();
-            return false;
-        }
+    ModbusCommand command;
+    command.type = ModbusCommand::Read;
+    command.address = address;
+    command.count = 1;
 
-        QEventLoop loop; QTimer timer; timer.setSingleShot(true);
-        bool timeoutOccurred = false;
-        QModbusDevice::Error error = QModbusDevice::NoError; QString errorString;
+    QVector<quint16> values;
+    QString errorText;
+    if (waitForRequest(command, timeoutMs, &values, &errorText) && !values.isEmpty()) {
+        value = values.first();
+        return true;
+    }
 
-        QObject::connect(&timer, &QTimer::timeout, [&]() {
-            timeoutOccurred = true; loop.quit();
-        });
+    if (errorText == QLatin1String("timeout")) {
+        emit errorOccurred(QString("寄存器 0x%1 读取超时").arg(address, 4, 16, QChar('0')));
+    } else {
+        emit errorOccurred(QString("寄存器 0x%1 读取失败: %2").arg(address, 4, 16, QChar('0')).arg(errorText));
+    }
+    return false;
+}
 
-        QObject::connect(reply, &QModbusReply::finished, [&]() {
-            error = reply->error();
-            if (error == QModbusDevice::NoError) {
-                QModbusDataUnit result = reply->result();
-                value = result.value(0);
-            } else {
-                errorString = reply->errorString();
-            }
-            loop.quit();
-        });
 
-        timer.start(timeoutMs);
-        loop.exec();
+bool ModbusManager::writeRegistersSync(int address, const QVector<quint16>& values, int timeoutMs)
+{
+    QMap<int, QVector<quint16>> blocks;
+    blocks.insert(address, values);
+    return writeRegisterBlocksSync(blocks, timeoutMs);
+}
 
-        bool success = false;
-        if (timeoutOccurred) {
-            emit errorOccurred(QString("寄存器 0x%1 读取超时").arg(address, 4, 16, QChar('0')));
-        } else if (error == QModbusDevice::NoError) {
-            qDebug() << QString("[心跳降级] 寄存器 0x%1 同步读取成功, 值: %2").arg(address, 4, 16, QChar('0')).arg(value);
-            success = true;
-        } else {
-            emit errorOccurred(QString("寄存器 0x%1 读取失败: %2").arg(address, 4, 16, QChar('0')).arg(errorString));
+
+bool ModbusManager::writeRegisterBlocksSync(const QMap<int, QVector<quint16>>& blocks, int timeoutMs)
+{
+    if (m_state != QModbusDevice::ConnectedState) {
+        emit errorOccurred(QStringLiteral("设备未连接"));
+        return false;
+    }
+
+    // 每个块按FC16单帧上限拆分，所有帧一起投递，I/O线程背靠背发送
+    QVector<ModbusCommand> commands;
+    int registerCount = 0;
+    for (auto it = blocks.constBegin(); it != blocks.constEnd(); ++it) {
+        const QVector<quint16>& values = it.value();
+        for (int offset = 0; offset < values.size(); offset += kMaxWriteRegisters) {
+            ModbusCommand command;
+            command.type = ModbusCommand::Write;
+            command.address = it.key() + offset;
+            command.values = values.mid(offset, kMaxWriteRegisters);
+            commands.append(command);
         }
+        registerCount += values.size();
+    }
+    if (commands.isEmpty()) {
+        return true;
+    }
 
-        reply->deleteLater();
-        return success;
+    QString errorText;
+    if (waitForRequests(commands, timeoutMs, nullptr, &errorText)) {
+        return true;
+    }
+    emit errorOccurred(QString("寄存器 0x%1 起 %2 个寄存器批量写失败: %3")
+                       .arg(blocks.firstKey(), 4, 16, QChar('0')).arg(registerCount).arg(errorText));
+    return false;
+}
+
+
+bool ModbusManager::readRegistersSync(int address, int count, QVector<quint16>& values, int timeoutMs)
+{
+    if (m_state != QModbusDevice::ConnectedState) {
+        emit errorOccurred(QStringLiteral("设备未连接"));
+        return false;
     }
 
-    emit errorOccurred(QString("发送读取请求失败: %1").arg(m_modbusClient->errorString()));
+    QVector<ModbusCommand> commands;
+    for (int offset = 0; offset < count; offset += kMaxReadRegisters) {
+        ModbusCommand command;
+        command.type = ModbusCommand::Read;
+        command.address = address + offset;
+        command.count = qMin(kMaxReadRegisters, count - offset);
+        commands.append(command);
+    }
+
+    QString errorText;
+    if (waitForRequests(commands, timeoutMs, &values, &errorText) && values.size() == count) {
+        return true;
+    }
+    emit errorOccurred(QString("寄存器 0x%1 起 %2 个寄存器批量读失败: %3")
+                       .arg(address, 4, 16, QChar('0')).arg(count)
+                       .arg(errorText.isEmpty() ? QStringLiteral("数据长度不符") : errorText));
     return false;
 }
 
 
 void ModbusManager::readRegister(int address)
 {
-    if (!m_modbusClient || m_modbusClient->state() != QModbusDevice::ConnectedState) {
+    if (m_state != QModbusDevice::ConnectedState) {
         emit errorOccurred(QStringLiteral("设备未连接"));
         return;
     }
 
-    QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, address, 1);
-
-    if (QModbusReply* reply = m_modbusClient->sendReadRequest(readUnit, m_unitId)) {
-        connect(reply, &QModbusReply::finished, this, [this, reply, address]() {
-            if (reply->error() == QModbusDevice::NoError) {
-                QModbusDataUnit result = reply->result();
-                quint16 value = result.value(0);
-                emit registerDataRead(value, address);
-            } else if (reply->error() == QModbusDevice::ProtocolError) {
-                QModbusResponse response = reply->rawResult();
-                if (response.isException()) {
-                    quint8 exceptionCode = response.exceptionCode();
-                    QString errorMsg = QString("Modbus异常应答(地址 0x%1), 码: %2")
-                                       .arg(address, 4, 16, QChar('0'))
-                                       .arg(exceptionCode);
-                    emit errorOccurred(errorMsg);
-                }
-            } else {
-                QString errorMsg = QString("读取寄存器 0x%1 失败: %2")
-                                   .arg(address, 4, 16, QChar('0'))
-                                   .arg(reply->errorString());
-                emit errorOccurred(errorMsg);
-            }
-            reply->deleteLater();
-        });
-    } else {
-        QString errorMsg = QString("发送读取请求失败: %1").arg(m_modbusClient->errorString());
-        emit errorOccurred(errorMsg);
+    ModbusCommand command;
+    command.type = ModbusCommand::Read;
+    command.address = address;
+    command.count = 1;
+
+    const bool queued = submitRequest(command, [this, address](bool success, const QVector<quint16>& values, const QString& errorText) {
+        if (success && !values.isEmpty()) {
+            emit registerDataRead(values.first(), address);
+        } else {
+            emit errorOccurred(QString("读取寄存器 0x%1 失败: %2")
+                               .arg(address, 4, 16, QChar('0'))
+                               .arg(errorText));
+        }
+    });
+    if (!queued) {
+        emit errorOccurred(QStringLiteral("发送读取请求失败: 命令队列已满"));
     }
 }
 
 
 void ModbusManager::startHeartbeat(int intervalMs)
 {
-    if (m_heartbeatTimer) {
-        m_heartbeatTimer->setInterval(intervalMs);
-        m_heartbeatTimer->start();
-    }
+    ModbusCommand command;
+    command.type = ModbusCommand::StartHeartbeat;
+    command.intervalMs = intervalMs;
+    submitCommand(command);
 }
 
 
 void ModbusManager::stopHeartbeat()
 {
-    if (m_heartbeatTimer) {
-        m_heartbeatTimer->stop();
-    }
+    ModbusCommand command;
+    command.type = ModbusCommand::StopHeartbeat;
+    submitCommand(command);
 }
 
 
-void ModbusManager::setupHeartbeat()
+void ModbusManager::setHeartbeatRegisterAddress(int address)
 {
-    m_heartbeatTimer = new QTimer(this);
-    // 默认2秒（可自定义）
-    m_heartbeatTimer->setInterval(kHeartbeatIntervalMs);
-    connect(m_heartbeatTimer, &QTimer::timeout, this, &ModbusManager::onHeartbeatTimeout);
+    m_heartbeatRegisterAddress = address;
+    configureHeartbeat();
 }
 
 
-void ModbusManager::onStateChanged(QModbusDevice::State newState)
+void ModbusManager::setHeartbeatToggleEnabled(bool enabled)
 {
-    emit stateChanged(newState);
-
-    // 连接成功后延时启动心跳（给网关/PLC预热时间）
-    if (newState == QModbusDevice::ConnectedState) {
-        m_heartbeatToggleState = false; // 重置心跳写入状态
-        QTimer::singleShot(400, this, [this]() { startHeartbeat(kHeartbeatIntervalMs); });
-    } else if (newState == QModbusDevice::UnconnectedState) {
-        stopHeartbeat();
-    }
+    m_heartbeatToggleEnabled = enabled;
+    configureHeartbeat();
 }
 
 
-void ModbusManager::onHeartbeatTimeout()
+void ModbusManager::configureHeartbeat()
 {
-    if (m_modbusClient->state() != QModbusDevice::ConnectedState)
-        return;
-
-    if (m_heartbeatToggleEnabled) {
-        // 尝试获取互斥锁，如果控制操作正在进行则跳过本次心跳
-        if (!m_registerMutex.tryLock()) {
-            qDebug() << "心跳跳过：控制操作正在进行";
-            return;
-        }
-
-        // 仅翻转 bit15，不影响其他位
-        m_heartbeatToggleState = !m_heartbeatToggleState;
-        
-        qDebug() << "心跳执行，bit15状态:" << (m_heartbeatToggleState ? "1" : "0");
+    ModbusCommand command;
+    command.type = ModbusCommand::ConfigureHeartbeat;
+    command.address = m_heartbeatRegisterAddress;
+    command.enabled = m_heartbeatToggleEnabled;
+    submitCommand(command);
+}
 
-        quint16 andMask, orMask;
-        if (m_heartbeatToggleState) {
-            andMask = 0xFFFF;  // 保持其他位
-            orMask = 0x8000;   // 置位 bit15
-        } else {
-            andMask = 0x7FFF;  // 清除 bit15，其余位保持
-            orMask = 0x0000;
-        }
 
-        // 优先掩码写，失败则降级，缩短超时时间避免长时间占用锁
-        int opTimeout = qMax(800, kHeartbeatIntervalMs / 3); // 缩短超时时间
-        bool success = maskWriteRegisterSync(m_heartbeatRegisterAddress, andMask, orMask, opTimeout);
-        
-        m_registerMutex.unlock(); // 释放锁
-        
-        if (!success) {
-            qDebug() << "心跳写入失败";
-        }
-    } else {
-        // 仅读取作为保活（不需要锁）
-        QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, m_heartbeatRegisterAddress, 1);
-        if (QModbusReply* reply = m_modbusClient->sendReadRequest(readUnit, m_unitId)) {
-            if (!reply->isFinished()) {
-                connect(reply, &QModbusReply::finished, reply, &QObject::deleteLater);
-            } else {
-                reply->deleteLater();
-            }
-        }
-    }
+void ModbusManager::setMoverPolling(bool enabled, int moverCount, int intervalMs, int baseAddress)
+{
+    ModbusCommand command;
+    command.type = ModbusCommand::ConfigureMoverPoll;
+    command.address = baseAddress;
+    command.count = moverCount;
+    command.registersPerMover = kMoverStatusRegistersPerMover;
+    command.intervalMs = intervalMs;
+    command.enabled = enabled;
+    submitCommand(command);
 }
@@ -8,6 +8,7 @@
 #include <QStandardPaths>
 #include <QDir>
 #include <cstring>
+#include <algorithm>
 
 //
 
@@ -35,6 +36,15 @@ const QMap<ProcessType, QPair<int, int>> RecipeManager::ProcessStationRanges = {
 RecipeManager::RecipeManager(ModbusManager* modbusManager, QObject *parent)
     : BaseController(modbusManager, parent)
 {
+    // 断开后设备可能被重启或由其他上位机改写，缓存的寄存器映像不再可信
+    if (m_modbusManager) {
+        connect(m_modbusManager, &ModbusManager::stateChanged, this, [this](QModbusDevice::State state) {
+            if (state != QModbusDevice::ConnectedState) {
+                invalidateDeviceImage();
+            }
+        });
+    }
+
     // 初始化默认配方数据（10个工位，按工艺分工，按新数据结构）
     for (int i = 0; i < 10; ++i) {
         StationRecipe recipe;
@@ -63,6 +73,9 @@ bool RecipeManager::saveRecipe(int stationIndex, const StationRecipe& recipe)
         emitError(ErrorMessages::INVALID_STATION_INDEX, stationIndex);
         return false;
     }
+    if (!checkDeviceIdle()) {
+        return false;
+    }
     
     // 更新内存中的数据
     m_stations[stationIndex] = recipe;
@@ -98,22 +111,23 @@ bool RecipeManager::saveAllRecipes()
         return false;
     }
     
-    qDebug() << "Writing station count:" << m_stations.size();
-    // 首先写入工位总数到寄存器[35]
-    if (!writeStationCountToModbus(m_stations.size())) {
-        emit errorOccurred("写入工位总数失败");
-        qDebug() << "--- Aborting saveAllRecipes: Failed to write station count ---";
+    if (!checkDeviceIdle()) {
+        qDebug() << "--- Aborting saveAllRecipes: Device transfer in progress ---";
+        return false;
+    }
+    
+    // 工位总数与全部工位配方编码为一段连续寄存器，按FC16帧批量写入后回读校验
+    qDebug() << "Writing recipe image, station count:" << m_stations.size();
+    m_deviceTransferActive = true;
+    const bool written = writeRecipeImageToModbus(m_stations);
+    m_deviceTransferActive = false;
+    if (!written) {
+        qDebug() << "--- Aborting saveAllRecipes: Failed to write recipe image ---";
         return false;
     }
     
-    // 然后从寄存器[36]开始写入所有工位配方数据
     for (int i = 0; i < m_stations.size(); ++i) {
-        qDebug() << "Saving recipe for station index:" << i;
-        if (!saveRecipe(i, m_stations[i])) {
-            emit errorOccurred(QString("保存工位 %1 失败").arg(i + 1));
-            qDebug() << "--- Aborting saveAllRecipes: Failed to save station" << i;
-            return false;
-        }
+        emit stationUpdated(i);
     }
     
     emit statusChanged(QString("所有配方已保存到设备 (工位总数: %1)").arg(m_stations.size()));
@@ -481,6 +495,10 @@ bool RecipeManager::applyCompleteRecipeToDevice(const QString& recipeName)
         emit errorOccurred(QString("配方 '%1' 不存在").arg(recipeName));
         return false;
     }
+    // 下发进行中不能替换当前工位数据
+    if (!checkDeviceIdle()) {
+        return false;
+    }
     
     // 首先加载配方到当前数据
     if (!loadCompleteRecipe(recipeName)) {
@@ -533,89 +551,190 @@ bool RecipeManager::writeStationToModbus(int stationIndex, const StationRecipe&
     int baseAddr = getStationBaseAddr(stationIndex);
     qDebug() << "  -> Base address for station" << stationIndex << "is" << QString("0x%1").arg(baseAddr, 4, 16, QChar('0'));
     
-    // 写入数据（每个工位8个寄存器）
-    
-    // 寄存器0: 工位NO(bit0) + 任务ID(bit1)
-    quint16 reg0 = packTwoBytes(recipe.stationNo, recipe.taskId);
-    if (!m_modbusManager->writeRegisterSync(baseAddr + OFFSET_STATION_TASK, reg0)) {
-        emit errorOccurred("写入工位号和任务ID失败");
+    // 一个工位的8个寄存器用一帧FC16写入
+    const QVector<quint16> registers = encodeStation(recipe);
+    m_deviceTransferActive = true;
+    const bool written = m_modbusManager->writeRegistersSync(baseAddr, registers);
+    m_deviceTransferActive = false;
+    if (!written) {
+        invalidateDeviceImage();
+        emit errorOccurred(QString("写入工位 %1 配方失败").arg(stationIndex + 1));
         return false;
     }
     
-    // 寄存器1: 所属路段号(bit0) + 目标工位号(bit1)
-    quint16 reg1 = packTwoBytes(recipe.segmentNo, recipe.nextStationId);
-    if (!m_modbusManager->writeRegisterSync(baseAddr + OFFSET_SEGMENT_NEXT, reg1)) {
-        emit errorOccurred("写入路段号和目标工位号失败");
-        return false;
+    // 同步更新映像缓存
+    const int imageOffset = baseAddr - STATION_COUNT_ADDR;
+    if (m_deviceImageValid && imageOffset + STATION_SIZE <= m_deviceImage.size()) {
+        std::copy(registers.cbegin(), registers.cend(), m_deviceImage.begin() + imageOffset);
     }
     
-    // 寄存器2: 路段位置
-    if (!m_modbusManager->writeRegisterSync(baseAddr + OFFSET_SEG_POSITION, recipe.segmentPosition)) {
-        emit errorOccurred("写入路段位置失败");
+    emit statusChanged(QString("工位 %1 配方已写入设备").arg(stationIndex + 1));
+    emit stationUpdated(stationIndex);
+    
+    qDebug() << "  -> Finished writeStationToModbus for station index:" << stationIndex;
+    return true;
+}
+
+QVector<quint16> RecipeManager::encodeStation(const StationRecipe& recipe) const
+{
+    QVector<quint16> registers(STATION_SIZE, 0);
+    
+    // 寄存器0: 工位NO(bit0) + 任务ID(bit1)
+    registers[OFFSET_STATION_TASK] = packTwoBytes(recipe.stationNo, recipe.taskId);
+    // 寄存器1: 所属路段号(bit0) + 目标工位号(bit1)
+    registers[OFFSET_SEGMENT_NEXT] = packTwoBytes(recipe.segmentNo, recipe.nextStationId);
+    registers[OFFSET_SEG_POSITION] = recipe.segmentPosition;
+    registers[OFFSET_SEG_SPEED] = recipe.segmentSpeed;
+    registers[OFFSET_START_POSITION] = recipe.startPosition;
+    registers[OFFSET_END_POSITION] = recipe.endPosition;
+    registers[OFFSET_ARRIVAL_DELAY] = recipe.arrivalDelay;
+    // 寄存器7: 摆渡位置(bit0) + 工位屏蔽(bit1)
+    registers[OFFSET_FERRY_MASK] = packTwoBytes(static_cast<quint8>(recipe.ferryPos),
+                                                recipe.stationMask ? 1 : 0);
+    return registers;
+}
+
+QVector<quint16> RecipeManager::encodeRecipeImage(const QVector<StationRecipe>& stations) const
+{
+    // 映像从STATION_COUNT_ADDR开始：[工位总数][工位0的8个寄存器][工位1]...
+    QVector<quint16> image;
+    image.reserve(1 + stations.size() * STATION_SIZE);
+    image.append(static_cast<quint16>(stations.size()));
+    for (const StationRecipe& station : stations) {
+        image.append(encodeStation(station));
+    }
+    return image;
+}
+
+bool RecipeManager::writeRecipeImageToModbus(const QVector<StationRecipe>& stations)
+{
+    if (!checkConnection()) {
         return false;
     }
     
-    // 寄存器3: 路段速度
-    if (!m_modbusManager->writeRegisterSync(baseAddr + OFFSET_SEG_SPEED, recipe.segmentSpeed)) {
-        emit errorOccurred("写入路段速度失败");
-        return false;
+    const QVector<quint16> image = encodeRecipeImage(stations);
+    
+    // 没有可信的映像时先回读；回读失败则按全量下发处理
+    if (!m_deviceImageValid || m_deviceImage.size() < image.size()) {
+        if (!loadDeviceImage(image.size())) {
+            qDebug() << "  -> Device image unavailable, falling back to full download";
+            m_deviceImage.clear();
+        }
     }
     
-    // 寄存器4: 起始位置
-    if (!m_modbusManager->writeRegisterSync(baseAddr + OFFSET_START_POSITION, recipe.startPosition)) {
-        emit errorOccurred("写入起始位置失败");
-        return false;
+    const QVector<RegisterRange> ranges = diffRegisterImage(m_deviceImage, image);
+    if (ranges.isEmpty()) {
+        emit statusChanged(QString("设备配方与目标一致，无需下发 (工位总数: %1)").arg(stations.size()));
+        return true;
     }
     
-    // 寄存器5: 终止位置
-    if (!m_modbusManager->writeRegisterSync(baseAddr + OFFSET_END_POSITION, recipe.endPosition)) {
-        emit errorOccurred("写入终止位置失败");
-        return false;
+    QMap<int, QVector<quint16>> blocks;
+    int changedRegisters = 0;
+    for (const RegisterRange& range : ranges) {
+        blocks.insert(STATION_COUNT_ADDR + range.offset, image.mid(range.offset, range.count));
+        changedRegisters += range.count;
     }
+    qDebug() << "  -> Writing recipe delta:" << changedRegisters << "of" << image.size()
+             << "registers in" << ranges.size() << "range(s)";
     
-    // 寄存器6: 到位延时
-    if (!m_modbusManager->writeRegisterSync(baseAddr + OFFSET_ARRIVAL_DELAY, recipe.arrivalDelay)) {
-        emit errorOccurred("写入到位延时失败");
+    if (!m_modbusManager->writeRegisterBlocksSync(blocks)) {
+        invalidateDeviceImage();
+        emit errorOccurred("批量写入配方失败");
         return false;
     }
     
-    // 寄存器7: 摆渡位置(bit0) + 工位屏蔽(bit1)
-    quint8 ferryPos = static_cast<quint8>(recipe.ferryPos);
-    quint8 stationMask = recipe.stationMask ? 1 : 0;
-    quint16 reg7 = packTwoBytes(ferryPos, stationMask);
-    if (!m_modbusManager->writeRegisterSync(baseAddr + OFFSET_FERRY_MASK, reg7)) {
-        emit errorOccurred("写入摆渡位置和工位屏蔽失败");
+    // 回读校验覆盖所有变化区间的最小连续范围
+    const int verifyStart = ranges.first().offset;
+    const int verifyEnd = ranges.last().offset + ranges.last().count;
+    if (!verifyRegisters(STATION_COUNT_ADDR + verifyStart, image.mid(verifyStart, verifyEnd - verifyStart))) {
+        invalidateDeviceImage();
         return false;
     }
     
-    emit statusChanged(QString("工位 %1 配方已写入设备").arg(stationIndex + 1));
-    emit stationUpdated(stationIndex);
+    // 保留映像中超出本次配方长度的部分（工位数减少时设备上的旧数据不变）
+    if (m_deviceImage.size() < image.size()) {
+        m_deviceImage.resize(image.size());
+    }
+    std::copy(image.cbegin(), image.cend(), m_deviceImage.begin());
+    m_deviceImageValid = true;
     
-    qDebug() << "  -> Finished writeStationToModbus for station index:" << stationIndex;
+    emit statusChanged(QString("工位总数 %1 及配方已写入设备并校验 (变化寄存器: %2/%3)")
+                       .arg(stations.size()).arg(changedRegisters).arg(image.size()));
     return true;
 }
 
-bool RecipeManager::writeStationCountToModbus(int stationCount)
+QVector<RecipeManager::RegisterRange> RecipeManager::diffRegisterImage(const QVector<quint16>& current,
+                                                                      const QVector<quint16>& target) const
 {
-    qDebug() << "  -> Writing station count to Modbus:" << stationCount;
-    if (!checkConnection()) {
-        qDebug() << "  -> Aborting writeStationCountToModbus: No connection";
-        return false;
+    auto changed = [&](int i) {
+        return i >= current.size() || current.at(i) != target.at(i);
+    };
+    
+    QVector<RegisterRange> ranges;
+    int i = 0;
+    while (i < target.size()) {
+        if (!changed(i)) {
+            ++i;
+            continue;
+        }
+        
+        // 向后扩展区间，间隔不超过MERGE_GAP的未变化寄存器并入同一区间
+        const int start = i;
+        int end = i + 1;
+        for (int j = end; j < target.size() && j - end < MERGE_GAP + 1; ++j) {
+            if (changed(j)) {
+                end = j + 1;
+            }
+        }
+        ranges.append({start, end - start});
+        i = end;
     }
+    return ranges;
+}
 
-    // 设备上限保护
-    
-    // 写入工位总数到寄存器[35]
-    if (!m_modbusManager->writeRegisterSync(STATION_COUNT_ADDR, static_cast<quint16>(stationCount))) {
-        emit errorOccurred("写入工位总数失败");
-        qDebug() << "  -> Failed to write station count to Modbus";
+bool RecipeManager::loadDeviceImage(int registerCount)
+{
+    QVector<quint16> values;
+    if (!m_modbusManager->readRegistersSync(STATION_COUNT_ADDR, registerCount, values)) {
+        invalidateDeviceImage();
         return false;
     }
-    
-    emit statusChanged(QString("工位总数 %1 已写入设备").arg(stationCount));
-    qDebug() << "  -> Successfully wrote station count to Modbus";
+    m_deviceImage = values;
+    m_deviceImageValid = true;
     return true;
 }
 
+bool RecipeManager::checkDeviceIdle()
+{
+    // 同步下发在局部事件循环中等待，期间界面可能再次触发保存或应用配方
+    if (m_deviceTransferActive) {
+        emit errorOccurred("配方正在下发，请稍后再试");
+        return false;
+    }
+    return true;
+}
 
+void RecipeManager::invalidateDeviceImage()
+{
+    m_deviceImageValid = false;
+}
 
+bool RecipeManager::verifyRegisters(int address, const QVector<quint16>& expected)
+{
+    QVector<quint16> actual;
+    if (!m_modbusManager->readRegistersSync(address, expected.size(), actual)) {
+        emit errorOccurred("配方回读校验失败：读取寄存器失败");
+        return false;
+    }
+    
+    for (int i = 0; i < expected.size(); ++i) {
+        if (actual.at(i) != expected.at(i)) {
+            emit errorOccurred(QString("配方回读校验失败：寄存器 0x%1 期望 %2，实际 %3")
+                               .arg(address + i, 4, 16, QChar('0'))
+                               .arg(expected.at(i))
+                               .arg(actual.at(i)));
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,86 @@
+#ifndef MAGLEVLOOPMODEL_H
+#define MAGLEVLOOPMODEL_H
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief 单个模拟动子的运动状态
+ */
+struct SimMover
+{
+    enum Command {
+        Idle,           // 减速到静止
+        MoveTo,         // 按最短路径移动到目标位置
+        Velocity        // 以给定速度连续运行
+    };
+
+    double position = 0.0;          // 位置 (mm)，[0, trackLength)
+    double velocity = 0.0;          // 速度 (mm/s)，正方向为逆时针（前进）
+    double target = 0.0;            // 目标位置 (mm)
+    double maxSpeed = 0.0;          // MoveTo的速度上限 (mm/s)
+    double commandVelocity = 0.0;   // Velocity命令的速度 (mm/s)
+    Command command = Idle;
+    bool enabled = false;
+    bool inPosition = true;
+    quint16 errorCode = 0;
+};
+
+/**
+ * @brief 磁悬浮环线的运动学模型
+ *
+ * 以固定步长积分所有动子：速度按加速度上限向期望速度逼近，
+ * MoveTo使用梯形速度曲线（剩余距离决定的最大速度 sqrt(2·a·d)）。
+ * 相邻动子间距小于最小间距且仍在靠近时，两者都报碰撞错误并立即停止。
+ * 纯计算类，不依赖Modbus，可以单独验证。
+ */
+class MaglevLoopModel
+{
+public:
+    struct Parameters {
+        double trackLength = 7455.75;       // 环线周长 (mm)
+        double acceleration = 2000.0;       // 加减速度上限 (mm/s²)
+        double emergencyDeceleration = 10000.0; // 急停、禁用时的减速度 (mm/s²)
+        double minGap = 60.0;               // 相邻动子最小间距 (mm)
+        double positionTolerance = 0.01;    // 到位判定 (mm)
+    };
+
+    MaglevLoopModel();
+    explicit MaglevLoopModel(const Parameters &parameters);
+
+    // 重新生成动子并沿环线均匀分布
+    void reset(int moverCount, bool enabled);
+
+    int moverCount() const { return m_movers.size(); }
+    const SimMover &mover(int id) const { return m_movers[id]; }
+    const Parameters &parameters() const { return m_parameters; }
+
+    // --- 命令 ---
+    void setEnabled(int id, bool enabled);
+    void moveTo(int id, double target, double speed);
+    void runAtVelocity(int id, double velocity);
+    void stop(int id);
+    void stopAll();
+    void setEmergencyStop(bool active);
+    bool isEmergencyStop() const { return m_emergencyStop; }
+    void clearErrors();
+
+    // 积分一步
+    void step(double dt);
+
+    quint16 statusWord(int id) const;
+    int errorCount() const;
+
+private:
+    double wrap(double position) const;
+    double signedDistance(double from, double to) const;
+    void integrateMover(SimMover &mover, double dt);
+    void detectCollisions();
+
+    Parameters m_parameters;
+    QVector<SimMover> m_movers;
+    QVector<int> m_order;           // 按位置排序的动子编号，每步插入排序维护
+    bool m_emergencyStop;
+};
+
+#endif // MAGLEVLOOPMODEL_H
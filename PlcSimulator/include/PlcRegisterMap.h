@@ -0,0 +1,96 @@
+#ifndef PLCREGISTERMAP_H
+#define PLCREGISTERMAP_H
+
+/**
+ * @brief 模拟PLC的保持寄存器映射
+ *
+ * 与ControlSystemUI的ModbusRegisters、MaglevControl的ModbusManager/RecipeManager保持一致，
+ * 两个上位机修改寄存器地址时需同步修改这里。
+ */
+namespace PlcRegisterMap {
+
+    // --- 单动子控制（控制字bit15同时作为MaglevControl的心跳位） ---
+    namespace SingleAxis {
+        const int CONTROL_WORD = 0x0000;
+        const int AUTO_SPEED_LOW = 0x0001;       // 自动速度 (mm/s, DINT)
+        const int JOG_POSITION = 0x0003;         // 自动运行目标位置 (mm)
+        const int JOG_SPEED_LOW = 0x0004;        // 点动速度 (mm/s, DINT)
+        const int LAST_ADDRESS = 0x0005;
+
+        const int ENABLE_BIT = 0;
+        const int RUN_MODE_BIT = 1;              // 1=自动, 0=点动
+        const int MANUAL_ALLOW_BIT = 2;
+        const int JOG_LEFT_BIT = 3;              // 后退（顺时针）
+        const int JOG_RIGHT_BIT = 4;             // 前进（逆时针）
+        const int AUTO_RUN_BIT = 5;
+        const int HEARTBEAT_BIT = 15;
+    }
+
+    // --- 点动会话保活（ControlSystemUI） ---
+    namespace JogSession {
+        const int KEEPALIVE = 0x0006;            // 保活计数，写0立即结束会话
+        const int TIMEOUT_MS = 0x0007;           // 保活超时 (ms)，0表示不检查
+    }
+
+    // --- 配方块（MaglevControl） ---
+    namespace Recipe {
+        const int STATION_COUNT = 0x0023;
+        const int BASE_ADDRESS = 0x0024;
+        const int REGISTERS_PER_STATION = 8;
+    }
+
+    // --- 动子状态块 ---
+    // 默认基址100之后紧接系统状态块，只能容纳10个动子；更多动子用--status-base把状态块放到空闲区（如0x1000）
+    namespace MoverStatus {
+        const int BASE_ADDRESS = 100;            // 默认基址
+        const int REGISTERS_PER_MOVER = 10;
+        const int POSITION_LOW = 0;              // 位置 (um, DINT)
+        const int VELOCITY_LOW = 2;              // 速度 (um/s, DINT)
+        const int STATUS_WORD = 4;
+        const int ERROR_CODE = 5;
+        const int TARGET_LOW = 8;                // 目标位置 (um, DINT)
+
+        // 状态字位定义，与上位机的解析一致
+        const int ENABLED_BIT = 0;
+        const int RUNNING_BIT = 1;
+        const int IN_POSITION_BIT = 2;
+        const int ERROR_BIT = 3;
+        const int EMERGENCY_BIT = 4;
+    }
+
+    // --- 系统状态 ---
+    namespace SystemStatus {
+        const int SYSTEM_READY = 200;
+        const int SYSTEM_ERROR = 201;
+        const int EMERGENCY_STOP = 202;          // 上位机写非零触发急停，写零复位
+        const int MOVER_COUNT = 203;
+    }
+
+    // --- 多动子控制 ---
+    namespace MultiAxis {
+        const int ENABLE_BASE_ADDRESS = 0x0100;
+        const int SPEED_BASE_ADDRESS = 0x0200;   // 速度 (mm/s, 有符号)，非零时按该速度连续运行
+    }
+
+    // --- 协同定位邮箱：先写条目，最后写序号触发，所有条目在同一周期内启动 ---
+    namespace GroupMove {
+        const int BASE_ADDRESS = 0x0400;
+        const int SEQUENCE = 0;                  // 触发序号，非零且与上次不同时执行
+        const int COUNT = 1;
+        const int ENTRIES = 2;
+        const int REGISTERS_PER_ENTRY = 4;
+        const int ENTRY_MOVER_ID = 0;
+        const int ENTRY_TARGET_LOW = 1;          // 目标位置 (um, DINT)
+        const int ENTRY_SPEED = 3;               // 速度 (mm/s)
+        const int MAX_ENTRIES = 128;
+        const int ACK_SEQUENCE = ENTRIES + MAX_ENTRIES * REGISTERS_PER_ENTRY;  // 已执行的序号，上位机回读确认
+    }
+
+    // --- 错误码 ---
+    namespace ErrorCode {
+        const int COLLISION = 0x0101;            // 与相邻动子间距小于最小间距
+        const int WATCHDOG = 0x0201;             // 心跳超时（系统错误）
+    }
+}
+
+#endif // PLCREGISTERMAP_H
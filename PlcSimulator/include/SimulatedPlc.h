@@ -0,0 +1,86 @@
+#ifndef SIMULATEDPLC_H
+#define SIMULATEDPLC_H
+
+#include <QModbusTcpServer>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "MaglevLoopModel.h"
+
+/**
+ * @brief 基于QModbusTcpServer的模拟PLC
+ *
+ * 上位机写入的控制寄存器在writeData中转换为运动学模型的命令，
+ * 模型按固定步长积分，每个周期把动子状态块和系统状态写回保持寄存器。
+ * 控制字bit15的翻转被当作心跳，超时后所有动子停止并报系统错误。
+ * 点动会话的保活计数超时或写0时，单动子的点动立即停止。
+ */
+class SimulatedPlc : public QModbusTcpServer
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        QString address = "0.0.0.0";
+        int port = 5020;
+        int unitId = 1;
+        int moverCount = 10;
+        int moverStatusBase = 100;          // 动子状态块基址，须与上位机配置一致
+        int tickMs = 1;                     // 积分步长
+        int publishIntervalMs = 5;          // 状态寄存器刷新周期
+        int watchdogMs = 10000;             // 心跳超时，0表示不检查
+        int axisMover = 0;                  // 单动子控制寄存器对应的动子
+        bool startEnabled = true;           // 启动时所有动子处于使能状态
+        bool maskWriteSupported = true;     // false时对0x16返回非法功能码，模拟不支持掩码写的PLC
+        MaglevLoopModel::Parameters model;
+    };
+
+    explicit SimulatedPlc(const Options &options, QObject *parent = nullptr);
+
+    bool start();
+    void stop();
+
+    const MaglevLoopModel &model() const { return m_model; }
+
+protected:
+    bool writeData(const QModbusDataUnit &newData) override;
+    QModbusResponse processRequest(const QModbusPdu &request) override;
+
+private slots:
+    void onTick();
+
+private:
+    void handleClientWrite(int address, int count);
+    void applySingleAxisCommand();
+    void executeGroupMove();
+    void checkWatchdog(qint64 nowMs);
+    void checkJogSession(qint64 nowMs);
+    void endJogSession();
+    void publishState();
+    bool checkRegisterLayout() const;
+
+    quint16 registerValue(int address) const;
+    qint32 registerDint(int lowAddress) const;
+
+    Options m_options;
+    MaglevLoopModel m_model;
+    QTimer *m_tickTimer;
+    QElapsedTimer m_clock;
+    qint64 m_simulatedMs;           // 已积分的模拟时间
+    qint64 m_lastPublishMs;
+    int m_registerCount;
+    bool m_publishing;              // 写回状态寄存器时不当作上位机命令处理
+    quint16 m_lastGroupSequence;    // 已执行的协同定位序号
+
+    // 点动会话：保活超时或会话结束后屏蔽点动位，直到上位机清除点动位或开始新会话
+    bool m_jogSessionActive;
+    qint64 m_lastJogKeepAliveMs;
+    bool m_jogInhibited;
+
+    // 心跳
+    bool m_heartbeatSeen;
+    bool m_lastHeartbeatBit;
+    qint64 m_lastHeartbeatMs;
+    bool m_watchdogTripped;
+};
+
+#endif // SIMULATEDPLC_H
@@ -0,0 +1,248 @@
+#include "MaglevLoopModel.h"
+#include "PlcRegisterMap.h"
+#include <cmath>
+
+using namespace PlcRegisterMap;
+
+// --- 构造与初始化 ---
+
+MaglevLoopModel::MaglevLoopModel()
+    : MaglevLoopModel(Parameters())
+{
+}
+
+MaglevLoopModel::MaglevLoopModel(const Parameters &parameters)
+    : m_parameters(parameters)
+    , m_emergencyStop(false)
+{
+}
+
+/**
+ * @brief 重新生成动子并沿环线均匀分布
+ * @param moverCount 动子数量
+ * @param enabled 初始是否使能
+ */
+void MaglevLoopModel::reset(int moverCount, bool enabled)
+{
+    m_movers = QVector<SimMover>(qMax(0, moverCount));
+    m_order.resize(m_movers.size());
+    const double spacing = m_movers.isEmpty() ? 0.0 : m_parameters.trackLength / m_movers.size();
+    for (int i = 0; i < m_movers.size(); ++i) {
+        SimMover &mover = m_movers[i];
+        mover.position = i * spacing;
+        mover.target = mover.position;
+        mover.enabled = enabled;
+        m_order[i] = i;
+    }
+    m_emergencyStop = false;
+}
+
+// --- 命令 ---
+
+void MaglevLoopModel::setEnabled(int id, bool enabled)
+{
+    if (id < 0 || id >= m_movers.size()) {
+        return;
+    }
+    SimMover &mover = m_movers[id];
+    mover.enabled = enabled;
+    if (!enabled) {
+        mover.command = SimMover::Idle;
+    }
+}
+
+/**
+ * @brief 按最短路径移动到目标位置
+ * @param id 动子编号
+ * @param target 目标位置 (mm)
+ * @param speed 速度上限 (mm/s)
+ */
+void MaglevLoopModel::moveTo(int id, double target, double speed)
+{
+    if (id < 0 || id >= m_movers.size() || speed <= 0.0) {
+        return;
+    }
+    SimMover &mover = m_movers[id];
+    mover.target = wrap(target);
+    mover.maxSpeed = speed;
+    mover.command = SimMover::MoveTo;
+    mover.inPosition = false;
+}
+
+void MaglevLoopModel::runAtVelocity(int id, double velocity)
+{
+    if (id < 0 || id >= m_movers.size()) {
+        return;
+    }
+    SimMover &mover = m_movers[id];
+    mover.commandVelocity = velocity;
+    mover.command = SimMover::Velocity;
+    mover.inPosition = false;
+}
+
+void MaglevLoopModel::stop(int id)
+{
+    if (id >= 0 && id < m_movers.size()) {
+        m_movers[id].command = SimMover::Idle;
+    }
+}
+
+void MaglevLoopModel::stopAll()
+{
+    for (SimMover &mover : m_movers) {
+        mover.command = SimMover::Idle;
+    }
+}
+
+void MaglevLoopModel::setEmergencyStop(bool active)
+{
+    m_emergencyStop = active;
+    if (active) {
+        stopAll();
+    }
+}
+
+void MaglevLoopModel::clearErrors()
+{
+    for (SimMover &mover : m_movers) {
+        mover.errorCode = 0;
+    }
+}
+
+// --- 积分 ---
+
+/**
+ * @brief 积分一个固定步长
+ * @param dt 步长 (s)
+ */
+void MaglevLoopModel::step(double dt)
+{
+    for (SimMover &mover : m_movers) {
+        integrateMover(mover, dt);
+    }
+    detectCollisions();
+}
+
+void MaglevLoopModel::integrateMover(SimMover &mover, double dt)
+{
+    double desired = 0.0;
+    double acceleration = m_parameters.acceleration;
+
+    if (!mover.enabled || m_emergencyStop || mover.errorCode != 0) {
+        acceleration = m_parameters.emergencyDeceleration;
+    } else if (mover.command == SimMover::MoveTo) {
+        const double distance = signedDistance(mover.position, mover.target);
+        // 本步即可到达时直接到位，避免离散积分在目标附近来回振荡
+        if (std::fabs(distance) <= m_parameters.positionTolerance
+            || (std::fabs(distance) <= std::fabs(mover.velocity) * dt && distance * mover.velocity > 0.0)) {
+            mover.position = mover.target;
+            mover.velocity = 0.0;
+            mover.command = SimMover::Idle;
+            mover.inPosition = true;
+            return;
+        }
+        const double brakingSpeed = std::sqrt(2.0 * acceleration * std::fabs(distance));
+        desired = std::copysign(qMin(mover.maxSpeed, brakingSpeed), distance);
+    } else if (mover.command == SimMover::Velocity) {
+        desired = mover.commandVelocity;
+    }
+
+    const double maxChange = acceleration * dt;
+    mover.velocity += qBound(-maxChange, desired - mover.velocity, maxChange);
+    mover.position = wrap(mover.position + mover.velocity * dt);
+
+    if (mover.command == SimMover::Idle && mover.velocity == 0.0) {
+        mover.inPosition = true;
+    }
+}
+
+/**
+ * @brief 检查相邻动子间距
+ *
+ * 动子顺序在两步之间几乎不变，插入排序接近O(n)。
+ */
+void MaglevLoopModel::detectCollisions()
+{
+    const int count = m_movers.size();
+    if (count < 2) {
+        return;
+    }
+
+    for (int i = 1; i < count; ++i) {
+        const int id = m_order[i];
+        const double position = m_movers[id].position;
+        int j = i - 1;
+        while (j >= 0 && m_movers[m_order[j]].position > position) {
+            m_order[j + 1] = m_order[j];
+            --j;
+        }
+        m_order[j + 1] = id;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        SimMover &behind = m_movers[m_order[i]];
+        SimMover &ahead = m_movers[m_order[(i + 1) % count]];
+        const double gap = wrap(ahead.position - behind.position);
+        const bool closing = behind.velocity - ahead.velocity > 0.0;
+        if (gap < m_parameters.minGap && closing) {
+            for (SimMover *mover : {&behind, &ahead}) {
+                mover->errorCode = ErrorCode::COLLISION;
+                mover->velocity = 0.0;
+                mover->command = SimMover::Idle;
+            }
+        }
+    }
+}
+
+// --- 状态 ---
+
+quint16 MaglevLoopModel::statusWord(int id) const
+{
+    const SimMover &mover = m_movers[id];
+    quint16 word = 0;
+    if (mover.enabled) {
+        word |= 1u << MoverStatus::ENABLED_BIT;
+    }
+    if (mover.velocity != 0.0) {
+        word |= 1u << MoverStatus::RUNNING_BIT;
+    }
+    if (mover.inPosition && mover.velocity == 0.0) {
+        word |= 1u << MoverStatus::IN_POSITION_BIT;
+    }
+    if (mover.errorCode != 0) {
+        word |= 1u << MoverStatus::ERROR_BIT;
+    }
+    if (m_emergencyStop) {
+        word |= 1u << MoverStatus::EMERGENCY_BIT;
+    }
+    return word;
+}
+
+int MaglevLoopModel::errorCount() const
+{
+    int count = 0;
+    for (const SimMover &mover : m_movers) {
+        if (mover.errorCode != 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+double MaglevLoopModel::wrap(double position) const
+{
+    const double length = m_parameters.trackLength;
+    position = std::fmod(position, length);
+    return position < 0.0 ? position + length : position;
+}
+
+// 从from到to的有符号最短距离，范围(-L/2, L/2]
+double MaglevLoopModel::signedDistance(double from, double to) const
+{
+    const double length = m_parameters.trackLength;
+    double distance = wrap(to - from);
+    if (distance > length / 2.0) {
+        distance -= length;
+    }
+    return distance;
+}
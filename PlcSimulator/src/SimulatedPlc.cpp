@@ -0,0 +1,442 @@
+#include "SimulatedPlc.h"
+#include "PlcRegisterMap.h"
+#include <QModbusDataUnit>
+#include <QDebug>
+#include <cmath>
+
+using namespace PlcRegisterMap;
+
+namespace {
+// 进程被挂起后最多补算的步数，超过则直接跳到当前时间
+const int MAX_CATCH_UP_STEPS = 1000;
+}
+
+// --- 构造与启停 ---
+
+SimulatedPlc::SimulatedPlc(const Options &options, QObject *parent)
+    : QModbusTcpServer(parent)
+    , m_options(options)
+    , m_model(options.model)
+    , m_tickTimer(new QTimer(this))
+    , m_simulatedMs(0)
+    , m_lastPublishMs(0)
+    , m_registerCount(0)
+    , m_publishing(false)
+    , m_lastGroupSequence(0)
+    , m_jogSessionActive(false)
+    , m_lastJogKeepAliveMs(0)
+    , m_jogInhibited(false)
+    , m_heartbeatSeen(false)
+    , m_lastHeartbeatBit(false)
+    , m_lastHeartbeatMs(0)
+    , m_watchdogTripped(false)
+{
+    m_options.tickMs = qMax(1, m_options.tickMs);
+    m_options.moverCount = qBound(1, m_options.moverCount, 1024);
+    m_tickTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_tickTimer, &QTimer::timeout, this, &SimulatedPlc::onTick);
+}
+
+/**
+ * @brief 建立寄存器表并开始监听
+ * @return 监听成功返回true
+ */
+bool SimulatedPlc::start()
+{
+    const int moverCount = m_options.moverCount;
+    m_model.reset(moverCount, m_options.startEnabled);
+
+    if (!checkRegisterLayout()) {
+        return false;
+    }
+
+    m_registerCount = qMax(m_options.moverStatusBase + moverCount * MoverStatus::REGISTERS_PER_MOVER,
+                           MultiAxis::SPEED_BASE_ADDRESS + moverCount);
+    m_registerCount = qMax(m_registerCount, GroupMove::BASE_ADDRESS + GroupMove::ACK_SEQUENCE + 1);
+    m_registerCount = qMin(m_registerCount, 65536);
+
+    QModbusDataUnitMap map;
+    map.insert(QModbusDataUnit::HoldingRegisters,
+               QModbusDataUnit(QModbusDataUnit::HoldingRegisters, 0, m_registerCount));
+    setMap(map);
+
+    setConnectionParameter(QModbusDevice::NetworkAddressParameter, m_options.address);
+    setConnectionParameter(QModbusDevice::NetworkPortParameter, m_options.port);
+    setServerAddress(m_options.unitId);
+
+    if (!connectDevice()) {
+        qWarning() << "模拟PLC监听失败：" << errorString();
+        return false;
+    }
+
+    // 初始寄存器与模型一致：使能位和多动子使能寄存器反映启动状态
+    m_publishing = true;
+    const quint16 enableValue = m_options.startEnabled ? 1 : 0;
+    setData(QModbusDataUnit::HoldingRegisters, SingleAxis::CONTROL_WORD,
+            quint16(enableValue << SingleAxis::ENABLE_BIT));
+    setData(QModbusDataUnit(QModbusDataUnit::HoldingRegisters, MultiAxis::ENABLE_BASE_ADDRESS,
+                            QVector<quint16>(moverCount, enableValue)));
+    m_publishing = false;
+
+    m_clock.start();
+    m_simulatedMs = 0;
+    m_lastPublishMs = 0;
+    publishState();
+    m_tickTimer->start(m_options.tickMs);
+    return true;
+}
+
+void SimulatedPlc::stop()
+{
+    m_tickTimer->stop();
+    disconnectDevice();
+}
+
+// --- 上位机写入 ---
+
+/**
+ * @brief 所有寄存器写入（包括0x06/0x10/0x16/0x17）都经过这里
+ */
+bool SimulatedPlc::writeData(const QModbusDataUnit &newData)
+{
+    const bool written = QModbusTcpServer::writeData(newData);
+    if (written && !m_publishing && newData.registerType() == QModbusDataUnit::HoldingRegisters) {
+        handleClientWrite(newData.startAddress(), int(newData.valueCount()));
+    }
+    return written;
+}
+
+QModbusResponse SimulatedPlc::processRequest(const QModbusPdu &request)
+{
+    if (!m_options.maskWriteSupported && request.functionCode() == QModbusPdu::MaskWriteRegister) {
+        return QModbusExceptionResponse(request.functionCode(), QModbusExceptionResponse::IllegalFunction);
+    }
+    return QModbusTcpServer::processRequest(request);
+}
+
+/**
+ * @brief 把上位机写入的寄存器转换为模型命令
+ * @param address 起始地址
+ * @param count 寄存器数量
+ */
+void SimulatedPlc::handleClientWrite(int address, int count)
+{
+    const int moverCount = m_model.moverCount();
+    bool singleAxisChanged = false;
+    bool groupTriggered = false;
+
+    for (int a = address; a < address + count; ++a) {
+        if (a <= SingleAxis::LAST_ADDRESS) {
+            if (a == SingleAxis::CONTROL_WORD) {
+                const bool bit = (registerValue(a) >> SingleAxis::HEARTBEAT_BIT) & 1;
+                if (bit != m_lastHeartbeatBit) {
+                    m_lastHeartbeatBit = bit;
+                    m_heartbeatSeen = true;
+                    m_lastHeartbeatMs = m_clock.elapsed();
+                    if (m_watchdogTripped) {
+                        m_watchdogTripped = false;
+                        qInfo() << "心跳恢复";
+                    }
+                }
+            }
+            singleAxisChanged = true;
+        } else if (a == JogSession::KEEPALIVE) {
+            if (registerValue(a) == 0) {
+                endJogSession();
+            } else {
+                if (!m_jogSessionActive) {
+                    m_jogInhibited = false;     // 新会话解除上一次超时的屏蔽
+                }
+                m_jogSessionActive = true;
+                m_lastJogKeepAliveMs = m_clock.elapsed();
+            }
+        } else if (a == SystemStatus::EMERGENCY_STOP) {
+            const bool active = registerValue(a) != 0;
+            if (active != m_model.isEmergencyStop()) {
+                m_model.setEmergencyStop(active);
+                if (!active) {
+                    m_model.clearErrors();  // 急停复位同时清除动子错误
+                }
+                qInfo() << (active ? "急停触发" : "急停复位");
+            }
+        } else if (a >= MultiAxis::ENABLE_BASE_ADDRESS && a < MultiAxis::ENABLE_BASE_ADDRESS + moverCount) {
+            m_model.setEnabled(a - MultiAxis::ENABLE_BASE_ADDRESS, registerValue(a) != 0);
+        } else if (a >= MultiAxis::SPEED_BASE_ADDRESS && a < MultiAxis::SPEED_BASE_ADDRESS + moverCount) {
+            const int id = a - MultiAxis::SPEED_BASE_ADDRESS;
+            const qint16 speed = qint16(registerValue(a));
+            if (speed != 0) {
+                m_model.runAtVelocity(id, speed);
+            } else {
+                m_model.stop(id);
+            }
+        } else if (a == GroupMove::BASE_ADDRESS + GroupMove::SEQUENCE) {
+            groupTriggered = true;
+        }
+        // 配方块等其余寄存器只保存数值，供上位机回读校验
+    }
+
+    if (singleAxisChanged) {
+        applySingleAxisCommand();
+    }
+    // 序号与条目可能在同一帧写入，条目全部落地后再执行
+    if (groupTriggered) {
+        executeGroupMove();
+    }
+}
+
+/**
+ * @brief 执行协同定位邮箱中的全部条目
+ *
+ * 序号为零或与上次相同（上位机重发同一帧）时忽略；
+ * 所有条目在同一次调用中下发给模型，因此在同一个积分周期内开始运动。
+ * 执行后把序号写入ACK_SEQUENCE，条目数超限的命令不确认。
+ */
+void SimulatedPlc::executeGroupMove()
+{
+    const quint16 sequence = registerValue(GroupMove::BASE_ADDRESS + GroupMove::SEQUENCE);
+    if (sequence == 0 || sequence == m_lastGroupSequence) {
+        return;
+    }
+    m_lastGroupSequence = sequence;
+
+    const int count = registerValue(GroupMove::BASE_ADDRESS + GroupMove::COUNT);
+    if (count > GroupMove::MAX_ENTRIES) {
+        qWarning() << "协同定位" << sequence << "条目数" << count << "超出上限，忽略";
+        return;
+    }
+
+    int started = 0;
+    for (int i = 0; i < count; ++i) {
+        const int entry = GroupMove::BASE_ADDRESS + GroupMove::ENTRIES + i * GroupMove::REGISTERS_PER_ENTRY;
+        const int id = registerValue(entry + GroupMove::ENTRY_MOVER_ID);
+        if (id >= m_model.moverCount()) {
+            qWarning() << "协同定位" << sequence << "动子编号" << id << "无效";
+            continue;
+        }
+        const double target = registerDint(entry + GroupMove::ENTRY_TARGET_LOW) / 1000.0;
+        m_model.moveTo(id, target, registerValue(entry + GroupMove::ENTRY_SPEED));
+        ++started;
+    }
+
+    m_publishing = true;
+    setData(QModbusDataUnit::HoldingRegisters, GroupMove::BASE_ADDRESS + GroupMove::ACK_SEQUENCE, sequence);
+    m_publishing = false;
+    qInfo() << "协同定位" << sequence << "启动" << started << "个动子";
+}
+
+/**
+ * @brief 根据单动子控制寄存器的当前值更新对应动子的命令
+ *
+ * 自动模式下AUTO_RUN置位时移动到JOG_POSITION；点动模式下左右点动位置位时以点动速度连续运行。
+ */
+void SimulatedPlc::applySingleAxisCommand()
+{
+    const int id = m_options.axisMover;
+    if (id < 0 || id >= m_model.moverCount()) {
+        return;
+    }
+
+    const quint16 controlWord = registerValue(SingleAxis::CONTROL_WORD);
+    auto bit = [controlWord](int index) { return (controlWord >> index) & 1; };
+
+    m_model.setEnabled(id, bit(SingleAxis::ENABLE_BIT));
+    if (!bit(SingleAxis::ENABLE_BIT)) {
+        return;
+    }
+
+    const SimMover &mover = m_model.mover(id);
+    if (bit(SingleAxis::RUN_MODE_BIT)) {
+        if (bit(SingleAxis::AUTO_RUN_BIT)) {
+            const double target = qint16(registerValue(SingleAxis::JOG_POSITION));
+            const double speed = std::abs(registerDint(SingleAxis::AUTO_SPEED_LOW));
+            if (mover.command != SimMover::MoveTo || mover.target != target || mover.maxSpeed != speed) {
+                m_model.moveTo(id, target, speed);
+            }
+        } else if (mover.command == SimMover::MoveTo) {
+            m_model.stop(id);
+        }
+    } else {
+        const double speed = std::abs(registerDint(SingleAxis::JOG_SPEED_LOW));
+        const bool left = bit(SingleAxis::JOG_LEFT_BIT);
+        const bool right = bit(SingleAxis::JOG_RIGHT_BIT);
+        if (!left && !right) {
+            m_jogInhibited = false;
+        }
+        if (m_jogInhibited) {
+            if (mover.command == SimMover::Velocity) {
+                m_model.stop(id);
+            }
+        } else if (left && !right) {
+            m_model.runAtVelocity(id, -speed);
+        } else if (right && !left) {
+            m_model.runAtVelocity(id, speed);
+        } else if (mover.command == SimMover::Velocity) {
+            m_model.stop(id);
+        }
+    }
+}
+
+// --- 周期处理 ---
+
+/**
+ * @brief 按固定步长追赶到当前时间，再刷新状态寄存器
+ */
+void SimulatedPlc::onTick()
+{
+    const qint64 now = m_clock.elapsed();
+    const int tickMs = m_options.tickMs;
+
+    if ((now - m_simulatedMs) / tickMs > MAX_CATCH_UP_STEPS) {
+        m_simulatedMs = now - qint64(MAX_CATCH_UP_STEPS) * tickMs;
+    }
+    while (m_simulatedMs + tickMs <= now) {
+        m_model.step(tickMs / 1000.0);
+        m_simulatedMs += tickMs;
+    }
+
+    checkWatchdog(now);
+    checkJogSession(now);
+
+    if (now - m_lastPublishMs >= m_options.publishIntervalMs) {
+        m_lastPublishMs = now;
+        publishState();
+    }
+}
+
+void SimulatedPlc::checkWatchdog(qint64 nowMs)
+{
+    if (m_options.watchdogMs <= 0 || !m_heartbeatSeen || m_watchdogTripped) {
+        return;
+    }
+    if (nowMs - m_lastHeartbeatMs > m_options.watchdogMs) {
+        m_watchdogTripped = true;
+        m_model.stopAll();
+        qWarning() << "心跳超时" << m_options.watchdogMs << "ms，所有动子停止";
+    }
+}
+
+// 保活计数超过TIMEOUT_MS未变化时结束点动会话，不等待控制字
+void SimulatedPlc::checkJogSession(qint64 nowMs)
+{
+    if (!m_jogSessionActive) {
+        return;
+    }
+    const int timeoutMs = registerValue(JogSession::TIMEOUT_MS);
+    if (timeoutMs > 0 && nowMs - m_lastJogKeepAliveMs > timeoutMs) {
+        qWarning() << "点动保活超时" << timeoutMs << "ms，点动停止";
+        endJogSession();
+    }
+}
+
+void SimulatedPlc::endJogSession()
+{
+    m_jogSessionActive = false;
+    m_jogInhibited = true;
+    applySingleAxisCommand();
+}
+
+/**
+ * @brief 把模型状态写回动子状态块和系统状态寄存器
+ */
+void SimulatedPlc::publishState()
+{
+    using namespace MoverStatus;
+    const int moverCount = m_model.moverCount();
+
+    QVector<quint16> block(moverCount * REGISTERS_PER_MOVER, 0);
+    auto putDint = [&block](int index, double value) {
+        const quint32 raw = quint32(qint32(std::lround(value * 1000.0)));
+        block[index] = quint16(raw & 0xFFFF);
+        block[index + 1] = quint16(raw >> 16);
+    };
+
+    for (int id = 0; id < moverCount; ++id) {
+        const SimMover &mover = m_model.mover(id);
+        const int base = id * REGISTERS_PER_MOVER;
+        putDint(base + POSITION_LOW, mover.position);
+        putDint(base + VELOCITY_LOW, mover.velocity);
+        putDint(base + TARGET_LOW, mover.target);
+        block[base + STATUS_WORD] = m_model.statusWord(id);
+        block[base + ERROR_CODE] = mover.errorCode;
+    }
+
+    const int errorCount = m_model.errorCount();
+    quint16 systemError = 0;
+    if (m_watchdogTripped) {
+        systemError = ErrorCode::WATCHDOG;
+    } else if (errorCount > 0) {
+        systemError = ErrorCode::COLLISION;
+    }
+    const bool ready = !m_model.isEmergencyStop() && systemError == 0;
+
+    m_publishing = true;
+    setData(QModbusDataUnit(QModbusDataUnit::HoldingRegisters, m_options.moverStatusBase, block));
+    setData(QModbusDataUnit(QModbusDataUnit::HoldingRegisters, SystemStatus::SYSTEM_READY,
+                            QVector<quint16>{quint16(ready ? 1 : 0), systemError,
+                                             quint16(m_model.isEmergencyStop() ? 1 : 0),
+                                             quint16(moverCount)}));
+    m_publishing = false;
+}
+
+/**
+ * @brief 检查各寄存器区互不重叠
+ *
+ * 状态块与其他区重叠时上位机会把系统状态或控制寄存器当作动子状态解码，
+ * 因此拒绝启动，提示减少动子数量或用--status-base移动状态块。
+ * @return 布局可用返回true
+ */
+bool SimulatedPlc::checkRegisterLayout() const
+{
+    const int moverCount = m_options.moverCount;
+    struct Block {
+        const char *name;
+        int start;
+        int end;
+    };
+    const Block blocks[] = {
+        {"单动子控制/点动会话", SingleAxis::CONTROL_WORD, JogSession::TIMEOUT_MS + 1},
+        {"系统状态", SystemStatus::SYSTEM_READY, SystemStatus::MOVER_COUNT + 1},
+        {"多动子使能", MultiAxis::ENABLE_BASE_ADDRESS, MultiAxis::ENABLE_BASE_ADDRESS + moverCount},
+        {"多动子速度", MultiAxis::SPEED_BASE_ADDRESS, MultiAxis::SPEED_BASE_ADDRESS + moverCount},
+        {"协同定位", GroupMove::BASE_ADDRESS,
+         GroupMove::BASE_ADDRESS + GroupMove::ACK_SEQUENCE + 1},
+        {"动子状态", m_options.moverStatusBase,
+         m_options.moverStatusBase + moverCount * MoverStatus::REGISTERS_PER_MOVER},
+    };
+
+    bool ok = true;
+    const int blockCount = int(sizeof(blocks) / sizeof(blocks[0]));
+    for (int i = 0; i < blockCount; ++i) {
+        for (int j = i + 1; j < blockCount; ++j) {
+            if (blocks[i].start < blocks[j].end && blocks[j].start < blocks[i].end) {
+                qWarning().noquote() << QString("寄存器区重叠：%1 %2-%3 与 %4 %5-%6")
+                                            .arg(blocks[i].name).arg(blocks[i].start).arg(blocks[i].end - 1)
+                                            .arg(blocks[j].name).arg(blocks[j].start).arg(blocks[j].end - 1);
+                ok = false;
+            }
+        }
+    }
+    if (blocks[blockCount - 1].end > 65536) {
+        qWarning() << "动子状态块超出寄存器地址范围";
+        ok = false;
+    }
+    if (!ok) {
+        qWarning() << "请减少动子数量，或用--status-base把动子状态块移到空闲区（如0x1000）";
+    }
+    return ok;
+}
+
+// --- 寄存器访问 ---
+
+quint16 SimulatedPlc::registerValue(int address) const
+{
+    quint16 value = 0;
+    data(QModbusDataUnit::HoldingRegisters, quint16(address), &value);
+    return value;
+}
+
+// 低字在前，与上位机的writeHoldingRegisterDINT一致
+qint32 SimulatedPlc::registerDint(int lowAddress) const
+{
+    return qint32((quint32(registerValue(lowAddress + 1)) << 16) | registerValue(lowAddress));
+}
@@ -0,0 +1,78 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTimer>
+#include <QDebug>
+#include "SimulatedPlc.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("PlcSimulator");
+    app.setApplicationVersion("1.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("磁悬浮环线模拟PLC（Modbus TCP）");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    const QCommandLineOption addressOption("address", "监听地址", "address", "0.0.0.0");
+    const QCommandLineOption portOption({"p", "port"}, "监听端口", "port", "5020");
+    const QCommandLineOption unitOption("unit", "从站地址", "id", "1");
+    const QCommandLineOption moversOption({"m", "movers"}, "动子数量", "count", "10");
+    const QCommandLineOption statusBaseOption("status-base", "动子状态块基址（默认100时最多10个动子）", "address", "100");
+    const QCommandLineOption tickOption("tick-ms", "积分步长 (ms)", "ms", "1");
+    const QCommandLineOption publishOption("publish-ms", "状态寄存器刷新周期 (ms)", "ms", "5");
+    const QCommandLineOption watchdogOption("watchdog-ms", "心跳超时 (ms)，0为不检查", "ms", "10000");
+    const QCommandLineOption axisOption("axis-mover", "单动子控制寄存器对应的动子编号", "id", "0");
+    const QCommandLineOption accelOption("accel", "加速度上限 (mm/s²)", "value", "2000");
+    const QCommandLineOption trackOption("track-length", "环线周长 (mm)", "mm", "7455.75");
+    const QCommandLineOption gapOption("min-gap", "相邻动子最小间距 (mm)", "mm", "60");
+    const QCommandLineOption disabledOption("start-disabled", "启动时动子处于禁用状态");
+    const QCommandLineOption noMaskWriteOption("no-mask-write", "拒绝0x16掩码写，模拟不支持该功能码的PLC");
+    parser.addOptions({addressOption, portOption, unitOption, moversOption, statusBaseOption, tickOption, publishOption,
+                       watchdogOption, axisOption, accelOption, trackOption, gapOption,
+                       disabledOption, noMaskWriteOption});
+    parser.process(app);
+
+    SimulatedPlc::Options options;
+    options.address = parser.value(addressOption);
+    options.port = parser.value(portOption).toInt();
+    options.unitId = parser.value(unitOption).toInt();
+    options.moverCount = parser.value(moversOption).toInt();
+    options.moverStatusBase = parser.value(statusBaseOption).toInt(nullptr, 0);
+    options.tickMs = parser.value(tickOption).toInt();
+    options.publishIntervalMs = parser.value(publishOption).toInt();
+    options.watchdogMs = parser.value(watchdogOption).toInt();
+    options.axisMover = parser.value(axisOption).toInt();
+    options.startEnabled = !parser.isSet(disabledOption);
+    options.maskWriteSupported = !parser.isSet(noMaskWriteOption);
+    options.model.acceleration = parser.value(accelOption).toDouble();
+    options.model.trackLength = parser.value(trackOption).toDouble();
+    options.model.minGap = parser.value(gapOption).toDouble();
+
+    SimulatedPlc plc(options);
+    if (!plc.start()) {
+        return 1;
+    }
+    qInfo().noquote() << QString("模拟PLC已启动：%1:%2，从站%3，%4个动子，步长%5ms")
+                             .arg(options.address).arg(options.port).arg(options.unitId)
+                             .arg(plc.model().moverCount()).arg(options.tickMs);
+
+    // 定期输出运行概况，便于压测时观察
+    QTimer statusTimer;
+    QObject::connect(&statusTimer, &QTimer::timeout, &plc, [&plc]() {
+        const MaglevLoopModel &model = plc.model();
+        int moving = 0;
+        for (int i = 0; i < model.moverCount(); ++i) {
+            if (model.mover(i).velocity != 0.0) {
+                ++moving;
+            }
+        }
+        qInfo().noquote() << QString("运行中%1 / 故障%2 / 急停%3")
+                                 .arg(moving).arg(model.errorCount())
+                                 .arg(model.isEmergencyStop() ? "是" : "否");
+    });
+    statusTimer.start(10000);
+
+    return app.exec();
+}